@@ -0,0 +1,11 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    size: ${experiment['size']},
+    tile_size: ${experiment['tile_size']},
+    function: "${experiment['function']}",
+    dtype: "${experiment['dtype']}",
+    implementation: "${experiment['implementation']}"
+}
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+FUNCTIONS = ['GELU_TANH', 'GELU_ERF', 'SILU', 'SIGMOID', 'TANH']
+DTYPES = ['FP64', 'FP32', 'FP16', 'FP8']
+IMPLEMENTATIONS = ['NAIVE', 'OPT']
+SIZE = 4096
+TILE_SIZE = 512
+COMPUTE_HART = 'hart_0'
+
+VERIFY_PY = Path('../../sw/kernels/dnn/activation/scripts/verify.py')
+
+
+def gen_experiments():
+    return eu.sweep(
+        app='activation',
+        size=SIZE,
+        tile_size=TILE_SIZE,
+        function=FUNCTIONS,
+        dtype=DTYPES,
+        implementation=IMPLEMENTATIONS,
+    )
+
+
+def metrics(df):
+    df['cycles_per_element'] = df['cycles'] / SIZE
+    # Speedup over the libm baseline for the same function and precision
+    eu.add_speedup(df, df['implementation'] == 'NAIVE', ['function', 'dtype'])
+
+
+def main():
+    # The layer is enclosed in a dedicated region, following the runtime setup
+    eu.run_kernel_experiments(gen_experiments(), ['function', 'dtype', 'implementation'],
+                              VERIFY_PY, eu.timespan(SimRegion(COMPUTE_HART, 1)), metrics)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,15 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    L: ${experiment['L']},
+    S: ${experiment['L']},
+    d: ${experiment['d']},
+    B_r: ${experiment['B_r']},
+    B_c: ${experiment['B_c']},
+    dtype: "${experiment['dtype']}",
+    baseline: false,
+    causal: ${str(experiment['causal']).lower()},
+    multicast: ${str(experiment['multicast']).lower()}
+}
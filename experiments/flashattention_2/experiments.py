@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+SEQ_LENS = [512, 1024, 2048, 4096]
+HEAD_DIM = 64
+B_R = 32
+B_C = 32
+DTYPE = 'FP16'
+DMA_HART = 'hart_8'
+
+VERIFY_PY = Path('../../sw/kernels/dnn/flashattention_2/scripts/verify.py')
+
+
+def gen_experiments():
+    return eu.sweep(
+        app='flashattention_2',
+        L=SEQ_LENS,
+        d=HEAD_DIM,
+        B_r=B_R,
+        B_c=B_C,
+        dtype=DTYPE,
+        causal=[False, True],
+        multicast=[False, True],
+    )
+
+
+def get_flops(row):
+    # Q*K^t and P*V, both of 2*L*S*d operations
+    flops = 4 * row['L'] * row['L'] * HEAD_DIM
+    # Only the blocks on and below the diagonal are computed with a
+    # causal mask
+    if row['causal']:
+        T = row['L'] // B_C
+        flops = flops * (T + 1) // (2 * T)
+    return flops
+
+
+def metrics(df):
+    df['flops'] = df.apply(get_flops, axis=1)
+    df['throughput'] = df['flops'] / df['cycles']
+
+
+def main():
+    # The DM core executes the kernel from the first Q load to the last O
+    # store. Skip the first region, which covers the runtime setup and TCDM
+    # allocation, and the last one, which covers the runtime teardown.
+    eu.run_kernel_experiments(gen_experiments(), ['L', 'causal', 'multicast'], VERIFY_PY,
+                              eu.timespan(SimRegion(DMA_HART, 1), SimRegion(DMA_HART, -2)),
+                              metrics)
+
+
+if __name__ == '__main__':
+    main()
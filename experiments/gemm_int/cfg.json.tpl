@@ -0,0 +1,25 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    setup_ssr: 1,
+    parallelize_m: 0,
+    parallelize_k: 0,
+    m_tiles: 1,
+    n_tiles: 1,
+    k_tiles: 1,
+    load_a: 1,
+    load_b: 1,
+    load_c: 1,
+    double_buffer: 0,
+    partition_banks: 0,
+    transa: false,
+    transb: true,
+    m: ${experiment['m']},
+    n: ${experiment['n']},
+    k: ${experiment['k']},
+    alpha: 1,
+    beta: 0,
+    gemm_fp: "${experiment['gemm_fp']}"
+}
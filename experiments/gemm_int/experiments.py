@@ -0,0 +1,40 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+KERNELS = ['gemm_i8_opt', 'gemm_i16_opt', 'gemm_fp8_opt_ex']
+M = 32
+N = 32
+K = 64
+COMPUTE_HART = 'hart_0'
+
+VERIFY_PY = Path('../../sw/kernels/blas/gemm/scripts/verify.py')
+
+
+def gen_experiments():
+    return eu.sweep(
+        app='gemm',
+        m=M,
+        n=N,
+        k=K,
+        gemm_fp=KERNELS,
+    )
+
+
+def metrics(df):
+    df['ops_per_cycle'] = 2 * M * N * K / df['cycles']
+
+
+def main():
+    # The kernels enclose their computation in a dedicated region
+    eu.run_kernel_experiments(gen_experiments(), ['gemm_fp'], VERIFY_PY,
+                              eu.timespan(SimRegion(COMPUTE_HART, 1)), metrics)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,13 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    rows: ${experiment['rows']},
+    embeddings: ${experiment['embeddings']},
+    hidden: ${experiment['hidden']},
+    prec: "${experiment['prec']}",
+    gemm_fp: "gemm_${experiment['prec'].lower()}_opt",
+    mode: "${experiment['mode']}",
+    tile_rows: ${experiment['tile_rows']}
+}
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+MODES = ['GRAPH_LAYERS', 'GRAPH_RESIDENT']
+DTYPES = ['FP32', 'FP16']
+ROWS = 32
+EMBEDDINGS = 32
+HIDDEN = 128
+TILE_ROWS = 8
+COMPUTE_HART = 'hart_0'
+
+VERIFY_PY = Path('../../sw/kernels/dnn/graph/scripts/verify.py')
+
+
+def gen_experiments():
+    return eu.sweep(
+        app='graph',
+        rows=ROWS,
+        embeddings=EMBEDDINGS,
+        hidden=HIDDEN,
+        tile_rows=TILE_ROWS,
+        mode=MODES,
+        prec=DTYPES,
+    )
+
+
+def metrics(df):
+    df['cycles_per_token'] = df['cycles'] / ROWS
+
+
+def main():
+    # The whole graph is enclosed in a dedicated region, following the
+    # runtime setup
+    eu.run_kernel_experiments(gen_experiments(), ['mode', 'prec'], VERIFY_PY,
+                              eu.timespan(SimRegion(COMPUTE_HART, 1)), metrics)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,18 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    input_dim: {
+        batch_size: ${experiment['batch_size']},
+        seq_len: ${experiment['seq_len']},
+        embeddings: ${experiment['embeddings']}
+    },
+    eps: 1e-5,
+    prec: "${experiment['prec']}",
+    fused: true,
+    norm: "${experiment['norm']}",
+    tile_rows: ${experiment['tile_rows']},
+    affine: true,
+    residual: ${'true' if experiment['residual'] else 'false'}
+}
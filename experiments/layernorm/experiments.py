@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+NORMS = ['LAYERNORM_STANDARD', 'LAYERNORM_RMS']
+DTYPES = ['FP32', 'FP16']
+RESIDUAL = [False, True]
+BATCH_SIZE = 1
+SEQ_LEN = 512
+EMBEDDINGS = 256
+TILE_ROWS = 16
+COMPUTE_HART = 'hart_0'
+
+VERIFY_PY = Path('../../sw/kernels/dnn/layernorm/scripts/verify.py')
+
+
+def gen_experiments():
+    return eu.sweep(
+        app='layernorm',
+        batch_size=BATCH_SIZE,
+        seq_len=SEQ_LEN,
+        embeddings=EMBEDDINGS,
+        tile_rows=TILE_ROWS,
+        norm=NORMS,
+        prec=DTYPES,
+        residual=RESIDUAL,
+    )
+
+
+def metrics(df):
+    df['cycles_per_token'] = df['cycles'] / (BATCH_SIZE * SEQ_LEN)
+
+
+def main():
+    # The tile pipeline is enclosed in a dedicated region, following the
+    # runtime setup and the packing of the affine parameters
+    eu.run_kernel_experiments(gen_experiments(), ['norm', 'prec', 'residual'], VERIFY_PY,
+                              eu.timespan(SimRegion(COMPUTE_HART, 1)), metrics)
+
+
+if __name__ == '__main__':
+    main()
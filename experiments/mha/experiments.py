@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+SEQ_LENS = [32, 64, 128]
+DTYPES = ['FP32', 'FP16', 'FP8']
+HEAD_DIM = 16
+D_MODEL = 32
+B_R = 16
+B_C = 16
+DMA_HART = 'hart_8'
+
+VERIFY_PY = Path('../../sw/kernels/dnn/mha/scripts/verify.py')
+
+
+def gen_experiments():
+    return eu.sweep(
+        app='mha',
+        L=SEQ_LENS,
+        d=HEAD_DIM,
+        d_model=D_MODEL,
+        B_r=B_R,
+        B_c=B_C,
+        dtype=DTYPES,
+    )
+
+
+def metrics(df):
+    # Speedup over the FP32 implementation at equal sequence length
+    eu.add_speedup(df, df['dtype'] == 'FP32', ['L'])
+
+
+def main():
+    # Skip the first region, which covers the runtime setup, and the last
+    # one, which covers the runtime teardown
+    eu.run_kernel_experiments(gen_experiments(), ['L', 'dtype'], VERIFY_PY,
+                              eu.timespan(SimRegion(DMA_HART, 1), SimRegion(DMA_HART, -2)),
+                              metrics)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,15 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    input_dim: {
+        batch_size: 1,
+        seq_len: ${experiment['rows']},
+        input_samples: ${experiment['input_samples']}
+    },
+    reduce_dim: -1,
+    prec: "${experiment['prec']}",
+    implementation: "${experiment['implementation']}",
+    tile_rows: ${experiment['tile_rows']}
+}
@@ -0,0 +1,44 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+# The NAIVE kernel only supports FP32
+CONFIGS = [('NAIVE', 'FP32'), ('OPT', 'FP32'), ('OPT', 'FP16'), ('OPT', 'FP8')]
+ROWS = 128
+INPUT_SAMPLES = [32, 64]
+TILE_ROWS = 16
+COMPUTE_HART = 'hart_0'
+
+VERIFY_PY = Path('../../sw/kernels/dnn/softmax/scripts/verify.py')
+
+
+def gen_experiments():
+    return [experiment for implementation, prec in CONFIGS for experiment in eu.sweep(
+        app='softmax',
+        rows=ROWS,
+        input_samples=INPUT_SAMPLES,
+        tile_rows=TILE_ROWS,
+        prec=prec,
+        implementation=implementation,
+    )]
+
+
+def metrics(df):
+    df['cycles_per_row'] = df['cycles'] / ROWS
+    # Speedup over the FP32 baseline for the same row length
+    eu.add_speedup(df, df['implementation'] == 'NAIVE', ['input_samples'])
+
+
+def main():
+    # The layer is enclosed in a dedicated region, following the runtime setup
+    eu.run_kernel_experiments(gen_experiments(), ['implementation', 'prec', 'input_samples'],
+                              VERIFY_PY, eu.timespan(SimRegion(COMPUTE_HART, 1)), metrics)
+
+
+if __name__ == '__main__':
+    main()
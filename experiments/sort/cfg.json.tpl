@@ -0,0 +1,12 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    algorithm: "${experiment['algorithm']}",
+    n: ${experiment['n']},
+    min: ${experiment['min']},
+    max: ${experiment['max']},
+    pairs: ${str(experiment['pairs']).lower()},
+    block: ${experiment['block']}
+}
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+N = 2048
+BLOCK = 256
+# The bucket sort only supports keys in a small range, and no values
+CONFIGS = [
+    {'algorithm': 'bucket', 'min': -256, 'max': 256, 'pairs': False},
+    {'algorithm': 'radix', 'min': -256, 'max': 256, 'pairs': False},
+    {'algorithm': 'sample', 'min': -256, 'max': 256, 'pairs': False},
+    {'algorithm': 'radix', 'min': -2**31, 'max': 2**31 - 1, 'pairs': False},
+    {'algorithm': 'sample', 'min': -2**31, 'max': 2**31 - 1, 'pairs': False},
+    {'algorithm': 'radix', 'min': -2**31, 'max': 2**31 - 1, 'pairs': True},
+    {'algorithm': 'sample', 'min': -2**31, 'max': 2**31 - 1, 'pairs': True},
+]
+DMA_HART = 'hart_8'
+# The sort is enclosed in a dedicated region, which the bucket sort further
+# divides into five
+END_REGION = {'bucket': 6, 'radix': 1, 'sample': 1}
+# Clock frequency assumed for the throughput
+FREQ = 1e9
+
+VERIFY_PY = Path('../../sw/kernels/misc/sort/scripts/verify.py')
+
+
+def gen_experiments():
+    return [{'app': 'sort', **config, 'n': N, 'block': BLOCK} for config in CONFIGS]
+
+
+def get_runtime(row):
+    end = END_REGION[row['algorithm']]
+    return row['results'].get_timespan(SimRegion(DMA_HART, 1), SimRegion(DMA_HART, end))
+
+
+def metrics(df):
+    df['keys_per_second'] = N * FREQ / df['cycles']
+
+
+def main():
+    eu.run_kernel_experiments(gen_experiments(), ['algorithm', 'max', 'pairs'], VERIFY_PY,
+                              get_runtime, metrics)
+
+
+if __name__ == '__main__':
+    main()
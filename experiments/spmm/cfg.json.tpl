@@ -0,0 +1,15 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    format: "${experiment['format']}",
+    M: ${experiment['M']},
+    N: ${experiment['N']},
+    K: ${experiment['K']},
+    density: ${experiment['density']},
+    distribution: "${experiment['distribution']}",
+    panel_rows: 32,
+    panel_nnz: 1024,
+    baseline: ${str(experiment['baseline']).lower()}
+}
@@ -0,0 +1,45 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+FORMATS = ['CSR', 'CSC']
+DISTRIBUTIONS = ['uniform', 'powerlaw']
+DENSITIES = [0.01, 0.05, 0.1, 0.2, 0.3]
+M = 128
+K = 128
+N = 1
+COMPUTE_HART = 'hart_0'
+
+VERIFY_PY = Path('../../sw/kernels/blas/spmm/scripts/verify.py')
+
+
+def gen_experiments():
+    return eu.sweep(
+        app='spmm',
+        format=FORMATS,
+        distribution=DISTRIBUTIONS,
+        density=DENSITIES,
+        baseline=[True, False],
+        M=M,
+        N=N,
+        K=K,
+    )
+
+
+def metrics(df):
+    df['flops_per_cycle'] = 2 * df['density'] * M * K * N / df['cycles']
+
+
+def main():
+    # The kernel is enclosed in a dedicated region
+    eu.run_kernel_experiments(gen_experiments(), ['format', 'distribution', 'density', 'baseline'],
+                              VERIFY_PY, eu.timespan(SimRegion(COMPUTE_HART, 1)), metrics)
+
+
+if __name__ == '__main__':
+    main()
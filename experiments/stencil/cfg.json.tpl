@@ -0,0 +1,15 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+{
+    kernel: "${experiment['kernel']}",
+    param: ${experiment['param']},
+    nx: ${experiment['nx']},
+    ny: ${experiment['ny']},
+    nz: ${experiment['nz']},
+    steps: ${experiment['steps']},
+    tsteps: ${experiment['tsteps']},
+    resident: ${str(experiment['resident']).lower()},
+    tile_z: ${experiment['tile_z']}
+}
@@ -0,0 +1,51 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+from pathlib import Path
+import snitch.util.experiments.experiment_utils as eu
+from snitch.util.experiments.SimResults import SimRegion
+
+KERNEL = 'BOX3D1R'
+NX = 10
+NY = 10
+NZ = 48
+STEPS = 4
+TILE_Z = 8
+TSTEPS = [1, 2, 4]
+# The compute cores invoke the micro-kernels, which define regions of their
+# own, so the kernel is timed on the DMA core
+DMA_HART = 'hart_8'
+
+VERIFY_PY = Path('../../sw/kernels/misc/stencil/scripts/verify.py')
+
+
+def gen_experiments():
+    return eu.sweep(
+        app='stencil',
+        kernel=KERNEL,
+        param=1,
+        nx=NX,
+        ny=NY,
+        nz=NZ,
+        steps=STEPS,
+        resident=[False, True],
+        tsteps=TSTEPS,
+        tile_z=TILE_Z,
+    )
+
+
+def metrics(df):
+    points = (NX - 2) * (NY - 2) * (NZ - 2) * STEPS
+    df['cycles_per_point'] = df['cycles'] / points
+
+
+def main():
+    # The driver is enclosed in a dedicated region
+    eu.run_kernel_experiments(gen_experiments(), ['resident', 'tsteps'], VERIFY_PY,
+                              eu.timespan(SimRegion(DMA_HART, 1)), metrics)
+
+
+if __name__ == '__main__':
+    main()
@@ -77,6 +77,8 @@ SN_APPS += $(SN_ROOT)/sw/kernels/blas/gemm
 SN_APPS += $(SN_ROOT)/sw/kernels/blas/gemv
 SN_APPS += $(SN_ROOT)/sw/kernels/blas/dot
 SN_APPS += $(SN_ROOT)/sw/kernels/blas/syrk
+SN_APPS += $(SN_ROOT)/sw/kernels/blas/spmm
+SN_APPS += $(SN_ROOT)/sw/kernels/blas/spdot
 SN_APPS += $(SN_ROOT)/sw/kernels/dnn/batchnorm
 # SN_APPS += $(SN_ROOT)/sw/kernels/dnn/conv2d
 # SN_APPS += $(SN_ROOT)/sw/kernels/dnn/fusedconv
@@ -88,18 +90,27 @@ SN_APPS += $(SN_ROOT)/sw/kernels/dnn/flashattention_2
 SN_APPS += $(SN_ROOT)/sw/kernels/dnn/concat
 SN_APPS += $(SN_ROOT)/sw/kernels/dnn/fused_concat_linear
 SN_APPS += $(SN_ROOT)/sw/kernels/dnn/transpose
+SN_APPS += $(SN_ROOT)/sw/kernels/dnn/layout
 SN_APPS += $(SN_ROOT)/sw/kernels/dnn/mha
+SN_APPS += $(SN_ROOT)/sw/kernels/dnn/decode_attention
+SN_APPS += $(SN_ROOT)/sw/kernels/dnn/activation
+SN_APPS += $(SN_ROOT)/sw/kernels/dnn/conv2d_igemm
+SN_APPS += $(SN_ROOT)/sw/kernels/dnn/graph
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/montecarlo/pi_estimation
+SN_APPS += $(SN_ROOT)/sw/kernels/misc/montecarlo/philox
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/atax
+SN_APPS += $(SN_ROOT)/sw/kernels/misc/bicg
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/correlation
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/covariance
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/doitgen
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/kmeans
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/exp
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/log
+SN_APPS += $(SN_ROOT)/sw/kernels/misc/vmath
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/kbpcpa
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/box3d1r
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/j3d27pt
+SN_APPS += $(SN_ROOT)/sw/kernels/misc/stencil
 SN_APPS += $(SN_ROOT)/sw/kernels/misc/sort
 endif
 
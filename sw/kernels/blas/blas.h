@@ -20,5 +20,8 @@ static inline double multiply_opt(double multiplicand, double multiplier) {
 #include "axpy/src/axpy.h"
 #include "dot/src/dot.h"
 #include "gemm/src/gemm.h"
+#include "gemm/src/gemm_batched.h"
 #include "gemv/src/gemv.h"
+#include "spdot/src/spdot.h"
+#include "spmm/src/spmm.h"
 #include "syrk/src/syrk.h"
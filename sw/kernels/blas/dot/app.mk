@@ -8,6 +8,7 @@ APP              := dot
 $(APP)_BUILD_DIR ?= $(SN_ROOT)/sw/kernels/blas/$(APP)/build
 SRC_DIR          := $(SN_ROOT)/sw/kernels/blas/$(APP)/src
 SRCS             := $(SRC_DIR)/main.c
+$(APP)_INCDIRS   := $(SN_ROOT)/sw/kernels/misc
 
 include $(SN_ROOT)/sw/kernels/datagen.mk
 include $(SN_ROOT)/sw/kernels/common.mk
@@ -4,6 +4,8 @@
 
 #include "snrt.h"
 
+#include "primitives/primitives.h"
+
 inline void dot_seq(uint32_t n, double *x, double *y, double *output) {
     // Start of SSR region.
     register volatile double ft0 asm("ft0");
@@ -126,12 +128,12 @@ static inline void dot(uint32_t n, double *x, double *y, double *result) {
 
     snrt_cluster_hw_barrier();
 
-    // Reduce partial sums on core 0
+    // Reduce partial sums in a tree
 #ifndef _DOTP_EXCLUDE_FINAL_SYNC_
+    double sum = prim_cluster_allreduce(
+        snrt_is_compute_core() ? partial_sums[core_idx] : 0.0);
     if (snrt_cluster_core_idx() == 0) {
-        for (uint32_t i = 1; i < snrt_cluster_compute_core_num(); i++) {
-            partial_sums[0] += partial_sums[i];
-        }
+        partial_sums[0] = sum;
         snrt_fpu_fence();
     }
 #endif
@@ -24,6 +24,10 @@ class GemmDataGen(du.DataGen):
     # the occurrence of these splits the data should be aligned to 4KB
     BURST_ALIGNMENT = 4096
     NUM_CORES = 8
+    # Flags integer precisions, see `gemm_int_prec_t`
+    GEMM_INT = 0x10
+    INT_CTYPES = {1: 'int8_t', 2: 'int16_t'}
+    INT_DTYPES = {1: np.int8, 2: np.int16}
 
     def golden_model(self, alpha, a, b, beta, c):
         return alpha * np.matmul(a, b) + beta * c
@@ -38,11 +42,42 @@ class GemmDataGen(du.DataGen):
                     result[i][j] += a[i][h] * b[h][j]
         return result
 
+    def requantize(self, acc, mul, add, shift, size):
+        """Reference model of `gemm_requantize`."""
+        q = (acc.astype(np.int64) * mul + add) >> shift
+        bound = 1 << (8 * size - 1)
+        return np.clip(q, -bound, bound - 1)
+
+    def requant_params(self, acc, size):
+        """Per-column requantization parameters mapping the range of the
+        int32 results to the range of the operands, with random scale factors
+        slightly exceeding it to exercise saturation, and random zero
+        points."""
+        n = acc.shape[1]
+        amax = np.maximum(np.max(np.abs(acc), axis=0), 1)
+        scale = np.random.uniform(0.8, 1.2, n) * (1 << (8 * size - 1)) / amax
+        zero_point = np.random.randint(-8, 9, n)
+        shift = int(min(24, np.floor(np.log2((2**31 - 1) / np.max(scale)))))
+        mul = np.round(scale * (1 << shift)).astype(np.int32)
+        add = ((zero_point << shift) + (1 << (shift - 1))).astype(np.int32)
+        return mul, add, shift
+
     def infer_implementation(self, gemm_fp):
-        # gemm_fp: "gemm_fp64_opt"
-        # create a regex with fp_<type>_<implementation>
-        prec, impl = re.search(r'gemm_fp(\d+)_(\w+)', gemm_fp).group(1, 2)
-        return int(prec) // 8, impl
+        # gemm_fp: "gemm_fp64_opt" or "gemm_i8_opt"
+        # create a regex with <fp|i><type>_<implementation>
+        kind, prec, impl = re.search(r'gemm_(fp|i)(\d+)_(\w+)', gemm_fp).group(1, 2, 3)
+        prec = int(prec) // 8
+        if kind == 'i':
+            prec |= self.GEMM_INT
+        return prec, impl
+
+    def ctypes(self, prec, requant=False):
+        """C types of the A and B, and of the C matrix elements."""
+        if prec & self.GEMM_INT:
+            ab_ctype = self.INT_CTYPES[prec & ~self.GEMM_INT]
+            return ab_ctype, ab_ctype if requant else 'int32_t'
+        ctype = du.ctype_from_precision_t(prec)
+        return ctype, ctype
 
     def validate(self, gemm_fp, parallelize_m,
                  parallelize_k, m_tiles, n_tiles, k_tiles, transa,
@@ -57,10 +92,14 @@ class GemmDataGen(du.DataGen):
 
         # Calculate total TCDM occupation
         # Note: doesn't account for double buffering
-        prec = du.size_from_precision_t(dtype)
+        if dtype & self.GEMM_INT:
+            prec = dtype & ~self.GEMM_INT
+            c_prec = 4
+        else:
+            prec = c_prec = du.size_from_precision_t(dtype)
         a_size = tile_m * tile_k * prec
         b_size = tile_k * tile_n * prec
-        c_size = tile_m * tile_n * prec
+        c_size = tile_m * tile_n * c_prec
         total_size = a_size
         total_size += b_size
         total_size += c_size
@@ -106,6 +145,22 @@ class GemmDataGen(du.DataGen):
         assert not (partition_banks and (dtype != 8)), 'Lower than double precision kernels do' \
             'not support partitioned banks, yet.'
         assert not (parallelize_k and (dtype == 1)), 'FP8 reduction is not supported yet.'
+        if dtype & self.GEMM_INT:
+            assert (tile_k * prec) % 4 == 0, \
+                'K dimension of tile size must fill a multiple of 32-bit words'
+            assert impl == 'naive' or tile_n % 4 == 0, \
+                'n dimension of tile size must be a multiple of 4 when using optimized kernels'
+            assert impl == 'naive' or (transb and not transa), \
+                'Optimized integer kernels only support a transposed B and non-transposed A'
+        if kwargs.get('requant', False):
+            assert dtype & self.GEMM_INT, 'Requantization requires integer kernels'
+            assert beta == 0, 'Requantization requires beta == 0'
+        split_outputs = kwargs.get('split_outputs', 0)
+        if split_outputs:
+            assert n % split_outputs == 0, 'split_outputs must divide the n dimension'
+            assert not partition_banks, 'Tensor views are not supported with partitioned banks'
+            assert not kwargs.get('requant', False), 'Tensor views are not supported with' \
+                ' requantization'
 
     def emit_header(self, **kwargs):
         header = [super().emit_header()]
@@ -116,13 +171,33 @@ class GemmDataGen(du.DataGen):
         m, n, k = kwargs['m'], kwargs['n'], kwargs['k']
 
         prec, _ = self.infer_implementation(kwargs['gemm_fp'])
+        requant = kwargs.pop('requant', False)
+        # Number of tensors the C matrix is split into along n, through a tensor view
+        split_outputs = kwargs.pop('split_outputs', 0)
 
-        ctype = du.ctype_from_precision_t(prec)
+        ctype, c_ctype = self.ctypes(prec, requant)
 
-        a = du.generate_random_array((m, k), prec, seed=42)
-        b = du.generate_random_array((k, n), prec, seed=42)
-        c = du.generate_random_array((m, n), prec, seed=42)
-        result = self.exact_golden_model(1, a, b, kwargs['beta'], c)
+        if prec & self.GEMM_INT:
+            size = prec & ~self.GEMM_INT
+            dtype = self.INT_DTYPES[size]
+            # Operands span their full range, so int16 accumulations can
+            # overflow, and wrap around as in the int32 accumulators
+            bound = 1 << (8 * size - 1)
+            rng = np.random.default_rng(seed=42)
+            a = rng.integers(-bound, bound, (m, k)).astype(dtype)
+            b = rng.integers(-bound, bound, (k, n)).astype(dtype)
+            c = rng.integers(-bound, bound, (m, n)).astype(np.int32)
+            result = kwargs['beta'] * c.astype(np.int64) + a.astype(np.int64) @ b
+            result = result.astype(np.int32)
+            if requant:
+                mul, add, shift = self.requant_params(result, size)
+                result = self.requantize(result, mul, add, shift, size)
+                c = np.zeros((m, n), dtype=dtype)
+        else:
+            a = du.generate_random_array((m, k), prec, seed=42)
+            b = du.generate_random_array((k, n), prec, seed=42)
+            c = du.generate_random_array((m, n), prec, seed=42)
+            result = self.exact_golden_model(1, a, b, kwargs['beta'], c)
 
         # Store matrices in transposed form if requested
         a = a.T if kwargs['transa'] else a
@@ -153,6 +228,14 @@ class GemmDataGen(du.DataGen):
         cfg['k'] = k_uid
         cfg['beta'] = beta_uid
         cfg['transb'] = transb_uid
+        if requant:
+            cfg['requant_mul'] = 'requant_mul'
+            cfg['requant_add'] = 'requant_add'
+            cfg['requant_shift'] = 'requant_shift'
+        if split_outputs:
+            cfg['c_view'] = '&c_view'
+            part_size = n // split_outputs
+            c_parts = [c[:, i * part_size:(i + 1) * part_size] for i in range(split_outputs)]
 
         a = a.flatten()
         b = b.flatten()
@@ -161,7 +244,7 @@ class GemmDataGen(du.DataGen):
         # "extern" specifier is required on declarations preceding a definition
         header += [du.format_array_declaration(f'extern {ctype}', a_uid, a.shape)]
         header += [du.format_array_declaration(f'extern {ctype}', b_uid, b.shape)]
-        header += [du.format_array_declaration(f'extern {ctype}', c_uid, c.shape)]
+        header += [du.format_array_declaration(f'extern {c_ctype}', c_uid, c.shape)]
         # "extern" specifier ensures that the variable is emitted and not mangled
         header += [du.format_scalar_definition('extern const uint32_t', prec_uid, prec)]
         header += [du.format_scalar_definition('extern const uint32_t', m_uid, m)]
@@ -170,14 +253,40 @@ class GemmDataGen(du.DataGen):
         header += [du.format_scalar_definition('extern const uint32_t', beta_uid, kwargs['beta'])]
         header += [du.format_scalar_definition('extern const uint32_t', transb_uid,
                                                kwargs['transb'])]
+        header += [du.format_scalar_definition('extern const uint32_t', 'requant', int(requant))]
+        header += [du.format_scalar_definition('extern const uint32_t', 'split_outputs',
+                                               split_outputs)]
+        if split_outputs:
+            # C is loaded from and stored to separate tensors, which the kernel splits the
+            # output into through a tensor view
+            header += [du.format_array_declaration(f'extern {c_ctype}', f'c_{i}',
+                                                   part.shape)
+                       for i, part in enumerate(c_parts)]
+            part_defs = [f'\t{{.ptr = c_{i}, .x1_offset = 0, .x0_offset = {i * part_size},'
+                         f' .x1_size = {m}, .x0_size = {part_size}, .ld = {part_size}}}'
+                         for i in range(split_outputs)]
+            header += [f'snrt_dma_view_part_t c_parts[{split_outputs}] = {{\n' +
+                       ',\n'.join(part_defs) + '\n};']
+            header += [du.format_struct_definition('snrt_dma_view_t', 'c_view',
+                                                   {'num_parts': split_outputs,
+                                                    'parts': 'c_parts'})]
+        if requant:
+            header += [du.format_array_definition('int32_t', 'requant_mul', mul)]
+            header += [du.format_array_definition('int32_t', 'requant_add', add)]
+            header += [du.format_scalar_definition('extern const uint32_t', 'requant_shift',
+                                                   shift)]
         header += [du.format_struct_definition('extern const gemm_args_t', 'args', cfg)]
         header += [du.format_array_definition(ctype, a_uid, a,
                                               section=kwargs['section'])]
         header += [du.format_array_definition(ctype, b_uid, b,
                                               section=kwargs['section'])]
-        header += [du.format_array_definition(ctype, c_uid, c,
+        header += [du.format_array_definition(c_ctype, c_uid, c,
                                               section=kwargs['section'])]
-        result_def = du.format_array_definition(ctype, 'result', result.flatten())
+        if split_outputs:
+            header += [du.format_array_definition(c_ctype, f'c_{i}', part.flatten(),
+                                                  section=kwargs['section'])
+                       for i, part in enumerate(c_parts)]
+        result_def = du.format_array_definition(c_ctype, 'result', result.flatten())
         header += [du.format_ifdef_wrapper('BIST', result_def)]
         header = '\n\n'.join(header)
 
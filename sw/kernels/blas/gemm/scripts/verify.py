@@ -10,7 +10,6 @@ import sys
 from datagen import GemmDataGen
 
 from snitch.util.sim.verif_utils import Verifier
-from snitch.util.sim.data_utils import ctype_from_precision_t
 
 
 class GemmVerifier(Verifier):
@@ -20,20 +19,37 @@ class GemmVerifier(Verifier):
         1: 1e-4,
         2: 5e-1,
         4: 1e-3,
-        8: 1e-3
+        8: 1e-3,
+        # Integer GEMMs are exact
+        GemmDataGen.GEMM_INT | 1: 0,
+        GemmDataGen.GEMM_INT | 2: 0
     }
 
     def __init__(self):
         super().__init__()
         self.prec = self.get_input_from_symbol('prec', 'uint32_t')[0]
+        self.requant = self.get_input_from_symbol('requant', 'uint32_t')[0]
+        self.ctype, self.c_ctype = GemmDataGen().ctypes(self.prec, self.requant)
+        # If C is split into several tensors, through a tensor view, these
+        # are the outputs
+        self.split_outputs = self.get_input_from_symbol('split_outputs', 'uint32_t')[0]
+        if self.split_outputs:
+            self.OUTPUT_UIDS = [f'c_{i}' for i in range(self.split_outputs)]
 
     def get_actual_results(self):
-        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], ctype_from_precision_t(self.prec))
+        if self.split_outputs:
+            m = self.get_input_from_symbol('m', 'uint32_t')[0]
+            parts = [self.get_output_from_symbol(uid, self.c_ctype).reshape(m, -1)
+                     for uid in self.OUTPUT_UIDS]
+            c = np.concatenate(parts, axis=1).flatten()
+        else:
+            c = self.get_output_from_symbol(self.OUTPUT_UIDS[0], self.c_ctype)
+        return c.astype(np.int64) if self.prec & GemmDataGen.GEMM_INT else c
 
     def get_expected_results(self):
-        a = self.get_input_from_symbol('a', ctype_from_precision_t(self.prec))
-        b = self.get_input_from_symbol('b', ctype_from_precision_t(self.prec))
-        c = self.get_input_from_symbol('c', ctype_from_precision_t(self.prec))
+        a = self.get_input_from_symbol('a', self.ctype)
+        b = self.get_input_from_symbol('b', self.ctype)
+        c = self.get_input_from_symbol('c', self.c_ctype)
         m = self.get_input_from_symbol('m', 'uint32_t')[0]
         n = self.get_input_from_symbol('n', 'uint32_t')[0]
         k = self.get_input_from_symbol('k', 'uint32_t')[0]
@@ -48,6 +64,16 @@ class GemmVerifier(Verifier):
             b = np.reshape(b, (k, n))
         c = np.reshape(c, (m, n))
 
+        if self.prec & GemmDataGen.GEMM_INT:
+            result = beta * c.astype(np.int64) + a.astype(np.int64) @ b
+            if self.requant:
+                datagen = GemmDataGen()
+                mul = self.get_input_from_symbol('requant_mul', 'int32_t')
+                add = self.get_input_from_symbol('requant_add', 'int32_t')
+                shift = self.get_input_from_symbol('requant_shift', 'uint32_t')[0]
+                result = datagen.requantize(result, mul, add, shift,
+                                            self.prec & ~GemmDataGen.GEMM_INT)
+            return result.flatten()
         return GemmDataGen().exact_golden_model(1, a, b, beta, c).flatten()
 
     def check_results(self, *args):
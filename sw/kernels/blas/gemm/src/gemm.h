@@ -20,6 +20,7 @@
 #include "gemm_fp32.h"
 #include "gemm_fp64.h"
 #include "gemm_fp8.h"
+#include "gemm_int.h"
 
 /**
  * @brief Executes one GEMM tile on one Snitch cluster (single-cluster,
@@ -47,8 +48,10 @@ void sc_st_gemm(gemm_fp_t kernel, sc_st_gemm_args_t *args) {
         uint32_t ldc = core_num * args->ldc;
 
         // Compute cores access A and C at offsets of one row from each other
-        uint32_t offset_a = core_idx * args->lda * args->prec;
-        uint32_t offset_c = core_idx * args->ldc * args->prec;
+        uint32_t offset_a =
+            core_idx * args->lda * gemm_operand_size(args->prec);
+        uint32_t offset_c =
+            core_idx * args->ldc * gemm_accumulator_size(args->prec);
         void *a = (void *)((uintptr_t)(args->a) + offset_a);
         void *c = (void *)((uintptr_t)(args->c) + offset_c);
 
@@ -160,6 +163,37 @@ static inline uint32_t calculate_partitioned_banks_stride(
     return (lines_per_row * SNRT_TCDM_HYPERBANK_WIDTH) / prec;
 }
 
+// Maps the index of a tile among the lower-triangular tiles of a cluster to
+// its row and column tile indices. The rows of the cluster are `first`,
+// `first + stride`, ... and all tiles of a row are visited before the next.
+static inline void gemm_lower_tile_idx(int mn, uint32_t first, uint32_t stride,
+                                       int *m, int *n) {
+    uint32_t row = first;
+    if (mn < 0) mn = 0;
+    while ((uint32_t)mn > row) {
+        mn -= row + 1;
+        row += stride;
+    }
+    *m = row;
+    *n = mn;
+}
+
+/**
+ * @brief Requantize an int32 tile of C in TCDM, whose rows are distributed
+ *        across the compute cores.
+ * @details Requantized rows are packed at the start of the int32 rows.
+ */
+static inline void gemm_requantize_tile(int32_t *c, uint32_t tile_m,
+                                        uint32_t tile_n, const int32_t *mul,
+                                        const int32_t *add, uint32_t shift,
+                                        uint32_t ab_size) {
+    uint32_t core_num = snrt_cluster_compute_core_num();
+    for (uint32_t r = snrt_cluster_core_idx(); r < tile_m; r += core_num) {
+        gemm_requantize(ab_size, 1, tile_n, c + r * tile_n, tile_n, mul, add,
+                        shift);
+    }
+}
+
 /**
  * @brief Performs a General Matrix Multiplication (GEMM) operation on a
  *        Snitch-based multiple-cluster architecture with support for
@@ -199,13 +233,34 @@ static inline int gemm(const gemm_args_t *args) {
     const gemm_args_t *largs = args;
 #endif
 
+    // Calculate element sizes of the A and B operands, and of the C
+    // accumulators, which differ for integer GEMMs
+    uint32_t ab_size = gemm_operand_size(largs->prec);
+    uint32_t c_size = gemm_accumulator_size(largs->prec);
+
+    // Load the per-column requantization parameters to TCDM
+    int32_t *requant_mul = NULL;
+    int32_t *requant_add = NULL;
+    if (largs->requant_mul) {
+        uint32_t requant_size = largs->n * sizeof(int32_t);
+        requant_mul = (int32_t *)snrt_l1_alloc_cluster_local(
+            requant_size, alignof(int32_t));
+        requant_add = (int32_t *)snrt_l1_alloc_cluster_local(
+            requant_size, alignof(int32_t));
+        if (snrt_is_dm_core()) {
+            snrt_dma_start_1d(requant_mul, largs->requant_mul, requant_size);
+            snrt_dma_start_1d(requant_add, largs->requant_add, requant_size);
+            snrt_dma_wait_all();
+        }
+    }
+
     // Calculate tile sizes
     uint32_t tile_m = largs->m / largs->m_tiles;
     uint32_t tile_n = largs->n / largs->n_tiles;
     uint32_t tile_k = largs->k / largs->k_tiles;
-    uint32_t tile_a_size = tile_m * tile_k * largs->prec;
-    uint32_t tile_b_size = tile_k * tile_n * largs->prec;
-    uint32_t tile_c_size = tile_m * tile_n * largs->prec;
+    uint32_t tile_a_size = tile_m * tile_k * ab_size;
+    uint32_t tile_b_size = tile_k * tile_n * ab_size;
+    uint32_t tile_c_size = tile_m * tile_n * c_size;
 
     // Allocate space for local tile buffers in TCDM, unless preloaded
     void *a0, *a1, *b0, *b1, *c0, *c1;
@@ -227,7 +282,8 @@ static inline int gemm(const gemm_args_t *args) {
     uint32_t cluster_m_tiles = largs->m_tiles;
     uint32_t cluster_k_tiles = largs->k_tiles;
     uint32_t num_working_clusters = snrt_cluster_num();
-    if (largs->parallelize_m) cluster_m_tiles /= snrt_cluster_num();
+    if (largs->parallelize_m && !largs->lower)
+        cluster_m_tiles /= snrt_cluster_num();
     if (largs->parallelize_k) {
         uint32_t k_tiles_quotient = cluster_k_tiles / snrt_cluster_num();
         uint32_t k_tiles_remainder = cluster_k_tiles % snrt_cluster_num();
@@ -240,6 +296,20 @@ static inline int gemm(const gemm_args_t *args) {
 
     // Calculate number of iterations
     uint32_t num_tiles = cluster_m_tiles * largs->n_tiles * cluster_k_tiles;
+
+    // With a triangular output, every cluster visits the tiles of its rows up
+    // to the diagonal
+    uint32_t lower_first = 0;
+    uint32_t lower_stride = 1;
+    if (largs->lower) {
+        if (largs->parallelize_m) {
+            lower_first = snrt_cluster_idx();
+            lower_stride = snrt_cluster_num();
+        }
+        num_tiles = 0;
+        for (uint32_t m = lower_first; m < largs->m_tiles; m += lower_stride)
+            num_tiles += (m + 1) * cluster_k_tiles;
+    }
     uint32_t num_iters = num_tiles;
     if (largs->double_buffer)
         num_iters += 2;
@@ -283,6 +353,14 @@ static inline int gemm(const gemm_args_t *args) {
             comp_k_abs += snrt_cluster_idx() * cluster_k_tiles;
             dma_out_k_abs += snrt_cluster_idx() * cluster_k_tiles;
         }
+        if (largs->lower) {
+            gemm_lower_tile_idx(dma_in_mn, lower_first, lower_stride,
+                                &dma_in_m_abs, &dma_in_n);
+            gemm_lower_tile_idx(comp_mn, lower_first, lower_stride,
+                                &comp_m_abs, &comp_n);
+            gemm_lower_tile_idx(dma_out_mn, lower_first, lower_stride,
+                                &dma_out_m_abs, &dma_out_n);
+        }
 
         // DMA out phase
         if (snrt_is_dm_core()) {
@@ -293,7 +371,18 @@ static inline int gemm(const gemm_args_t *args) {
                 // Store C
                 // If parallelize_k, then only cluster 0 must writeback
                 if ((snrt_cluster_idx() == 0) || !(largs->parallelize_k)) {
-                    if (largs->partition_banks) {
+                    if (largs->c_view) {
+                        snrt_dma_store_2d_tile_view(
+                            largs->c_view, lc[buff_idx], dma_out_m_abs,
+                            dma_out_n, tile_m, tile_n, c_size);
+                    } else if (largs->requant_mul) {
+                        // Requantized rows are packed at the start of the
+                        // int32 rows of the tile
+                        snrt_dma_store_2d_tile(
+                            largs->c, lc[buff_idx], dma_out_m_abs, dma_out_n,
+                            tile_m, tile_n, largs->ldc, ab_size,
+                            tile_n * c_size);
+                    } else if (largs->partition_banks) {
                         snrt_dma_2d_to_1d(
                             (void *)((uintptr_t)largs->c +
                                      dma_out_m_abs * tile_c_size),
@@ -303,7 +392,7 @@ static inline int gemm(const gemm_args_t *args) {
                     } else {
                         snrt_dma_store_2d_tile(largs->c, lc[buff_idx],
                                                dma_out_m_abs, dma_out_n, tile_m,
-                                               tile_n, largs->ldc, largs->prec);
+                                               tile_n, largs->ldc, c_size);
                     }
                     snrt_dma_wait_all();
                 }
@@ -322,7 +411,11 @@ static inline int gemm(const gemm_args_t *args) {
 
                 // Load A
                 if (largs->load_a) {
-                    if (largs->partition_banks) {
+                    if (largs->a_view) {
+                        snrt_dma_load_2d_tile_view(
+                            la[buff_idx], largs->a_view, dma_in_m_abs,
+                            dma_in_k_abs, tile_m, tile_k, ab_size);
+                    } else if (largs->partition_banks) {
                         snrt_dma_1d_to_2d(
                             la[buff_idx],
                             (void *)((uintptr_t)largs->a +
@@ -333,7 +426,7 @@ static inline int gemm(const gemm_args_t *args) {
                     } else {
                         snrt_dma_load_2d_tile(
                             la[buff_idx], largs->a, dma_in_m_abs, dma_in_k_abs,
-                            tile_m, tile_k, largs->lda, largs->prec);
+                            tile_m, tile_k, largs->lda, ab_size);
                     }
                 }
 
@@ -342,7 +435,7 @@ static inline int gemm(const gemm_args_t *args) {
                     if (largs->transb) {
                         snrt_dma_load_2d_tile(lb[buff_idx], largs->b, dma_in_n,
                                               dma_in_k_abs, tile_n, tile_k,
-                                              largs->ldb, largs->prec);
+                                              largs->ldb, ab_size);
                     } else {
                         if (largs->partition_banks) {
                             snrt_dma_1d_to_2d(
@@ -355,7 +448,7 @@ static inline int gemm(const gemm_args_t *args) {
                         } else {
                             snrt_dma_load_2d_tile(
                                 lb[buff_idx], largs->b, dma_in_k_abs, dma_in_n,
-                                tile_k, tile_n, largs->ldb, largs->prec);
+                                tile_k, tile_n, largs->ldb, ab_size);
                         }
                     }
                 }
@@ -363,10 +456,15 @@ static inline int gemm(const gemm_args_t *args) {
                 // Load C
                 // C tile is loaded only upon the first k iteration, then
                 // the C array will contain the partial results from the
-                // previous iteration
-                if (largs->load_c) {
+                // previous iteration. Requantized C matrices are never
+                // accumulated upon.
+                if (largs->load_c && !largs->requant_mul) {
                     if (dma_in_k_abs == 0) {
-                        if (largs->partition_banks) {
+                        if (largs->c_view) {
+                            snrt_dma_load_2d_tile_view(
+                                lc[c_buff_idx], largs->c_view, dma_in_m_abs,
+                                dma_in_n, tile_m, tile_n, c_size);
+                        } else if (largs->partition_banks) {
                             snrt_dma_1d_to_2d(
                                 lc[c_buff_idx],
                                 (void *)((uintptr_t)largs->c +
@@ -378,7 +476,7 @@ static inline int gemm(const gemm_args_t *args) {
                             snrt_dma_load_2d_tile(lc[c_buff_idx], largs->c,
                                                   dma_in_m_abs, dma_in_n,
                                                   tile_m, tile_n, largs->ldc,
-                                                  largs->prec);
+                                                  c_size);
                         }
                     } else if (dma_in_k == 0) {
                         // Clusters other than the first need to initialize
@@ -457,6 +555,17 @@ static inline int gemm(const gemm_args_t *args) {
                 sc_st_args.k = tile_k;
                 sc_st_gemm(largs->gemm_fp, &sc_st_args);
 
+                // Requantize the rows computed by this core, once fully
+                // accumulated. Partial results of a parallelized K loop are
+                // only requantized after the reduction.
+                if (largs->requant_mul && !largs->parallelize_k &&
+                    comp_k == (cluster_k_tiles - 1)) {
+                    gemm_requantize_tile((int32_t *)lc[c_buff_idx], tile_m,
+                                         tile_n, requant_mul + comp_n * tile_n,
+                                         requant_add + comp_n * tile_n,
+                                         largs->requant_shift, ab_size);
+                }
+
                 // uint32_t end_cycle = snrt_mcycle();
             }
 
@@ -480,6 +589,22 @@ static inline int gemm(const gemm_args_t *args) {
                             (__fp16 *)lcr, (__fp16 *)lc[c_buff_idx],
                             tile_m * tile_n, comm);
                         break;
+                    case INT8:
+                    case INT16:
+                        snrt_global_reduction_dma<int32_t>(
+                            (int32_t *)lcr, (int32_t *)lc[c_buff_idx],
+                            tile_m * tile_n, comm);
+                        break;
+                }
+
+                // Requantize the fully reduced tile in cluster 0, which
+                // writes it back
+                if (largs->requant_mul && snrt_cluster_idx() == 0 &&
+                    snrt_is_compute_core()) {
+                    gemm_requantize_tile((int32_t *)lc[c_buff_idx], tile_m,
+                                         tile_n, requant_mul + comp_n * tile_n,
+                                         requant_add + comp_n * tile_n,
+                                         largs->requant_shift, ab_size);
                 }
             }
         }
@@ -0,0 +1,222 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "gemm.h"
+#include "snrt.h"
+
+/**
+ * @struct gemm_batched_args_t
+ * @brief Structure to hold arguments for a batched GEMM operation,
+ *        C[b] = A[b] B[b] + beta C[b] for b in [0, batch), on Snitch-based
+ *        multiple-cluster architectures.
+ *
+ * Covers tensor contractions which reduce to many small GEMMs, e.g. the
+ * DOITGEN kernel, the attention heads of a transformer layer or grouped
+ * linear layers. All matrices of a batch must fit in TCDM together.
+ *
+ * @var gemm_batched_args_t::batch
+ * Number of GEMMs in the batch.
+ *
+ * @var gemm_batched_args_t::stride_a
+ * Distance between the A matrices of consecutive GEMMs, in elements.
+ *
+ * @var gemm_batched_args_t::stride_b
+ * Distance between the B matrices of consecutive GEMMs, in elements. If
+ * zero, all GEMMs share the same B matrix, which is loaded only once per
+ * cluster.
+ *
+ * @var gemm_batched_args_t::stride_c
+ * Distance between the C matrices of consecutive GEMMs, in elements. C may
+ * alias A, if every C matrix is no larger than the respective A matrix.
+ *
+ * @var gemm_batched_args_t::multicast
+ * If set, a shared B matrix is multicast by the first cluster to all
+ * clusters, among the first power-of-two clusters.
+ *
+ * @note Refer to `gemm_args_t` for a description of the other parameters.
+ *       `lda`, `ldb` and `ldc` are the leading dimensions of the matrices in
+ *       memory. In TCDM, the matrices are stored contiguously.
+ */
+typedef struct {
+    uint32_t batch;
+    uint32_t multicast;
+    gemm_fp_t gemm_fp;
+    uint32_t prec;
+    // BLAS args
+    uint32_t transb;
+    uint32_t m;
+    uint32_t n;
+    uint32_t k;
+    void *a;
+    uint32_t lda;
+    uint32_t stride_a;
+    void *b;
+    uint32_t ldb;
+    uint32_t stride_b;
+    uint32_t beta;
+    void *c;
+    uint32_t ldc;
+    uint32_t stride_c;
+} gemm_batched_args_t;
+
+// Start the DMA transfer of the B matrix of a GEMM in the batch to TCDM.
+static inline void gemm_batched_load_b(const gemm_batched_args_t *args,
+                                       void *lb, uint32_t b, snrt_comm_t comm) {
+    uint32_t ab_size = gemm_operand_size(args->prec);
+    void *src = (void *)((uintptr_t)args->b + b * args->stride_b * ab_size);
+    uint32_t rows = args->transb ? args->n : args->k;
+    uint32_t cols = args->transb ? args->k : args->n;
+    if (comm)
+        snrt_dma_load_2d_tile_mcast(lb, src, 0, 0, rows, cols, args->ldb,
+                                    ab_size, comm);
+    else
+        snrt_dma_load_2d_tile(lb, src, 0, 0, rows, cols, args->ldb, ab_size);
+}
+
+/**
+ * @brief Performs a batched GEMM on all clusters.
+ *
+ * @param args Pointer to a `gemm_batched_args_t` structure containing the
+ *             arguments of the batched GEMM.
+ *
+ * @details The GEMMs are distributed over the clusters in contiguous ranges,
+ *          and every cluster computes one GEMM at a time, with the
+ *          single-cluster `sc_st_gemm` and the kernel in `gemm_fp`. The
+ *          A and C matrices, and the B matrices unless shared, are double
+ *          buffered in TCDM, so that the matrices of the next GEMM are
+ *          loaded, and the results of the previous GEMM stored, while the
+ *          current GEMM is computed. A shared B matrix is loaded once, and
+ *          optionally multicast to all clusters. Must be invoked by all cores
+ *          in all clusters.
+ */
+static inline void gemm_batched(const gemm_batched_args_t *args) {
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t cluster_num = snrt_cluster_num();
+    uint32_t ab_size = gemm_operand_size(args->prec);
+    uint32_t c_size = gemm_accumulator_size(args->prec);
+    uint32_t m = args->m;
+    uint32_t n = args->n;
+    uint32_t k = args->k;
+    uint32_t shared_b = args->stride_b == 0;
+    void *l1_start = snrt_l1_next_v2();
+
+    // Distribute GEMMs to clusters
+    uint32_t first = cluster_idx * args->batch / cluster_num;
+    uint32_t num = (cluster_idx + 1) * args->batch / cluster_num - first;
+
+    // Multicast communicators must span a power-of-two number of clusters.
+    // The communicator is created by all clusters, to keep their allocators
+    // aligned, which also places the shared B at the same offset in every
+    // cluster's TCDM.
+    snrt_comm_t comm = NULL;
+    uint32_t num_mcast = cluster_num;
+    while (num_mcast & (num_mcast - 1)) num_mcast &= num_mcast - 1;
+    if (shared_b && args->multicast && num_mcast > 1)
+        snrt_comm_create(num_mcast, &comm);
+    uint32_t in_comm = comm && cluster_idx < num_mcast;
+
+    // Allocate space for the matrices in TCDM
+    void *la[2], *lb[2], *lc[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        la[i] = snrt_l1_alloc_cluster_local(m * k * ab_size, sizeof(double));
+        lc[i] = snrt_l1_alloc_cluster_local(m * n * c_size, sizeof(double));
+        if (i == 0 || !shared_b)
+            lb[i] =
+                snrt_l1_alloc_cluster_local(k * n * ab_size, sizeof(double));
+        else
+            lb[i] = lb[0];
+    }
+
+    // Load the shared B matrix
+    if (shared_b) {
+        if (snrt_is_dm_core() && (!in_comm || cluster_idx == 0)) {
+            gemm_batched_load_b(args, lb[0], 0, in_comm ? comm : NULL);
+            snrt_dma_wait_all();
+        }
+        if (in_comm) snrt_global_barrier(comm);
+    }
+
+    // Single-cluster GEMM arguments, which are the same for all GEMMs but
+    // the operand addresses
+    sc_st_gemm_args_t sc_st_args;
+    sc_st_args.prec = args->prec;
+    sc_st_args.setup_ssr = 1;
+    sc_st_args.partition_banks = 0;
+    sc_st_args.transa = 0;
+    sc_st_args.transb = args->transb;
+    sc_st_args.m = m;
+    sc_st_args.n = n;
+    sc_st_args.k = k;
+    sc_st_args.alpha = 1;
+    sc_st_args.lda = k;
+    sc_st_args.ldb = args->transb ? k : n;
+    sc_st_args.beta = args->beta;
+    sc_st_args.ldc = n;
+
+    // Iterate over the GEMMs of the cluster, in a three-stage pipeline
+    snrt_cluster_hw_barrier();
+    for (uint32_t i = 0; i < num + 2; i++) {
+        int dma_in_i = i;
+        int comp_i = i - 1;
+        int dma_out_i = i - 2;
+
+        if (snrt_is_dm_core()) {
+            snrt_mcycle();
+
+            // Store C
+            if (dma_out_i >= 0) {
+                uint32_t b = first + dma_out_i;
+                void *dst =
+                    (void *)((uintptr_t)args->c + b * args->stride_c * c_size);
+                snrt_dma_store_2d_tile(dst, lc[dma_out_i % 2], 0, 0, m, n,
+                                       args->ldc, c_size);
+                snrt_dma_wait_all();
+            }
+
+            // Load A, B and C
+            if (dma_in_i < (int)num) {
+                uint32_t b = first + dma_in_i;
+                void *src =
+                    (void *)((uintptr_t)args->a + b * args->stride_a * ab_size);
+                snrt_dma_load_2d_tile(la[dma_in_i % 2], src, 0, 0, m, k,
+                                      args->lda, ab_size);
+                if (!shared_b)
+                    gemm_batched_load_b(args, lb[dma_in_i % 2], b, NULL);
+                if (args->beta) {
+                    src = (void *)((uintptr_t)args->c +
+                                   b * args->stride_c * c_size);
+                    snrt_dma_load_2d_tile(lc[dma_in_i % 2], src, 0, 0, m, n,
+                                          args->ldc, c_size);
+                }
+                snrt_dma_wait_all();
+            }
+
+            snrt_mcycle();
+        }
+
+        // Compute
+        if (comp_i >= 0 && comp_i < (int)num && snrt_is_compute_core()) {
+            snrt_mcycle();
+
+            sc_st_args.a = la[comp_i % 2];
+            sc_st_args.b = lb[comp_i % 2];
+            sc_st_args.c = lc[comp_i % 2];
+            sc_st_gemm(args->gemm_fp, &sc_st_args);
+
+            // The SSRs only need to be configured for the first GEMM
+            sc_st_args.setup_ssr = 0;
+
+            snrt_mcycle();
+        }
+
+        snrt_cluster_hw_barrier();
+    }
+
+    // Free memory
+    snrt_l1_update_next_v2(l1_start);
+}
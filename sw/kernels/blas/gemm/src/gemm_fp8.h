@@ -156,6 +156,7 @@ void gemm_fp8_opt_ex(uint32_t setup_ssr, uint32_t partition_banks,
 
     // Kernel progresses by 8 values each step
     const uint32_t n_frep = K / 8 - 1;
+    snrt_mcycle();
 
     for (uint32_t m = 0; m < M; m++) {
         uint32_t n = 0;
@@ -304,6 +305,8 @@ void gemm_fp8_opt_ex(uint32_t setup_ssr, uint32_t partition_banks,
 
         // snrt_ssr_enable();
     }
+    snrt_fpu_fence();
+    snrt_mcycle();
 
     snrt_ssr_disable();
 #endif
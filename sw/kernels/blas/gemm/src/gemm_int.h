@@ -0,0 +1,149 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Integer GEMM kernels, computing C = A * B (+ C if beta != 0) on int8 or
+// int16 A and B matrices with int32 accumulation. C is always int32, and
+// can be requantized to the precision of A and B by `gemm_requantize`.
+//
+// The `opt` kernels use the packed-SIMD dot-product instructions of the Xpulp
+// extensions, which are not fed by the SSRs, so `setup_ssr` and
+// `partition_banks` are ignored. They require `transb`, so that both A and B
+// are contiguous along K, K to fill a multiple of 32-bit words and N to be a
+// multiple of 4.
+
+#define GEMM_INT_DEFINE_NAIVE(name, type)                                     \
+    void name(uint32_t setup_ssr, uint32_t partition_banks, uint32_t transa,  \
+              uint32_t transb, uint32_t M, uint32_t N, uint32_t K, void* A_p, \
+              uint32_t lda, void* B_p, uint32_t ldb, uint32_t beta,           \
+              void* C_p, uint32_t ldc) {                                      \
+        type* A = (type*)A_p;                                                 \
+        type* B = (type*)B_p;                                                 \
+        int32_t* C = (int32_t*)C_p;                                           \
+                                                                              \
+        for (uint32_t m = 0; m < M; m++) {                                    \
+            for (uint32_t n = 0; n < N; n++) {                                \
+                int32_t c0 = beta ? C[m * ldc + n] : 0;                       \
+                for (uint32_t k = 0; k < K; k++) {                            \
+                    int32_t a = transa ? A[k * lda + m] : A[m * lda + k];     \
+                    int32_t b = transb ? B[n * ldb + k] : B[k * ldb + n];     \
+                    c0 += a * b;                                              \
+                }                                                             \
+                C[m * ldc + n] = c0;                                          \
+            }                                                                 \
+        }                                                                     \
+    }
+
+GEMM_INT_DEFINE_NAIVE(gemm_i8_naive, int8_t)
+GEMM_INT_DEFINE_NAIVE(gemm_i16_naive, int16_t)
+
+// Accumulate the dot product of two 32-bit words of packed signed integers
+static inline int32_t gemm_sdotsp_b(int32_t acc, uint32_t a, uint32_t b) {
+#ifdef SNRT_SUPPORTS_PULP
+    asm("pv.sdotsp.b %[acc], %[a], %[b]" : [ acc ] "+r"(acc)
+        : [ a ] "r"(a), [ b ] "r"(b));
+    return acc;
+#else
+    for (uint32_t i = 0; i < 4; i++)
+        acc += (int8_t)(a >> (8 * i)) * (int8_t)(b >> (8 * i));
+    return acc;
+#endif
+}
+
+static inline int32_t gemm_sdotsp_h(int32_t acc, uint32_t a, uint32_t b) {
+#ifdef SNRT_SUPPORTS_PULP
+    asm("pv.sdotsp.h %[acc], %[a], %[b]" : [ acc ] "+r"(acc)
+        : [ a ] "r"(a), [ b ] "r"(b));
+    return acc;
+#else
+    for (uint32_t i = 0; i < 2; i++)
+        acc += (int16_t)(a >> (16 * i)) * (int16_t)(b >> (16 * i));
+    return acc;
+#endif
+}
+
+// Every iteration computes four consecutive elements in a row of C, reusing
+// every word of A for four dot-product instructions
+#define GEMM_INT_DEFINE_OPT(name, type, sdotsp)                               \
+    void name(uint32_t setup_ssr, uint32_t partition_banks, uint32_t transa,  \
+              uint32_t transb, uint32_t M, uint32_t N, uint32_t K, void* A_p, \
+              uint32_t lda, void* B_p, uint32_t ldb, uint32_t beta,           \
+              void* C_p, uint32_t ldc) {                                      \
+        const uint32_t elems = sizeof(uint32_t) / sizeof(type);               \
+        int32_t* C = (int32_t*)C_p;                                           \
+        snrt_mcycle();                                                        \
+                                                                              \
+        for (uint32_t m = 0; m < M; m++) {                                    \
+            const uint32_t* a = (const uint32_t*)((type*)A_p + m * lda);      \
+            int32_t* c = C + m * ldc;                                         \
+            for (uint32_t n = 0; n < N; n += 4) {                             \
+                const uint32_t* b0 = (const uint32_t*)((type*)B_p + n * ldb); \
+                const uint32_t* b1 = b0 + ldb / elems;                        \
+                const uint32_t* b2 = b1 + ldb / elems;                        \
+                const uint32_t* b3 = b2 + ldb / elems;                        \
+                int32_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;                       \
+                if (beta) {                                                   \
+                    c0 = c[n + 0];                                            \
+                    c1 = c[n + 1];                                            \
+                    c2 = c[n + 2];                                            \
+                    c3 = c[n + 3];                                            \
+                }                                                             \
+                for (uint32_t k = 0; k < K / elems; k++) {                    \
+                    uint32_t ak = a[k];                                       \
+                    c0 = sdotsp(c0, ak, b0[k]);                               \
+                    c1 = sdotsp(c1, ak, b1[k]);                               \
+                    c2 = sdotsp(c2, ak, b2[k]);                               \
+                    c3 = sdotsp(c3, ak, b3[k]);                               \
+                }                                                             \
+                c[n + 0] = c0;                                                \
+                c[n + 1] = c1;                                                \
+                c[n + 2] = c2;                                                \
+                c[n + 3] = c3;                                                \
+            }                                                                 \
+        }                                                                     \
+        snrt_mcycle();                                                        \
+    }
+
+GEMM_INT_DEFINE_OPT(gemm_i8_opt, int8_t, gemm_sdotsp_b)
+GEMM_INT_DEFINE_OPT(gemm_i16_opt, int16_t, gemm_sdotsp_h)
+
+/**
+ * @brief Requantize rows of an int32 matrix, in place, to int8 or int16.
+ *
+ * @param prec Size in bytes of the requantized elements.
+ * @param M Number of rows.
+ * @param N Number of columns.
+ * @param C Pointer to the matrix. Requantized rows are packed at the start of
+ *          the respective int32 rows.
+ * @param ldc Leading dimension of the int32 matrix.
+ * @param mul Per-column integer scale factors.
+ * @param add Per-column offsets, e.g. a rounding term and the zero point
+ *            scaled by 2^shift.
+ * @param shift Right shift applied after scaling and offsetting.
+ *
+ * @details Every element is computed as
+ *          clip((c * mul[n] + add[n]) >> shift), where the product is
+ *          evaluated in 64 bits to avoid overflows, and the result is
+ *          saturated to the range of the requantized type. Elements are
+ *          processed in order, so every int32 element is read before it is
+ *          overwritten.
+ */
+static inline void gemm_requantize(uint32_t prec, uint32_t M, uint32_t N,
+                                   int32_t* C, uint32_t ldc,
+                                   const int32_t* mul, const int32_t* add,
+                                   uint32_t shift) {
+    const int32_t max = (1 << (8 * prec - 1)) - 1;
+    const int32_t min = -max - 1;
+
+    for (uint32_t m = 0; m < M; m++) {
+        int32_t* c = C + m * ldc;
+        for (uint32_t n = 0; n < N; n++) {
+            int32_t q = (int32_t)(((int64_t)c[n] * mul[n] + add[n]) >> shift);
+            q = q > max ? max : (q < min ? min : q);
+            if (prec == sizeof(int8_t))
+                ((int8_t*)c)[n] = q;
+            else
+                ((int16_t*)c)[n] = q;
+        }
+    }
+}
@@ -13,6 +13,27 @@ typedef void (*gemm_fp_t)(uint32_t setup_ssr, uint32_t partition_banks,
                           void* B_p, uint32_t ldb, uint32_t beta, void* C_p,
                           uint32_t ldc);
 
+// Flags integer precisions in the `prec` field of the GEMM arguments
+#define GEMM_INT 0x10
+
+/**
+ * @brief Integer precisions of the GEMM operands, with int32 accumulation.
+ * @details The lower bits encode the size in bytes of the A and B elements,
+ *          as in `precision_t`. C elements are int32, or have the size of the
+ *          A and B elements when requantized.
+ */
+typedef enum { INT8 = GEMM_INT | 1, INT16 = GEMM_INT | 2 } gemm_int_prec_t;
+
+// Size in bytes of the elements of the A and B matrices
+static inline uint32_t gemm_operand_size(uint32_t prec) {
+    return prec & ~GEMM_INT;
+}
+
+// Size in bytes of the elements of the C matrix, as accumulated in TCDM
+static inline uint32_t gemm_accumulator_size(uint32_t prec) {
+    return (prec & GEMM_INT) ? sizeof(int32_t) : prec;
+}
+
 /**
  * @struct gemm_args_t
  * @brief Structure to hold arguments for a GEMM operation on Snitch-based
@@ -76,6 +97,36 @@ typedef void (*gemm_fp_t)(uint32_t setup_ssr, uint32_t partition_banks,
  * @var gemm_args_t::partition_banks
  * Flag indicating whether to partition the banks, assigning a unique subset
  * of banks to each buffer.
+ *
+ * @var gemm_args_t::a_view
+ * Optional tensor view from which tiles of the A matrix are loaded, in place
+ * of the `a` array, e.g. to fuse a preceding concatenation. Not supported
+ * together with `partition_banks`.
+ *
+ * @var gemm_args_t::c_view
+ * Optional tensor view to which tiles of the C matrix are loaded from and
+ * stored to, in place of the `c` array, e.g. to fuse a succeeding split.
+ * Not supported together with `partition_banks`.
+ *
+ * @var gemm_args_t::requant_mul
+ * Optional per-column scale factors of integer GEMMs. If set, the int32
+ * results are requantized to the precision of A and B with
+ * `gemm_requantize`, before being stored to the C matrix. Requires `beta`
+ * to be zero, and is not supported together with `parallelize_k` and
+ * `partition_banks`.
+ *
+ * @var gemm_args_t::requant_add
+ * Per-column offsets of the requantization, e.g. to add a zero point.
+ *
+ * @var gemm_args_t::requant_shift
+ * Right shift of the requantization.
+ *
+ * @var gemm_args_t::lower
+ * Flag indicating whether to compute only the tiles of C on and below the
+ * diagonal, e.g. for symmetric products such as A A^T. Requires square
+ * tiles, i.e. `m == n` and `m_tiles == n_tiles`. When parallelizing M, the
+ * rows of tiles are assigned cyclically to the clusters, to balance the
+ * triangle.
  */
 typedef struct {
     uint32_t m_tiles;
@@ -105,6 +156,15 @@ typedef struct {
     uint32_t beta;
     void* c;
     uint32_t ldc;
+    // Tensor views
+    snrt_dma_view_t* a_view;
+    snrt_dma_view_t* c_view;
+    // Requantization
+    int32_t* requant_mul;
+    int32_t* requant_add;
+    uint32_t requant_shift;
+    // Triangular output
+    uint32_t lower;
 } gemm_args_t;
 
 /**
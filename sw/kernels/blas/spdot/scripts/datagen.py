@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+import snitch.util.sim.data_utils as du
+
+np.random.seed(42)
+
+
+class SpdotDataGen(du.DataGen):
+
+    # AXI splits bursts crossing 4KB address boundaries. To minimize
+    # the occurrence of these splits the data should be aligned to 4KB
+    BURST_ALIGNMENT = 4096
+    # Maximum length addressable by the 16-bit indices
+    MAX_LEN = 1 << 16
+
+    def golden_model(self, x, y):
+        return np.dot(x, y)
+
+    @staticmethod
+    def sparse_vector(n, density):
+        """Sorted indices and values of a random vector with the given fraction of nonzeros."""
+        idx = np.nonzero(np.random.rand(n) < density)[0]
+        return idx, np.random.uniform(-1, 1, len(idx))
+
+    @staticmethod
+    def densify(n, idx, val):
+        x = np.zeros(n)
+        x[idx] = val
+        return x
+
+    def validate(self, n, nnz_x, nnz_y, dense_y, **kwargs):
+        assert n <= self.MAX_LEN, f'n must not exceed {self.MAX_LEN}'
+        assert nnz_x > 0, 'x has no nonzeros'
+        assert dense_y or nnz_y > 0, 'y has no nonzeros'
+        # Operands and the dense scratch vector
+        ny = n if dense_y else nnz_y
+        du.validate_tcdm_footprint(nnz_x * 10 + nnz_y * 2 + ny * 8 + n * 8)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        kwargs.setdefault('baseline', False)
+        n, dense_y = kwargs['n'], kwargs['dense_y']
+
+        idx_x, val_x = self.sparse_vector(n, kwargs['density_x'])
+        if dense_y:
+            idx_y = np.array([], dtype=int)
+            val_y = np.random.uniform(-1, 1, n)
+            y = val_y
+        else:
+            idx_y, val_y = self.sparse_vector(n, kwargs['density_y'])
+            y = self.densify(n, idx_y, val_y)
+        self.validate(n, len(idx_x), len(idx_y), dense_y)
+        result = self.golden_model(self.densify(n, idx_x, val_x), y)
+
+        args = {
+            'n': n,
+            'nnz_x': len(idx_x),
+            'idx_x': 'idx_x',
+            'val_x': 'val_x',
+            'dense_y': dense_y,
+            'nnz_y': len(idx_y),
+            'idx_y': None if dense_y else 'idx_y',
+            'val_y': 'val_y',
+            'result': '&result',
+            'baseline': kwargs['baseline']
+        }
+
+        arrays = [('uint16_t', 'idx_x', idx_x), ('double', 'val_x', val_x)]
+        if not dense_y:
+            arrays += [('uint16_t', 'idx_y', idx_y)]
+        arrays += [('double', 'val_y', val_y)]
+
+        for ctype, uid, array in arrays:
+            header += [du.format_array_declaration(f'extern {ctype}', uid, array.shape,
+                                                   alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_scalar_declaration('double', 'result',
+                                                alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_struct_definition('spdot_args_t', 'args', args)]
+        for ctype, uid, array in arrays:
+            header += [du.format_array_definition(ctype, uid, array,
+                                                  alignment=self.BURST_ALIGNMENT)]
+        result_def = du.format_scalar_definition('double', 'g', result)
+        header += [du.format_ifdef_wrapper('BIST', result_def)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(SpdotDataGen().main())
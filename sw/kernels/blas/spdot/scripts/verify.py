@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import sys
+
+from datagen import SpdotDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+
+
+class SpdotVerifier(Verifier):
+
+    OUTPUT_UIDS = ['result']
+
+    def __init__(self):
+        super().__init__()
+        self.func_args = {
+            'n': 'I',
+            'nnz_x': 'I',
+            'idx_x': 'I',
+            'val_x': 'I',
+            'dense_y': 'I',
+            'nnz_y': 'I',
+            'idx_y': 'I',
+            'val_y': 'I',
+            'result': 'I',
+            'baseline': 'I'
+        }
+        self.func_args = self.get_input_from_symbol('args', self.func_args)
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], 'double')
+
+    def get_expected_results(self):
+        n = self.func_args['n']
+        idx_x = self.get_input_from_symbol('idx_x', 'uint16_t')
+        val_x = self.get_input_from_symbol('val_x', 'double')
+        x = SpdotDataGen.densify(n, idx_x, val_x)
+        y = self.get_input_from_symbol('val_y', 'double')
+        if not self.func_args['dense_y']:
+            idx_y = self.get_input_from_symbol('idx_y', 'uint16_t')
+            y = SpdotDataGen.densify(n, idx_y, y)
+        return SpdotDataGen().golden_model(x, y)
+
+    def check_results(self, *args):
+        return super().check_results(*args, atol=1e-10)
+
+
+if __name__ == "__main__":
+    sys.exit(SpdotVerifier().main())
@@ -0,0 +1,14 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#include "spdot.h"
+
+#include "data.h"
+
+int main() {
+    if (snrt_cluster_idx() == 0) spdot(&args);
+    return 0;
+}
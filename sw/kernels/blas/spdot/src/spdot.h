@@ -0,0 +1,278 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "snrt.h"
+
+/**
+ * @struct spdot_args_t
+ * @brief Arguments of the dot product of a sparse vector x with a sparse or
+ *        dense vector y.
+ *
+ * Sparse vectors are stored as sorted 16-bit indices and the respective
+ * values, thus their length must not exceed 65536.
+ *
+ * @var spdot_args_t::n
+ * Length of the vectors.
+ * @var spdot_args_t::dense_y
+ * If set, `val_y` holds all `n` entries of y and `idx_y` is ignored.
+ * @var spdot_args_t::baseline
+ * Use the scalar kernels instead of the SSR-based ones.
+ */
+typedef struct {
+    uint32_t n;
+    uint32_t nnz_x;
+    uint16_t *idx_x;
+    double *val_x;
+    uint32_t dense_y;
+    uint32_t nnz_y;
+    uint16_t *idx_y;
+    double *val_y;
+    double *result;
+    uint32_t baseline;
+} spdot_args_t;
+
+/**
+ * @brief Scalar dot product of a sparse vector x with a dense vector y.
+ */
+static inline double spdot_sd_naive(uint32_t nnz, const uint16_t *idx,
+                                    const double *val, const double *y) {
+    double acc = 0;
+    for (uint32_t i = 0; i < nnz; i++) acc += val[i] * y[idx[i]];
+    return acc;
+}
+
+/**
+ * @brief SSR dot product of a sparse vector x with a dense vector y.
+ *
+ * @details SSR 0 gathers the entries of y indirectly, through the indices of
+ *          x, while SSR 1 streams the values of x. Four accumulators hide the
+ *          latency of the FMA unit.
+ */
+static inline double spdot_sd_issr(uint32_t nnz, const uint16_t *idx,
+                                   const double *val, const double *y) {
+    if (!nnz) return 0;
+
+    snrt_issr_read(SNRT_SSR_DM0, (void *)y, (void *)idx, nnz,
+                   SNRT_SSR_IDXSIZE_U16);
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, nnz, sizeof(double));
+    snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, (void *)val);
+    snrt_ssr_enable();
+
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0;
+    if (nnz >= 4) {
+        asm volatile(
+            "frep.o %[n_frep], 4, 0, 0 \n"
+            "fmadd.d %[acc0], ft0, ft1, %[acc0] \n"
+            "fmadd.d %[acc1], ft0, ft1, %[acc1] \n"
+            "fmadd.d %[acc2], ft0, ft1, %[acc2] \n"
+            "fmadd.d %[acc3], ft0, ft1, %[acc3] \n"
+            : [ acc0 ] "+f"(acc0), [ acc1 ] "+f"(acc1), [ acc2 ] "+f"(acc2),
+              [ acc3 ] "+f"(acc3)
+            : [ n_frep ] "r"(nnz / 4 - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    }
+    if (nnz % 4) {
+        asm volatile(
+            "frep.o %[n_frep], 1, 0, 0 \n"
+            "fmadd.d %[acc0], ft0, ft1, %[acc0] \n"
+            : [ acc0 ] "+f"(acc0)
+            : [ n_frep ] "r"(nnz % 4 - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    }
+    asm volatile(
+        "fadd.d %[acc0], %[acc0], %[acc1] \n"
+        "fadd.d %[acc2], %[acc2], %[acc3] \n"
+        "fadd.d %[acc0], %[acc0], %[acc2] \n"
+        : [ acc0 ] "+f"(acc0), [ acc2 ] "+f"(acc2)
+        : [ acc1 ] "f"(acc1), [ acc3 ] "f"(acc3)
+        : "ft0", "ft1", "ft2");
+
+    snrt_ssr_disable();
+    snrt_fpu_fence();
+    return acc0;
+}
+
+/**
+ * @brief Scalar dot product of two sparse vectors, merging their indices.
+ */
+static inline double spdot_ss_naive(uint32_t nnz_x, const uint16_t *idx_x,
+                                    const double *val_x, uint32_t nnz_y,
+                                    const uint16_t *idx_y,
+                                    const double *val_y) {
+    double acc = 0;
+    uint32_t i = 0, j = 0;
+    while (i < nnz_x && j < nnz_y) {
+        if (idx_x[i] < idx_y[j])
+            i++;
+        else if (idx_x[i] > idx_y[j])
+            j++;
+        else
+            acc += val_x[i++] * val_y[j++];
+    }
+    return acc;
+}
+
+/**
+ * @brief Scatter the nonzeros of a sparse vector to a dense vector.
+ *
+ * @details SSR 0 streams the values, SSR 1 writes them indirectly through
+ *          the indices. If `val` is NULL, zeros are written instead, which
+ *          clears the nonzeros previously scattered to `dense`.
+ */
+static inline void spdot_scatter_issr(uint32_t nnz, const uint16_t *idx,
+                                      const double *val, double *dense) {
+    if (!nnz) return;
+
+    snrt_issr_write(SNRT_SSR_DM1, (void *)dense, (void *)idx, nnz,
+                    SNRT_SSR_IDXSIZE_U16);
+    if (val) {
+        snrt_ssr_loop_1d(SNRT_SSR_DM0, nnz, sizeof(double));
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, (void *)val);
+    }
+    snrt_ssr_enable();
+
+    if (val) {
+        asm volatile(
+            "frep.o %[n_frep], 1, 0, 0 \n"
+            "fmv.d ft1, ft0 \n"
+            :
+            : [ n_frep ] "r"(nnz - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    } else {
+        asm volatile(
+            "fcvt.d.w ft3, zero \n"
+            "frep.o %[n_frep], 1, 0, 0 \n"
+            "fmv.d ft1, ft3 \n"
+            :
+            : [ n_frep ] "r"(nnz - 1)
+            : "ft0", "ft1", "ft2", "ft3", "memory");
+    }
+
+    snrt_ssr_disable();
+    snrt_fpu_fence();
+}
+
+/**
+ * @brief Parallel dot product of a sparse vector x with a sparse or dense
+ *        vector y, computed by all cores in the cluster.
+ *
+ * @details A sparse y is first scattered to the zero-initialized dense
+ *          scratch vector `dense`, turning the index intersection into an
+ *          indirect gather of `dense` through the indices of x. After the
+ *          gather, the scattered nonzeros are cleared again, so that `dense`
+ *          is all zeros on return and can be reused without a full reset.
+ *          Both phases are partitioned among the compute cores by nonzeros.
+ *
+ *          The stream intersector could compute the intersection directly,
+ *          but its length is not known in advance, while the SSR kernels
+ *          rely on FREP loops of known length.
+ *
+ * @param dense Scratch vector of `n` zeros. Ignored if y is dense.
+ * @param partial Scratch array with one entry per compute core.
+ * @return The dot product, on compute core 0.
+ */
+static inline double spdot_cluster(spdot_args_t *args, uint16_t *idx_x,
+                                   double *val_x, uint16_t *idx_y,
+                                   double *val_y, double *dense,
+                                   double *partial) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t is_compute = snrt_is_compute_core();
+    uint32_t sparse = !args->dense_y && !args->baseline;
+    const double *y = args->dense_y ? val_y : dense;
+
+    // Slice of the nonzeros of y and x of the current core
+    uint32_t y0 = core_idx * args->nnz_y / ncores;
+    uint32_t y1 = (core_idx + 1) * args->nnz_y / ncores;
+    uint32_t x0 = core_idx * args->nnz_x / ncores;
+    uint32_t x1 = (core_idx + 1) * args->nnz_x / ncores;
+
+    if (sparse && is_compute)
+        spdot_scatter_issr(y1 - y0, idx_y + y0, val_y + y0, dense);
+    snrt_cluster_hw_barrier();
+
+    if (is_compute) {
+        double acc;
+        if (args->baseline && !args->dense_y) {
+            // Every core merges its slice of x with the matching range of y
+            uint32_t j0 = 0, j1 = args->nnz_y;
+            while (j0 < j1 && x0 < x1 && idx_y[j0] < idx_x[x0]) j0++;
+            acc = spdot_ss_naive(x1 - x0, idx_x + x0, val_x + x0, j1 - j0,
+                                 idx_y + j0, val_y + j0);
+        } else if (args->baseline) {
+            acc = spdot_sd_naive(x1 - x0, idx_x + x0, val_x + x0, y);
+        } else {
+            acc = spdot_sd_issr(x1 - x0, idx_x + x0, val_x + x0, y);
+        }
+        partial[core_idx] = acc;
+        snrt_fpu_fence();
+    }
+    snrt_cluster_hw_barrier();
+
+    if (sparse && is_compute)
+        spdot_scatter_issr(y1 - y0, idx_y + y0, NULL, dense);
+
+    double result = 0;
+    if (core_idx == 0) {
+        for (uint32_t i = 0; i < ncores; i++) result += partial[i];
+    }
+    snrt_cluster_hw_barrier();
+    return result;
+}
+
+/**
+ * @brief Dot product of a sparse vector with a sparse or dense vector.
+ *
+ * @details Loads the operands to TCDM, computes the dot product on all
+ *          cores of the calling cluster and stores it to `args->result`.
+ *          The TCDM allocations are released on return.
+ */
+static inline void spdot(spdot_args_t *args) {
+    void *l1_next = snrt_l1_next_v2();
+    uint32_t ny = args->dense_y ? args->n : args->nnz_y;
+
+    uint16_t *idx_x = (uint16_t *)snrt_l1_alloc_cluster_local(
+        args->nnz_x * sizeof(uint16_t), sizeof(double));
+    double *val_x = (double *)snrt_l1_alloc_cluster_local(
+        args->nnz_x * sizeof(double), sizeof(double));
+    uint16_t *idx_y = (uint16_t *)snrt_l1_alloc_cluster_local(
+        args->nnz_y * sizeof(uint16_t), sizeof(double));
+    double *val_y = (double *)snrt_l1_alloc_cluster_local(
+        ny * sizeof(double), sizeof(double));
+    double *dense = (double *)snrt_l1_alloc_cluster_local(
+        args->n * sizeof(double), sizeof(double));
+    double *partial = (double *)snrt_l1_alloc_cluster_local(
+        snrt_cluster_compute_core_num() * sizeof(double), sizeof(double));
+
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(idx_x, args->idx_x, args->nnz_x * sizeof(uint16_t));
+        snrt_dma_start_1d(val_x, args->val_x, args->nnz_x * sizeof(double));
+        if (!args->dense_y)
+            snrt_dma_start_1d(idx_y, args->idx_y,
+                              args->nnz_y * sizeof(uint16_t));
+        snrt_dma_start_1d(val_y, args->val_y, ny * sizeof(double));
+        snrt_dma_wait_all();
+    }
+
+    // Zero the scratch vector
+    if (snrt_is_compute_core()) {
+        uint32_t ncores = snrt_cluster_compute_core_num();
+        for (uint32_t i = snrt_cluster_core_idx(); i < args->n; i += ncores)
+            dense[i] = 0;
+    }
+    snrt_cluster_hw_barrier();
+
+    snrt_mcycle();
+    double result =
+        spdot_cluster(args, idx_x, val_x, idx_y, val_y, dense, partial);
+    snrt_mcycle();
+
+    if (snrt_cluster_core_idx() == 0) *args->result = result;
+
+    snrt_l1_update_next_v2(l1_next);
+}
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+import snitch.util.sim.data_utils as du
+
+np.random.seed(42)
+
+
+class SpmmDataGen(du.DataGen):
+
+    # AXI splits bursts crossing 4KB address boundaries. To minimize
+    # the occurrence of these splits the data should be aligned to 4KB
+    BURST_ALIGNMENT = 4096
+    FORMATS = ['CSR', 'CSC']
+    # Number of compute cores per cluster
+    NUM_CORES = 8
+    # Maximum dimension addressable by the 16-bit indices
+    MAX_DIM = 1 << 16
+
+    def golden_model(self, a, b):
+        return np.matmul(a, b)
+
+    @staticmethod
+    def sparse_matrix(M, K, density, distribution):
+        """Random matrix with the given fraction of nonzeros.
+
+        With the `powerlaw` distribution, the density of the i-th row (in a
+        random order) is proportional to 1 / (i + 1), producing the few long
+        and many short rows typical of graphs and unstructured meshes.
+        """
+        if distribution == 'uniform':
+            row_density = np.full(M, density)
+        elif distribution == 'powerlaw':
+            weights = 1 / np.arange(1, M + 1)
+            row_density = np.minimum(density * M * weights / weights.sum(), 1)
+            np.random.shuffle(row_density)
+        else:
+            raise ValueError(f'Unknown distribution {distribution}')
+        mask = np.random.rand(M, K) < row_density[:, np.newaxis]
+        return np.where(mask, np.random.uniform(-1, 1, (M, K)), 0)
+
+    @staticmethod
+    def compress(a, fmt):
+        """Pointers, indices and values of a matrix in CSR or CSC format."""
+        if fmt == 'CSC':
+            a = a.T
+        rows, cols = np.nonzero(a)
+        ptr = np.concatenate(([0], np.cumsum(np.count_nonzero(a, axis=1))))
+        return ptr, cols, a[rows, cols]
+
+    @staticmethod
+    def decompress(fmt, M, K, ptr, idx, val):
+        """Inverse of `compress`."""
+        outer = K if fmt == 'CSC' else M
+        a = np.zeros((outer, M if fmt == 'CSC' else K))
+        for i in range(outer):
+            a[i, idx[ptr[i]:ptr[i + 1]]] = val[ptr[i]:ptr[i + 1]]
+        return a.T if fmt == 'CSC' else a
+
+    def validate(self, format, M, N, K, ptr, panel_rows, panel_nnz, **kwargs):
+        assert format in self.FORMATS, f'format must be one of {self.FORMATS}'
+        assert M <= self.MAX_DIM and K <= self.MAX_DIM, \
+            f'M and K must not exceed {self.MAX_DIM}'
+        nnz = int(ptr[-1])
+        assert nnz > 0, 'The matrix has no nonzeros'
+        if format == 'CSR':
+            max_row = int(np.max(np.diff(ptr)))
+            assert max_row <= panel_nnz, \
+                f'panel_nnz must hold the longest row ({max_row} nonzeros)'
+            # B and two panel buffers
+            panel_size = (panel_rows + 1) * 4 + panel_nnz * 10 + panel_rows * N * 8
+            du.validate_tcdm_footprint(K * N * 8 + 2 * panel_size)
+        else:
+            assert (M * N) % self.NUM_CORES == 0, \
+                f'M * N must be a multiple of {self.NUM_CORES}'
+            # A single cluster holds all of A and B, plus one copy of C per
+            # core and two for the reduction
+            du.validate_tcdm_footprint((K + 1) * 4 + nnz * 10 + K * N * 8 +
+                                       (self.NUM_CORES + 2) * M * N * 8)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        kwargs.setdefault('distribution', 'uniform')
+        kwargs.setdefault('baseline', False)
+        fmt, M, N, K = kwargs['format'], kwargs['M'], kwargs['N'], kwargs['K']
+
+        a = self.sparse_matrix(M, K, kwargs['density'], kwargs['distribution'])
+        b = np.random.uniform(-1, 1, (K, N))
+        ptr, idx, val = self.compress(a, fmt)
+        self.validate(ptr=ptr, **kwargs)
+
+        ptr_uid = 'ptr'
+        idx_uid = 'idx'
+        val_uid = 'val'
+        b_uid = 'b'
+        c_uid = 'c'
+
+        args = {
+            'format': f'SPMM_{fmt}',
+            'M': M,
+            'N': N,
+            'K': K,
+            'nnz': len(val),
+            'ptr': ptr_uid,
+            'idx': idx_uid,
+            'val': val_uid,
+            'B': b_uid,
+            'C': c_uid,
+            'panel_rows': kwargs['panel_rows'],
+            'panel_nnz': kwargs['panel_nnz'],
+            'baseline': kwargs['baseline']
+        }
+
+        # B is stored in column-major order
+        b = b.T.flatten()
+
+        header += [du.format_array_declaration('extern uint32_t', ptr_uid, ptr.shape,
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('extern uint16_t', idx_uid, idx.shape,
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('extern double', val_uid, val.shape,
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('extern double', b_uid, b.shape,
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('double', c_uid, (M * N,),
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_struct_definition('spmm_args_t', 'args', args)]
+        header += [du.format_array_definition('uint32_t', ptr_uid, ptr,
+                                              alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_definition('uint16_t', idx_uid, idx,
+                                              alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_definition('double', val_uid, val,
+                                              alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_definition('double', b_uid, b,
+                                              alignment=self.BURST_ALIGNMENT)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(SpmmDataGen().main())
@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+from datagen import SpmmDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+
+
+class SpmmVerifier(Verifier):
+
+    OUTPUT_UIDS = ['c']
+
+    def __init__(self):
+        super().__init__()
+        self.func_args = {
+            'format': 'I',
+            'M': 'I',
+            'N': 'I',
+            'K': 'I',
+            'nnz': 'I',
+            'ptr': 'I',
+            'idx': 'I',
+            'val': 'I',
+            'B': 'I',
+            'C': 'I',
+            'panel_rows': 'I',
+            'panel_nnz': 'I',
+            'baseline': 'I'
+        }
+        self.func_args = self.get_input_from_symbol('args', self.func_args)
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], 'double')
+
+    def get_expected_results(self):
+        fmt = SpmmDataGen.FORMATS[self.func_args['format']]
+        M, N, K = self.func_args['M'], self.func_args['N'], self.func_args['K']
+        ptr = self.get_input_from_symbol('ptr', 'uint32_t')
+        idx = self.get_input_from_symbol('idx', 'uint16_t')
+        val = self.get_input_from_symbol('val', 'double')
+        b = self.get_input_from_symbol('b', 'double').reshape(N, K).T
+        a = SpmmDataGen.decompress(fmt, M, K, ptr, idx, val)
+        return SpmmDataGen().golden_model(a, b).flatten()
+
+    def check_results(self, *args):
+        return super().check_results(*args, atol=1e-10)
+
+
+if __name__ == "__main__":
+    sys.exit(SpmmVerifier().main())
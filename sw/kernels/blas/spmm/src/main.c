@@ -0,0 +1,14 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#include "spmm.h"
+
+#include "data.h"
+
+int main() {
+    spmm(&args);
+    return 0;
+}
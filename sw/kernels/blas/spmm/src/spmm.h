@@ -0,0 +1,497 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "snrt.h"
+
+/**
+ * @brief Storage format of the sparse matrix.
+ */
+typedef enum { SPMM_CSR = 0, SPMM_CSC = 1 } spmm_format_t;
+
+/**
+ * @struct spmm_args_t
+ * @brief Arguments of a sparse-dense matrix multiplication C = A * B.
+ *
+ * A is an M x K sparse matrix, B a dense K x N matrix and C a dense M x N
+ * matrix, stored in row-major order. SpMV is the special case N = 1.
+ *
+ * @var spmm_args_t::format
+ * Storage format of A, one of `spmm_format_t`.
+ * @var spmm_args_t::ptr
+ * Row pointers (CSR, M + 1 entries) or column pointers (CSC, K + 1 entries).
+ * @var spmm_args_t::idx
+ * Column (CSR) or row (CSC) index of every nonzero. 16-bit indices are
+ * streamed directly by the indirect SSRs, thus M and K must not exceed 65536.
+ * @var spmm_args_t::val
+ * Value of every nonzero.
+ * @var spmm_args_t::B
+ * Dense operand stored in column-major order, i.e. as an N x K matrix, so
+ * that every column of B can be gathered by the same column indices.
+ * @var spmm_args_t::panel_rows
+ * CSR only: maximum number of rows in a panel loaded to TCDM.
+ * @var spmm_args_t::panel_nnz
+ * CSR only: maximum number of nonzeros in a panel loaded to TCDM. Must be at
+ * least the number of nonzeros in the longest row.
+ * @var spmm_args_t::baseline
+ * Use the scalar kernels instead of the SSR-based ones.
+ */
+typedef struct {
+    uint32_t format;
+    uint32_t M;
+    uint32_t N;
+    uint32_t K;
+    uint32_t nnz;
+    uint32_t *ptr;
+    uint16_t *idx;
+    double *val;
+    double *B;
+    double *C;
+    uint32_t panel_rows;
+    uint32_t panel_nnz;
+    uint32_t baseline;
+} spmm_args_t;
+
+/**
+ * @brief Prefetched slice of consecutive rows of a CSR matrix.
+ *
+ * The row pointers in `ptr` are global offsets, i.e. `ptr[0]` is the offset
+ * of the first nonzero in the panel within the whole matrix.
+ */
+typedef struct {
+    uint32_t row;
+    uint32_t nrows;
+    uint32_t *ptr;
+    uint16_t *idx;
+    double *val;
+    double *C;
+} spmm_panel_t;
+
+/**
+ * @brief First row of a partition of the rows by number of nonzeros.
+ *
+ * @param ptr Row pointers of the rows to partition.
+ * @param nrows Number of rows to partition.
+ * @param parts Number of partitions.
+ * @param part Index of the partition.
+ * @return The index of the first row starting at or after the `part`-th
+ *         fraction of the nonzeros. Partition `parts` always starts at
+ *         `nrows`, so that trailing empty rows are also assigned.
+ */
+static inline uint32_t spmm_partition(const uint32_t *ptr, uint32_t nrows,
+                                      uint32_t parts, uint32_t part) {
+    if (part >= parts) return nrows;
+    uint32_t nz =
+        ptr[0] + (uint32_t)(((uint64_t)(ptr[nrows] - ptr[0]) * part) / parts);
+    uint32_t lo = 0, hi = nrows;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (ptr[mid] < nz)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Number of rows in the next panel.
+ *
+ * @return The largest number of rows, up to `max_rows`, whose nonzeros do
+ *         not exceed `max_nnz`.
+ */
+static inline uint32_t spmm_panel_rows(const uint32_t *ptr, uint32_t max_rows,
+                                       uint32_t max_nnz) {
+    uint32_t lo = 0, hi = max_rows;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi + 1) / 2;
+        if (ptr[mid] - ptr[0] <= max_nnz)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+/**
+ * @brief Scalar CSR kernel, computing `nrows` rows of C.
+ *
+ * @param ptr Row pointers of the rows to compute.
+ * @param idx Column indices, starting at the first nonzero of the rows.
+ * @param val Values, starting at the first nonzero of the rows.
+ * @param N Number of columns of B and C.
+ * @param K Leading dimension of B, in column-major order.
+ * @param B Dense operand.
+ * @param C First row of C to compute, with leading dimension N.
+ */
+static inline void spmm_csr_naive(uint32_t nrows, const uint32_t *ptr,
+                                  const uint16_t *idx, const double *val,
+                                  uint32_t N, uint32_t K, const double *B,
+                                  double *C) {
+    for (uint32_t n = 0; n < N; n++) {
+        const double *b = B + n * K;
+        const uint16_t *i = idx;
+        const double *v = val;
+        for (uint32_t r = 0; r < nrows; r++) {
+            double acc = 0;
+            for (uint32_t p = ptr[r]; p < ptr[r + 1]; p++)
+                acc += *v++ * b[*i++];
+            C[r * N + n] = acc;
+        }
+    }
+}
+
+/**
+ * @brief SSR CSR kernel, with the same interface as `spmm_csr_naive`.
+ *
+ * @details SSR 0 gathers the entries of a column of B indirectly, through the
+ *          column indices, while SSR 1 streams the values. Both streams span
+ *          all nonzeros of the rows, so they are configured once per column of
+ *          B, and every row only issues an FREP loop over its nonzeros.
+ */
+static inline void spmm_csr_issr(uint32_t nrows, const uint32_t *ptr,
+                                 const uint16_t *idx, const double *val,
+                                 uint32_t N, uint32_t K, const double *B,
+                                 double *C) {
+    uint32_t nnz = ptr[nrows] - ptr[0];
+
+    for (uint32_t n = 0; n < N; n++) {
+        if (nnz) {
+            snrt_issr_read(SNRT_SSR_DM0, (void *)(B + n * K), (void *)idx, nnz,
+                           SNRT_SSR_IDXSIZE_U16);
+            snrt_ssr_loop_1d(SNRT_SSR_DM1, nnz, sizeof(double));
+            snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, (void *)val);
+            snrt_ssr_enable();
+        }
+
+        for (uint32_t r = 0; r < nrows; r++) {
+            uint32_t len = ptr[r + 1] - ptr[r];
+            double acc = 0.0;
+
+            if (len) {
+                asm volatile(
+                    "frep.o %[n_frep], 1, 0, 0 \n"
+                    "fmadd.d %[acc], ft0, ft1, %[acc] \n"
+                    : [ acc ] "+f"(acc)
+                    : [ n_frep ] "r"(len - 1)
+                    : "ft0", "ft1", "ft2", "memory");
+            }
+
+            C[r * N + n] = acc;
+        }
+
+        if (nnz) {
+            snrt_ssr_disable();
+            snrt_fpu_fence();
+        }
+    }
+}
+
+/**
+ * @brief Scalar CSC kernel, accumulating the contributions of `ncols`
+ *        columns of A to C.
+ *
+ * @param ptr Column pointers of the columns to process.
+ * @param idx Row indices, starting at the first nonzero of the columns.
+ * @param val Values, starting at the first nonzero of the columns.
+ * @param N Number of columns of B and C.
+ * @param K Leading dimension of B, in column-major order.
+ * @param B First row of B to process.
+ * @param C Matrix to accumulate to, with leading dimension N.
+ */
+static inline void spmm_csc_naive(uint32_t ncols, const uint32_t *ptr,
+                                  const uint16_t *idx, const double *val,
+                                  uint32_t N, uint32_t K, const double *B,
+                                  double *C) {
+    for (uint32_t n = 0; n < N; n++) {
+        const uint16_t *i = idx;
+        const double *v = val;
+        for (uint32_t c = 0; c < ncols; c++) {
+            double b = B[n * K + c];
+            for (uint32_t p = ptr[c]; p < ptr[c + 1]; p++)
+                C[*i++ * N + n] += *v++ * b;
+        }
+    }
+}
+
+/**
+ * @brief SSR CSC kernel, with the same interface as `spmm_csc_naive`.
+ *
+ * @details SSR 0 streams the values of all nonzeros, once per column of B.
+ *          Consecutive columns of A can update the same rows of C, so the
+ *          updates are not streamed but issued as explicit loads and stores,
+ *          which the FPU executes in order.
+ */
+static inline void spmm_csc_ssr(uint32_t ncols, const uint32_t *ptr,
+                                const uint16_t *idx, const double *val,
+                                uint32_t N, uint32_t K, const double *B,
+                                double *C) {
+    uint32_t nnz = ptr[ncols] - ptr[0];
+    if (!nnz) return;
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, nnz, sizeof(double));
+
+    for (uint32_t n = 0; n < N; n++) {
+        const uint16_t *i = idx;
+        double *c = C + n;
+
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, (void *)val);
+        snrt_ssr_enable();
+
+        for (uint32_t col = 0; col < ncols; col++) {
+            uint32_t len = ptr[col + 1] - ptr[col];
+            if (!len) continue;
+
+            asm volatile(
+                "fld ft3, 0(%[b]) \n"
+                "1: \n"
+                "lhu t0, 0(%[i]) \n"
+                "mul t0, t0, %[ldc] \n"
+                "add t0, t0, %[c] \n"
+                "fld ft4, 0(t0) \n"
+                "fmadd.d ft4, ft0, ft3, ft4 \n"
+                "fsd ft4, 0(t0) \n"
+                "addi %[i], %[i], 2 \n"
+                "addi %[len], %[len], -1 \n"
+                "bnez %[len], 1b \n"
+                : [ i ] "+r"(i), [ len ] "+r"(len)
+                : [ b ] "r"(B + n * K + col), [ c ] "r"(c),
+                  [ ldc ] "r"(N * sizeof(double))
+                : "t0", "ft0", "ft1", "ft2", "ft3", "ft4", "memory");
+        }
+
+        snrt_ssr_disable();
+        snrt_fpu_fence();
+    }
+}
+
+/**
+ * @brief Start loading the next CSR panel to TCDM.
+ *
+ * @param panel Panel buffer to load to.
+ * @param row First row of the panel.
+ * @param end End of the rows to walk. The panel is empty if `row == end`.
+ */
+static inline void spmm_load_panel(spmm_args_t *args, spmm_panel_t *panel,
+                                   uint32_t row, uint32_t end) {
+    uint32_t max_rows = args->panel_rows;
+    if (max_rows > end - row) max_rows = end - row;
+    uint32_t nrows =
+        spmm_panel_rows(args->ptr + row, max_rows, args->panel_nnz);
+    panel->row = row;
+    panel->nrows = nrows;
+    if (nrows) {
+        uint32_t p0 = args->ptr[row];
+        uint32_t nnz = args->ptr[row + nrows] - p0;
+        snrt_dma_start_1d(panel->ptr, args->ptr + row,
+                          (nrows + 1) * sizeof(uint32_t));
+        snrt_dma_start_1d(panel->idx, args->idx + p0, nnz * sizeof(uint16_t));
+        snrt_dma_start_1d(panel->val, args->val + p0, nnz * sizeof(double));
+    }
+}
+
+/**
+ * @brief Sparse-dense matrix multiplication with A in CSR format.
+ *
+ * @details The rows of A are partitioned among the clusters by number of
+ *          nonzeros. Every cluster walks its rows in panels of up to
+ *          `panel_rows` rows and `panel_nnz` nonzeros, double-buffering the
+ *          row pointers, indices and values of the next panel while the
+ *          compute cores work on the current one. The rows of a panel are in
+ *          turn partitioned among the compute cores by number of nonzeros, so
+ *          that rows of very different length do not cause load imbalance.
+ */
+static inline void spmm_csr(spmm_args_t *args) {
+    uint32_t M = args->M, N = args->N, K = args->K;
+
+    // Rows of the cluster
+    uint32_t r0 = spmm_partition(args->ptr, M, snrt_cluster_num(),
+                                 snrt_cluster_idx());
+    uint32_t r1 = spmm_partition(args->ptr, M, snrt_cluster_num(),
+                                 snrt_cluster_idx() + 1);
+
+    // Allocate B and two panel buffers in TCDM
+    double *B = (double *)snrt_l1_alloc_cluster_local(K * N * sizeof(double),
+                                                      sizeof(double));
+    spmm_panel_t *panels = (spmm_panel_t *)snrt_l1_alloc_cluster_local(
+        2 * sizeof(spmm_panel_t), sizeof(uint32_t));
+    for (uint32_t b = 0; b < 2; b++) {
+        panels[b].ptr = (uint32_t *)snrt_l1_alloc_cluster_local(
+            (args->panel_rows + 1) * sizeof(uint32_t), sizeof(uint32_t));
+        panels[b].idx = (uint16_t *)snrt_l1_alloc_cluster_local(
+            args->panel_nnz * sizeof(uint16_t), sizeof(double));
+        panels[b].val = (double *)snrt_l1_alloc_cluster_local(
+            args->panel_nnz * sizeof(double), sizeof(double));
+        panels[b].C = (double *)snrt_l1_alloc_cluster_local(
+            args->panel_rows * N * sizeof(double), sizeof(double));
+    }
+
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(B, args->B, K * N * sizeof(double));
+        spmm_load_panel(args, &panels[0], r0, r1);
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+
+    for (uint32_t b = 0; panels[b].nrows; b ^= 1) {
+        spmm_panel_t *panel = &panels[b];
+
+        // Prefetch the next panel, while waiting for the previous one to be
+        // stored
+        if (snrt_is_dm_core()) {
+            spmm_load_panel(args, &panels[b ^ 1],
+                            panel->row + panel->nrows, r1);
+            snrt_dma_wait_all();
+        }
+
+        // Every compute core computes a subset of the rows in the panel
+        if (snrt_is_compute_core()) {
+            uint32_t ncores = snrt_cluster_compute_core_num();
+            uint32_t lo = spmm_partition(panel->ptr, panel->nrows, ncores,
+                                         snrt_cluster_core_idx());
+            uint32_t hi = spmm_partition(panel->ptr, panel->nrows, ncores,
+                                         snrt_cluster_core_idx() + 1);
+            uint32_t p0 = panel->ptr[lo] - panel->ptr[0];
+            if (hi > lo) {
+                if (args->baseline)
+                    spmm_csr_naive(hi - lo, panel->ptr + lo, panel->idx + p0,
+                                   panel->val + p0, N, K, B,
+                                   panel->C + lo * N);
+                else
+                    spmm_csr_issr(hi - lo, panel->ptr + lo, panel->idx + p0,
+                                  panel->val + p0, N, K, B,
+                                  panel->C + lo * N);
+            }
+        }
+        snrt_fpu_fence();
+        snrt_cluster_hw_barrier();
+
+        // Store the panel's rows of C
+        if (snrt_is_dm_core()) {
+            snrt_dma_start_1d(args->C + panel->row * N, panel->C,
+                              panel->nrows * N * sizeof(double));
+        }
+    }
+
+    if (snrt_is_dm_core()) snrt_dma_wait_all();
+}
+
+/**
+ * @brief Sparse-dense matrix multiplication with A in CSC format.
+ *
+ * @details The columns of A are partitioned among the clusters, and in turn
+ *          among the compute cores, by number of nonzeros. Every core
+ *          accumulates the contributions of its columns to a private copy of
+ *          C. The copies are summed within the cluster, and then across
+ *          clusters by a DMA-based reduction. M * N must be a multiple of the
+ *          number of compute cores.
+ */
+static inline void spmm_csc(spmm_args_t *args) {
+    uint32_t M = args->M, N = args->N, K = args->K;
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t c_len = M * N;
+
+    // Columns of the cluster
+    uint32_t c0 = spmm_partition(args->ptr, K, snrt_cluster_num(),
+                                 snrt_cluster_idx());
+    uint32_t c1 = spmm_partition(args->ptr, K, snrt_cluster_num(),
+                                 snrt_cluster_idx() + 1);
+    uint32_t ncols = c1 - c0;
+    uint32_t p0 = args->ptr[c0];
+    uint32_t nnz = args->ptr[c1] - p0;
+
+    // Allocate the buffers of the reduction first, as they must lie at the
+    // same offset in every cluster, followed by the private copies of C, B
+    // and the cluster's slice of A
+    double *C = (double *)snrt_l1_alloc_cluster_local(c_len * sizeof(double),
+                                                      sizeof(double));
+    double *C_red = (double *)snrt_l1_alloc_cluster_local(
+        c_len * sizeof(double), sizeof(double));
+    double *C_core = (double *)snrt_l1_alloc_cluster_local(
+        ncores * c_len * sizeof(double), sizeof(double));
+    double *B = (double *)snrt_l1_alloc_cluster_local(K * N * sizeof(double),
+                                                      sizeof(double));
+    uint32_t *ptr = (uint32_t *)snrt_l1_alloc_cluster_local(
+        (ncols + 1) * sizeof(uint32_t), sizeof(uint32_t));
+    uint16_t *idx = (uint16_t *)snrt_l1_alloc_cluster_local(
+        nnz * sizeof(uint16_t), sizeof(double));
+    double *val = (double *)snrt_l1_alloc_cluster_local(nnz * sizeof(double),
+                                                        sizeof(double));
+
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(ptr, args->ptr + c0, (ncols + 1) * sizeof(uint32_t));
+        snrt_dma_start_1d(idx, args->idx + p0, nnz * sizeof(uint16_t));
+        snrt_dma_start_1d(val, args->val + p0, nnz * sizeof(double));
+        snrt_dma_start_1d(B, args->B, K * N * sizeof(double));
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+
+    if (snrt_is_compute_core()) {
+        uint32_t core_idx = snrt_cluster_core_idx();
+        double *c = C_core + core_idx * c_len;
+        for (uint32_t i = 0; i < c_len; i++) c[i] = 0;
+
+        // Every compute core processes a subset of the columns
+        uint32_t lo = spmm_partition(ptr, ncols, ncores, core_idx);
+        uint32_t hi = spmm_partition(ptr, ncols, ncores, core_idx + 1);
+        uint32_t q0 = ptr[lo] - ptr[0];
+        if (hi > lo) {
+            if (args->baseline)
+                spmm_csc_naive(hi - lo, ptr + lo, idx + q0, val + q0, N, K,
+                               B + c0 + lo, c);
+            else
+                spmm_csc_ssr(hi - lo, ptr + lo, idx + q0, val + q0, N, K,
+                             B + c0 + lo, c);
+        }
+        snrt_fpu_fence();
+    }
+    snrt_cluster_hw_barrier();
+
+    // Sum the private copies, every core reducing a slice of C
+    if (snrt_is_compute_core()) {
+        uint32_t slice = c_len / ncores;
+        uint32_t start = snrt_cluster_core_idx() * slice;
+        for (uint32_t i = start; i < start + slice; i++) {
+            double acc = 0;
+            for (uint32_t core = 0; core < ncores; core++)
+                acc += C_core[core * c_len + i];
+            C[i] = acc;
+        }
+    }
+
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+
+    // Sum the partial results of all clusters in cluster 0
+    snrt_global_reduction_dma(C_red, C, c_len);
+
+    if (snrt_is_dm_core() && snrt_cluster_idx() == 0) {
+        snrt_dma_start_1d(args->C, C, c_len * sizeof(double));
+        snrt_dma_wait_all();
+    }
+}
+
+/**
+ * @brief Sparse-dense matrix multiplication, dispatching on the format.
+ *
+ * @details Must be called by all cores of all clusters. The TCDM allocations
+ *          are released on return.
+ */
+static inline void spmm(spmm_args_t *args) {
+    void *l1_next = snrt_l1_next_v2();
+
+    snrt_mcycle();
+    if (args->format == SPMM_CSR)
+        spmm_csr(args);
+    else
+        spmm_csc(args);
+    snrt_mcycle();
+
+    snrt_l1_update_next_v2(l1_next);
+    snrt_global_barrier();
+}
@@ -5,6 +5,7 @@
 // Author: Luca Colagrande <colluca@iis.ee.ethz.ch>
 
 #include "args.h"
+#include "gemm/src/gemm.h"
 #include "snrt.h"
 
 __thread int setup_ssr = 1;
@@ -294,3 +295,127 @@ void syrk_job(syrk_args_t *args) {
         snrt_cluster_hw_barrier();
     }
 }
+
+/**
+ * @brief Epilogue of @ref syrk_tiled_mirror, applied by a compute core to a
+ *        row segment of a tile of C in TCDM.
+ *
+ * @param ctx Argument passed through by @ref syrk_tiled_mirror.
+ * @param row Pointer to the first element of the segment.
+ * @param i Index of the row of the segment in C.
+ * @param j Index of the column of the first element of the segment in C.
+ * @param len Number of elements in the segment.
+ */
+typedef void (*syrk_epilogue_t)(void *ctx, double *row, uint32_t i, uint32_t j,
+                                uint32_t len);
+
+/**
+ * @brief Computes the lower triangle of tiles of C = A A^T, for an m x k
+ *        matrix A in L3, on all clusters.
+ *
+ * @details Builds on the multi-cluster GEMM driver, with B = A^T loaded as
+ *          transposed tiles of A. The rows of tiles of C are assigned
+ *          cyclically to the clusters, and A is streamed in m/m_tiles x
+ *          k/k_tiles tiles, so neither A nor C need fit in TCDM.
+ *
+ * @param gemm_fp Tile kernel of the GEMM driver, e.g. `gemm_fp64_opt`.
+ */
+static inline void syrk_tiled_lower(uint32_t m, uint32_t k, double *a,
+                                    double *c, uint32_t m_tiles,
+                                    uint32_t k_tiles, gemm_fp_t gemm_fp) {
+    void *l1_next = snrt_l1_next_v2();
+
+    gemm_args_t gemm_args = {.m_tiles = m_tiles,
+                             .n_tiles = m_tiles,
+                             .k_tiles = k_tiles,
+                             .parallelize_m = 1,
+                             .parallelize_k = 0,
+                             .load_a = 1,
+                             .load_b = 1,
+                             .load_c = 1,
+                             .double_buffer = 1,
+                             .gemm_fp = gemm_fp,
+                             .prec = FP64,
+                             .setup_ssr = 1,
+                             .transa = 0,
+                             .transb = 1,
+                             .m = m,
+                             .n = m,
+                             .k = k,
+                             .alpha = 1.0,
+                             .a = a,
+                             .lda = k,
+                             .b = a,
+                             .ldb = k,
+                             .beta = 0,
+                             .c = c,
+                             .ldc = m,
+                             .lower = 1};
+    gemm(&gemm_args);
+
+    snrt_l1_update_next_v2(l1_next);
+}
+
+/**
+ * @brief Completes a symmetric m x m matrix C in L3, of which the lower
+ *        triangle of tiles was computed by @ref syrk_tiled_lower.
+ *
+ * @details Every cluster loads the lower tiles in its rows of tiles, as
+ *          assigned by @ref syrk_tiled_lower, applies the epilogue to them
+ *          and stores them back, together with their transpose in the upper
+ *          triangle. Must be preceded by a global barrier if the epilogue
+ *          depends on tiles of other clusters.
+ *
+ * @param epilogue Function applied to every tile before it is stored, or
+ *                 NULL to only mirror the lower triangle.
+ */
+static inline void syrk_tiled_mirror(uint32_t m, double *c, uint32_t m_tiles,
+                                     syrk_epilogue_t epilogue, void *ctx) {
+    void *l1_next = snrt_l1_next_v2();
+    uint32_t tile = m / m_tiles;
+    uint32_t tile_bytes = tile * tile * sizeof(double);
+    double *buf =
+        (double *)snrt_l1_alloc_cluster_local(tile_bytes, sizeof(double));
+    double *buf_t =
+        (double *)snrt_l1_alloc_cluster_local(tile_bytes, sizeof(double));
+
+    for (uint32_t ti = snrt_cluster_idx(); ti < m_tiles;
+         ti += snrt_cluster_num()) {
+        for (uint32_t tj = 0; tj <= ti; tj++) {
+            if (snrt_is_dm_core()) {
+                snrt_dma_load_2d_tile(buf, c, ti, tj, tile, tile, m,
+                                      sizeof(double));
+                snrt_dma_wait_all();
+            }
+            snrt_cluster_hw_barrier();
+
+            // Every core owns a subset of the rows of the tile, and writes
+            // them to the columns of the transposed tile
+            if (snrt_is_compute_core()) {
+                for (uint32_t r = snrt_cluster_core_idx(); r < tile;
+                     r += snrt_cluster_compute_core_num()) {
+                    double *row = buf + r * tile;
+                    if (epilogue)
+                        epilogue(ctx, row, ti * tile + r, tj * tile, tile);
+                    if (ti != tj)
+                        for (uint32_t j = 0; j < tile; j++)
+                            buf_t[j * tile + r] = row[j];
+                }
+                snrt_fpu_fence();
+            }
+            snrt_cluster_hw_barrier();
+
+            if (snrt_is_dm_core()) {
+                snrt_dma_store_2d_tile(c, buf, ti, tj, tile, tile, m,
+                                       sizeof(double));
+                if (ti != tj)
+                    snrt_dma_store_2d_tile(c, buf_t, tj, ti, tile, tile, m,
+                                           sizeof(double));
+                snrt_dma_wait_all();
+            }
+        }
+    }
+
+    snrt_cluster_hw_barrier();
+    snrt_l1_update_next_v2(l1_next);
+}
@@ -0,0 +1,10 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+APP              := activation
+$(APP)_BUILD_DIR ?= $(SN_ROOT)/sw/kernels/dnn/$(APP)/build
+SRC_DIR          := $(SN_ROOT)/sw/kernels/dnn/$(APP)/src
+SRCS             := $(SRC_DIR)/main.c
+
+include $(SN_ROOT)/sw/kernels/dnn/common.mk
@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import math
+import numpy as np
+import pyflexfloat as ff
+import sys
+
+import snitch.util.sim.data_utils as du
+
+np.random.seed(42)
+
+# AXI splits bursts crossing 4KB address boundaries. To minimize
+# the occurrence of these splits the data should be aligned to 4KB
+BURST_ALIGNMENT = 4096
+
+
+class ActivationDataGen(du.DataGen):
+
+    FUNCTIONS = ['GELU_TANH', 'GELU_ERF', 'SILU', 'SIGMOID', 'TANH']
+
+    def golden_model(self, ifmap, function):
+        x = ifmap.astype(np.float64)
+        if function == 'GELU_TANH':
+            return 0.5 * x * (1 + np.tanh(np.sqrt(2 / np.pi) * (x + 0.044715 * x**3)))
+        elif function == 'GELU_ERF':
+            erf = np.vectorize(math.erf)
+            return 0.5 * x * (1 + erf(x / np.sqrt(2)))
+        elif function == 'SILU':
+            return x / (1 + np.exp(-x))
+        elif function == 'SIGMOID':
+            return 1 / (1 + np.exp(-x))
+        elif function == 'TANH':
+            return np.tanh(x)
+
+    def validate(self, size, tile_size, function, dtype, **kwargs):
+        assert function in self.FUNCTIONS, f'Unsupported function {function}'
+        assert size % tile_size == 0, 'size must be an integer multiple of tile_size'
+        num_cores = 8
+        assert tile_size % (8 * num_cores) == 0, 'tile_size must be a multiple of 64'
+
+        # Double-buffered input and output tiles, plus a single-precision
+        # scratchpad for FP16 and FP8 tiles
+        prec = du.size_from_precision_t(dtype)
+        du.validate_tcdm_footprint(4 * tile_size * prec + tile_size * 4)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        self.validate(**kwargs)
+
+        size = kwargs['size']
+        prec = kwargs['dtype']
+
+        ff_desc = du.ff_desc_from_precision_t(prec)
+        ctype = du.ctype_from_precision_t(prec)
+
+        ifmap = ff.array(np.random.randn(size), ff_desc)
+
+        ifmap_uid = 'ifmap'
+        ofmap_uid = 'ofmap'
+
+        layer_cfg = {
+            'size': size,
+            'ifmap': ifmap_uid,
+            'ofmap': ofmap_uid,
+            'dtype': prec,
+            'function': kwargs['function'],
+            'implementation': kwargs['implementation'],
+            'tile_size': kwargs['tile_size']
+        }
+
+        header += [du.format_array_declaration(f'extern {ctype}', ifmap_uid, ifmap.shape,
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_declaration(ctype, ofmap_uid, ifmap.shape,
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_struct_definition('activation_layer_t', 'layer', layer_cfg)]
+        header += [du.format_array_definition(ctype, ifmap_uid, ifmap,
+                                              alignment=BURST_ALIGNMENT)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(ActivationDataGen().main())
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+from datagen import ActivationDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+from snitch.util.sim.data_utils import ctype_from_precision_t
+
+
+class ActivationVerifier(Verifier):
+
+    OUTPUT_UIDS = ['ofmap']
+    # The polynomial approximations are accurate to about 5e-3 over the whole
+    # input range, on top of which comes the rounding to the output precision
+    ERR_THRESHOLD = {8: 6e-3, 4: 6e-3, 2: 1e-2, 1: 0.5}
+
+    def __init__(self):
+        super().__init__()
+        self.layer_struct = {
+            'size': 'I',
+            'ifmap': 'I',
+            'ofmap': 'I',
+            'dtype': 'I',
+            'function': 'I',
+            'implementation': 'I',
+            'tile_size': 'I'
+        }
+        self.layer = self.get_input_from_symbol('layer', self.layer_struct)
+        self.prec = self.layer['dtype']
+        self.function = ActivationDataGen.FUNCTIONS[self.layer['function']]
+
+    def get_actual_results(self):
+        ofmap = self.get_output_from_symbol(self.OUTPUT_UIDS[0], ctype_from_precision_t(self.prec))
+        return ofmap.astype(np.float64)
+
+    def get_expected_results(self):
+        ifmap = self.get_input_from_symbol('ifmap', ctype_from_precision_t(self.prec))
+        return ActivationDataGen().golden_model(ifmap, self.function)
+
+    def check_results(self, *args):
+        return super().check_results(*args, atol=self.ERR_THRESHOLD[self.prec])
+
+
+if __name__ == "__main__":
+    sys.exit(ActivationVerifier().main())
@@ -0,0 +1,496 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <math.h>
+
+#include "snrt.h"
+
+/**
+ * @brief Supported activation functions.
+ */
+typedef enum { GELU_TANH, GELU_ERF, SILU, SIGMOID, TANH } activation_t;
+
+/**
+ * @struct activation_layer_t
+ * @brief This structure contains all parameters necessary for computing
+ *        an elementwise activation function.
+ * @var activation_layer_t::size
+ * Number of elements in the feature maps
+ * @var activation_layer_t::ifmap
+ * Pointer to the input feature map
+ * @var activation_layer_t::ofmap
+ * Pointer to the output feature map
+ * @var activation_layer_t::dtype
+ * Precision of the input and output feature maps
+ * @var activation_layer_t::function
+ * Activation function to compute
+ * @var activation_layer_t::implementation
+ * Selects the scalar libm baseline (NAIVE) or the SSR- and FREP-based
+ * polynomial approximation (OPT)
+ * @var activation_layer_t::tile_size
+ * Number of elements in every tile. Must be a multiple of eight times the
+ * number of compute cores per cluster, and divide @p size
+ */
+typedef struct {
+    uint32_t size;
+    void *ifmap;
+    void *ofmap;
+    precision_t dtype;
+    activation_t function;
+    implementation_t implementation;
+    uint32_t tile_size;
+} activation_layer_t;
+
+// Degree of the approximating polynomials
+#define ACTIVATION_POLY_DEGREE 6
+
+/**
+ * @struct activation_poly_t
+ * @brief Polynomial approximation of an activation function.
+ * @details All supported functions are expressed in terms of an odd function
+ *          h(x), which saturates to a constant for large |x|:
+ *
+ *              tanh, sigmoid:  y = beta + h(x)
+ *              GELU, SiLU:     y = x * (beta + h(x))
+ *                                = |x| * (beta * sgn(x) + r(t))
+ *
+ *          where h(x) = sgn(x) * r(t), t = min(|x|, c) and r is a polynomial
+ *          with no constant term, fitted such that r(c) equals the
+ *          saturation value. Clamping the argument makes the approximation
+ *          piecewise: polynomial in [-c, c] and constant outside, without
+ *          requiring any branch.
+ * @var activation_poly_t::c
+ * Clamping threshold
+ * @var activation_poly_t::beta
+ * Offset of the activation function at the origin
+ * @var activation_poly_t::r
+ * Coefficients of t^1 to t^6 of the polynomial r
+ */
+typedef struct {
+    float c;
+    float beta;
+    float r[ACTIVATION_POLY_DEGREE];
+} activation_poly_t;
+
+// Minimax fits of 0.5 * tanh(sqrt(2/pi) * (x + 0.044715 * x^3)),
+// 0.5 * erf(x / sqrt(2)) and tanh(x). Sigmoid and SiLU are derived from the
+// latter, as sigmoid(x) = 0.5 + 0.5 * tanh(x / 2).
+static const activation_poly_t activation_polys[] = {
+    // GELU_TANH
+    {3.45f,
+     0.5f,
+     {0.394383838f, 0.0277658829f, -0.12224057f, 0.0484688552f,
+      -0.0077751163f, 0.000451980265f}},
+    // GELU_ERF
+    {3.5f,
+     0.5f,
+     {0.394049153f, 0.0292445682f, -0.123747691f, 0.0491042404f,
+      -0.00790066342f, 0.000461922235f}},
+    // SILU
+    {7.3f,
+     0.5f,
+     {0.254062923f, -0.00527235965f, -0.024135878f, 0.00681845916f,
+      -0.000760988258f, 3.12432845e-05f}},
+    // SIGMOID
+    {7.3f,
+     0.5f,
+     {0.254062923f, -0.00527235965f, -0.024135878f, 0.00681845916f,
+      -0.000760988258f, 3.12432845e-05f}},
+    // TANH
+    {3.65f,
+     0.0f,
+     {1.01625169f, -0.0421788772f, -0.386174048f, 0.218190693f,
+      -0.0487032485f, 0.00399914042f}},
+};
+
+static inline uint32_t activation_is_gated(activation_t function) {
+    return function == GELU_TANH || function == GELU_ERF || function == SILU;
+}
+
+/**
+ * @brief Reference implementation of the activation functions, based on
+ *        libm and evaluated in double precision.
+ */
+static inline double activation_ref(double x, activation_t function) {
+    switch (function) {
+        case GELU_TANH:
+            return 0.5 * x *
+                   (1.0 + tanh(sqrt(2.0 / M_PI) * (x + 0.044715 * x * x * x)));
+        case GELU_ERF:
+            return 0.5 * x * (1.0 + erf(x * 0.7071067811865476));
+        case SILU:
+            return x / (1.0 + exp(-x));
+        case SIGMOID:
+            return 1.0 / (1.0 + exp(-x));
+        case TANH:
+            return tanh(x);
+        default:
+            return x;
+    }
+}
+
+/**
+ * @brief Scalar evaluation of the polynomial approximation, in single
+ *        precision.
+ */
+static inline float activation_poly(float x, const activation_poly_t *poly,
+                                    uint32_t gated) {
+    float a = fabsf(x);
+    float t = fminf(a, poly->c);
+    float p = poly->r[ACTIVATION_POLY_DEGREE - 1] * t;
+    for (int k = ACTIVATION_POLY_DEGREE - 2; k >= 0; k--)
+        p = (p + poly->r[k]) * t;
+    if (gated) return (p + copysignf(poly->beta, x)) * a;
+    return copysignf(p, x) + poly->beta;
+}
+
+static inline double activation_load(void *src, uint32_t i,
+                                     precision_t prec) {
+    switch (prec) {
+        case FP64:
+            return ((double *)src)[i];
+        case FP32:
+            return ((float *)src)[i];
+        case FP16:
+            return ((__fp16 *)src)[i];
+        case FP8:
+            return fp8_to_float(((char *)src)[i]);
+        default:
+            return 0;
+    }
+}
+
+static inline void activation_store(void *dst, uint32_t i, double y,
+                                    precision_t prec) {
+    switch (prec) {
+        case FP64:
+            ((double *)dst)[i] = y;
+            break;
+        case FP32:
+            ((float *)dst)[i] = (float)y;
+            break;
+        case FP16:
+            ((__fp16 *)dst)[i] = (__fp16)y;
+            break;
+        case FP8:
+            ((char *)dst)[i] = float_to_fp8((float)y);
+            break;
+        default:
+            break;
+    }
+}
+
+// Emits the FREP loop evaluating an activation function over two words per
+// iteration, whose computations are interleaved to hide the FPU latency. The
+// input is streamed twice, through SSR0 and SSR2, as both its magnitude and
+// its sign are needed, and the output is streamed through SSR1. With
+// `prefix` "vf" and `fmt` "s" every word holds two single-precision elements,
+// with `prefix` "f" and `fmt` "d" one double-precision element. Each loop
+// body amounts to 30 or 32 instructions, which must fit in the FREP
+// sequencer, see `activation_chunk`.
+#define ACTIVATION_HORNER_STEP_ASM(prefix, fmt, r) \
+    prefix "add." fmt " %[p0], %[p0], %[" r "] \n"  \
+    prefix "add." fmt " %[p1], %[p1], %[" r "] \n"  \
+    prefix "mul." fmt " %[p0], %[p0], %[t0] \n"     \
+    prefix "mul." fmt " %[p1], %[p1], %[t1] \n"
+
+#define ACTIVATION_HORNER_ASM(prefix, fmt)             \
+    prefix "mul." fmt " %[p0], %[t0], %[r5] \n"        \
+    prefix "mul." fmt " %[p1], %[t1], %[r5] \n"        \
+    ACTIVATION_HORNER_STEP_ASM(prefix, fmt, "r4")      \
+    ACTIVATION_HORNER_STEP_ASM(prefix, fmt, "r3")      \
+    ACTIVATION_HORNER_STEP_ASM(prefix, fmt, "r2")      \
+    ACTIVATION_HORNER_STEP_ASM(prefix, fmt, "r1")      \
+    ACTIVATION_HORNER_STEP_ASM(prefix, fmt, "r0")
+
+#define ACTIVATION_ASM(prefix, fmt)                                       \
+    do {                                                                  \
+        if (gated)                                                        \
+            asm volatile(                                                 \
+                "frep.o  %[n_frep], 32, 0, 0 \n"                          \
+                prefix "sgnj." fmt " %[a0], ft0, %[c] \n"                 \
+                prefix "sgnj." fmt " %[a1], ft0, %[c] \n"                 \
+                prefix "min." fmt " %[t0], %[a0], %[c] \n"                \
+                prefix "min." fmt " %[t1], %[a1], %[c] \n"                \
+                prefix "sgnj." fmt " %[b0], %[beta], ft2 \n"              \
+                prefix "sgnj." fmt " %[b1], %[beta], ft2 \n"              \
+                ACTIVATION_HORNER_ASM(prefix, fmt)                        \
+                prefix "add." fmt " %[p0], %[p0], %[b0] \n"               \
+                prefix "add." fmt " %[p1], %[p1], %[b1] \n"               \
+                prefix "mul." fmt " ft1, %[p0], %[a0] \n"                 \
+                prefix "mul." fmt " ft1, %[p1], %[a1] \n"                 \
+                : [ a0 ] "=&f"(a0), [ a1 ] "=&f"(a1), [ t0 ] "=&f"(t0),   \
+                  [ t1 ] "=&f"(t1), [ p0 ] "=&f"(p0), [ p1 ] "=&f"(p1),   \
+                  [ b0 ] "=&f"(b0), [ b1 ] "=&f"(b1)                      \
+                : [ n_frep ] "r"(n_words / 2 - 1), [ c ] "f"(c),          \
+                  [ beta ] "f"(beta), [ r0 ] "f"(r[0]), [ r1 ] "f"(r[1]), \
+                  [ r2 ] "f"(r[2]), [ r3 ] "f"(r[3]), [ r4 ] "f"(r[4]),   \
+                  [ r5 ] "f"(r[5])                                        \
+                : "ft0", "ft1", "ft2", "memory");                         \
+        else                                                              \
+            asm volatile(                                                 \
+                "frep.o  %[n_frep], 30, 0, 0 \n"                          \
+                prefix "sgnj." fmt " %[a0], ft0, %[c] \n"                 \
+                prefix "sgnj." fmt " %[a1], ft0, %[c] \n"                 \
+                prefix "min." fmt " %[t0], %[a0], %[c] \n"                \
+                prefix "min." fmt " %[t1], %[a1], %[c] \n"                \
+                ACTIVATION_HORNER_ASM(prefix, fmt)                        \
+                prefix "sgnj." fmt " %[p0], %[p0], ft2 \n"                \
+                prefix "sgnj." fmt " %[p1], %[p1], ft2 \n"                \
+                prefix "add." fmt " ft1, %[p0], %[beta] \n"               \
+                prefix "add." fmt " ft1, %[p1], %[beta] \n"               \
+                : [ a0 ] "=&f"(a0), [ a1 ] "=&f"(a1), [ t0 ] "=&f"(t0),   \
+                  [ t1 ] "=&f"(t1), [ p0 ] "=&f"(p0), [ p1 ] "=&f"(p1)    \
+                : [ n_frep ] "r"(n_words / 2 - 1), [ c ] "f"(c),          \
+                  [ beta ] "f"(beta), [ r0 ] "f"(r[0]), [ r1 ] "f"(r[1]), \
+                  [ r2 ] "f"(r[2]), [ r3 ] "f"(r[3]), [ r4 ] "f"(r[4]),   \
+                  [ r5 ] "f"(r[5])                                        \
+                : "ft0", "ft1", "ft2", "memory");                         \
+    } while (0)
+
+/**
+ * @brief Evaluates the polynomial approximation of an activation function
+ *        over a buffer in TCDM.
+ * @details @p prec must be FP32 or FP64. FP32 buffers are processed with
+ *          packed-SIMD instructions, two elements at a time. @p out may
+ *          alias @p in.
+ * @param n_words Number of 64-bit words in the buffers, must be even.
+ */
+static inline void activation_poly_frep(void *in, void *out, uint32_t n_words,
+                                        precision_t prec,
+                                        activation_t function) {
+#ifdef SNRT_SUPPORTS_FREP
+    const activation_poly_t *poly = &activation_polys[function];
+    uint32_t gated = activation_is_gated(function);
+
+    // Replicate the constants in every SIMD lane
+    double c, beta, r[ACTIVATION_POLY_DEGREE];
+    double a0, a1, t0, t1, p0, p1, b0, b1;
+    if (prec == FP32) {
+        asm volatile(
+            "vfcpka.s.s %[c], %[c_s], %[c_s] \n"
+            "vfcpka.s.s %[beta], %[beta_s], %[beta_s] \n"
+            : [ c ] "=f"(c), [ beta ] "=f"(beta)
+            : [ c_s ] "f"(poly->c), [ beta_s ] "f"(poly->beta));
+        for (int k = 0; k < ACTIVATION_POLY_DEGREE; k++)
+            asm volatile("vfcpka.s.s %[r], %[r_s], %[r_s] \n"
+                         : [ r ] "=f"(r[k])
+                         : [ r_s ] "f"(poly->r[k]));
+    } else {
+        c = poly->c;
+        beta = poly->beta;
+        for (int k = 0; k < ACTIVATION_POLY_DEGREE; k++) r[k] = poly->r[k];
+    }
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, n_words, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, n_words, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM2, n_words, sizeof(double));
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, in);
+    snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_1D, out);
+    snrt_ssr_read(SNRT_SSR_DM2, SNRT_SSR_1D, in);
+    snrt_ssr_enable();
+    if (prec == FP32)
+        ACTIVATION_ASM("vf", "s");
+    else
+        ACTIVATION_ASM("f", "d");
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+#endif
+}
+
+/**
+ * @brief Converts a buffer of FP16 or FP8 elements to single precision.
+ * @details The input is streamed through SSR0 and SSR2, such that both
+ *          halves of every word can be converted with packed-SIMD
+ *          instructions, and the output is streamed through SSR1.
+ * @param n Number of elements, must be a multiple of eight.
+ */
+static inline void activation_widen(void *in, float *out, uint32_t n,
+                                    precision_t prec) {
+#ifdef SNRT_SUPPORTS_FREP
+    uint32_t n_words = n * prec / sizeof(double);
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, n_words, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, n / 2, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM2, n_words, sizeof(double));
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, in);
+    snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_1D, out);
+    snrt_ssr_read(SNRT_SSR_DM2, SNRT_SSR_1D, in);
+    snrt_ssr_enable();
+    if (prec == FP16) {
+        asm volatile(
+            "frep.o  %[n_frep], 2, 0, 0 \n"
+            "vfcvt.s.h ft1, ft0 \n"
+            "vfcvtu.s.h ft1, ft2 \n"
+            :
+            : [ n_frep ] "r"(n_words - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    } else {
+        double lo, hi;
+        asm volatile(
+            "frep.o  %[n_frep], 6, 0, 0 \n"
+            "vfcvt.h.b %[lo], ft0 \n"
+            "vfcvtu.h.b %[hi], ft2 \n"
+            "vfcvt.s.h ft1, %[lo] \n"
+            "vfcvtu.s.h ft1, %[lo] \n"
+            "vfcvt.s.h ft1, %[hi] \n"
+            "vfcvtu.s.h ft1, %[hi] \n"
+            : [ lo ] "=&f"(lo), [ hi ] "=&f"(hi)
+            : [ n_frep ] "r"(n_words - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    }
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+#endif
+}
+
+/**
+ * @brief Converts a buffer of single-precision elements to FP16 or FP8.
+ * @details Every word of two elements is converted with a packed-SIMD
+ *          instruction, which only defines the lower lanes of the result,
+ *          and is therefore stored with a narrow store.
+ * @param n Number of elements, must be even.
+ */
+static inline void activation_narrow(float *in, void *out, uint32_t n,
+                                     precision_t prec) {
+    double *words = (double *)in;
+    if (prec == FP16) {
+        uint32_t *dst = (uint32_t *)out;
+        for (uint32_t i = 0; i < n / 2; i++) {
+            asm volatile(
+                "vfcvt.h.s ft3, %[w] \n"
+                "fsw ft3, 0(%[dst]) \n"
+                :
+                : [ w ] "f"(words[i]), [ dst ] "r"(dst + i)
+                : "ft3", "memory");
+        }
+    } else {
+        uint16_t *dst = (uint16_t *)out;
+        for (uint32_t i = 0; i < n / 2; i++) {
+            asm volatile(
+                "vfcvt.b.s ft3, %[w] \n"
+                "fsh ft3, 0(%[dst]) \n"
+                :
+                : [ w ] "f"(words[i]), [ dst ] "r"(dst + i)
+                : "ft3", "memory");
+        }
+    }
+}
+
+/**
+ * @brief Computes the activation function over a chunk of elements in TCDM.
+ * @details FP16 and FP8 chunks are widened to single precision, evaluated
+ *          with packed-SIMD FP32 instructions and narrowed back, as a
+ *          degree-6 polynomial evaluated in FP16 is not accurate enough.
+ *          If the FREP sequencer cannot hold the evaluation loop, the
+ *          polynomial is evaluated one element at a time.
+ * @param scratch Buffer of @p n floats, holding the intermediate results of
+ *                FP16 and FP8 chunks, which are evaluated in single
+ *                precision.
+ */
+static inline void activation_chunk(void *in, void *out, float *scratch,
+                                    uint32_t n, precision_t prec,
+                                    activation_t function,
+                                    implementation_t implementation) {
+    if (implementation == NAIVE) {
+        for (uint32_t i = 0; i < n; i++) {
+            double x = activation_load(in, i, prec);
+            activation_store(out, i, activation_ref(x, function), prec);
+        }
+        return;
+    }
+
+#ifdef SNRT_SUPPORTS_FREP
+    // The loop bodies of activation_poly_frep must fit in the FREP sequencer
+    if (SNRT_NUM_SEQUENCER_INSNS >= 32) {
+        switch (prec) {
+            case FP64:
+            case FP32:
+                activation_poly_frep(in, out, n * prec / sizeof(double), prec,
+                                     function);
+                break;
+            case FP16:
+            case FP8:
+                activation_widen(in, scratch, n, prec);
+                activation_poly_frep(scratch, scratch, n / 2, FP32, function);
+                activation_narrow(scratch, out, n, prec);
+                break;
+            default:
+                break;
+        }
+        return;
+    }
+#endif
+    const activation_poly_t *poly = &activation_polys[function];
+    uint32_t gated = activation_is_gated(function);
+    for (uint32_t i = 0; i < n; i++) {
+        float x = activation_load(in, i, prec);
+        activation_store(out, i, activation_poly(x, poly, gated), prec);
+    }
+}
+
+/**
+ * @brief  Tiled, multi-cluster activation layer
+ * @details The tiles of the feature maps are split in contiguous blocks
+ *          across clusters. Every cluster processes its block one tile at a
+ *          time, double buffering the tiles in TCDM, such that the DMA
+ *          transfers of the input and output tiles overlap with the
+ *          computation of the current tile. Within a tile, every compute
+ *          core processes a contiguous chunk of elements.
+ *
+ * @param l activation_layer struct that holds addresses and parameters
+ */
+static inline void activation_layer(activation_layer_t const l) {
+    uint32_t n_tiles_total = l.size / l.tile_size;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t first_tile = n_tiles_total * cluster_idx / num_clusters;
+    uint32_t last_tile = n_tiles_total * (cluster_idx + 1) / num_clusters;
+    uint32_t n_tiles = last_tile - first_tile;
+    uint32_t tile_bytes = l.tile_size * l.dtype;
+    uint32_t chunk_size = l.tile_size / snrt_cluster_compute_core_num();
+    uint32_t chunk_offset = snrt_cluster_core_idx() * chunk_size * l.dtype;
+
+    // Block of tiles assigned to the current cluster
+    char *ifmap = (char *)l.ifmap + first_tile * tile_bytes;
+    char *ofmap = (char *)l.ofmap + first_tile * tile_bytes;
+
+    // Allocate double buffers for the input and output tiles, followed by
+    // a scratchpad for every compute core
+    char *itile[2], *otile[2];
+    itile[0] = (char *)snrt_l1_next();
+    itile[1] = itile[0] + tile_bytes;
+    otile[0] = itile[1] + tile_bytes;
+    otile[1] = otile[0] + tile_bytes;
+    float *scratch =
+        (float *)(otile[1] + tile_bytes) + snrt_cluster_core_idx() * chunk_size;
+
+    // Software pipeline: in iteration i the DMA loads tile i and stores tile
+    // i - 2, while the compute cores process tile i - 1
+    snrt_mcycle();
+    for (uint32_t i = 0; i < n_tiles + 2; i++) {
+        if (snrt_is_dm_core()) {
+            if (i < n_tiles)
+                snrt_dma_start_1d(itile[i % 2], ifmap + i * tile_bytes,
+                                  tile_bytes);
+            if (i >= 2)
+                snrt_dma_start_1d(ofmap + (i - 2) * tile_bytes, otile[i % 2],
+                                  tile_bytes);
+            snrt_dma_wait_all();
+        }
+
+        if (snrt_is_compute_core() && i >= 1 && i <= n_tiles) {
+            activation_chunk(itile[(i - 1) % 2] + chunk_offset,
+                             otile[(i - 1) % 2] + chunk_offset, scratch,
+                             chunk_size, l.dtype, l.function,
+                             l.implementation);
+        }
+
+        snrt_cluster_hw_barrier();
+    }
+    snrt_mcycle();
+
+    snrt_global_barrier();
+}
@@ -0,0 +1,12 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "dnn.h"
+
+#include "data.h"
+
+int main() {
+    activation_layer(layer);
+    return 0;
+}
@@ -10,6 +10,7 @@
 import argparse
 import pathlib
 import json5
+import numpy as np
 import torch
 
 from snitch.util.sim import data_utils
@@ -17,6 +18,7 @@ from snitch.util.sim.data_utils import emit_license, format_struct_definition, \
     format_array_definition, format_array_declaration, format_ifdef_wrapper
 
 torch.manual_seed(42)
+np.random.seed(42)
 
 # AXI splits bursts crossing 4KB address boundaries. To minimize
 # the occurrence of these splits the data should be aligned to 4KB
@@ -36,8 +38,150 @@ def golden_model(ifmap):
     return ofmap, gamma, beta
 
 
+def golden_model_training(ifmap, gamma, beta, running_mean, running_var, eps, momentum,
+                          relu):
+    # Statistics over all pixels of every channel, in HWC layout
+    ifmap = ifmap.astype(np.float64)
+    m = ifmap.shape[0]
+    mean = np.mean(ifmap, axis=0)
+    var = np.var(ifmap, axis=0)
+    ofmap = (ifmap - mean) / np.sqrt(var + eps) * gamma + beta
+    if relu:
+        ofmap = np.maximum(ofmap, 0)
+    running_mean = (1 - momentum) * running_mean + momentum * mean
+    running_var = (1 - momentum) * running_var + momentum * var * m / (m - 1)
+    return ofmap, mean, var, running_mean, running_var
+
+
+def golden_model_backward(ifmap, grad_ofmap, gamma, mean, var, eps):
+    ifmap = ifmap.astype(np.float64)
+    grad_ofmap = grad_ofmap.astype(np.float64)
+    m = ifmap.shape[0]
+    istd = 1 / np.sqrt(var + eps)
+    xhat = (ifmap - mean) * istd
+    grad_beta = np.sum(grad_ofmap, axis=0)
+    grad_gamma = np.sum(grad_ofmap * xhat, axis=0)
+    grad_ifmap = gamma * istd / m * (m * grad_ofmap - grad_beta - xhat * grad_gamma)
+    return grad_ifmap, grad_gamma, grad_beta
+
+
+def validate(**kwargs):
+    mode = kwargs.get('mode', 'INFERENCE')
+    ci = kwargs['input_dim']['channels']
+    n_pixels = kwargs['input_dim']['height'] * kwargs['input_dim']['width']
+    prec = data_utils.size_from_precision_t(kwargs['prec'])
+
+    if mode == 'INFERENCE':
+        assert kwargs['prec'] == 'FP64', 'Only FP64 supported in inference mode'
+    else:
+        assert kwargs['prec'] in ['FP64', 'FP32', 'FP16'], 'FP8 not supported'
+        tile_pixels = kwargs['tile_pixels']
+        assert (ci * prec) % 64 == 0, 'Pixel size must be a multiple of 64B'
+        assert tile_pixels % 4 == 0, 'tile_pixels must be a multiple of 4'
+        assert n_pixels % tile_pixels == 0, 'Number of pixels must be an integer multiple' \
+                                            ' of tile_pixels'
+        # Double-buffered input and output tiles, reduction buffers and coefficients
+        data_utils.validate_tcdm_footprint(6 * tile_pixels * ci * prec + 4 * ci * 8 +
+                                           3 * ci * prec)
+
+
+def emit_training_header(**kwargs):
+    mode = kwargs['mode']
+    ci = kwargs['input_dim']['channels']
+    ih = kwargs['input_dim']['height']
+    iw = kwargs['input_dim']['width']
+    prec = kwargs['prec']
+    eps = kwargs.get('eps', 1e-5)
+    momentum = kwargs.get('momentum', 0.1)
+    relu = kwargs.get('relu', False)
+
+    ctype = data_utils.ctype_from_precision_t(prec)
+    np_type = data_utils.numpy_type_from_precision_t(prec)
+    # Statistics are stored in double precision for FP64, and single precision otherwise
+    stat_ctype = 'double' if prec == 'FP64' else 'float'
+    stat_type = np.float64 if prec == 'FP64' else np.float32
+
+    # Feature maps in HWC layout, with the batch folded into the height, and
+    # non-zero per-channel means
+    shape = (ih * iw, ci)
+    ifmap = (np.random.randn(*shape) * 2 + np.random.rand(ci) + 1).astype(np_type)
+    gamma = (np.random.rand(ci) + 0.5).astype(np_type)
+    beta = np.random.randn(ci).astype(np_type)
+
+    layer_cfg = {
+        'CI': ci,
+        'IH': ih,
+        'IW': iw,
+        'ifmap': 'ifmap',
+        'gamma': 'gamma_',
+        'dtype': prec,
+        'mode': f'BATCHNORM_{mode}',
+        'relu': int(relu),
+        'tile_pixels': kwargs['tile_pixels'],
+        'eps': eps,
+        'momentum': momentum,
+        'mean': 'mean',
+        'var': 'var'
+    }
+
+    data_str = [emit_license()]
+    if mode == 'TRAINING':
+        running_mean = np.random.randn(ci).astype(stat_type)
+        running_var = (np.random.rand(ci) + 0.5).astype(stat_type)
+        ofmap, *_ = golden_model_training(ifmap, gamma, beta, running_mean, running_var,
+                                          eps, momentum, relu)
+        layer_cfg.update({'ofmap': 'ofmap', 'beta': 'beta', 'running_mean': 'running_mean',
+                          'running_var': 'running_var'})
+        data_str += [format_array_declaration(f'extern {ctype}', 'ifmap', shape)]
+        data_str += [format_array_declaration(f'extern {ctype}', 'gamma_', gamma.shape)]
+        data_str += [format_array_declaration(f'extern {ctype}', 'beta', beta.shape)]
+        data_str += [format_array_declaration(ctype, 'ofmap', shape)]
+        data_str += [format_array_declaration(stat_ctype, 'mean', (ci,))]
+        data_str += [format_array_declaration(stat_ctype, 'var', (ci,))]
+        data_str += [format_array_declaration(stat_ctype, 'running_mean', (ci,))]
+        data_str += [format_array_declaration(stat_ctype, 'running_var', (ci,))]
+        data_str += [format_struct_definition('batchnorm_layer_t', 'layer', layer_cfg)]
+        data_str += [format_array_definition(ctype, 'ifmap', ifmap)]
+        data_str += [format_array_definition(ctype, 'gamma_', gamma)]
+        data_str += [format_array_definition(ctype, 'beta', beta)]
+        data_str += [format_array_definition(stat_ctype, 'running_mean', running_mean)]
+        data_str += [format_array_definition(stat_ctype, 'running_var', running_var)]
+        result_def = format_array_definition(ctype, 'golden', ofmap.astype(np_type))
+    else:
+        grad_ofmap = (np.random.randn(*shape) + 0.5).astype(np_type)
+        mean = np.mean(ifmap.astype(np.float64), axis=0).astype(stat_type)
+        var = np.var(ifmap.astype(np.float64), axis=0).astype(stat_type)
+        grad_ifmap, _, _ = golden_model_backward(ifmap, grad_ofmap, gamma, mean, var, eps)
+        layer_cfg.update({'grad_ofmap': 'grad_ofmap', 'grad_ifmap': 'grad_ifmap',
+                          'grad_gamma': 'grad_gamma', 'grad_beta': 'grad_beta'})
+        data_str += [format_array_declaration(f'extern {ctype}', 'ifmap', shape)]
+        data_str += [format_array_declaration(f'extern {ctype}', 'grad_ofmap', shape)]
+        data_str += [format_array_declaration(f'extern {ctype}', 'gamma_', gamma.shape)]
+        data_str += [format_array_declaration(f'extern {stat_ctype}', 'mean', (ci,))]
+        data_str += [format_array_declaration(f'extern {stat_ctype}', 'var', (ci,))]
+        data_str += [format_array_declaration(ctype, 'grad_ifmap', shape)]
+        data_str += [format_array_declaration(ctype, 'grad_gamma', (ci,))]
+        data_str += [format_array_declaration(ctype, 'grad_beta', (ci,))]
+        data_str += [format_struct_definition('batchnorm_layer_t', 'layer', layer_cfg)]
+        data_str += [format_array_definition(ctype, 'ifmap', ifmap)]
+        data_str += [format_array_definition(ctype, 'grad_ofmap', grad_ofmap)]
+        data_str += [format_array_definition(ctype, 'gamma_', gamma)]
+        data_str += [format_array_definition(stat_ctype, 'mean', mean)]
+        data_str += [format_array_definition(stat_ctype, 'var', var)]
+        result_def = format_array_definition(ctype, 'golden', grad_ifmap.astype(np_type))
+    data_str += [format_ifdef_wrapper('BIST', result_def)]
+    return '\n\n'.join(data_str)
+
+
 def emit_header(**kwargs):
 
+    # Validate parameters
+    validate(**kwargs)
+
+    # Training and backward modes
+    if kwargs.get('mode', 'INFERENCE') != 'INFERENCE':
+        return emit_training_header(**kwargs)
+
     in_channels = kwargs['input_dim']['channels']
     in_height = kwargs['input_dim']['height']
     in_width = kwargs['input_dim']['width']
@@ -72,7 +216,8 @@ def emit_header(**kwargs):
         'ifmap': ifmap_uid,
         'ofmap': ofmap_uid,
         'beta': beta_uid,
-        'gamma': gamma_uid
+        'gamma': gamma_uid,
+        'dtype': prec
     }
 
     data_str = [emit_license()]
@@ -97,7 +242,7 @@ def emit_header(**kwargs):
 
 def main():
 
-    parser = argparse.ArgumentParser(description='Generate data for layernorm kernel')
+    parser = argparse.ArgumentParser(description='Generate data for batchnorm kernel')
     parser.add_argument(
         "-c", "--cfg",
         type=pathlib.Path,
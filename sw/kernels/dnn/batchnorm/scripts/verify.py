@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+from datagen import golden_model_training, golden_model_backward
+
+from snitch.util.sim.verif_utils import Verifier
+from snitch.util.sim.data_utils import ctype_from_precision_t
+
+
+class BatchnormVerifier(Verifier):
+
+    MODES = ['INFERENCE', 'TRAINING', 'BACKWARD']
+    # Outputs of every mode: the feature map comes first, followed by the
+    # per-channel outputs
+    MODE_OUTPUT_UIDS = {
+        'INFERENCE': ['ofmap'],
+        'TRAINING': ['ofmap', 'mean', 'var', 'running_mean', 'running_var'],
+        'BACKWARD': ['grad_ifmap', 'grad_gamma', 'grad_beta']
+    }
+    # Errors are measured relative to the largest magnitude of every output.
+    # FP16 feature maps are normalized in half precision.
+    ERR_THRESHOLD = {8: 1e-10, 4: 1e-5, 2: 1e-2}
+
+    def __init__(self):
+        super().__init__()
+        self.layer_struct = {
+            'CI': 'I',
+            'IH': 'I',
+            'IW': 'I',
+            'TILE_CI': 'I',
+            'ifmap': 'I',
+            'ofmap': 'I',
+            'gamma': 'I',
+            'beta': 'I',
+            'dtype': 'I',
+            'mode': 'I',
+            'relu': 'I',
+            'tile_pixels': 'I',
+            'eps': 'f',
+            'momentum': 'f',
+            'mean': 'I',
+            'var': 'I',
+            'running_mean': 'I',
+            'running_var': 'I',
+            'grad_ofmap': 'I',
+            'grad_ifmap': 'I',
+            'grad_gamma': 'I',
+            'grad_beta': 'I'
+        }
+        self.layer = self.get_input_from_symbol('layer', self.layer_struct)
+        self.mode = self.MODES[self.layer['mode']]
+        self.prec = self.layer['dtype']
+        self.ctype = ctype_from_precision_t(self.prec)
+        self.stat_ctype = 'double' if self.prec == 8 else 'float'
+        self.shape = (self.layer['IH'] * self.layer['IW'], self.layer['CI'])
+        self.OUTPUT_UIDS = self.MODE_OUTPUT_UIDS[self.mode]
+
+    def output_ctype(self, uid):
+        return self.stat_ctype if uid in ['mean', 'var', 'running_mean', 'running_var'] \
+            else self.ctype
+
+    def get_input(self, uid, ctype=None):
+        return self.get_input_from_symbol(uid, ctype if ctype else self.ctype).astype(np.float64)
+
+    def get_actual_results(self):
+        return [self.get_output_from_symbol(uid, self.output_ctype(uid)).astype(np.float64)
+                for uid in self.OUTPUT_UIDS]
+
+    def get_expected_results(self):
+        ifmap = self.get_input('ifmap').reshape(self.shape)
+        gamma = self.get_input('gamma_')
+        if self.mode == 'INFERENCE':
+            return [ifmap * gamma + self.get_input('beta')]
+        elif self.mode == 'TRAINING':
+            return golden_model_training(ifmap, gamma, self.get_input('beta'),
+                                         self.get_input('running_mean', self.stat_ctype),
+                                         self.get_input('running_var', self.stat_ctype),
+                                         self.layer['eps'], self.layer['momentum'],
+                                         self.layer['relu'])
+        else:
+            return golden_model_backward(ifmap, self.get_input('grad_ofmap').reshape(self.shape),
+                                         gamma, self.get_input('mean', self.stat_ctype),
+                                         self.get_input('var', self.stat_ctype),
+                                         self.layer['eps'])
+
+    def check_results(self, actual, expected):
+        retcode = 0
+        for a, e in zip(actual, expected):
+            atol = self.ERR_THRESHOLD[self.prec] * np.max(np.abs(e))
+            retcode |= super().check_results(a, e, atol=atol)
+        return retcode
+
+
+if __name__ == "__main__":
+    sys.exit(BatchnormVerifier().main())
@@ -4,16 +4,96 @@
 
 #include "snrt.h"
 
+/**
+ * @brief Operating mode of the batchnorm layer.
+ * @details In inference mode, the layer applies the folded running
+ *          statistics, passed through the gamma and beta parameters. In
+ *          training mode, it normalizes the input with its own batch
+ *          statistics. In backward mode, it computes the gradients of a
+ *          training-mode forward pass.
+ */
+typedef enum {
+    BATCHNORM_INFERENCE,
+    BATCHNORM_TRAINING,
+    BATCHNORM_BACKWARD
+} batchnorm_mode_t;
+
+/**
+ * @struct batchnorm_layer_t
+ * @brief This structure contains all parameters necessary for computing a
+ *        batchnorm layer over a feature map in HWC layout. The batch
+ *        dimension, if any, is folded into the height.
+ * @var batchnorm_layer_t::TILE_CI
+ * Number of channels in every tile (inference mode only)
+ * @var batchnorm_layer_t::ifmap
+ * Pointer to the input feature map, also required in backward mode
+ * @var batchnorm_layer_t::ofmap
+ * Pointer to the output feature map (inference and training modes)
+ * @var batchnorm_layer_t::gamma
+ * Pointer to the scale parameters. In inference mode, these already include
+ * the running statistics
+ * @var batchnorm_layer_t::beta
+ * Pointer to the shift parameters. In inference mode, these already include
+ * the running statistics
+ * @var batchnorm_layer_t::dtype
+ * Precision of the feature maps and parameters. Only FP64 is supported in
+ * inference mode
+ * @var batchnorm_layer_t::mode
+ * Operating mode of the layer
+ * @var batchnorm_layer_t::relu
+ * Fuse a ReLU activation into the output of a training-mode forward pass
+ * @var batchnorm_layer_t::tile_pixels
+ * Number of pixels in every tile (training and backward modes), must be a
+ * multiple of 4
+ * @var batchnorm_layer_t::eps
+ * Constant added to the variance for numerical stability
+ * @var batchnorm_layer_t::momentum
+ * Weight of the batch statistics in the update of the running statistics
+ * @var batchnorm_layer_t::mean
+ * Pointer to the batch mean. Output of the training mode and input of the
+ * backward mode. Stored in double precision for FP64, and in single
+ * precision otherwise
+ * @var batchnorm_layer_t::var
+ * Pointer to the biased batch variance, with the same semantics and
+ * precision as the mean
+ * @var batchnorm_layer_t::running_mean
+ * Pointer to the running mean, updated in place in training mode if not
+ * NULL. Same precision as the mean
+ * @var batchnorm_layer_t::running_var
+ * Pointer to the running (unbiased) variance, updated in place in training
+ * mode if not NULL. Same precision as the mean
+ * @var batchnorm_layer_t::grad_ofmap
+ * Pointer to the gradient of the loss w.r.t. the output feature map
+ * @var batchnorm_layer_t::grad_ifmap
+ * Pointer to the gradient of the loss w.r.t. the input feature map
+ * @var batchnorm_layer_t::grad_gamma
+ * Pointer to the gradient of the loss w.r.t. the scale parameters
+ * @var batchnorm_layer_t::grad_beta
+ * Pointer to the gradient of the loss w.r.t. the shift parameters
+ */
 typedef struct {
     uint32_t CI;
     uint32_t IH;
     uint32_t IW;
     uint32_t TILE_CI;
-    double *ifmap;
-    double *ofmap;
-    double *gamma;
-    double *beta;
+    void *ifmap;
+    void *ofmap;
+    void *gamma;
+    void *beta;
     precision_t dtype;
+    batchnorm_mode_t mode;
+    uint32_t relu;
+    uint32_t tile_pixels;
+    float eps;
+    float momentum;
+    void *mean;
+    void *var;
+    void *running_mean;
+    void *running_var;
+    void *grad_ofmap;
+    void *grad_ifmap;
+    void *grad_gamma;
+    void *grad_beta;
 } batchnorm_layer_t;
 
 /**
@@ -69,12 +149,15 @@ static inline void batchnorm_fp64(double *ifmap, double *gamma, double *beta,
 #endif
 }
 
-static inline void batchnorm_layer(const batchnorm_layer_t *l) {
+static inline void batchnorm_layer_inference(const batchnorm_layer_t *l) {
     const uint32_t cluster_num = snrt_cluster_num();
     const uint32_t cluster_id = snrt_cluster_idx();
     const uint32_t compute_num = snrt_cluster_compute_core_num();
     const uint32_t compute_id = snrt_cluster_core_idx();
 
+    double *l_ifmap = (double *)l->ifmap;
+    double *l_ofmap = (double *)l->ofmap;
+
     // Calculate output dimensions
     uint32_t OH = l->IH;
     uint32_t OW = l->IW;
@@ -116,13 +199,13 @@ static inline void batchnorm_layer(const batchnorm_layer_t *l) {
                 if (l->TILE_CI == l->CI) {
                     // data layout is consecutively in memory
                     snrt_dma_start_1d(&ifmap[write_buf * ifmap_size / 2],
-                                      &l->ifmap[oh * l->IW * l->CI],
+                                      &l_ifmap[oh * l->IW * l->CI],
                                       sizeof(double) * l->IW * l->TILE_CI);
                 } else {
                     // data is interleaved
                     snrt_dma_start_2d(
                         &ifmap[write_buf * ifmap_size / 2], /* dst */
-                        &l->ifmap[oh * l->IW * l->CI + ci], /* src */
+                        &l_ifmap[oh * l->IW * l->CI + ci],  /* src */
                         sizeof(double) * l->TILE_CI,        /* size */
                         sizeof(double) * l->TILE_CI,        /* dst_stride */
                         sizeof(double) * l->CI,             /* src_stride */
@@ -136,13 +219,13 @@ static inline void batchnorm_layer(const batchnorm_layer_t *l) {
                 if (!(oh == cluster_id && ci == 0)) {
                     if (l->TILE_CI == l->CI) {
                         // data is stored consecutively
-                        snrt_dma_start_1d(&l->ofmap[prev_oh * OW * l->CI],
+                        snrt_dma_start_1d(&l_ofmap[prev_oh * OW * l->CI],
                                           &ofmap[!read_buf * (ofmap_size / 2)],
                                           sizeof(double) * l->IW * l->CI);
                     } else {
                         // data is stored in interleaved layout
                         snrt_dma_start_2d(
-                            &l->ofmap[prev_oh * OW * l->CI + prev_ci], /* dst */
+                            &l_ofmap[prev_oh * OW * l->CI + prev_ci],  /* dst */
                             &ofmap[!read_buf * (ofmap_size / 2)],      /* src */
                             sizeof(double) * l->TILE_CI, /* size */
                             sizeof(double) * l->CI,      /* dst_stride */
@@ -183,13 +266,13 @@ static inline void batchnorm_layer(const batchnorm_layer_t *l) {
     if (snrt_is_dm_core()) {
         if (l->TILE_CI == l->CI) {
             // data is stored consecutively
-            snrt_dma_start_1d(&l->ofmap[prev_oh * OW * l->CI],
+            snrt_dma_start_1d(&l_ofmap[prev_oh * OW * l->CI],
                               &ofmap[!read_buf * (ofmap_size / 2)],
                               sizeof(double) * l->IW * l->CI);
         } else {
             // data is stored in interleaved layout
             snrt_dma_start_2d(
-                &l->ofmap[prev_oh * OW * l->CI + prev_ci], /* dst */
+                &l_ofmap[prev_oh * OW * l->CI + prev_ci],  /* dst */
                 &ofmap[!read_buf * (ofmap_size / 2)],      /* src */
                 sizeof(double) * l->TILE_CI,               /* size */
                 sizeof(double) * l->CI,                    /* dst_stride */
@@ -200,3 +283,21 @@ static inline void batchnorm_layer(const batchnorm_layer_t *l) {
         snrt_dma_wait_all();
     }
 }
+
+#include "batchnorm_train.h"
+
+static inline void batchnorm_layer(const batchnorm_layer_t *l) {
+    switch (l->mode) {
+        case BATCHNORM_INFERENCE:
+            batchnorm_layer_inference(l);
+            break;
+        case BATCHNORM_TRAINING:
+            batchnorm_layer_training(l);
+            break;
+        case BATCHNORM_BACKWARD:
+            batchnorm_layer_backward(l);
+            break;
+        default:
+            break;
+    }
+}
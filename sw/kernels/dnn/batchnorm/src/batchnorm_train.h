@@ -0,0 +1,826 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Training-mode forward and backward batchnorm layers.
+//
+// Feature maps are streamed through TCDM in tiles of pixels, which are
+// distributed across clusters. Every compute core processes an interleaved
+// subset of the 64-bit words of a pixel, i.e. one (FP64), two (FP32) or four
+// (FP16) channels at a time, with the SIMD lanes operating on different
+// channels. Per-channel reductions are therefore local to a core, and only
+// need to be reduced across clusters.
+
+#include <math.h>
+
+/**
+ * @brief Passes over the feature maps, performed by `batchnorm_stream()`.
+ */
+typedef enum {
+    BATCHNORM_PASS_STATS,
+    BATCHNORM_PASS_NORMALIZE,
+    BATCHNORM_PASS_GRAD_STATS,
+    BATCHNORM_PASS_GRAD_INPUT
+} batchnorm_pass_t;
+
+/**
+ * @brief Per-channel reduction buffers and coefficients used by the passes.
+ * @details Reduction buffers hold one double-precision value per channel,
+ *          coefficients are in the precision of the feature maps.
+ */
+typedef struct {
+    double *sum;
+    double *sumsq;
+    void *a;
+    void *b;
+    void *c;
+    double lo;
+} batchnorm_pass_args_t;
+
+/**
+ * @brief Load element @p i of an array in the feature map precision.
+ */
+static inline double batchnorm_load(void *arr, uint32_t i, precision_t prec) {
+    switch (prec) {
+        case FP64:
+            return ((double *)arr)[i];
+        case FP32:
+            return ((float *)arr)[i];
+        case FP16:
+            return ((__fp16 *)arr)[i];
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Store element @p i of an array in the feature map precision.
+ */
+static inline void batchnorm_store(void *arr, uint32_t i, double val,
+                                   precision_t prec) {
+    switch (prec) {
+        case FP64:
+            ((double *)arr)[i] = val;
+            break;
+        case FP32:
+            ((float *)arr)[i] = (float)val;
+            break;
+        case FP16:
+            ((__fp16 *)arr)[i] = (__fp16)val;
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Load element @p i of a statistics array, which is stored in double
+ *        precision for FP64 feature maps, and in single precision otherwise.
+ */
+static inline double batchnorm_load_stat(void *arr, uint32_t i,
+                                         precision_t prec) {
+    if (prec == FP64) return ((double *)arr)[i];
+    return ((float *)arr)[i];
+}
+
+/**
+ * @brief Store element @p i of a statistics array.
+ */
+static inline void batchnorm_store_stat(void *arr, uint32_t i, double val,
+                                        precision_t prec) {
+    if (prec == FP64)
+        ((double *)arr)[i] = val;
+    else
+        ((float *)arr)[i] = (float)val;
+}
+
+/**
+ * @brief Replicate @p val over all SIMD lanes of a 64-bit word.
+ */
+static inline double batchnorm_splat(double val, precision_t prec) {
+    v2s v2;
+    v4s v4;
+    switch (prec) {
+        case FP32:
+            for (uint32_t i = 0; i < 2; i++) v2.vec[i] = (float)val;
+            return v2.f64;
+        case FP16:
+            for (uint32_t i = 0; i < 4; i++) v4.vec[i] = (__fp16)val;
+            return v4.f64;
+        default:
+            return val;
+    }
+}
+
+/**
+ * @brief Add the lanes of four packed accumulators to the per-channel sums
+ *        @p dst of a word.
+ * @details FP16 words are accumulated in single precision, so the
+ *          accumulators alternate between the lower and upper two channels
+ *          of the word.
+ */
+static inline void batchnorm_accumulate(double *dst, double *acc,
+                                        precision_t prec) {
+    v2s v;
+    switch (prec) {
+        case FP64:
+            dst[0] += (acc[0] + acc[1]) + (acc[2] + acc[3]);
+            break;
+        case FP32:
+            for (uint32_t i = 0; i < 4; i++) {
+                v.f64 = acc[i];
+                dst[0] += v.vec[0];
+                dst[1] += v.vec[1];
+            }
+            break;
+        case FP16:
+            for (uint32_t i = 0; i < 4; i++) {
+                v.f64 = acc[i];
+                dst[2 * (i % 2)] += v.vec[0];
+                dst[2 * (i % 2) + 1] += v.vec[1];
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Configure the SSRs @p dm to stream over the words of the calling
+ *        core, for all pixels of a tile.
+ */
+static inline void batchnorm_ssr_setup(snrt_ssr_dm_t dm, uint32_t n_pixels,
+                                       uint32_t n_words, uint32_t CI,
+                                       precision_t prec) {
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    snrt_ssr_loop_2d(dm, n_pixels, n_words, CI * prec,
+                     num_cores * sizeof(double));
+}
+
+/**
+ * @brief Accumulate the per-channel sums and sums of squares of a tile.
+ * @details The input is streamed through all three SSRs, so that every
+ *          instruction reads each element from a different stream. Four
+ *          independent accumulators hide the FPU latency. FP16 inputs are
+ *          widened to FP32 for accumulation.
+ */
+static inline void batchnorm_tile_stats(void *x, double *sum, double *sumsq,
+                                        uint32_t n_pixels, uint32_t CI,
+                                        precision_t prec) {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    uint32_t lanes = sizeof(double) / prec;
+    uint32_t n_words = CI / lanes / num_cores;
+    double *x_w = (double *)x + core_idx;
+
+    batchnorm_ssr_setup(SNRT_SSR_DM0, n_pixels, n_words, CI, prec);
+    batchnorm_ssr_setup(SNRT_SSR_DM1, n_pixels, n_words, CI, prec);
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_2D, x_w);
+    snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_2D, x_w);
+    if (prec != FP16) {
+        batchnorm_ssr_setup(SNRT_SSR_DM2, n_pixels, n_words, CI, prec);
+        snrt_ssr_read(SNRT_SSR_DM2, SNRT_SSR_2D, x_w);
+    }
+    snrt_ssr_enable();
+
+    for (uint32_t w = 0; w < n_words; w++) {
+        double s[4] = {0, 0, 0, 0};
+        double q[4] = {0, 0, 0, 0};
+        double t[4];
+
+        switch (prec) {
+            case FP64:
+                asm volatile(
+                    "frep.o %[n_frep], 8, 0, 0 \n"
+                    "fadd.d %[s0], %[s0], ft0 \n"
+                    "fadd.d %[s1], %[s1], ft0 \n"
+                    "fadd.d %[s2], %[s2], ft0 \n"
+                    "fadd.d %[s3], %[s3], ft0 \n"
+                    "fmadd.d %[q0], ft1, ft2, %[q0] \n"
+                    "fmadd.d %[q1], ft1, ft2, %[q1] \n"
+                    "fmadd.d %[q2], ft1, ft2, %[q2] \n"
+                    "fmadd.d %[q3], ft1, ft2, %[q3] \n"
+                    : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]),
+                      [ s2 ] "+f"(s[2]), [ s3 ] "+f"(s[3]),
+                      [ q0 ] "+f"(q[0]), [ q1 ] "+f"(q[1]),
+                      [ q2 ] "+f"(q[2]), [ q3 ] "+f"(q[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1)
+                    : "ft0", "ft1", "ft2");
+                break;
+            case FP32:
+                asm volatile(
+                    "frep.o %[n_frep], 8, 0, 0 \n"
+                    "vfadd.s %[s0], %[s0], ft0 \n"
+                    "vfadd.s %[s1], %[s1], ft0 \n"
+                    "vfadd.s %[s2], %[s2], ft0 \n"
+                    "vfadd.s %[s3], %[s3], ft0 \n"
+                    "vfmac.s %[q0], ft1, ft2 \n"
+                    "vfmac.s %[q1], ft1, ft2 \n"
+                    "vfmac.s %[q2], ft1, ft2 \n"
+                    "vfmac.s %[q3], ft1, ft2 \n"
+                    : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]),
+                      [ s2 ] "+f"(s[2]), [ s3 ] "+f"(s[3]),
+                      [ q0 ] "+f"(q[0]), [ q1 ] "+f"(q[1]),
+                      [ q2 ] "+f"(q[2]), [ q3 ] "+f"(q[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1)
+                    : "ft0", "ft1", "ft2");
+                break;
+            case FP16:
+                // Two pixels per iteration, each widened into a lower and
+                // an upper pair of channels
+                asm volatile(
+                    "frep.o %[n_frep], 12, 0, 0 \n"
+                    "vfcvt.s.h %[t0], ft0 \n"
+                    "vfcvtu.s.h %[t1], ft1 \n"
+                    "vfcvt.s.h %[t2], ft0 \n"
+                    "vfcvtu.s.h %[t3], ft1 \n"
+                    "vfadd.s %[s0], %[s0], %[t0] \n"
+                    "vfadd.s %[s1], %[s1], %[t1] \n"
+                    "vfadd.s %[s2], %[s2], %[t2] \n"
+                    "vfadd.s %[s3], %[s3], %[t3] \n"
+                    "vfmac.s %[q0], %[t0], %[t0] \n"
+                    "vfmac.s %[q1], %[t1], %[t1] \n"
+                    "vfmac.s %[q2], %[t2], %[t2] \n"
+                    "vfmac.s %[q3], %[t3], %[t3] \n"
+                    : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]),
+                      [ s2 ] "+f"(s[2]), [ s3 ] "+f"(s[3]),
+                      [ q0 ] "+f"(q[0]), [ q1 ] "+f"(q[1]),
+                      [ q2 ] "+f"(q[2]), [ q3 ] "+f"(q[3]),
+                      [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+                      [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+                    : [ n_frep ] "r"(n_pixels / 2 - 1)
+                    : "ft0", "ft1", "ft2");
+                break;
+            default:
+                break;
+        }
+
+        // Fold the accumulators into the sums of the word's channels,
+        // pausing the streams while the core computes on FP registers
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+        uint32_t ch = (core_idx + w * num_cores) * lanes;
+        batchnorm_accumulate(&sum[ch], s, prec);
+        batchnorm_accumulate(&sumsq[ch], q, prec);
+        snrt_ssr_enable();
+    }
+
+    snrt_ssr_disable();
+}
+
+/**
+ * @brief Normalize a tile as y = max(a * x + b, lo), with per-channel
+ *        coefficients @p a and @p b, where @p lo is zero for a fused ReLU
+ *        and minus infinity otherwise.
+ */
+static inline void batchnorm_tile_normalize(void *x, void *y, void *a, void *b,
+                                            double lo, uint32_t n_pixels,
+                                            uint32_t CI, precision_t prec) {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    uint32_t lanes = sizeof(double) / prec;
+    uint32_t n_words = CI / lanes / num_cores;
+
+    batchnorm_ssr_setup(SNRT_SSR_DM0, n_pixels, n_words, CI, prec);
+    batchnorm_ssr_setup(SNRT_SSR_DM1, n_pixels, n_words, CI, prec);
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_2D, (double *)x + core_idx);
+    snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_2D, (double *)y + core_idx);
+    snrt_ssr_enable();
+
+    for (uint32_t w = core_idx; w < n_words * num_cores; w += num_cores) {
+        double a_w = ((double *)a)[w];
+        double b_w = ((double *)b)[w];
+        double t[4];
+
+        switch (prec) {
+            case FP64:
+                asm volatile(
+                    "frep.o %[n_frep], 8, 0, 0 \n"
+                    "fmadd.d %[t0], ft0, %[a], %[b] \n"
+                    "fmadd.d %[t1], ft0, %[a], %[b] \n"
+                    "fmadd.d %[t2], ft0, %[a], %[b] \n"
+                    "fmadd.d %[t3], ft0, %[a], %[b] \n"
+                    "fmax.d ft1, %[t0], %[lo] \n"
+                    "fmax.d ft1, %[t1], %[lo] \n"
+                    "fmax.d ft1, %[t2], %[lo] \n"
+                    "fmax.d ft1, %[t3], %[lo] \n"
+                    : [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+                      [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1), [ a ] "f"(a_w),
+                      [ b ] "f"(b_w), [ lo ] "f"(lo)
+                    : "ft0", "ft1", "ft2");
+                break;
+            case FP32:
+                asm volatile(
+                    "frep.o %[n_frep], 12, 0, 0 \n"
+                    "vfmul.s %[t0], ft0, %[a] \n"
+                    "vfmul.s %[t1], ft0, %[a] \n"
+                    "vfmul.s %[t2], ft0, %[a] \n"
+                    "vfmul.s %[t3], ft0, %[a] \n"
+                    "vfadd.s %[t0], %[t0], %[b] \n"
+                    "vfadd.s %[t1], %[t1], %[b] \n"
+                    "vfadd.s %[t2], %[t2], %[b] \n"
+                    "vfadd.s %[t3], %[t3], %[b] \n"
+                    "vfmax.s ft1, %[t0], %[lo] \n"
+                    "vfmax.s ft1, %[t1], %[lo] \n"
+                    "vfmax.s ft1, %[t2], %[lo] \n"
+                    "vfmax.s ft1, %[t3], %[lo] \n"
+                    : [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+                      [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1), [ a ] "f"(a_w),
+                      [ b ] "f"(b_w), [ lo ] "f"(lo)
+                    : "ft0", "ft1", "ft2");
+                break;
+            case FP16:
+                asm volatile(
+                    "frep.o %[n_frep], 12, 0, 0 \n"
+                    "vfmul.h %[t0], ft0, %[a] \n"
+                    "vfmul.h %[t1], ft0, %[a] \n"
+                    "vfmul.h %[t2], ft0, %[a] \n"
+                    "vfmul.h %[t3], ft0, %[a] \n"
+                    "vfadd.h %[t0], %[t0], %[b] \n"
+                    "vfadd.h %[t1], %[t1], %[b] \n"
+                    "vfadd.h %[t2], %[t2], %[b] \n"
+                    "vfadd.h %[t3], %[t3], %[b] \n"
+                    "vfmax.h ft1, %[t0], %[lo] \n"
+                    "vfmax.h ft1, %[t1], %[lo] \n"
+                    "vfmax.h ft1, %[t2], %[lo] \n"
+                    "vfmax.h ft1, %[t3], %[lo] \n"
+                    : [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+                      [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1), [ a ] "f"(a_w),
+                      [ b ] "f"(b_w), [ lo ] "f"(lo)
+                    : "ft0", "ft1", "ft2");
+                break;
+            default:
+                break;
+        }
+    }
+
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+}
+
+/**
+ * @brief Accumulate the per-channel sums of the output gradients dy, and of
+ *        their products with the inputs x, over a tile.
+ * @details The output gradients are streamed through SSRs 0 and 1, the
+ *          inputs through SSR 2. FP16 inputs are copied to a register,
+ *          so that they can be widened in two halves from a single stream.
+ */
+static inline void batchnorm_tile_grad_stats(void *dy, void *x,
+                                             double *sum_dy, double *sum_dyx,
+                                             uint32_t n_pixels, uint32_t CI,
+                                             precision_t prec) {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    uint32_t lanes = sizeof(double) / prec;
+    uint32_t n_words = CI / lanes / num_cores;
+    double *dy_w = (double *)dy + core_idx;
+
+    batchnorm_ssr_setup(SNRT_SSR_DM0, n_pixels, n_words, CI, prec);
+    batchnorm_ssr_setup(SNRT_SSR_DM1, n_pixels, n_words, CI, prec);
+    batchnorm_ssr_setup(SNRT_SSR_DM2, n_pixels, n_words, CI, prec);
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_2D, dy_w);
+    snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_2D, dy_w);
+    snrt_ssr_read(SNRT_SSR_DM2, SNRT_SSR_2D, (double *)x + core_idx);
+    snrt_ssr_enable();
+
+    double zero = 0;
+    for (uint32_t w = 0; w < n_words; w++) {
+        double s[4] = {0, 0, 0, 0};
+        double q[4] = {0, 0, 0, 0};
+        double t[2], u[2], v;
+
+        switch (prec) {
+            case FP64:
+                asm volatile(
+                    "frep.o %[n_frep], 8, 0, 0 \n"
+                    "fadd.d %[s0], %[s0], ft0 \n"
+                    "fadd.d %[s1], %[s1], ft0 \n"
+                    "fadd.d %[s2], %[s2], ft0 \n"
+                    "fadd.d %[s3], %[s3], ft0 \n"
+                    "fmadd.d %[q0], ft1, ft2, %[q0] \n"
+                    "fmadd.d %[q1], ft1, ft2, %[q1] \n"
+                    "fmadd.d %[q2], ft1, ft2, %[q2] \n"
+                    "fmadd.d %[q3], ft1, ft2, %[q3] \n"
+                    : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]),
+                      [ s2 ] "+f"(s[2]), [ s3 ] "+f"(s[3]),
+                      [ q0 ] "+f"(q[0]), [ q1 ] "+f"(q[1]),
+                      [ q2 ] "+f"(q[2]), [ q3 ] "+f"(q[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1)
+                    : "ft0", "ft1", "ft2");
+                break;
+            case FP32:
+                asm volatile(
+                    "frep.o %[n_frep], 8, 0, 0 \n"
+                    "vfadd.s %[s0], %[s0], ft0 \n"
+                    "vfadd.s %[s1], %[s1], ft0 \n"
+                    "vfadd.s %[s2], %[s2], ft0 \n"
+                    "vfadd.s %[s3], %[s3], ft0 \n"
+                    "vfmac.s %[q0], ft1, ft2 \n"
+                    "vfmac.s %[q1], ft1, ft2 \n"
+                    "vfmac.s %[q2], ft1, ft2 \n"
+                    "vfmac.s %[q3], ft1, ft2 \n"
+                    : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]),
+                      [ s2 ] "+f"(s[2]), [ s3 ] "+f"(s[3]),
+                      [ q0 ] "+f"(q[0]), [ q1 ] "+f"(q[1]),
+                      [ q2 ] "+f"(q[2]), [ q3 ] "+f"(q[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1)
+                    : "ft0", "ft1", "ft2");
+                break;
+            case FP16:
+                // One pixel per iteration, to fit the FREP sequencer: t
+                // holds the widened output gradients, u the widened inputs
+                // and v the input copy
+                asm volatile(
+                    "frep.o %[n_frep], 9, 0, 0 \n"
+                    "vfcvt.s.h %[t0], ft0 \n"
+                    "vfcvtu.s.h %[t1], ft1 \n"
+                    "vfadd.h %[v], ft2, %[zero] \n"
+                    "vfcvt.s.h %[u0], %[v] \n"
+                    "vfcvtu.s.h %[u1], %[v] \n"
+                    "vfadd.s %[s0], %[s0], %[t0] \n"
+                    "vfadd.s %[s1], %[s1], %[t1] \n"
+                    "vfmac.s %[q0], %[t0], %[u0] \n"
+                    "vfmac.s %[q1], %[t1], %[u1] \n"
+                    : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]),
+                      [ q0 ] "+f"(q[0]), [ q1 ] "+f"(q[1]),
+                      [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+                      [ u0 ] "=&f"(u[0]), [ u1 ] "=&f"(u[1]), [ v ] "=&f"(v)
+                    : [ n_frep ] "r"(n_pixels - 1), [ zero ] "f"(zero)
+                    : "ft0", "ft1", "ft2");
+                break;
+            default:
+                break;
+        }
+
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+        uint32_t ch = (core_idx + w * num_cores) * lanes;
+        batchnorm_accumulate(&sum_dy[ch], s, prec);
+        batchnorm_accumulate(&sum_dyx[ch], q, prec);
+        snrt_ssr_enable();
+    }
+
+    snrt_ssr_disable();
+}
+
+/**
+ * @brief Compute the input gradients of a tile as dx = a * dy + b * x + c,
+ *        with per-channel coefficients @p a, @p b and @p c.
+ */
+static inline void batchnorm_tile_grad_input(void *dy, void *x, void *dx,
+                                             void *a, void *b, void *c,
+                                             uint32_t n_pixels, uint32_t CI,
+                                             precision_t prec) {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    uint32_t lanes = sizeof(double) / prec;
+    uint32_t n_words = CI / lanes / num_cores;
+
+    batchnorm_ssr_setup(SNRT_SSR_DM0, n_pixels, n_words, CI, prec);
+    batchnorm_ssr_setup(SNRT_SSR_DM1, n_pixels, n_words, CI, prec);
+    batchnorm_ssr_setup(SNRT_SSR_DM2, n_pixels, n_words, CI, prec);
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_2D, (double *)dy + core_idx);
+    snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_2D, (double *)dx + core_idx);
+    snrt_ssr_read(SNRT_SSR_DM2, SNRT_SSR_2D, (double *)x + core_idx);
+    snrt_ssr_enable();
+
+    for (uint32_t w = core_idx; w < n_words * num_cores; w += num_cores) {
+        double a_w = ((double *)a)[w];
+        double b_w = ((double *)b)[w];
+        double c_w = ((double *)c)[w];
+        double t[4];
+
+        switch (prec) {
+            case FP64:
+                asm volatile(
+                    "frep.o %[n_frep], 8, 0, 0 \n"
+                    "fmadd.d %[t0], ft0, %[a], %[c] \n"
+                    "fmadd.d %[t1], ft0, %[a], %[c] \n"
+                    "fmadd.d %[t2], ft0, %[a], %[c] \n"
+                    "fmadd.d %[t3], ft0, %[a], %[c] \n"
+                    "fmadd.d ft1, ft2, %[b], %[t0] \n"
+                    "fmadd.d ft1, ft2, %[b], %[t1] \n"
+                    "fmadd.d ft1, ft2, %[b], %[t2] \n"
+                    "fmadd.d ft1, ft2, %[b], %[t3] \n"
+                    : [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+                      [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1), [ a ] "f"(a_w),
+                      [ b ] "f"(b_w), [ c ] "f"(c_w)
+                    : "ft0", "ft1", "ft2");
+                break;
+            case FP32:
+                asm volatile(
+                    "frep.o %[n_frep], 12, 0, 0 \n"
+                    "vfmul.s %[t0], ft2, %[b] \n"
+                    "vfmul.s %[t1], ft2, %[b] \n"
+                    "vfmul.s %[t2], ft2, %[b] \n"
+                    "vfmul.s %[t3], ft2, %[b] \n"
+                    "vfmac.s %[t0], ft0, %[a] \n"
+                    "vfmac.s %[t1], ft0, %[a] \n"
+                    "vfmac.s %[t2], ft0, %[a] \n"
+                    "vfmac.s %[t3], ft0, %[a] \n"
+                    "vfadd.s ft1, %[t0], %[c] \n"
+                    "vfadd.s ft1, %[t1], %[c] \n"
+                    "vfadd.s ft1, %[t2], %[c] \n"
+                    "vfadd.s ft1, %[t3], %[c] \n"
+                    : [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+                      [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1), [ a ] "f"(a_w),
+                      [ b ] "f"(b_w), [ c ] "f"(c_w)
+                    : "ft0", "ft1", "ft2");
+                break;
+            case FP16:
+                asm volatile(
+                    "frep.o %[n_frep], 12, 0, 0 \n"
+                    "vfmul.h %[t0], ft2, %[b] \n"
+                    "vfmul.h %[t1], ft2, %[b] \n"
+                    "vfmul.h %[t2], ft2, %[b] \n"
+                    "vfmul.h %[t3], ft2, %[b] \n"
+                    "vfmac.h %[t0], ft0, %[a] \n"
+                    "vfmac.h %[t1], ft0, %[a] \n"
+                    "vfmac.h %[t2], ft0, %[a] \n"
+                    "vfmac.h %[t3], ft0, %[a] \n"
+                    "vfadd.h ft1, %[t0], %[c] \n"
+                    "vfadd.h ft1, %[t1], %[c] \n"
+                    "vfadd.h ft1, %[t2], %[c] \n"
+                    "vfadd.h ft1, %[t3], %[c] \n"
+                    : [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+                      [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+                    : [ n_frep ] "r"(n_pixels / 4 - 1), [ a ] "f"(a_w),
+                      [ b ] "f"(b_w), [ c ] "f"(c_w)
+                    : "ft0", "ft1", "ft2");
+                break;
+            default:
+                break;
+        }
+    }
+
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+}
+
+/**
+ * @brief Stream the cluster's tiles of the feature maps through TCDM, and
+ *        process them with @p pass.
+ * @details Up to two input feature maps (@p src0, @p src1) and one output
+ *          feature map (@p dst) are double-buffered in @p buf, so that the
+ *          DMA core loads the next tile and stores the previous one while
+ *          the compute cores process the current one.
+ */
+static inline void batchnorm_stream(const batchnorm_layer_t *l,
+                                    batchnorm_pass_t pass, void *src0,
+                                    void *src1, void *dst, char *buf[3][2],
+                                    batchnorm_pass_args_t *args) {
+    uint32_t n_tiles_total = l->IH * l->IW / l->tile_pixels;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t first_tile = n_tiles_total * cluster_idx / num_clusters;
+    uint32_t last_tile = n_tiles_total * (cluster_idx + 1) / num_clusters;
+    uint32_t n_tiles = last_tile - first_tile;
+    uint32_t tile_bytes = l->tile_pixels * l->CI * l->dtype;
+    void *src[2] = {src0, src1};
+
+    // Software pipeline: in iteration i the DMA loads tile i and stores tile
+    // i - 2, while the compute cores process tile i - 1
+    for (uint32_t i = 0; i < n_tiles + 2; i++) {
+        if (snrt_is_dm_core()) {
+            uint32_t offset = (first_tile + i) * tile_bytes;
+            for (uint32_t j = 0; j < 2; j++) {
+                if (src[j] && i < n_tiles)
+                    snrt_dma_start_1d(buf[j][i % 2], (char *)src[j] + offset,
+                                      tile_bytes);
+            }
+            if (dst && i >= 2)
+                snrt_dma_start_1d((char *)dst + offset - 2 * tile_bytes,
+                                  buf[2][i % 2], tile_bytes);
+            snrt_dma_wait_all();
+        }
+
+        if (snrt_is_compute_core() && i >= 1 && i <= n_tiles) {
+            uint32_t b = (i - 1) % 2;
+            switch (pass) {
+                case BATCHNORM_PASS_STATS:
+                    batchnorm_tile_stats(buf[0][b], args->sum, args->sumsq,
+                                         l->tile_pixels, l->CI, l->dtype);
+                    break;
+                case BATCHNORM_PASS_NORMALIZE:
+                    batchnorm_tile_normalize(buf[0][b], buf[2][b], args->a,
+                                             args->b, args->lo, l->tile_pixels,
+                                             l->CI, l->dtype);
+                    break;
+                case BATCHNORM_PASS_GRAD_STATS:
+                    batchnorm_tile_grad_stats(buf[0][b], buf[1][b], args->sum,
+                                              args->sumsq, l->tile_pixels,
+                                              l->CI, l->dtype);
+                    break;
+                case BATCHNORM_PASS_GRAD_INPUT:
+                    batchnorm_tile_grad_input(
+                        buf[0][b], buf[1][b], buf[2][b], args->a, args->b,
+                        args->c, l->tile_pixels, l->CI, l->dtype);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        snrt_cluster_hw_barrier();
+    }
+}
+
+/**
+ * @brief Allocate the TCDM buffers of the training and backward layers.
+ * @details The allocation must be identical in all clusters, as the
+ *          reduced sums are read from cluster 0's TCDM. The reduction
+ *          buffers hold the per-channel sums followed by the sums of
+ *          squares (or of products), and are cleared.
+ */
+static inline void batchnorm_alloc(const batchnorm_layer_t *l, char *buf[3][2],
+                                   double **red_src, double **red_dst,
+                                   batchnorm_pass_args_t *args) {
+    uint32_t tile_bytes = l->tile_pixels * l->CI * l->dtype;
+    uint32_t coeff_bytes = l->CI * l->dtype;
+    for (uint32_t j = 0; j < 3; j++) {
+        for (uint32_t i = 0; i < 2; i++) {
+            buf[j][i] = (char *)snrt_l1_alloc_cluster_local(
+                tile_bytes, alignof(double));
+        }
+    }
+    *red_src = (double *)snrt_l1_alloc_cluster_local(
+        2 * l->CI * sizeof(double), alignof(double));
+    *red_dst = (double *)snrt_l1_alloc_cluster_local(
+        2 * l->CI * sizeof(double), alignof(double));
+    args->a = snrt_l1_alloc_cluster_local(coeff_bytes, alignof(double));
+    args->b = snrt_l1_alloc_cluster_local(coeff_bytes, alignof(double));
+    args->c = snrt_l1_alloc_cluster_local(coeff_bytes, alignof(double));
+    args->sum = *red_src;
+    args->sumsq = *red_src + l->CI;
+
+    if (snrt_is_compute_core()) {
+        uint32_t core_idx = snrt_cluster_core_idx();
+        uint32_t num_cores = snrt_cluster_compute_core_num();
+        for (uint32_t i = core_idx; i < 2 * l->CI; i += num_cores)
+            (*red_src)[i] = 0;
+    }
+    snrt_cluster_hw_barrier();
+}
+
+/**
+ * @brief Sum the per-channel reduction buffers of all clusters, and make the
+ *        result available in the TCDM of every cluster.
+ * @returns A pointer to the reduced sums.
+ */
+static inline double *batchnorm_allreduce(const batchnorm_layer_t *l,
+                                          double *red_src, double *red_dst) {
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t len = 2 * l->CI;
+
+    // Sum the partial results of all clusters in cluster 0
+    snrt_global_reduction_dma(red_dst, red_src, len);
+    snrt_global_barrier();
+
+    // Broadcast the result from cluster 0's TCDM
+    if (cluster_idx == 0) return red_src;
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(red_dst, snrt_remote_l1_ptr(red_src, cluster_idx, 0),
+                          len * sizeof(double));
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+    return red_dst;
+}
+
+/**
+ * @brief Training-mode forward batchnorm layer.
+ * @details Normalizes the input with the mean and biased variance over all
+ *          pixels of every channel, computed in double precision from the
+ *          per-channel sums and sums of squares, and applies the affine
+ *          transformation and the optional ReLU in a single pass. The batch
+ *          statistics are stored, and the running statistics updated, by
+ *          cluster 0. Every cluster must call this function.
+ */
+static inline void batchnorm_layer_training(const batchnorm_layer_t *l) {
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    precision_t prec = l->dtype;
+    uint32_t CI = l->CI;
+    double M = (double)l->IH * l->IW;
+
+    char *buf[3][2];
+    double *red_src, *red_dst;
+    batchnorm_pass_args_t args;
+    batchnorm_alloc(l, buf, &red_src, &red_dst, &args);
+
+    // Pass 1: per-channel sums and sums of squares
+    batchnorm_stream(l, BATCHNORM_PASS_STATS, l->ifmap, NULL, NULL, buf,
+                     &args);
+    double *sum = batchnorm_allreduce(l, red_src, red_dst);
+    double *sumsq = sum + CI;
+
+    // Fold statistics and affine parameters into per-channel coefficients
+    if (snrt_is_compute_core()) {
+        for (uint32_t c = core_idx; c < CI; c += num_cores) {
+            double mean = sum[c] / M;
+            double var = sumsq[c] / M - mean * mean;
+            if (var < 0) var = 0;
+            double scale =
+                batchnorm_load(l->gamma, c, prec) / sqrt(var + l->eps);
+            batchnorm_store(args.a, c, scale, prec);
+            batchnorm_store(args.b, c,
+                            batchnorm_load(l->beta, c, prec) - mean * scale,
+                            prec);
+
+            if (cluster_idx == 0) {
+                double m = l->momentum;
+                batchnorm_store_stat(l->mean, c, mean, prec);
+                batchnorm_store_stat(l->var, c, var, prec);
+                if (l->running_mean) {
+                    double rm = batchnorm_load_stat(l->running_mean, c, prec);
+                    batchnorm_store_stat(l->running_mean, c,
+                                         (1 - m) * rm + m * mean, prec);
+                }
+                if (l->running_var) {
+                    double rv = batchnorm_load_stat(l->running_var, c, prec);
+                    double unbiased = var * M / (M - 1);
+                    batchnorm_store_stat(l->running_var, c,
+                                         (1 - m) * rv + m * unbiased, prec);
+                }
+            }
+        }
+        args.lo = l->relu ? 0 : batchnorm_splat(-INFINITY, prec);
+    }
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+
+    // Pass 2: normalization, affine transformation and ReLU
+    snrt_mcycle();
+    batchnorm_stream(l, BATCHNORM_PASS_NORMALIZE, l->ifmap, NULL, l->ofmap,
+                     buf, &args);
+    snrt_mcycle();
+
+    snrt_global_barrier();
+}
+
+/**
+ * @brief Backward batchnorm layer, for a training-mode forward pass.
+ * @details Computes the parameter gradients dbeta = sum(dy) and
+ *          dgamma = sum(dy * xhat) from the per-channel sums of dy and
+ *          dy * x, and the input gradients
+ *          dx = gamma * istd * (dy - (dbeta + xhat * dgamma) / M), which are
+ *          affine in dy and x, in a second pass. The gradient of a fused
+ *          ReLU must already be applied to dy. Every cluster must call this
+ *          function.
+ */
+static inline void batchnorm_layer_backward(const batchnorm_layer_t *l) {
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    precision_t prec = l->dtype;
+    uint32_t CI = l->CI;
+    double M = (double)l->IH * l->IW;
+
+    char *buf[3][2];
+    double *red_src, *red_dst;
+    batchnorm_pass_args_t args;
+    batchnorm_alloc(l, buf, &red_src, &red_dst, &args);
+
+    // Pass 1: per-channel sums of dy and dy * x
+    batchnorm_stream(l, BATCHNORM_PASS_GRAD_STATS, l->grad_ofmap, l->ifmap,
+                     NULL, buf, &args);
+    double *sum_dy = batchnorm_allreduce(l, red_src, red_dst);
+    double *sum_dyx = sum_dy + CI;
+
+    // Parameter gradients and per-channel coefficients of dx
+    if (snrt_is_compute_core()) {
+        for (uint32_t c = core_idx; c < CI; c += num_cores) {
+            double mean = batchnorm_load_stat(l->mean, c, prec);
+            double istd =
+                1 / sqrt(batchnorm_load_stat(l->var, c, prec) + l->eps);
+            double dbeta = sum_dy[c];
+            double dgamma = istd * (sum_dyx[c] - mean * sum_dy[c]);
+            double a = batchnorm_load(l->gamma, c, prec) * istd;
+            double b = -a * istd * dgamma / M;
+            batchnorm_store(args.a, c, a, prec);
+            batchnorm_store(args.b, c, b, prec);
+            batchnorm_store(args.c, c, -a * dbeta / M - b * mean, prec);
+
+            if (cluster_idx == 0) {
+                batchnorm_store(l->grad_gamma, c, dgamma, prec);
+                batchnorm_store(l->grad_beta, c, dbeta, prec);
+            }
+        }
+    }
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+
+    // Pass 2: input gradients
+    snrt_mcycle();
+    batchnorm_stream(l, BATCHNORM_PASS_GRAD_INPUT, l->grad_ofmap, l->ifmap,
+                     l->grad_ifmap, buf, &args);
+    snrt_mcycle();
+
+    snrt_global_barrier();
+}
@@ -7,4 +7,5 @@
 include $(SN_ROOT)/sw/kernels/datagen.mk
 $(APP)_INCDIRS += $(SN_ROOT)/sw/kernels/dnn/src
 $(APP)_INCDIRS += $(SN_ROOT)/sw/kernels/blas
+$(APP)_INCDIRS += $(SN_ROOT)/sw/kernels/misc
 include $(SN_ROOT)/sw/kernels/common.mk
@@ -18,6 +18,8 @@
  * Pointer to an array of pointers to the individual tensors to concatenate
  * @var concat_layer_t::output
  * Pointer to the concatenated output tensor
+ * @var concat_layer_t::dtype
+ * Precision of the tensors
  */
 typedef struct {
     uint32_t num_inputs;
@@ -27,33 +29,53 @@ typedef struct {
     uint32_t dtype;
 } concat_layer_t;
 
+/**
+ * @brief Initialize a tensor view of the concatenation of the input tensors
+ *        along the innermost axis, without materializing it.
+ * @details Tiles of the view can be loaded directly by the tile loaders of
+ *          the consuming layer. Storing tiles to the view, conversely,
+ *          splits them into the input tensors.
+ * @param l Concat layer describing the input tensors
+ * @param parts Array of at least @p l.num_inputs parts backing the view
+ */
+static inline snrt_dma_view_t concat_view(concat_layer_t l,
+                                          snrt_dma_view_part_t *parts) {
+    for (uint32_t i = 0; i < l.num_inputs; i++) {
+        parts[i].ptr = l.inputs[i];
+        parts[i].x1_offset = 0;
+        parts[i].x0_offset = i * l.input_shape[1];
+        parts[i].x1_size = l.input_shape[0];
+        parts[i].x0_size = l.input_shape[1];
+        parts[i].ld = l.input_shape[1];
+    }
+    snrt_dma_view_t view = {.num_parts = l.num_inputs, .parts = parts};
+    return view;
+}
+
 // Concatenates a series of input tensors along the innermost axis.
-// Every cluster stores one of the input tensors in the output tensor, all
-// clusters operate in parallel.
-// Note: currently requires that the number of inputs is smaller than the
-// number of clusters in the system.
+// The rows of the output tensor are distributed across clusters, and every
+// cluster copies its rows of all input tensors. The concatenation is fully
+// performed by the DMA engines, for any number of inputs and precision.
 static inline int concat_layer(concat_layer_t l) {
-    // Return error if number of input tensors is greater than number of
-    // clusters
-    if (l.num_inputs > snrt_cluster_num()) return 1;
+    snrt_dma_view_part_t *parts =
+        (snrt_dma_view_part_t *)snrt_l1_alloc_cluster_local(
+            l.num_inputs * sizeof(snrt_dma_view_part_t),
+            alignof(snrt_dma_view_part_t));
 
-    // Perform the concatenation
     if (snrt_is_dm_core()) {
-        if (snrt_cluster_idx() < l.num_inputs) {
-            size_t row_size = l.input_shape[1] * sizeof(double);
-            size_t concatenated_row_size = row_size * l.num_inputs;
-            uintptr_t input = (uintptr_t)l.inputs[snrt_cluster_idx()];
-            uintptr_t output =
-                (uintptr_t)l.output + snrt_cluster_idx() * row_size;
-            snrt_dma_start_2d(output,                 // dst
-                              input,                  // src
-                              row_size,               // size
-                              concatenated_row_size,  // dst_stride
-                              row_size,               // src_stride
-                              l.input_shape[0]        // repeat
-            );
-            snrt_dma_wait_all();
-        }
+        snrt_dma_view_t view = concat_view(l, parts);
+
+        // Rows beyond the end of the tensor are clipped by the view
+        uint32_t rows_per_cluster =
+            (l.input_shape[0] + snrt_cluster_num() - 1) / snrt_cluster_num();
+        uint32_t row_size = l.input_shape[1] * l.num_inputs * l.dtype;
+        void *output =
+            (char *)l.output + snrt_cluster_idx() * rows_per_cluster * row_size;
+        snrt_dma_load_2d_tile_view(output, &view, snrt_cluster_idx(), 0,
+                                   rows_per_cluster,
+                                   l.input_shape[1] * l.num_inputs, l.dtype,
+                                   row_size);
+        snrt_dma_wait_all();
     }
 
     snrt_global_barrier();
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import pyflexfloat as ff
+import sys
+
+import snitch.util.sim.data_utils as du
+
+np.random.seed(42)
+
+# AXI splits bursts crossing 4KB address boundaries. To minimize
+# the occurrence of these splits the data should be aligned to 4KB
+BURST_ALIGNMENT = 4096
+
+
+def output_size(size, filter_size, stride, dilation, padding):
+    return (size + 2 * padding - dilation * (filter_size - 1) - 1) // stride + 1
+
+
+class Conv2dIgemmDataGen(du.DataGen):
+
+    # Unroll factor of the optimized GEMM kernels along N
+    GEMM_UNROLL = 8
+    POOL_MODES = ['POOL_MAX', 'POOL_AVG']
+
+    def golden_model(self, ifmap, weights, stride, dilation, padding, groups):
+        """Grouped 2D convolution of an NHWC feature map."""
+        N, H, W, CI = ifmap.shape
+        CO, FH, FW, CG = weights.shape
+        OH = output_size(H, FH, stride, dilation, padding)
+        OW = output_size(W, FW, stride, dilation, padding)
+        x = np.pad(ifmap.astype(np.float64),
+                   ((0, 0), (padding, padding), (padding, padding), (0, 0)))
+        w = weights.astype(np.float64)
+        COG = CO // groups
+        ofmap = np.zeros((N, OH, OW, CO))
+        for g in range(groups):
+            for fh in range(FH):
+                for fw in range(FW):
+                    h0 = fh * dilation
+                    w0 = fw * dilation
+                    patch = x[:, h0:h0 + (OH - 1) * stride + 1:stride,
+                              w0:w0 + (OW - 1) * stride + 1:stride, g * CG:(g + 1) * CG]
+                    ofmap[..., g * COG:(g + 1) * COG] += np.einsum(
+                        'nhwc,oc->nhwo', patch, w[g * COG:(g + 1) * COG, fh, fw])
+        return ofmap
+
+    @staticmethod
+    def pool(ofmap, mode, size):
+        """Pooling with non-overlapping windows of an NHWC feature map."""
+        N, OH, OW, CO = ofmap.shape
+        x = ofmap[:, :OH // size * size, :OW // size * size]
+        x = x.reshape(N, OH // size, size, OW // size, size, CO)
+        return x.max(axis=(2, 4)) if mode == 'POOL_MAX' else x.mean(axis=(2, 4))
+
+    def validate(self, H, W, CI, CO, FH, FW, stride, dilation, padding, groups, tile_oh,
+                 tile_co, prec, gemm_fp, pool_size, **kwargs):
+        size = du.size_from_precision_t(prec)
+        OH = output_size(H, FH, stride, dilation, padding)
+        OW = output_size(W, FW, stride, dilation, padding)
+        assert CI % groups == 0 and CO % groups == 0, 'groups must divide CI and CO'
+        assert (CO // groups) % tile_co == 0, 'tile_co must divide CO / groups'
+        assert OH > 0 and OW > 0, \
+            'Filters larger than the padded input'
+        if 'opt' in gemm_fp:
+            assert tile_co % self.GEMM_UNROLL == 0, \
+                f'tile_co must be a multiple of {self.GEMM_UNROLL}'
+            # The SIMD kernels require K and all operand rows to be a
+            # multiple of a 64-bit word
+            assert ((CI // groups) * size) % 8 == 0, \
+                'Channels per group must fill a multiple of 64 bits'
+        if pool_size:
+            assert OH % pool_size == 0 and tile_oh % pool_size == 0, \
+                'pool_size must divide OH and tile_oh'
+            assert (tile_co * size) % 8 == 0, 'Channel tiles must fill a multiple of 64 bits'
+
+        # Double-buffered halo, filter and output tiles
+        halo_rows = (tile_oh - 1) * stride + dilation * (FH - 1) + 1
+        halo_size = halo_rows * (W + 2 * padding) * CI
+        wtile_size = tile_co * FH * FW * (CI // groups)
+        otile_size = tile_oh * OW * tile_co
+        if pool_size:
+            otile_size += (tile_oh // pool_size) * (OW // pool_size) * tile_co
+        footprint = 2 * (halo_size + wtile_size + otile_size) * size
+        # Partial results of an output row, and their FP32 accumulators
+        if size < 4:
+            footprint += OW * tile_co * (size + 4)
+        du.validate_tcdm_footprint(footprint)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        # Pooling is disabled by default
+        kwargs.setdefault('pool_mode', 'POOL_MAX')
+        kwargs.setdefault('pool_size', 0)
+        self.validate(**kwargs)
+
+        prec = kwargs['prec']
+        ff_desc = du.ff_desc_from_precision_t(prec)
+        ctype = du.ctype_from_precision_t(prec)
+
+        ifmap_shape = (kwargs['N'], kwargs['H'], kwargs['W'], kwargs['CI'])
+        weights_shape = (kwargs['CO'], kwargs['FH'], kwargs['FW'],
+                         kwargs['CI'] // kwargs['groups'])
+        ifmap = ff.array(np.random.randn(*ifmap_shape), ff_desc)
+        weights = ff.array(np.random.randn(*weights_shape), ff_desc)
+        ofmap_shape = (kwargs['N'],
+                       output_size(kwargs['H'], kwargs['FH'], kwargs['stride'],
+                                   kwargs['dilation'], kwargs['padding']),
+                       output_size(kwargs['W'], kwargs['FW'], kwargs['stride'],
+                                   kwargs['dilation'], kwargs['padding']),
+                       kwargs['CO'])
+        if kwargs['pool_size']:
+            ofmap_shape = (ofmap_shape[0], ofmap_shape[1] // kwargs['pool_size'],
+                           ofmap_shape[2] // kwargs['pool_size'], ofmap_shape[3])
+
+        ifmap_uid = 'ifmap'
+        weights_uid = 'weights'
+        ofmap_uid = 'ofmap'
+
+        layer_cfg = {
+            'N': kwargs['N'],
+            'H': kwargs['H'],
+            'W': kwargs['W'],
+            'CI': kwargs['CI'],
+            'CO': kwargs['CO'],
+            'FH': kwargs['FH'],
+            'FW': kwargs['FW'],
+            'stride': kwargs['stride'],
+            'dilation': kwargs['dilation'],
+            'padding': kwargs['padding'],
+            'groups': kwargs['groups'],
+            'tile_oh': kwargs['tile_oh'],
+            'tile_co': kwargs['tile_co'],
+            'ifmap': ifmap_uid,
+            'weights': weights_uid,
+            'ofmap': ofmap_uid,
+            'dtype': prec,
+            'gemm_fp': kwargs['gemm_fp'],
+            'pool_mode': kwargs['pool_mode'],
+            'pool_size': kwargs['pool_size']
+        }
+
+        header += [du.format_array_declaration(f'extern {ctype}', ifmap_uid, ifmap_shape,
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_declaration(f'extern {ctype}', weights_uid, weights_shape,
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_declaration(ctype, ofmap_uid, ofmap_shape,
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_struct_definition('conv2d_igemm_layer_t', 'layer', layer_cfg)]
+        header += [du.format_array_definition(ctype, ifmap_uid, ifmap,
+                                              alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_definition(ctype, weights_uid, weights,
+                                              alignment=BURST_ALIGNMENT)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(Conv2dIgemmDataGen().main())
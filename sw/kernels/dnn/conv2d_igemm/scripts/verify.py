@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+from datagen import Conv2dIgemmDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+from snitch.util.sim.data_utils import ctype_from_precision_t
+
+
+class Conv2dIgemmVerifier(Verifier):
+
+    OUTPUT_UIDS = ['ofmap']
+    # Unit roundoff of every precision
+    UNIT_ROUNDOFF = {8: 2.**-53, 4: 2.**-24, 2: 2.**-11, 1: 2.**-3}
+
+    def __init__(self):
+        super().__init__()
+        self.layer_struct = {
+            'N': 'I',
+            'H': 'I',
+            'W': 'I',
+            'CI': 'I',
+            'CO': 'I',
+            'FH': 'I',
+            'FW': 'I',
+            'stride': 'I',
+            'dilation': 'I',
+            'padding': 'I',
+            'groups': 'I',
+            'tile_oh': 'I',
+            'tile_co': 'I',
+            'ifmap': 'I',
+            'weights': 'I',
+            'ofmap': 'I',
+            'dtype': 'I',
+            'gemm_fp': 'I',
+            'pool_mode': 'I',
+            'pool_size': 'I'
+        }
+        self.layer = self.get_input_from_symbol('layer', self.layer_struct)
+        self.prec = self.layer['dtype']
+        self.ctype = ctype_from_precision_t(self.prec)
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], self.ctype).astype(np.float64)
+
+    def get_expected_results(self):
+        cfg = self.layer
+        ifmap = self.get_input_from_symbol('ifmap', self.ctype).astype(np.float64)
+        weights = self.get_input_from_symbol('weights', self.ctype).astype(np.float64)
+        ifmap = ifmap.reshape(cfg['N'], cfg['H'], cfg['W'], cfg['CI'])
+        CG = cfg['CI'] // cfg['groups']
+        weights = weights.reshape(cfg['CO'], cfg['FH'], cfg['FW'], CG)
+
+        def conv(x, w):
+            return Conv2dIgemmDataGen().golden_model(x, w, cfg['stride'], cfg['dilation'],
+                                                     cfg['padding'], cfg['groups'])
+
+        ofmap = conv(ifmap, weights)
+
+        # Every GEMM call accumulates k products, merging the taps of a
+        # filter row if possible. FP16 and FP8 calls accumulate in FP16,
+        # and their results are rounded once, then summed in FP32. Other
+        # precisions accumulate all FH * FW * CG products in place.
+        u = self.UNIT_ROUNDOFF[self.prec]
+        merge_fw = cfg['dilation'] == 1 and cfg['groups'] == 1
+        k = cfg['FW'] * CG if merge_fw else CG
+        s = conv(np.abs(ifmap), np.abs(weights))
+        if self.prec < 4:
+            # Sum of the magnitudes of the partial results of all calls
+            p = np.zeros_like(ofmap)
+            taps = [(fh, slice(None)) for fh in range(cfg['FH'])] if merge_fw else \
+                [(fh, fw) for fh in range(cfg['FH']) for fw in range(cfg['FW'])]
+            for fh, fw in taps:
+                mask = np.zeros_like(weights)
+                mask[:, fh, fw] = 1
+                p += np.abs(conv(ifmap, weights * mask))
+            atol = k * self.UNIT_ROUNDOFF[2] * s + (u + len(taps) * self.UNIT_ROUNDOFF[4]) * p
+        else:
+            atol = cfg['FH'] * cfg['FW'] * CG * u * s
+        # Rounding of the output
+        atol += u * np.abs(ofmap)
+
+        # Pooling the per-element bound bounds the error of the pooled output
+        if cfg['pool_size']:
+            mode = Conv2dIgemmDataGen.POOL_MODES[cfg['pool_mode']]
+            ofmap = Conv2dIgemmDataGen.pool(ofmap, mode, cfg['pool_size'])
+            atol = Conv2dIgemmDataGen.pool(atol, mode, cfg['pool_size'])
+            atol += u * np.abs(ofmap)
+        self.atol = atol.flatten()
+        return ofmap.flatten()
+
+    def check_results(self, actual, expected):
+        return super().check_results(actual, expected, atol=self.atol)
+
+
+if __name__ == "__main__":
+    sys.exit(Conv2dIgemmVerifier().main())
@@ -0,0 +1,382 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "blas.h"
+#include "snrt.h"
+
+/**
+ * @struct conv2d_igemm_layer_t
+ * @brief This structure contains all parameters necessary for computing a
+ *        2D convolution as an implicit GEMM.
+ * @details Feature maps are stored in NHWC layout, and filters in
+ *          CO x FH x FW x (CI / groups) layout. Every filter tap (or row of
+ *          taps, for unit dilation and a single group) contributes one GEMM
+ *          between a strided view of the input halo tile and the
+ *          corresponding slice of the filters. These are computed in place
+ *          by the GEMM micro-kernels, without ever materializing the
+ *          im2col matrix.
+ * @var conv2d_igemm_layer_t::N
+ * Batch size
+ * @var conv2d_igemm_layer_t::H
+ * Height of the input feature map
+ * @var conv2d_igemm_layer_t::W
+ * Width of the input feature map
+ * @var conv2d_igemm_layer_t::CI
+ * Number of input channels
+ * @var conv2d_igemm_layer_t::CO
+ * Number of output channels
+ * @var conv2d_igemm_layer_t::FH
+ * Height of the filters
+ * @var conv2d_igemm_layer_t::FW
+ * Width of the filters
+ * @var conv2d_igemm_layer_t::stride
+ * Stride of the convolution, along both spatial dimensions
+ * @var conv2d_igemm_layer_t::dilation
+ * Dilation of the filters, along both spatial dimensions
+ * @var conv2d_igemm_layer_t::padding
+ * Zero padding of the input feature map, on every side
+ * @var conv2d_igemm_layer_t::groups
+ * Number of channel groups. Must divide CI and CO
+ * @var conv2d_igemm_layer_t::tile_oh
+ * Number of output rows in every tile
+ * @var conv2d_igemm_layer_t::tile_co
+ * Number of output channels in every tile. Must divide CO / groups, and be
+ * a multiple of eight for the optimized GEMM kernels
+ * @var conv2d_igemm_layer_t::ifmap
+ * Pointer to the input feature map, of shape (N, H, W, CI)
+ * @var conv2d_igemm_layer_t::weights
+ * Pointer to the filters, of shape (CO, FH, FW, CI / groups)
+ * @var conv2d_igemm_layer_t::ofmap
+ * Pointer to the output feature map, of shape (N, OH, OW, CO), or
+ * (N, OH / pool_size, OW / pool_size, CO) if pooling is fused
+ * @var conv2d_igemm_layer_t::dtype
+ * Precision of the feature maps and filters
+ * @var conv2d_igemm_layer_t::gemm_fp
+ * GEMM micro-kernel, e.g. `gemm_fp16_opt`. Filters are passed to it as a
+ * transposed B matrix
+ * @var conv2d_igemm_layer_t::pool_mode
+ * Pooling operation fused into the layer
+ * @var conv2d_igemm_layer_t::pool_size
+ * Size and stride of the pooling windows, or zero to disable pooling. Must
+ * divide OH and tile_oh
+ */
+typedef struct {
+    uint32_t N;
+    uint32_t H;
+    uint32_t W;
+    uint32_t CI;
+    uint32_t CO;
+    uint32_t FH;
+    uint32_t FW;
+    uint32_t stride;
+    uint32_t dilation;
+    uint32_t padding;
+    uint32_t groups;
+    uint32_t tile_oh;
+    uint32_t tile_co;
+    void *ifmap;
+    void *weights;
+    void *ofmap;
+    precision_t dtype;
+    gemm_fp_t gemm_fp;
+    pool_mode_t pool_mode;
+    uint32_t pool_size;
+} conv2d_igemm_layer_t;
+
+/**
+ * @struct conv2d_igemm_tile_t
+ * @brief Coordinates of a tile of the output feature map.
+ */
+typedef struct {
+    uint32_t n;
+    uint32_t oh0;
+    uint32_t rows;
+    uint32_t co0;
+} conv2d_igemm_tile_t;
+
+/**
+ * @brief Coordinates of tile @p idx. Tiles are ordered by image, then output
+ *        channels, then output rows.
+ */
+static inline conv2d_igemm_tile_t conv2d_igemm_tile(conv2d_igemm_layer_t *l,
+                                                    uint32_t idx, uint32_t OH) {
+    uint32_t n_oh_tiles = (OH + l->tile_oh - 1) / l->tile_oh;
+    uint32_t n_co_tiles = l->CO / l->tile_co;
+    conv2d_igemm_tile_t t;
+    t.oh0 = (idx % n_oh_tiles) * l->tile_oh;
+    t.co0 = ((idx / n_oh_tiles) % n_co_tiles) * l->tile_co;
+    t.n = idx / (n_oh_tiles * n_co_tiles);
+    t.rows = OH - t.oh0 < l->tile_oh ? OH - t.oh0 : l->tile_oh;
+    return t;
+}
+
+/**
+ * @brief Start the DMA transfers of the input halo tile and the filters
+ *        required by output tile @p t.
+ * @details The halo tile is stored with @p padding zero columns on either
+ *          side. These are never written, and must be zeroed upfront.
+ *          Rows falling in the top or bottom padding are zeroed by the DMA.
+ */
+static inline void conv2d_igemm_load(conv2d_igemm_layer_t *l,
+                                     conv2d_igemm_tile_t t, char *halo,
+                                     char *wtile, uint32_t halo_rows) {
+    uint32_t prec = l->dtype;
+    uint32_t row_bytes = l->W * l->CI * prec;
+    uint32_t halo_row_bytes = (l->W + 2 * l->padding) * l->CI * prec;
+    char *halo_interior = halo + l->padding * l->CI * prec;
+
+    // Input rows covered by the halo tile, in padded coordinates
+    int32_t ih0 = (int32_t)(t.oh0 * l->stride) - (int32_t)l->padding;
+    for (uint32_t r = 0; r < halo_rows;) {
+        int32_t ih = ih0 + (int32_t)r;
+        // Group consecutive rows inside and outside of the image
+        uint32_t run = 1;
+        uint32_t valid = ih >= 0 && ih < (int32_t)l->H;
+        while (r + run < halo_rows) {
+            int32_t next = ih + (int32_t)run;
+            if ((next >= 0 && next < (int32_t)l->H) != valid) break;
+            run++;
+        }
+        if (valid) {
+            char *src = (char *)l->ifmap +
+                        ((t.n * l->H + ih) * l->W) * l->CI * prec;
+            snrt_dma_start_2d(halo_interior + r * halo_row_bytes, src,
+                              row_bytes, halo_row_bytes, row_bytes, run);
+        } else {
+            snrt_dma_start_2d(halo + r * halo_row_bytes,
+                              snrt_cluster()->zeromem.mem, halo_row_bytes,
+                              halo_row_bytes, 0, run);
+        }
+        r += run;
+    }
+
+    // Filters of the tile's output channels
+    uint32_t filter_bytes = l->FH * l->FW * (l->CI / l->groups) * prec;
+    snrt_dma_start_1d(wtile, (char *)l->weights + t.co0 * filter_bytes,
+                      l->tile_co * filter_bytes);
+}
+
+/**
+ * @brief Load element @p i of a low-precision array, widened to FP32.
+ */
+static inline float conv2d_igemm_widen(void *x, uint32_t i, uint32_t prec) {
+    if (prec == FP16) return ((__fp16 *)x)[i];
+    return fp8_to_float(((char *)x)[i]);
+}
+
+/**
+ * @brief Store element @p i of a low-precision array, narrowed from FP32.
+ */
+static inline void conv2d_igemm_narrow(void *y, uint32_t i, float val,
+                                       uint32_t prec) {
+    if (prec == FP16)
+        ((__fp16 *)y)[i] = (__fp16)val;
+    else
+        ((char *)y)[i] = float_to_fp8(val);
+}
+
+/**
+ * @brief Compute output tile @p t from its halo tile and filters.
+ * @details Every output row is computed by a sequence of GEMMs accumulating
+ *          into the same output rows. The A operand of every GEMM is a
+ *          strided view of the halo tile, with a leading dimension of
+ *          stride * CI elements. In FP16 and FP8, every GEMM writes its
+ *          partial result to @p part, and the partial results are
+ *          accumulated in FP32 in @p acc, so that the output is rounded to
+ *          the feature map precision only once.
+ */
+static inline void conv2d_igemm_compute(conv2d_igemm_layer_t *l,
+                                        conv2d_igemm_tile_t t, char *halo,
+                                        char *wtile, char *otile, char *part,
+                                        float *acc, uint32_t OW) {
+    uint32_t prec = l->dtype;
+    uint32_t CG = l->CI / l->groups;
+    uint32_t halo_w = l->W + 2 * l->padding;
+    uint32_t group = t.co0 / (l->CO / l->groups);
+    uint32_t widen = prec < FP32;
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t core_num = snrt_cluster_compute_core_num();
+
+    // For unit dilation and a single group, the taps of a filter row are
+    // contiguous in the halo tile and are merged into one GEMM
+    uint32_t merge_fw = l->dilation == 1 && l->groups == 1;
+    uint32_t k = merge_fw ? l->FW * CG : CG;
+    uint32_t n_fw = merge_fw ? 1 : l->FW;
+
+    sc_st_gemm_args_t args;
+    args.prec = prec;
+    args.setup_ssr = 1;
+    args.partition_banks = 0;
+    args.transa = 0;
+    args.transb = 1;
+    args.alpha = 1;
+    args.m = OW;
+    args.n = l->tile_co;
+    args.k = k;
+    args.lda = l->stride * l->CI;
+    args.ldb = l->FH * l->FW * CG;
+    args.ldc = l->tile_co;
+
+    for (uint32_t r = 0; r < t.rows; r++) {
+        char *orow = otile + r * OW * l->tile_co * prec;
+        args.c = widen ? part : orow;
+        for (uint32_t fh = 0; fh < l->FH; fh++) {
+            uint32_t hr = r * l->stride + fh * l->dilation;
+            for (uint32_t fw = 0; fw < n_fw; fw++) {
+                uint32_t col = fw * l->dilation;
+                uint32_t first = fh == 0 && fw == 0;
+                args.a = halo + ((hr * halo_w + col) * l->CI + group * CG) *
+                                    prec;
+                args.b = wtile + (fh * l->FW + fw) * CG * prec;
+                args.beta = !widen && !first;
+                sc_st_gemm(l->gemm_fp, &args);
+
+                // Every core accumulates the rows of C it computed itself
+                if (widen && snrt_is_compute_core()) {
+                    for (uint32_t m = core_idx; m < OW; m += core_num) {
+                        for (uint32_t n = 0; n < l->tile_co; n++) {
+                            uint32_t i = m * l->tile_co + n;
+                            float p = conv2d_igemm_widen(part, i, prec);
+                            acc[i] = first ? p : acc[i] + p;
+                        }
+                    }
+                }
+            }
+        }
+        if (widen && snrt_is_compute_core()) {
+            for (uint32_t m = core_idx; m < OW; m += core_num) {
+                for (uint32_t n = 0; n < l->tile_co; n++) {
+                    uint32_t i = m * l->tile_co + n;
+                    conv2d_igemm_narrow(orow, i, acc[i], prec);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief 2D convolution layer, computed as an implicit GEMM
+ * @details Output tiles of tile_oh rows and tile_co channels are distributed
+ *          across clusters. The input halo tiles and filters of the next
+ *          tile are loaded, and the output of the previous tile is stored,
+ *          while the compute cores process the current tile.
+ *          If pooling is fused, every output tile is pooled in TCDM before
+ *          it is stored, so the unpooled feature map never reaches L3.
+ *          Every cluster must call this function.
+ */
+static inline void conv2d_igemm_layer(conv2d_igemm_layer_t l) {
+    uint32_t prec = l.dtype;
+    uint32_t span_h = l.dilation * (l.FH - 1) + 1;
+    uint32_t span_w = l.dilation * (l.FW - 1) + 1;
+    uint32_t OH = (l.H + 2 * l.padding - span_h) / l.stride + 1;
+    uint32_t OW = (l.W + 2 * l.padding - span_w) / l.stride + 1;
+
+    // Distribute tiles across clusters
+    uint32_t n_tiles_total = l.N * (l.CO / l.tile_co) *
+                             ((OH + l.tile_oh - 1) / l.tile_oh);
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t first_tile = n_tiles_total * cluster_idx / num_clusters;
+    uint32_t last_tile = n_tiles_total * (cluster_idx + 1) / num_clusters;
+    uint32_t n_tiles = last_tile - first_tile;
+
+    // Allocate double buffers for the halo, filter and output tiles
+    uint32_t halo_rows = (l.tile_oh - 1) * l.stride + span_h;
+    uint32_t halo_bytes =
+        halo_rows * (l.W + 2 * l.padding) * l.CI * prec;
+    uint32_t wtile_bytes =
+        l.tile_co * l.FH * l.FW * (l.CI / l.groups) * prec;
+    uint32_t otile_bytes = l.tile_oh * OW * l.tile_co * prec;
+    uint32_t P = l.pool_size;
+    uint32_t POH = P ? OH / P : OH;
+    uint32_t POW = P ? OW / P : OW;
+    char *halo[2], *wtile[2], *otile[2], *ptile[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        halo[i] =
+            (char *)snrt_l1_alloc_cluster_local(halo_bytes, alignof(double));
+        wtile[i] =
+            (char *)snrt_l1_alloc_cluster_local(wtile_bytes, alignof(double));
+        otile[i] =
+            (char *)snrt_l1_alloc_cluster_local(otile_bytes, alignof(double));
+        ptile[i] = otile[i];
+        if (P) {
+            ptile[i] = (char *)snrt_l1_alloc_cluster_local(
+                (l.tile_oh / P) * POW * l.tile_co * prec, alignof(double));
+        }
+    }
+
+    // Buffers for the low-precision partial results of an output row, and
+    // their FP32 accumulators
+    char *part = NULL;
+    float *acc = NULL;
+    if (prec < FP32) {
+        part = (char *)snrt_l1_alloc_cluster_local(OW * l.tile_co * prec,
+                                                   alignof(double));
+        acc = (float *)snrt_l1_alloc_cluster_local(
+            OW * l.tile_co * sizeof(float), alignof(double));
+    }
+
+    // Zero the padding columns of the halo tiles
+    if (snrt_is_dm_core() && l.padding) {
+        uint32_t halo_row_bytes = (l.W + 2 * l.padding) * l.CI * prec;
+        uint32_t pad_bytes = l.padding * l.CI * prec;
+        for (uint32_t i = 0; i < 2; i++) {
+            snrt_dma_start_2d(halo[i], snrt_cluster()->zeromem.mem,
+                              pad_bytes, halo_row_bytes, 0, halo_rows);
+            snrt_dma_start_2d(halo[i] + halo_row_bytes - pad_bytes,
+                              snrt_cluster()->zeromem.mem, pad_bytes,
+                              halo_row_bytes, 0, halo_rows);
+        }
+        snrt_dma_wait_all();
+    }
+
+    // Software pipeline: in iteration i the DMA loads tile i and stores tile
+    // i - 2, while the compute cores process tile i - 1
+    snrt_mcycle();
+    for (uint32_t i = 0; i < n_tiles + 2; i++) {
+        if (snrt_is_dm_core()) {
+            if (i < n_tiles) {
+                conv2d_igemm_tile_t t =
+                    conv2d_igemm_tile(&l, first_tile + i, OH);
+                conv2d_igemm_load(&l, t, halo[i % 2], wtile[i % 2],
+                                  halo_rows);
+            }
+            if (i >= 2) {
+                conv2d_igemm_tile_t t =
+                    conv2d_igemm_tile(&l, first_tile + i - 2, OH);
+                uint32_t oh0 = P ? t.oh0 / P : t.oh0;
+                uint32_t rows = P ? t.rows / P : t.rows;
+                char *dst = (char *)l.ofmap +
+                            (((t.n * POH + oh0) * POW) * l.CO + t.co0) * prec;
+                snrt_dma_start_2d(dst, ptile[i % 2], l.tile_co * prec,
+                                  l.CO * prec, l.tile_co * prec, rows * POW);
+            }
+            snrt_dma_wait_all();
+        }
+
+        if (i >= 1 && i <= n_tiles) {
+            uint32_t b = (i - 1) % 2;
+            conv2d_igemm_tile_t t =
+                conv2d_igemm_tile(&l, first_tile + i - 1, OH);
+            conv2d_igemm_compute(&l, t, halo[b], wtile[b], otile[b], part,
+                                 acc, OW);
+
+            // Pool the output tile once all of its rows are available
+            if (P) {
+                snrt_cluster_hw_barrier();
+                if (snrt_is_compute_core()) {
+                    pool_tile(l.pool_mode, l.dtype, otile[b], ptile[b], OW,
+                              l.tile_co, t.rows / P, POW, P, P, P);
+                }
+            }
+        }
+
+        snrt_cluster_hw_barrier();
+    }
+    snrt_mcycle();
+
+    snrt_global_barrier();
+}
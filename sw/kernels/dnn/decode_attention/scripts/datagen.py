@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import pyflexfloat as ff
+import sys
+
+import snitch.util.sim.data_utils as du
+
+np.random.seed(42)
+
+
+class DecodeAttentionDataGen(du.DataGen):
+
+    # Number of unused blocks in a paged KV cache
+    NUM_SPARE_BLOCKS = 2
+
+    def golden_model(self, q, K, V, block_table, S, B_c):
+        # Gather logical blocks, and compute in single precision as the kernel
+        if block_table is not None:
+            K = K[block_table]
+            V = V[block_table]
+        d = q.shape[0]
+        K = K.reshape(-1, d)[:S].astype(np.float32)
+        V = V.reshape(-1, d)[:S].astype(np.float32)
+        s = np.matmul(K, q.astype(np.float32))
+        p = np.exp(s - np.max(s))
+        return np.matmul(p, V) / np.sum(p)
+
+    def validate(self, S, d, B_c, dtype, **kwargs):
+        assert S > 0, 'S must be greater than 0'
+        assert dtype in ['FP32', 'FP16'], 'Only FP32 and FP16 are supported'
+
+        # Calculate total TCDM occupation
+        prec = du.size_from_precision_t(dtype)
+        num_cores = 8
+        total_size = d * prec  # q
+        total_size += d * 4  # q in single precision
+        total_size += 4 * B_c * d * prec  # double-buffered K and V blocks
+        total_size += num_cores * d * 4  # partial outputs
+        total_size += 2 * (d + num_cores) * 4  # reduction buffers
+        du.validate_tcdm_footprint(total_size)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        S = kwargs['S']
+        d = kwargs['d']
+        B_c = kwargs['B_c']
+        prec = kwargs['dtype']
+        paged = kwargs.get('paged', False)
+
+        self.validate(**kwargs)
+
+        ff_desc = du.ff_desc_from_precision_t(prec)
+        ctype = du.ctype_from_precision_t(prec)
+
+        # Allocate whole blocks in the caches, and in a paged cache scatter
+        # the logical blocks among the physical ones in random order
+        n_blocks = (S + B_c - 1) // B_c
+        block_table = None
+        n_physical_blocks = n_blocks
+        if paged:
+            n_physical_blocks += self.NUM_SPARE_BLOCKS
+            block_table = np.random.permutation(n_physical_blocks)[:n_blocks]
+
+        q = ff.array(np.random.randn(d), ff_desc)
+        K = ff.array(np.random.randn(n_physical_blocks, B_c, d), ff_desc)
+        V = ff.array(np.random.randn(n_physical_blocks, B_c, d), ff_desc)
+        o = self.golden_model(q, K, V, block_table, S, B_c)
+
+        q_uid = 'q'
+        k_uid = 'K'
+        v_uid = 'V'
+        block_table_uid = 'block_table' if paged else None
+        o_uid = 'o'
+
+        layer_cfg = {
+            'S': S,
+            'd': d,
+            'B_c': B_c,
+            'q': q_uid,
+            'K': k_uid,
+            'V': v_uid,
+            'block_table': block_table_uid,
+            'o': o_uid,
+            'dtype': prec,
+        }
+
+        header += [du.format_array_declaration(f'extern {ctype}', q_uid, q.shape)]
+        header += [du.format_array_declaration(f'extern {ctype}', k_uid, K.shape)]
+        header += [du.format_array_declaration(f'extern {ctype}', v_uid, V.shape)]
+        if paged:
+            header += [du.format_array_declaration('extern uint32_t', block_table_uid,
+                                                   block_table.shape)]
+        header += [du.format_array_declaration(ctype, o_uid, o.shape)]
+        header += [du.format_struct_definition('decode_attention_layer_t', 'layer', layer_cfg)]
+        header += [du.format_array_definition(ctype, q_uid, q)]
+        header += [du.format_array_definition(ctype, k_uid, K)]
+        header += [du.format_array_definition(ctype, v_uid, V)]
+        if paged:
+            header += [du.format_array_definition('uint32_t', block_table_uid, block_table)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(DecodeAttentionDataGen().main())
@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+from datagen import DecodeAttentionDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+from snitch.util.sim.data_utils import ctype_from_precision_t
+
+
+class DecodeAttentionVerifier(Verifier):
+
+    OUTPUT_UIDS = ['o']
+    ERR_THRESHOLD = {4: 1e-5, 2: 5e-3}
+
+    def __init__(self):
+        super().__init__()
+        self.layer_struct = {
+            'S': 'I',
+            'd': 'I',
+            'B_c': 'I',
+            'q': 'I',
+            'K': 'I',
+            'V': 'I',
+            'block_table': 'I',
+            'o': 'I',
+            'dtype': 'I'
+        }
+        self.layer = self.get_input_from_symbol('layer', self.layer_struct)
+        self.S = self.layer['S']
+        self.d = self.layer['d']
+        self.B_c = self.layer['B_c']
+        self.paged = self.layer['block_table'] != 0
+        self.prec = self.layer['dtype']
+
+    def get_actual_results(self):
+        o = self.get_output_from_symbol(self.OUTPUT_UIDS[0], ctype_from_precision_t(self.prec))
+        return o.astype(np.float32)
+
+    def get_expected_results(self):
+        ctype = ctype_from_precision_t(self.prec)
+        q = self.get_input_from_symbol('q', ctype)
+        K = self.get_input_from_symbol('K', ctype).reshape(-1, self.B_c, self.d)
+        V = self.get_input_from_symbol('V', ctype).reshape(-1, self.B_c, self.d)
+        block_table = None
+        if self.paged:
+            n_blocks = (self.S + self.B_c - 1) // self.B_c
+            block_table = self.get_input_from_symbol('block_table', 'uint32_t')[:n_blocks]
+        return DecodeAttentionDataGen().golden_model(q, K, V, block_table, self.S, self.B_c)
+
+    def check_results(self, *args):
+        return super().check_results(*args, atol=self.ERR_THRESHOLD[self.prec])
+
+
+if __name__ == "__main__":
+    sys.exit(DecodeAttentionVerifier().main())
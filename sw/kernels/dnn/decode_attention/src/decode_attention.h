@@ -0,0 +1,279 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <math.h>
+
+#include "snrt.h"
+
+/**
+ * @struct decode_attention_layer_t
+ * @brief This structure contains all parameters necessary for computing
+ *        the attention of a single query row over a KV cache, as in the
+ *        decode phase of autoregressive inference.
+ * @details The KV cache is split in blocks of B_c rows, which are distributed
+ *          across all clusters, as in Flash-Decoding. Every cluster computes
+ *          the partial softmax statistics and output over its blocks, which
+ *          are then merged with a global reduction.
+ * @var decode_attention_layer_t::S
+ * Number of valid rows in the KV cache, i.e. the current sequence length.
+ * Need not be a multiple of B_c
+ * @var decode_attention_layer_t::d
+ * Head dimension
+ * @var decode_attention_layer_t::B_c
+ * Number of rows in every block (page) of the KV cache
+ * @var decode_attention_layer_t::q
+ * Pointer to the query row, of shape (d)
+ * @var decode_attention_layer_t::K
+ * Pointer to the key cache, of shape (num_blocks, B_c, d)
+ * @var decode_attention_layer_t::V
+ * Pointer to the value cache, of shape (num_blocks, B_c, d)
+ * @var decode_attention_layer_t::block_table
+ * Maps every logical block of the sequence to a physical block in the K and
+ * V caches, for paged KV caches. If NULL, the caches are contiguous
+ * @var decode_attention_layer_t::o
+ * Pointer to the output row, of shape (d)
+ * @var decode_attention_layer_t::dtype
+ * Precision of the query, caches and output. Accumulation is always
+ * performed in single precision
+ */
+typedef struct {
+    uint32_t S;
+    uint32_t d;
+    uint32_t B_c;
+    void *q;
+    void *K;
+    void *V;
+    uint32_t *block_table;
+    void *o;
+    precision_t dtype;
+} decode_attention_layer_t;
+
+/**
+ * @brief Start the DMA transfers of K and V block @p block to TCDM.
+ */
+static inline void decode_attention_load_kv(decode_attention_layer_t *layer,
+                                            void *K, void *V, uint32_t block,
+                                            uint32_t prec) {
+    uint32_t size = layer->B_c * layer->d * prec;
+    if (layer->block_table) block = layer->block_table[block];
+    snrt_dma_start_1d(K, (void *)((uintptr_t)layer->K + block * size), size);
+    snrt_dma_start_1d(V, (void *)((uintptr_t)layer->V + block * size), size);
+}
+
+/**
+ * @brief Update the running softmax statistics and output of the calling
+ *        core with the rows of a K/V block.
+ * @details Every compute core processes a strided subset of the rows, and
+ *          keeps its own running maximum @p m, sum of exponentials @p l and
+ *          unnormalized output @p o. The output is only rescaled when the
+ *          running maximum changes.
+ */
+template <typename T>
+static inline void decode_attention_block(const float *q, const T *K,
+                                          const T *V, uint32_t n_rows,
+                                          uint32_t d, float *m, float *l,
+                                          float *o) {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+
+    for (uint32_t row = core_idx; row < n_rows; row += num_cores) {
+        const T *k = K + row * d;
+        const T *v = V + row * d;
+
+        // Attention score
+        float s = 0;
+        for (uint32_t i = 0; i < d; i++) s += q[i] * (float)k[i];
+
+        // Rescale previous statistics if the maximum changes
+        if (s > *m) {
+            float scale = vmath_expf(*m - s);
+            *l *= scale;
+            for (uint32_t i = 0; i < d; i++) o[i] *= scale;
+            *m = s;
+        }
+
+        // Accumulate contribution of the current row
+        float p = vmath_expf(s - *m);
+        *l += p;
+        for (uint32_t i = 0; i < d; i++) o[i] += p * (float)v[i];
+    }
+}
+
+/**
+ * @brief Rescaling factor of partial statistics computed with maximum
+ *        @p m_part to a common maximum @p m.
+ * @details Partial statistics over no rows have a maximum of -inf, and
+ *          contribute nothing.
+ */
+static inline float decode_attention_scale(float m_part, float m) {
+    return (m_part == -INFINITY) ? 0.f : vmath_expf(m_part - m);
+}
+
+template <typename T>
+static inline void decode_attention(decode_attention_layer_t layer) {
+    uint32_t S = layer.S;
+    uint32_t d = layer.d;
+    uint32_t B_c = layer.B_c;
+    uint32_t prec = sizeof(T);
+
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t num_cores = snrt_cluster_compute_core_num();
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+
+    // Distribute blocks evenly across clusters
+    uint32_t n_blocks = (S + B_c - 1) / B_c;
+    uint32_t first_block = n_blocks * cluster_idx / num_clusters;
+    uint32_t last_block = n_blocks * (cluster_idx + 1) / num_clusters;
+
+    // The reduction buffers hold the partial output followed by the partial
+    // sum of exponentials, padded to a multiple of the number of cores
+    uint32_t red_len = ((d + 1 + num_cores - 1) / num_cores) * num_cores;
+
+    // Allocate TCDM buffers. Allocation must be identical in all clusters,
+    // as the merge phase accesses buffers at the same offset in other
+    // clusters' TCDM.
+    uint32_t kv_size = B_c * d * prec;
+    T *q = (T *)snrt_l1_alloc_cluster_local(d * prec, alignof(double));
+    float *q_f = (float *)snrt_l1_alloc_cluster_local(d * sizeof(float),
+                                                      alignof(double));
+    T *K[2], *V[2];
+    for (int i = 0; i < 2; i++) {
+        K[i] = (T *)snrt_l1_alloc_cluster_local(kv_size, alignof(double));
+        V[i] = (T *)snrt_l1_alloc_cluster_local(kv_size, alignof(double));
+    }
+    float *o_core = (float *)snrt_l1_alloc_cluster_local(
+        num_cores * d * sizeof(float), alignof(double));
+    float *m_core = (float *)snrt_l1_alloc_cluster_local(
+        num_cores * sizeof(float), alignof(double));
+    float *l_core = (float *)snrt_l1_alloc_cluster_local(
+        num_cores * sizeof(float), alignof(double));
+    float *scale_core = (float *)snrt_l1_alloc_cluster_local(
+        num_cores * sizeof(float), alignof(double));
+    float *m_cluster = (float *)snrt_l1_alloc_cluster_local(sizeof(float),
+                                                            alignof(double));
+    float *red_src = (float *)snrt_l1_alloc_cluster_local(
+        red_len * sizeof(float), alignof(double));
+    float *red_dst = (float *)snrt_l1_alloc_cluster_local(
+        red_len * sizeof(float), alignof(double));
+
+    // Load query and first K/V block
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(q, layer.q, d * prec);
+        if (first_block < last_block) {
+            decode_attention_load_kv(&layer, K[0], V[0], first_block, prec);
+        }
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+
+    // Initialize running statistics, and convert query to single precision
+    float m = -INFINITY;
+    float l = 0;
+    float *o = o_core + core_idx * d;
+    if (snrt_is_compute_core()) {
+        for (uint32_t i = 0; i < d; i++) o[i] = 0;
+        for (uint32_t i = core_idx; i < d; i += num_cores) q_f[i] = (float)q[i];
+    }
+    snrt_cluster_hw_barrier();
+
+    // Iterate over the cluster's blocks, prefetching the next block while
+    // processing the current one
+    for (uint32_t block = first_block; block < last_block; block++) {
+        uint32_t buf = (block - first_block) % 2;
+
+        if (snrt_is_dm_core()) {
+            if (block + 1 < last_block) {
+                decode_attention_load_kv(&layer, K[!buf], V[!buf], block + 1,
+                                         prec);
+            }
+        }
+
+        if (snrt_is_compute_core()) {
+            uint32_t n_rows = S - block * B_c;
+            if (n_rows > B_c) n_rows = B_c;
+            decode_attention_block<T>(q_f, K[buf], V[buf], n_rows, d, &m, &l,
+                                      o);
+        }
+
+        if (snrt_is_dm_core()) snrt_dma_wait_all();
+        snrt_cluster_hw_barrier();
+    }
+
+    // Merge the partial statistics of the cores in the cluster
+    if (snrt_is_compute_core()) {
+        m_core[core_idx] = m;
+        l_core[core_idx] = l;
+    }
+    snrt_cluster_hw_barrier();
+    float m_c = -INFINITY;
+    if (snrt_is_compute_core()) {
+        for (uint32_t i = 0; i < num_cores; i++) m_c = fmaxf(m_c, m_core[i]);
+        scale_core[core_idx] = decode_attention_scale(m, m_c);
+        if (core_idx == 0) *m_cluster = m_c;
+    }
+    snrt_fpu_fence();
+    snrt_global_barrier();
+
+    // Rescale the cluster's partial results to the global maximum, which is
+    // gathered from the other clusters' TCDM
+    if (snrt_is_compute_core()) {
+        float m_g = -INFINITY;
+        for (uint32_t c = 0; c < num_clusters; c++) {
+            float *m_remote =
+                (float *)snrt_remote_l1_ptr(m_cluster, cluster_idx, c);
+            m_g = fmaxf(m_g, *m_remote);
+        }
+        float scale = decode_attention_scale(m_c, m_g);
+        for (uint32_t i = core_idx; i < red_len; i += num_cores) {
+            float acc = 0;
+            if (i < d) {
+                for (uint32_t k = 0; k < num_cores; k++)
+                    acc += o_core[k * d + i] * scale_core[k];
+            } else if (i == d) {
+                for (uint32_t k = 0; k < num_cores; k++)
+                    acc += l_core[k] * scale_core[k];
+            }
+            red_src[i] = acc * scale;
+        }
+    }
+
+    // Sum the rescaled partial results of all clusters in cluster 0
+    snrt_global_reduction_dma(red_dst, red_src, red_len);
+
+    // Normalize and write back the output
+    if (cluster_idx == 0) {
+        if (snrt_is_compute_core()) {
+            for (uint32_t i = core_idx; i < d; i += num_cores)
+                q[i] = (T)(red_src[i] / red_src[d]);
+        }
+        snrt_fpu_fence();
+        snrt_cluster_hw_barrier();
+        if (snrt_is_dm_core()) {
+            snrt_dma_start_1d(layer.o, q, d * prec);
+            snrt_dma_wait_all();
+        }
+    }
+    snrt_global_barrier();
+}
+
+/**
+ * @brief Decode-phase attention layer
+ * @details Every cluster must call this function.
+ * @returns 0 on success, 1 if the precision is not supported.
+ */
+static inline int decode_attention_layer(decode_attention_layer_t layer) {
+    switch (layer.dtype) {
+        case FP32:
+            decode_attention<float>(layer);
+            return 0;
+        case FP16:
+            decode_attention<__fp16>(layer);
+            return 0;
+        default:
+            return 1;
+    }
+}
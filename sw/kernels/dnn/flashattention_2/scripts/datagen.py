@@ -76,7 +76,7 @@ class FlashAttention2DataGen(du.DataGen):
             O_tiles.append(O_i)
         return np.concatenate(O_tiles, 0)
 
-    def exact_flexfloat_golden_model(self, Q, K, V, B_r, B_c, desc):
+    def exact_flexfloat_golden_model(self, Q, K, V, B_r, B_c, desc, causal=False):
         # Get layer dimensions
         L = Q.shape[0]
         d = Q.shape[1]
@@ -95,7 +95,9 @@ class FlashAttention2DataGen(du.DataGen):
             Q_i = Q[start_row:end_row, :]
             # Initialize l_i, m_i, O_i
             m_i = np.full((B_r, 1), -np.inf)
-            for j in range(T_c):
+            # With a causal mask, skip column blocks lying entirely above the diagonal
+            n_col_blocks = min(T_c, (end_row - 1) // B_c + 1) if causal else T_c
+            for j in range(n_col_blocks):
                 # Tile K_t and V
                 start_col = j * B_c
                 end_col = start_col + B_c
@@ -104,6 +106,10 @@ class FlashAttention2DataGen(du.DataGen):
                 # Compute O tile update
                 S_ij = ff.array(np.zeros((B_r, B_c)), desc)
                 S_ij = gemm.GemmDataGen().exact_golden_model(1, Q_i, K_t_j, 0, S_ij)
+                if causal:
+                    rows = np.arange(start_row, end_row)[:, None]
+                    cols = np.arange(start_col, end_col)[None, :]
+                    S_ij = np.where(cols > rows, -np.inf, S_ij.astype(np.float32))
                 m_i_prev = m_i
                 m_i = np.maximum(m_i_prev, np.max(S_ij, 1, keepdims=True))
                 shifted_exp = np.exp((m_i_prev.astype(np.float32) - m_i.astype(np.float32)))
@@ -144,8 +150,8 @@ class FlashAttention2DataGen(du.DataGen):
         m_i_size = B_r * prec
         l_i_size = B_r * prec
         total_size = q_fa_size
-        total_size += k_fa_size
-        total_size += v_fa_size * 2  # V and V^t
+        total_size += k_fa_size * 2  # double buffered
+        total_size += v_fa_size * 3  # double buffered V and V^t
         total_size += s_fa_size
         total_size += p_fa_size
         total_size += o_fa_size
@@ -211,7 +217,8 @@ class FlashAttention2DataGen(du.DataGen):
         K = ff.array(np.random.rand(S, d), ff_desc)
         V = ff.array(np.random.rand(S, d), ff_desc)
 
-        output = self.exact_flexfloat_golden_model(Q, K, V, B_r, B_c, ff_desc)
+        output = self.exact_flexfloat_golden_model(Q, K, V, B_r, B_c, ff_desc,
+                                                   kwargs.get('causal', False))
 
         q_uid = 'Q'
         k_uid = 'K'
@@ -219,12 +226,16 @@ class FlashAttention2DataGen(du.DataGen):
         o_uid = 'O'
 
         layer_cfg = {
+            'causal': False,
+            'multicast': False,
             **kwargs,
             'gemm_implementation': gemm_impl,
             'Q': q_uid,
             'K': k_uid,
             'V': v_uid,
             'O': o_uid,
+            'ld_qkv': d,
+            'ld_o': d,
         }
 
         header += [du.format_array_declaration(f'extern {ctype}', q_uid, Q.shape)]
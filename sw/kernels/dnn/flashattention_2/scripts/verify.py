@@ -32,8 +32,12 @@ class FlashAttention2Verifier(Verifier):
             'K': 'I',
             'V': 'I',
             'O': 'I',
+            'ld_qkv': 'I',
+            'ld_o': 'I',
             'dtype': 'I',
             'baseline': 'I',
+            'causal': 'I',
+            'multicast': 'I',
             'gemm_fp': 'I'
         }
         self.layer = self.get_input_from_symbol('layer', self.layer_struct)
@@ -43,6 +47,7 @@ class FlashAttention2Verifier(Verifier):
         self.B_r = self.layer['B_r']
         self.B_c = self.layer['B_c']
         self.prec = self.layer['dtype']
+        self.causal = self.layer['causal']
 
     def get_actual_results(self):
         return self.get_output_from_symbol(self.OUTPUT_UIDS[0], ctype_from_precision_t(self.prec))
@@ -65,7 +70,8 @@ class FlashAttention2Verifier(Verifier):
         # return torch_golden_model(Q, K, V).detach().numpy().flatten()
         # return exact_golden_model(Q, K, V, self.B_r, self.B_c).flatten()
         return FlashAttention2DataGen().exact_flexfloat_golden_model(Q, K, V, self.B_r, self.B_c,
-                                                                     ff_desc).flatten()
+                                                                     ff_desc,
+                                                                     self.causal).flatten()
 
     def check_results(self, *args):
         return super().check_results(*args, rtol=self.ERR_THRESHOLD[self.prec])
@@ -32,6 +32,23 @@
  * Pointer to value tensor
  * @var flashattention_2_layer_t::O
  * Pointer to output tensor
+ * @var flashattention_2_layer_t::ld_qkv
+ * Row stride of the Q, K and V tensors, in elements. Equal to d for dense
+ * tensors, larger if they are slices of a packed QKV tensor
+ * @var flashattention_2_layer_t::ld_o
+ * Row stride of the output tensor, in elements. Equal to d for a dense
+ * tensor, larger if it is a slice of a concatenated tensor
+ * @var flashattention_2_layer_t::qkv_in_tcdm
+ * Q, K and V already reside in the TCDM of the cluster, e.g. as the output
+ * of a preceding projection. Their blocks are then consumed in place rather
+ * than copied into dedicated buffers. Only supported on a single cluster,
+ * without multicast
+ * @var flashattention_2_layer_t::causal
+ * Apply a causal mask, i.e. query i only attends to keys j <= i. Column
+ * blocks which are entirely masked are skipped
+ * @var flashattention_2_layer_t::multicast
+ * Load every K/V block once and multicast it to all clusters, instead of
+ * having every cluster load it independently
  */
 typedef struct {
     uint32_t L;
@@ -43,27 +60,149 @@ typedef struct {
     void *K;
     void *V;
     void *O;
+    uint32_t ld_qkv;
+    uint32_t ld_o;
+    uint32_t qkv_in_tcdm;
     precision_t dtype;
     uint32_t baseline;
+    uint32_t causal;
+    uint32_t multicast;
     gemm_fp_t gemm_implementation;
 } flashattention_2_layer_t;
 
+/**
+ * @brief Number of column blocks of K/V to process for row block @p t_r of Q.
+ * @details With a causal mask, the column blocks lying entirely above the
+ *          diagonal are skipped.
+ */
+static inline uint32_t flashattention_2_num_col_blocks(
+    flashattention_2_layer_t *layer, uint32_t t_r) {
+    uint32_t T_c = layer->S / layer->B_c;
+    if (!layer->causal) return T_c;
+    uint32_t last_row = (t_r + 1) * layer->B_r - 1;
+    uint32_t n_blocks = last_row / layer->B_c + 1;
+    return n_blocks < T_c ? n_blocks : T_c;
+}
+
+/**
+ * @brief Number of unmasked columns in row @p row of Q for column block
+ *        @p t_c of K.
+ * @details Masked columns are always the last ones in the block.
+ */
+static inline int32_t flashattention_2_num_cols(flashattention_2_layer_t *layer,
+                                                uint32_t row, uint32_t t_c) {
+    int32_t n_cols = layer->B_c;
+    if (layer->causal) {
+        n_cols = (int32_t)row - (int32_t)(t_c * layer->B_c) + 1;
+        if (n_cols < 0) n_cols = 0;
+        if (n_cols > (int32_t)layer->B_c) n_cols = layer->B_c;
+    }
+    return n_cols;
+}
+
+/**
+ * @brief Start the DMA transfers of K column block (B_c, d) and V row block
+ *        (B_c, d) @p t_c to TCDM.
+ * @details Both K and V are stored in (S, ld_qkv) form in memory. If a
+ *          communicator is provided, the blocks are multicast to the same
+ *          TCDM location in all clusters of the communicator. Nothing is
+ *          transferred if K and V already reside in TCDM.
+ */
+static inline void flashattention_2_load_kv(flashattention_2_layer_t *layer,
+                                            void *K_fa, void *V_fa,
+                                            uint32_t t_c, snrt_comm_t comm) {
+    if (layer->qkv_in_tcdm) return;
+    uint32_t prec = layer->dtype;
+    uint32_t B_c = layer->B_c;
+    uint32_t d = layer->d;
+    uint32_t ld = layer->ld_qkv;
+    if (comm) {
+        snrt_dma_load_2d_tile_mcast(K_fa, layer->K, t_c, 0, B_c, d, ld, prec,
+                                    comm);
+        snrt_dma_load_2d_tile_mcast(V_fa, layer->V, t_c, 0, B_c, d, ld, prec,
+                                    comm);
+    } else {
+        snrt_dma_load_2d_tile(K_fa, layer->K, t_c, 0, B_c, d, ld, prec);
+        snrt_dma_load_2d_tile(V_fa, layer->V, t_c, 0, B_c, d, ld, prec);
+    }
+}
+
+/**
+ * @brief Block @p t of @p B rows of the Q, K or V tensor @p X, as consumed by
+ *        the GEMMs.
+ * @details Returns the block in place if the tensors reside in TCDM, and the
+ *          buffer @p X_fa the block was loaded to otherwise.
+ * @see flashattention_2_block_ld
+ */
+static inline void *flashattention_2_block(flashattention_2_layer_t *layer,
+                                           void *X, void *X_fa, uint32_t t,
+                                           uint32_t B) {
+    if (!layer->qkv_in_tcdm) return X_fa;
+    return (char *)X + t * B * layer->ld_qkv * layer->dtype;
+}
+
+/**
+ * @brief Row stride, in elements, of the blocks returned by
+ *        `flashattention_2_block`.
+ */
+static inline uint32_t flashattention_2_block_ld(
+    flashattention_2_layer_t *layer) {
+    return layer->qkv_in_tcdm ? layer->ld_qkv : layer->d;
+}
+
+/**
+ * @brief Synchronize all cores working on a row block of Q, or all clusters
+ *        in the communicator if K/V blocks are multicast.
+ */
+static inline void flashattention_2_sync(snrt_comm_t comm) {
+    if (comm)
+        snrt_global_barrier(comm);
+    else
+        snrt_cluster_hw_barrier();
+}
+
 #include "../flashattention_2/src/flashattention_2_fp16.h"
 #include "../flashattention_2/src/flashattention_2_fp32.h"
 #include "../flashattention_2/src/flashattention_2_fp8.h"
 
+/**
+ * @brief FlashAttention-2 layer
+ * @details The row blocks of Q are distributed across all clusters. If
+ *          multicast is enabled, it is used among the first power-of-two
+ *          clusters, while the remaining clusters stay idle.
+ */
 static inline void flashattention_2_layer(flashattention_2_layer_t layer) {
-    switch (layer.dtype) {
-        case FP32:
-            flashattention_2_fp32(layer);
-            break;
-        case FP16:
-            flashattention_2_fp16(layer);
-            break;
-        case FP8:
-            flashattention_2_fp8(layer);
-            break;
-        default:
-            break;
+    // Use at most one cluster per row block
+    uint32_t T_r = layer.L / layer.B_r;
+    uint32_t num_clusters = snrt_cluster_num();
+    if (num_clusters > T_r) num_clusters = T_r;
+
+    // Multicast communicators must span a power-of-two number of clusters
+    snrt_comm_t comm = NULL;
+    if (layer.multicast && num_clusters > 1) {
+        while (num_clusters & (num_clusters - 1))
+            num_clusters &= num_clusters - 1;
+        snrt_comm_create(num_clusters, &comm);
     }
+
+    if (snrt_cluster_idx() < num_clusters) {
+        switch (layer.dtype) {
+            case FP32:
+                flashattention_2_fp32(layer, snrt_cluster_idx(), num_clusters,
+                                      comm);
+                break;
+            case FP16:
+                flashattention_2_fp16(layer, snrt_cluster_idx(), num_clusters,
+                                      comm);
+                break;
+            case FP8:
+                flashattention_2_fp8(layer, snrt_cluster_idx(), num_clusters,
+                                     comm);
+                break;
+            default:
+                break;
+        }
+    }
+
+    snrt_global_barrier();
 }
\ No newline at end of file
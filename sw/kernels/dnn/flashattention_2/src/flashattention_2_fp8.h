@@ -5,28 +5,10 @@
 // Author: Viviane Potocnik <vivianep@iis.ee.ethz.ch>
 //         Luca Colagrande <colluca@iis.ee.ethz.ch>
 
-static inline float fp8_to_float(char val) {
-    float res;
-    asm volatile(
-        "fmv.b.x %[res], %[val]\n"
-        "fcvt.s.b %[res], %[res]\n"
-        : [ res ] "=f"(res)
-        : [ val ] "r"(val));
-    return res;
-}
-
-static inline char float_to_fp8(float val) {
-    char res;
-    asm volatile(
-        "fcvt.b.s ft3, %[val]\n"
-        "fmv.x.b %[res], ft3\n"
-        : [ res ] "=r"(res)
-        : [ val ] "f"(val)
-        : "ft3");
-    return res;
-}
-
-static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
+static inline void flashattention_2_fp8(flashattention_2_layer_t layer,
+                                        uint32_t group_idx = 0,
+                                        uint32_t group_size = 1,
+                                        snrt_comm_t comm = NULL) {
     // alias layer parameters
     uint32_t dtype = layer.dtype;
     uint32_t L = layer.L;
@@ -34,11 +16,12 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
     uint32_t d = layer.d;
     uint32_t B_r = layer.B_r;
     uint32_t B_c = layer.B_c;
+    uint32_t ld_qkv = layer.ld_qkv;
+    uint32_t ld_o = layer.ld_o;
+    uint32_t ld_blk = flashattention_2_block_ld(&layer);
     uint32_t baseline = layer.baseline;
     gemm_fp_t gemm_implementation = layer.gemm_implementation;
     char *Q_l3 = (char *)layer.Q;
-    char *K_l3 = (char *)layer.K;
-    char *V_l3 = (char *)layer.V;
     char *O_l3 = (char *)layer.O;
 
     // gemm specific parameters
@@ -63,7 +46,6 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
 
     // compute the tiling parameters
     uint32_t T_r = L / B_r;  // number of row blocks
-    uint32_t T_c = S / B_c;  // number of column blocks
 
     // compute the size of the matrices
     uint32_t q_fa_size = B_r * d * sizeof(char);
@@ -77,9 +59,17 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
     uint32_t shifted_exp_size = B_r * sizeof(float);
 
     // allocate memory in TCDM
-    char *Q_fa = (char *)snrt_l1_alloc_cluster_local(q_fa_size, alignof(char));
-    char *K_fa = (char *)snrt_l1_alloc_cluster_local(k_fa_size, alignof(char));
-    char *V_fa = (char *)snrt_l1_alloc_cluster_local(v_fa_size, alignof(char));
+    char *Q_fa, *K_fa[2], *V_fa[2];
+    // Q, K and V blocks are only buffered if not already in TCDM
+    if (!layer.qkv_in_tcdm) {
+        Q_fa = (char *)snrt_l1_alloc_cluster_local(q_fa_size, alignof(char));
+        for (int i = 0; i < 2; i++) {
+            K_fa[i] = (char *)snrt_l1_alloc_cluster_local(k_fa_size,
+                                                          alignof(char));
+            V_fa[i] = (char *)snrt_l1_alloc_cluster_local(v_fa_size,
+                                                          alignof(char));
+        }
+    }
     char *S_fa = (char *)snrt_l1_alloc_cluster_local(s_fa_size, alignof(char));
     char *P_fa = (char *)snrt_l1_alloc_cluster_local(p_fa_size, alignof(char));
     char *O_fa = (char *)snrt_l1_alloc_cluster_local(o_fa_size, alignof(char));
@@ -99,22 +89,51 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
 
     snrt_mcycle();
 
+    // Row blocks of Q are distributed across the clusters in the group, in
+    // rounds of group_size row blocks. If K/V blocks are multicast, all
+    // clusters in the group proceed through the rounds in lockstep.
+    uint32_t n_rounds = (T_r + group_size - 1) / group_size;
+    uint32_t is_mcast_leader = (comm != NULL) && (group_idx == 0);
+
     // Iterate row blocks of Q
-    for (int t_r = 0; t_r < T_r; t_r++) {
-        // DMA copy Q row block to TCDM
+    for (uint32_t round = 0; round < n_rounds; round++) {
+        uint32_t t_r = round * group_size + group_idx;
+        uint32_t is_active = t_r < T_r;
+
+        // Number of column blocks to process for the current row block, and
+        // for the row block with the most column blocks in the round
+        uint32_t T_c_end =
+            is_active ? flashattention_2_num_col_blocks(&layer, t_r) : 0;
+        uint32_t T_c_round = T_c_end;
+        if (comm) {
+            uint32_t last_t_r = (round + 1) * group_size - 1;
+            if (last_t_r >= T_r) last_t_r = T_r - 1;
+            T_c_round = flashattention_2_num_col_blocks(&layer, last_t_r);
+        }
+
+        // Q row block, consumed in place if Q resides in TCDM
+        char *Q_blk =
+            (char *)flashattention_2_block(&layer, Q_l3, Q_fa, t_r, B_r);
+
+        // DMA copy Q row block and first K/V blocks to TCDM
         if (snrt_is_dm_core()) {
-            snrt_dma_load_2d_tile(Q_fa,         // dst
-                                  Q_l3,         // src
-                                  t_r,          // tile_x1_idx
-                                  0,            // tile_x0_idx
-                                  B_r,          // tile_x1_size
-                                  d,            // tile_x0_size
-                                  d,            // full_x0_size
-                                  sizeof(char)  // prec
-            );
+            if (is_active && !layer.qkv_in_tcdm) {
+                snrt_dma_load_2d_tile(Q_fa,         // dst
+                                      Q_l3,         // src
+                                      t_r,          // tile_x1_idx
+                                      0,            // tile_x0_idx
+                                      B_r,          // tile_x1_size
+                                      d,            // tile_x0_size
+                                      ld_qkv,       // full_x0_size
+                                      sizeof(char)  // prec
+                );
+            }
+            if (comm ? is_mcast_leader : T_c_end > 0) {
+                flashattention_2_load_kv(&layer, K_fa[0], V_fa[0], 0, comm);
+            }
             snrt_dma_wait_all();
         }
-        snrt_cluster_hw_barrier();
+        flashattention_2_sync(comm);
 
         snrt_mcycle();
 
@@ -142,45 +161,37 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
         snrt_mcycle();
 
         // Iterate column blocks of K (corresponding to row blocks of V)
-        for (int t_c = 0; t_c < T_c; t_c++) {
-            // DMA copy K column block (B_c, d) and V row block (B_c, d) to
-            // TCDM. Both K and V are stored in (S, d) form in memory
-            if (!snrt_is_compute_core()) {
-                snrt_dma_load_2d_tile(K_fa,         // dst
-                                      K_l3,         // src
-                                      t_c,          // tile_x1_idx
-                                      0,            // tile_x0_idx
-                                      B_c,          // tile_x1_size
-                                      d,            // tile_x0_size
-                                      d,            // full_x0_size
-                                      sizeof(char)  // prec
-                );
-                snrt_dma_load_2d_tile(V_fa,         // dst
-                                      V_l3,         // src
-                                      t_c,          // tile_x1_idx
-                                      0,            // tile_x0_idx
-                                      B_c,          // tile_x1_size
-                                      d,            // tile_x0_size
-                                      d,            // full_x0_size
-                                      sizeof(char)  // prec
-                );
-                snrt_dma_wait_all();
+        for (uint32_t t_c = 0; t_c < T_c_round; t_c++) {
+            uint32_t buf = t_c % 2;
+            char *K_blk = (char *)flashattention_2_block(&layer, layer.K,
+                                                         K_fa[buf], t_c, B_c);
+            char *V_blk = (char *)flashattention_2_block(&layer, layer.V,
+                                                         V_fa[buf], t_c, B_c);
+
+            // Prefetch the next K column block (B_c, d) and V row block
+            // (B_c, d) to the other buffer, overlapping the transfers with
+            // the computation on the current blocks
+            if (snrt_is_dm_core() && (t_c + 1) < T_c_round) {
+                if (comm ? is_mcast_leader : (t_c + 1) < T_c_end) {
+                    flashattention_2_load_kv(&layer, K_fa[!buf], V_fa[!buf],
+                                             t_c + 1, comm);
+                }
             }
-            snrt_cluster_hw_barrier();
 
             snrt_mcycle();
 
-            // Calculate O tile from Q, K and V tiles
-            if (snrt_is_compute_core()) {
+            // Calculate O tile from Q, K and V tiles, unless the current
+            // column block is entirely masked
+            if (t_c < T_c_end && snrt_is_compute_core()) {
                 // Matrix multiplication between row block of Q and transposed
                 // column block of K to calculate a tile of S: S = Q * K^T.
                 // The S tile is of form (B_r, B_c)
                 gemm_args.n = B_c;
                 gemm_args.k = d;
-                gemm_args.a = Q_fa;
-                gemm_args.lda = d;
-                gemm_args.b = K_fa;
-                gemm_args.ldb = d;
+                gemm_args.a = Q_blk;
+                gemm_args.lda = ld_blk;
+                gemm_args.b = K_blk;
+                gemm_args.ldb = ld_blk;
                 gemm_args.beta = 0;
                 gemm_args.c = S_fa;
                 gemm_args.ldc = B_c;
@@ -196,27 +207,37 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
                     // Save m of current tile to rescale next tile
                     m_i_prev[row_idx] = m_i[row_idx];
 
+                    // Number of unmasked columns in the current row
+                    int32_t n_cols = flashattention_2_num_cols(
+                        &layer, t_r * B_r + row_idx, t_c);
+
                     // Initialize "local" row_sum to zero
                     row_sum = 0.0;
 
-                    // Iterate over all columns to calculate maximum for the
-                    // current row
-                    for (int col_idx = 0; col_idx < B_c; col_idx++) {
+                    // Iterate over all unmasked columns to calculate maximum
+                    // for the current row
+                    for (int col_idx = 0; col_idx < n_cols; col_idx++) {
                         float val = fp8_to_float(S_fa[row_idx * B_c + col_idx]);
                         if (val > m_i[row_idx]) m_i[row_idx] = val;
                     }
 
                     // Calculate P tile as the "local" softmax of S
-                    for (int col_idx = 0; col_idx < B_c; col_idx++) {
+                    for (int col_idx = 0; col_idx < n_cols; col_idx++) {
                         float val =
-                            expf(fp8_to_float(S_fa[row_idx * B_c + col_idx]) -
-                                 m_i[row_idx]);
+                            vmath_expf(fp8_to_float(S_fa[row_idx * B_c +
+                                                         col_idx]) -
+                                       m_i[row_idx]);
                         P_fa[row_idx * B_c + col_idx] = float_to_fp8(val);
                         row_sum += val;
                     }
 
+                    // Masked elements do not contribute to the softmax
+                    for (int col_idx = n_cols; col_idx < B_c; col_idx++) {
+                        P_fa[row_idx * B_c + col_idx] = 0;
+                    }
+
                     // Calculate rescaling factor l
-                    shifted_exp = expf(m_i_prev[row_idx] - m_i[row_idx]);
+                    shifted_exp = vmath_expf(m_i_prev[row_idx] - m_i[row_idx]);
                     if (t_c != 0) {
                         l_i[row_idx] = l_i[row_idx] * shifted_exp + row_sum;
                     } else {
@@ -255,8 +276,8 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
                     gemm_args.transb = 0;
                     gemm_args.a = P_fa;
                     gemm_args.lda = B_c;
-                    gemm_args.b = V_fa;
-                    gemm_args.ldb = d;
+                    gemm_args.b = V_blk;
+                    gemm_args.ldb = ld_blk;
                     gemm_args.beta = beta;
                     gemm_args.c = O_fa;
                     gemm_args.ldc = d;
@@ -268,8 +289,8 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
                     // we can compute P*(V^t)^t with the optimized GEMM.
 
                     // Compute V^t
-                    transpose_kernel((precision_t)dtype, V_fa, V_t, B_c, d,
-                                     baseline);
+                    transpose_kernel((precision_t)dtype, V_blk, V_t, B_c, d,
+                                     baseline, ld_blk);
 
                     // In first t_c iteration, initialize O_ij to
                     // P_ij * (V_j^t)^t. In successive t_c iterations,
@@ -290,20 +311,23 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
                     gemm_args.ldc = d;
                     sc_st_gemm(gemm_implementation, &gemm_args);
                 }
-            } else {
+            } else if (t_c < T_c_end) {
                 snrt_cluster_hw_barrier();
                 snrt_cluster_hw_barrier();
                 snrt_mcycle();
                 snrt_mcycle();
             }
-            snrt_cluster_hw_barrier();
+
+            // Wait for the next K/V blocks
+            if (snrt_is_dm_core()) snrt_dma_wait_all();
+            flashattention_2_sync(comm);
 
             snrt_mcycle();
         }  // end of T_c loop
 
         // Rescaling for last t_c iteration
         // O_i = diag(l_i_Tc)^-1 * O_i
-        if (snrt_is_compute_core()) {
+        if (is_active && snrt_is_compute_core()) {
             for (int row_idx = start_row; row_idx < end_row; row_idx++) {
                 for (int col_idx = 0; col_idx < d; col_idx++) {
                     float val = fp8_to_float(O_fa[row_idx * d + col_idx]);
@@ -319,14 +343,14 @@ static inline void flashattention_2_fp8(flashattention_2_layer_t layer) {
         snrt_mcycle();
 
         // Write back O row block (B_r, d) to DRAM
-        if (snrt_is_dm_core()) {
+        if (is_active && snrt_is_dm_core()) {
             snrt_dma_store_2d_tile(O_l3,         // dst
                                    O_fa,         // src
                                    t_r,          // tile_x1_idx
                                    0,            // tile_x0_idx
                                    B_r,          // tile_x1_size
                                    d,            // tile_x0_size
-                                   d,            // full_x0_size
+                                   ld_o,         // full_x0_size
                                    sizeof(char)  // prec
             );
             snrt_dma_wait_all();
@@ -80,32 +80,36 @@ static inline int fused_concat_linear_baseline(fused_concat_linear_layer_t l) {
     return nerr;
 }
 
+// Fuses the concatenation into the linear layer, by loading the tiles of
+// the A matrix directly from the input tensors through a tensor view. Every
+// input tensor corresponds to one K tile, which are double buffered.
 static inline int fused_concat_linear_optimized(fused_concat_linear_layer_t l) {
     uint32_t m = l.input_shape[0];
-    uint32_t k = l.input_shape[1];
+    uint32_t k = l.input_shape[1] * l.num_inputs;
     uint32_t n = l.output_shape[1];
-    uint32_t concat_k = k * l.num_inputs;
-
-    size_t size_a = m * k * l.dtype;
-    void *a = snrt_l1_alloc_cluster_local(size_a, l.dtype);
 
-    if (snrt_is_dm_core() && (snrt_cluster_idx() < l.num_inputs)) {
-        snrt_dma_load_2d_tile(a, l.inputs[snrt_cluster_idx()], 0, 0, m, k, k,
-                              l.dtype);
-        snrt_dma_wait_all();
-    }
-    snrt_cluster_hw_barrier();
+    concat_layer_t concat_layer_cfg = {
+        .num_inputs = l.num_inputs,
+        .input_shape = {l.input_shape[0], l.input_shape[1]},
+        .inputs = l.inputs,
+        .output = NULL,
+        .dtype = l.dtype};
+    snrt_dma_view_part_t *parts =
+        (snrt_dma_view_part_t *)snrt_l1_alloc_cluster_local(
+            l.num_inputs * sizeof(snrt_dma_view_part_t),
+            alignof(snrt_dma_view_part_t));
+    snrt_dma_view_t view = concat_view(concat_layer_cfg, parts);
 
     gemm_args_t gemm_args = {
-        .m_tiles = 1,
+        .m_tiles = snrt_cluster_num(),
         .n_tiles = 1,
         .k_tiles = l.num_inputs,
-        .parallelize_m = 0,
-        .parallelize_k = 1,
-        .load_a = 0,
+        .parallelize_m = 1,
+        .parallelize_k = 0,
+        .load_a = 1,
         .load_b = 1,
         .load_c = 1,
-        .double_buffer = 0,
+        .double_buffer = 1,
         .gemm_fp = l.gemm_implementation,
         .prec = l.dtype,
         .setup_ssr = 1,
@@ -113,15 +117,16 @@ static inline int fused_concat_linear_optimized(fused_concat_linear_layer_t l) {
         .transb = 0,
         .m = m,
         .n = n,
-        .k = concat_k,
+        .k = k,
         .alpha = 1.0,
-        .a = a,
-        .lda = concat_k,
+        .a = NULL,
+        .lda = k,
         .b = l.weights,
         .ldb = n,
         .beta = 0,
         .c = l.linear_output,
         .ldc = n,
+        .a_view = &view,
     };
 
     gemm(&gemm_args);
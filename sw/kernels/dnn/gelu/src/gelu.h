@@ -28,7 +28,7 @@ typedef struct gelu_layer_struct {
 // tanh based approximation of the GeLU activation function
 static inline double gelu_activation_fp64(double x) {
     return 0.5 * x *
-           (1.0 + tanh(sqrt(2.0 / M_PI) * (x + 0.044715 * x * x * x)));
+           (1.0 + vmath_tanh(sqrt(2.0 / M_PI) * (x + 0.044715 * x * x * x)));
 }
 
 // Sigmoid based approximation of the GeLU activation function
@@ -49,7 +49,6 @@ static inline double sigmoid_gelu_fp64(double x, float a, float b) {
 static inline void gelu_fp64(double *input, double *output, uint32_t size) {
     if (snrt_is_compute_core()) {
         for (uint32_t i = 0; i < size; i++) {
-            snrt_mcycle();
             // output[i] = sigmoid_gelu_fp64(input[i], -0.2888, -1.769);
             output[i] = gelu_activation_fp64(input[i]);
         }
@@ -83,7 +82,9 @@ static inline void gelu_layer(const gelu_layer_t l) {
     snrt_cluster_hw_barrier();
 
     // Cluster computation
+    snrt_mcycle();
     gelu_fp64(l1_ifmap, l1_ofmap, cluster_fmap_size);
+    snrt_mcycle();
 
     snrt_cluster_hw_barrier();
 
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import pyflexfloat as ff
+import sys
+
+import snitch.util.sim.data_utils as du
+
+np.random.seed(42)
+
+# AXI splits bursts crossing 4KB address boundaries. To minimize
+# the occurrence of these splits the data should be aligned to 4KB
+BURST_ALIGNMENT = 4096
+
+
+class GraphDataGen(du.DataGen):
+    """Feed-forward block of a post-norm transformer layer.
+
+    Computes y = LayerNorm(W2 GELU(W1 LayerNorm(x)) + x), where every row of
+    x is a token, as a graph of six tensors and five nodes.
+    """
+
+    EPS = 1e-5
+    # Unroll factor of the optimized GEMM kernels along N
+    GEMM_UNROLL = 8
+    TENSORS = ['x', 'ln1', 'fc1', 'gelu', 'fc2', 'y']
+
+    @staticmethod
+    def layernorm(x, gamma, beta, eps):
+        mean = np.mean(x, axis=-1, keepdims=True)
+        var = np.mean((x - mean)**2, axis=-1, keepdims=True)
+        return (x - mean) / np.sqrt(var + eps) * gamma + beta
+
+    @staticmethod
+    def gelu(x):
+        return 0.5 * x * (1 + np.tanh(np.sqrt(2 / np.pi) * (x + 0.044715 * x**3)))
+
+    def golden_model(self, x, w1, w2, gamma1, beta1, gamma2, beta2):
+        x, w1, w2 = [a.astype(np.float64) for a in (x, w1, w2)]
+        ln1 = self.layernorm(x, gamma1.astype(np.float64), beta1.astype(np.float64), self.EPS)
+        fc2 = self.gelu(ln1 @ w1.T) @ w2.T
+        return self.layernorm(fc2 + x, gamma2.astype(np.float64), beta2.astype(np.float64),
+                              self.EPS)
+
+    def validate(self, rows, embeddings, hidden, prec, gemm_fp, mode, tile_rows, **kwargs):
+        size = du.size_from_precision_t(prec)
+        assert prec in ['FP32', 'FP16'], 'Only FP32 and FP16 supported'
+        assert mode in ['GRAPH_LAYERS', 'GRAPH_RESIDENT'], f'Unsupported mode {mode}'
+        for cols in [embeddings, hidden]:
+            # Row-wise LayerNorm and activation kernels
+            assert (cols * size) % 32 == 0, 'Row size must be a multiple of 32B'
+            if 'opt' in gemm_fp:
+                assert cols % self.GEMM_UNROLL == 0, \
+                    f'Columns must be a multiple of {self.GEMM_UNROLL}'
+        assert rows % tile_rows == 0, 'tile_rows must divide rows'
+        assert (tile_rows * hidden) % 64 == 0, 'Activation tiles must be a multiple of 64'
+
+        # The standalone GEMM layers need the double-buffered weights and row
+        # tiles in TCDM. The resident mode falls back to them when its tensors
+        # do not fit.
+        du.validate_tcdm_footprint(2 * (tile_rows * (embeddings + hidden) +
+                                        embeddings * hidden) * size)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        self.validate(**kwargs)
+
+        rows = kwargs['rows']
+        embeddings = kwargs['embeddings']
+        hidden = kwargs['hidden']
+        prec = kwargs['prec']
+        ff_desc = du.ff_desc_from_precision_t(prec)
+        ctype = du.ctype_from_precision_t(prec)
+
+        # Scale the weights to keep the activations in the same range
+        x = ff.array(np.random.randn(rows, embeddings), ff_desc)
+        w1 = ff.array(np.random.randn(hidden, embeddings) / np.sqrt(embeddings), ff_desc)
+        w2 = ff.array(np.random.randn(embeddings, hidden) / np.sqrt(hidden), ff_desc)
+        gamma1 = ff.array(np.random.randn(embeddings), ff_desc)
+        beta1 = ff.array(np.random.randn(embeddings), ff_desc)
+        gamma2 = ff.array(np.random.randn(embeddings), ff_desc)
+        beta2 = ff.array(np.random.randn(embeddings), ff_desc)
+
+        # Tensors and nodes, in topological order
+        cols = [embeddings, embeddings, hidden, hidden, embeddings, embeddings]
+        tensors = [f'{{{c}, {uid}, {int(uid == "y")}}}' for c, uid in zip(cols, self.TENSORS)]
+        idx = {uid: i for i, uid in enumerate(self.TENSORS)}
+        nodes = [
+            f'{{GRAPH_LAYERNORM, {idx["x"]}, GRAPH_NONE, {idx["ln1"]}, gamma1, beta1, '
+            f'GELU_TANH, {self.EPS}}}',
+            f'{{GRAPH_LINEAR, {idx["ln1"]}, GRAPH_NONE, {idx["fc1"]}, w1, NULL, GELU_TANH, 0}}',
+            f'{{GRAPH_ACTIVATION, {idx["fc1"]}, GRAPH_NONE, {idx["gelu"]}, NULL, NULL, '
+            f'GELU_TANH, 0}}',
+            f'{{GRAPH_LINEAR, {idx["gelu"]}, GRAPH_NONE, {idx["fc2"]}, w2, NULL, GELU_TANH, 0}}',
+            f'{{GRAPH_LAYERNORM, {idx["fc2"]}, {idx["x"]}, {idx["y"]}, gamma2, beta2, '
+            f'GELU_TANH, {self.EPS}}}',
+        ]
+
+        layer_cfg = {
+            'rows': rows,
+            'num_tensors': len(tensors),
+            'tensors': 'tensors',
+            'num_nodes': len(nodes),
+            'nodes': 'nodes',
+            'dtype': prec,
+            'gemm_fp': kwargs['gemm_fp'],
+            'mode': kwargs['mode'],
+            'tile_rows': kwargs['tile_rows']
+        }
+
+        # Intermediate tensors are only accessed by the standalone layers
+        for uid, c in zip(self.TENSORS[1:], cols[1:]):
+            header += [du.format_array_declaration(ctype, uid, (rows, c),
+                                                   alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_definition(ctype, 'x', x, alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_definition(ctype, 'w1', w1, alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_definition(ctype, 'w2', w2, alignment=BURST_ALIGNMENT)]
+        for uid, param in zip(['gamma1', 'beta1', 'gamma2', 'beta2'],
+                              [gamma1, beta1, gamma2, beta2]):
+            header += [du.format_array_definition(ctype, uid, param,
+                                                  alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_definition('graph_tensor_t', 'tensors', np.array(tensors))]
+        header += [du.format_array_definition('graph_node_t', 'nodes', np.array(nodes))]
+        header += [du.format_struct_definition('graph_layer_t', 'layer', layer_cfg)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(GraphDataGen().main())
@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+from datagen import GraphDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+from snitch.util.sim.data_utils import ctype_from_precision_t
+
+
+class GraphVerifier(Verifier):
+
+    OUTPUT_UIDS = ['y']
+    # Errors are measured relative to the largest output magnitude, and
+    # include the error of the polynomial GELU approximation
+    ERR_THRESHOLD = {4: 1e-2, 2: 5e-2}
+
+    def __init__(self):
+        super().__init__()
+        self.layer_struct = {
+            'rows': 'I',
+            'num_tensors': 'I',
+            'tensors': 'I',
+            'num_nodes': 'I',
+            'nodes': 'I',
+            'dtype': 'I',
+            'gemm_fp': 'I',
+            'mode': 'I',
+            'tile_rows': 'I'
+        }
+        self.layer = self.get_input_from_symbol('layer', self.layer_struct)
+        self.prec = self.layer['dtype']
+        self.ctype = ctype_from_precision_t(self.prec)
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], self.ctype).astype(np.float64)
+
+    def get_expected_results(self):
+        x = self.get_input_from_symbol('x', self.ctype)
+        w1 = self.get_input_from_symbol('w1', self.ctype)
+        w2 = self.get_input_from_symbol('w2', self.ctype)
+        params = [self.get_input_from_symbol(uid, self.ctype)
+                  for uid in ['gamma1', 'beta1', 'gamma2', 'beta2']]
+        embeddings = params[0].size
+        x = x.reshape(self.layer['rows'], embeddings)
+        w1 = w1.reshape(-1, embeddings)
+        w2 = w2.reshape(embeddings, -1)
+        return GraphDataGen().golden_model(x, w1, w2, *params).flatten()
+
+    def check_results(self, actual, expected):
+        atol = self.ERR_THRESHOLD[self.prec] * np.max(np.abs(expected))
+        return super().check_results(actual, expected, atol=atol)
+
+
+if __name__ == "__main__":
+    sys.exit(GraphVerifier().main())
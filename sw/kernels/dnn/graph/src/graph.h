@@ -0,0 +1,488 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "blas.h"
+#include "snrt.h"
+
+// Maximum number of tensors in a graph
+#define GRAPH_MAX_TENSORS 16
+
+// Marks an unused tensor operand
+#define GRAPH_NONE 0xFFFFFFFF
+
+/**
+ * @brief Supported graph operations.
+ */
+typedef enum { GRAPH_LINEAR, GRAPH_LAYERNORM, GRAPH_ACTIVATION } graph_op_t;
+
+/**
+ * @brief Execution modes of a graph.
+ * @details GRAPH_LAYERS runs every node as a standalone layer, which loads
+ *          its inputs from and stores its outputs to L3. GRAPH_RESIDENT keeps
+ *          all tensors in TCDM, and only moves graph inputs, outputs and
+ *          parameters.
+ */
+typedef enum { GRAPH_LAYERS, GRAPH_RESIDENT } graph_mode_t;
+
+/**
+ * @struct graph_tensor_t
+ * @brief A rows x cols tensor, where rows is common to all tensors of a
+ *        graph.
+ * @var graph_tensor_t::cols
+ * Number of columns. The row size must be a multiple of 32 bytes
+ * @var graph_tensor_t::data
+ * Pointer to the tensor in L3. Holds the graph inputs and receives the graph
+ * outputs. Intermediate tensors are only accessed in GRAPH_LAYERS mode
+ * @var graph_tensor_t::output
+ * Whether the tensor is an output of the graph
+ */
+typedef struct {
+    uint32_t cols;
+    void *data;
+    uint32_t output;
+} graph_tensor_t;
+
+/**
+ * @struct graph_node_t
+ * @brief A row-wise operation between tensors of a graph.
+ * @var graph_node_t::op
+ * Operation computed by the node
+ * @var graph_node_t::input
+ * Index of the input tensor
+ * @var graph_node_t::residual
+ * Index of the tensor added to the input of a GRAPH_LAYERNORM node, or
+ * GRAPH_NONE
+ * @var graph_node_t::output
+ * Index of the output tensor
+ * @var graph_node_t::weights
+ * GRAPH_LINEAR: the output cols x input cols weight matrix, such that the
+ * output is input x weights^T. GRAPH_LAYERNORM: the scale parameters
+ * @var graph_node_t::bias
+ * GRAPH_LAYERNORM: the shift parameters
+ * @var graph_node_t::function
+ * GRAPH_ACTIVATION: the activation function
+ * @var graph_node_t::eps
+ * GRAPH_LAYERNORM: the epsilon added to the variance
+ */
+typedef struct {
+    graph_op_t op;
+    uint32_t input;
+    uint32_t residual;
+    uint32_t output;
+    void *weights;
+    void *bias;
+    activation_t function;
+    float eps;
+} graph_node_t;
+
+/**
+ * @struct graph_layer_t
+ * @brief A static graph of layers, executed in the order of its nodes.
+ * @var graph_layer_t::rows
+ * Number of rows of every tensor, e.g. batch size times sequence length
+ * @var graph_layer_t::num_tensors
+ * Number of tensors, at most GRAPH_MAX_TENSORS
+ * @var graph_layer_t::tensors
+ * Pointer to the tensor descriptors
+ * @var graph_layer_t::num_nodes
+ * Number of nodes
+ * @var graph_layer_t::nodes
+ * Pointer to the node descriptors, in topological order
+ * @var graph_layer_t::dtype
+ * Precision of all tensors and parameters, FP32 or FP16
+ * @var graph_layer_t::gemm_fp
+ * GEMM micro-kernel used by GRAPH_LINEAR nodes
+ * @var graph_layer_t::mode
+ * Execution mode
+ * @var graph_layer_t::tile_rows
+ * Rows in every tile of the standalone layers, in GRAPH_LAYERS mode
+ */
+typedef struct {
+    uint32_t rows;
+    uint32_t num_tensors;
+    graph_tensor_t *tensors;
+    uint32_t num_nodes;
+    graph_node_t *nodes;
+    precision_t dtype;
+    gemm_fp_t gemm_fp;
+    graph_mode_t mode;
+    uint32_t tile_rows;
+} graph_layer_t;
+
+/**
+ * @struct graph_plan_t
+ * @brief TCDM allocation of a graph in GRAPH_RESIDENT mode.
+ * @var graph_plan_t::offset
+ * Offset of every tensor in the activation arena
+ * @var graph_plan_t::arena_size
+ * Size of the activation arena
+ * @var graph_plan_t::param_size
+ * Size of each of the two parameter buffers
+ * @var graph_plan_t::max_cols
+ * Largest number of columns of any tensor
+ */
+typedef struct {
+    uint32_t offset[GRAPH_MAX_TENSORS];
+    uint32_t arena_size;
+    uint32_t param_size;
+    uint32_t max_cols;
+} graph_plan_t;
+
+/**
+ * @brief Size of the parameters of a node in TCDM.
+ */
+static inline uint32_t graph_param_size(graph_layer_t *l, graph_node_t *node) {
+    uint32_t in_cols = l->tensors[node->input].cols;
+    uint32_t out_cols = l->tensors[node->output].cols;
+    switch (node->op) {
+        case GRAPH_LINEAR:
+            return out_cols * in_cols * l->dtype;
+        case GRAPH_LAYERNORM:
+            return 2 * in_cols * l->dtype;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Plan the TCDM allocation of the rows of every tensor handled by
+ *        the current cluster.
+ * @details Every tensor is live from the node producing it, or from the
+ *          start for graph inputs, to the last node using it. Graph outputs
+ *          are additionally kept until the end of the following node, while
+ *          they are stored. Tensors are placed greedily, in order of
+ *          production, at the lowest offset not overlapping any tensor
+ *          whose lifetime overlaps theirs, so that tensors with disjoint
+ *          lifetimes share memory.
+ */
+static inline void graph_plan(graph_layer_t *l, uint32_t rows,
+                              graph_plan_t *plan) {
+    int32_t first[GRAPH_MAX_TENSORS], last[GRAPH_MAX_TENSORS];
+    uint32_t size[GRAPH_MAX_TENSORS];
+
+    // Compute the lifetimes
+    plan->max_cols = 0;
+    for (uint32_t t = 0; t < l->num_tensors; t++) {
+        first[t] = -1;
+        last[t] = -1;
+        size[t] = rows * l->tensors[t].cols * l->dtype;
+        if (l->tensors[t].cols > plan->max_cols)
+            plan->max_cols = l->tensors[t].cols;
+    }
+    plan->param_size = 0;
+    for (uint32_t i = 0; i < l->num_nodes; i++) {
+        graph_node_t *node = &l->nodes[i];
+        last[node->input] = i;
+        if (node->residual != GRAPH_NONE) last[node->residual] = i;
+        first[node->output] = i;
+        last[node->output] = l->tensors[node->output].output ? i + 1 : i;
+        uint32_t param_size = graph_param_size(l, node);
+        if (param_size > plan->param_size) plan->param_size = param_size;
+    }
+
+    // Place the tensors in order of production
+    uint32_t placed[GRAPH_MAX_TENSORS] = {0};
+    plan->arena_size = 0;
+    for (int32_t i = -1; i < (int32_t)l->num_nodes; i++) {
+        for (uint32_t t = 0; t < l->num_tensors; t++) {
+            if (first[t] != i) continue;
+
+            // Bump the candidate offset past every placed tensor it
+            // overlaps with, both in time and memory, until none is left
+            uint32_t offset = 0;
+            uint32_t conflict = 1;
+            while (conflict) {
+                conflict = 0;
+                for (uint32_t u = 0; u < l->num_tensors; u++) {
+                    if (!placed[u]) continue;
+                    if (last[u] < first[t] || first[u] > last[t]) continue;
+                    uint32_t end = plan->offset[u] + size[u];
+                    if (plan->offset[u] < offset + size[t] && offset < end) {
+                        offset = end;
+                        conflict = 1;
+                    }
+                }
+            }
+            plan->offset[t] = offset;
+            placed[t] = 1;
+            if (offset + size[t] > plan->arena_size)
+                plan->arena_size = offset + size[t];
+        }
+    }
+}
+
+/**
+ * @brief Start the DMA transfers of the parameters of a node to TCDM.
+ * @details The scale and shift parameters of GRAPH_LAYERNORM nodes are
+ *          packed as expected by `layernorm_fused_row`.
+ */
+static inline void graph_load_params(graph_layer_t *l, graph_node_t *node,
+                                     char *buf) {
+    switch (node->op) {
+        case GRAPH_LINEAR:
+            snrt_dma_start_1d(buf, node->weights, graph_param_size(l, node));
+            break;
+        case GRAPH_LAYERNORM: {
+            uint32_t block_bytes = 4 * sizeof(double);
+            uint32_t n_blocks =
+                l->tensors[node->input].cols * l->dtype / block_bytes;
+            snrt_dma_start_2d(buf, node->weights, block_bytes,
+                              2 * block_bytes, block_bytes, n_blocks);
+            snrt_dma_start_2d(buf + block_bytes, node->bias, block_bytes,
+                              2 * block_bytes, block_bytes, n_blocks);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Compute a node on the rows of its tensors held in TCDM.
+ * @details Must be called by all compute cores.
+ */
+static inline void graph_compute_node(graph_layer_t *l, graph_node_t *node,
+                                      char *arena, graph_plan_t *plan,
+                                      char *params, float *scratch,
+                                      uint32_t rows) {
+    precision_t prec = l->dtype;
+    uint32_t in_cols = l->tensors[node->input].cols;
+    uint32_t out_cols = l->tensors[node->output].cols;
+    char *in = arena + plan->offset[node->input];
+    char *out = arena + plan->offset[node->output];
+    char *res = node->residual != GRAPH_NONE
+                    ? arena + plan->offset[node->residual]
+                    : NULL;
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t core_num = snrt_cluster_compute_core_num();
+
+    switch (node->op) {
+        case GRAPH_LINEAR: {
+            sc_st_gemm_args_t args;
+            args.prec = prec;
+            args.setup_ssr = 1;
+            args.partition_banks = 0;
+            args.transa = 0;
+            args.transb = 1;
+            args.m = rows;
+            args.n = out_cols;
+            args.k = in_cols;
+            args.alpha = 1;
+            args.a = in;
+            args.lda = in_cols;
+            args.b = params;
+            args.ldb = in_cols;
+            args.beta = 0;
+            args.c = out;
+            args.ldc = out_cols;
+            sc_st_gemm(l->gemm_fp, &args);
+            break;
+        }
+        case GRAPH_LAYERNORM:
+            for (uint32_t j = core_idx; j < rows; j += core_num) {
+                uint32_t offset = j * in_cols * prec;
+                layernorm_fused_row(in + offset, res ? res + offset : NULL,
+                                    out + offset, params, in_cols,
+                                    LAYERNORM_STANDARD, node->eps, prec);
+            }
+            break;
+        case GRAPH_ACTIVATION:
+            for (uint32_t j = core_idx; j < rows; j += core_num) {
+                uint32_t offset = j * in_cols * prec;
+                activation_chunk(in + offset, out + offset, scratch, in_cols,
+                                 prec, node->function, OPT);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Run every node of the graph as a standalone layer.
+ * @details Serves as the baseline for the GRAPH_RESIDENT mode. The L1
+ *          allocations of every layer are released after it completes.
+ */
+static inline void graph_run_layers(graph_layer_t *l) {
+    void *l1_next = snrt_l1_next_v2();
+
+    for (uint32_t i = 0; i < l->num_nodes; i++) {
+        graph_node_t *node = &l->nodes[i];
+        graph_tensor_t *in = &l->tensors[node->input];
+        graph_tensor_t *out = &l->tensors[node->output];
+
+        switch (node->op) {
+            case GRAPH_LINEAR: {
+                gemm_args_t args = {0};
+                args.m_tiles = l->rows / l->tile_rows;
+                args.n_tiles = 1;
+                args.k_tiles = 1;
+                args.parallelize_m = 1;
+                args.load_a = 1;
+                args.load_b = 1;
+                args.load_c = 1;
+                args.double_buffer = 1;
+                args.gemm_fp = l->gemm_fp;
+                args.prec = l->dtype;
+                args.setup_ssr = 1;
+                args.transb = 1;
+                args.m = l->rows;
+                args.n = out->cols;
+                args.k = in->cols;
+                args.alpha = 1;
+                args.a = in->data;
+                args.lda = in->cols;
+                args.b = node->weights;
+                args.ldb = in->cols;
+                args.beta = 0;
+                args.c = out->data;
+                args.ldc = out->cols;
+                gemm(&args);
+                break;
+            }
+            case GRAPH_LAYERNORM: {
+                layernorm_layer_t ln = {0};
+                ln.batch_size = 1;
+                ln.seq_len = l->rows;
+                ln.embeddings = in->cols;
+                ln.eps = node->eps;
+                ln.ifmap = in->data;
+                ln.ofmap = out->data;
+                ln.dtype = l->dtype;
+                ln.fused = 1;
+                ln.type = LAYERNORM_STANDARD;
+                ln.tile_rows = l->tile_rows;
+                ln.gamma = node->weights;
+                ln.beta = node->bias;
+                if (node->residual != GRAPH_NONE)
+                    ln.residual = l->tensors[node->residual].data;
+                layernorm_layer(ln);
+                break;
+            }
+            case GRAPH_ACTIVATION: {
+                activation_layer_t act = {0};
+                act.size = l->rows * in->cols;
+                act.ifmap = in->data;
+                act.ofmap = out->data;
+                act.dtype = l->dtype;
+                act.function = node->function;
+                act.implementation = OPT;
+                act.tile_size = l->tile_rows * in->cols;
+                activation_layer(act);
+                break;
+            }
+            default:
+                break;
+        }
+
+        snrt_l1_update_next_v2(l1_next);
+        snrt_global_barrier();
+    }
+}
+
+/**
+ * @brief Run the graph keeping all tensors resident in TCDM.
+ * @details Rows are distributed across clusters, and every cluster runs
+ *          the whole graph on its rows. Only the graph inputs are loaded
+ *          and the graph outputs stored, while the intermediate tensors
+ *          never leave TCDM. The parameters of the next node are prefetched,
+ *          and the outputs of the previous node are stored, while the
+ *          compute cores process the current node.
+ * @return Zero on success, or a non-zero value if the tensors do not fit in
+ *         TCDM, in which case nothing is executed.
+ */
+static inline int graph_run_resident(graph_layer_t *l) {
+    precision_t prec = l->dtype;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t row0 = l->rows * cluster_idx / num_clusters;
+    uint32_t rows = l->rows * (cluster_idx + 1) / num_clusters - row0;
+
+    // Plan the allocation, and check that it fits in TCDM along with the
+    // double-buffered parameters and the scratchpads of the compute cores.
+    // All clusters plan for the largest share of rows, to take the same
+    // decision.
+    graph_plan_t plan;
+    graph_plan(l, (l->rows + num_clusters - 1) / num_clusters, &plan);
+    uint32_t scratch_size = plan.max_cols * sizeof(float);
+    uint32_t footprint =
+        plan.arena_size + 2 * plan.param_size +
+        snrt_cluster_compute_core_num() * scratch_size + 4 * sizeof(double);
+    if (snrt_l1_next_v2() + footprint > (void *)snrt_l1_allocator_v2()->end)
+        return 1;
+
+    char *arena =
+        (char *)snrt_l1_alloc_cluster_local(plan.arena_size, alignof(double));
+    char *params[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        params[i] = (char *)snrt_l1_alloc_cluster_local(plan.param_size,
+                                                        alignof(double));
+    }
+    float *scratch = (float *)snrt_l1_alloc_compute_core_local(
+        scratch_size, alignof(double));
+
+    // Load the rows of the graph inputs, and the parameters of the first
+    // node
+    if (snrt_is_dm_core()) {
+        uint32_t produced[GRAPH_MAX_TENSORS] = {0};
+        for (uint32_t i = 0; i < l->num_nodes; i++)
+            produced[l->nodes[i].output] = 1;
+        for (uint32_t t = 0; t < l->num_tensors; t++) {
+            if (produced[t]) continue;
+            uint32_t row_bytes = l->tensors[t].cols * prec;
+            snrt_dma_start_1d(arena + plan.offset[t],
+                              (char *)l->tensors[t].data + row0 * row_bytes,
+                              rows * row_bytes);
+        }
+        if (l->num_nodes) graph_load_params(l, &l->nodes[0], params[0]);
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+
+    for (uint32_t i = 0; i <= l->num_nodes; i++) {
+        if (snrt_is_dm_core()) {
+            // Prefetch the parameters of the next node
+            if (i + 1 < l->num_nodes)
+                graph_load_params(l, &l->nodes[i + 1], params[(i + 1) % 2]);
+
+            // Store the output of the previous node
+            if (i > 0) {
+                uint32_t t = l->nodes[i - 1].output;
+                if (l->tensors[t].output) {
+                    uint32_t row_bytes = l->tensors[t].cols * prec;
+                    snrt_dma_start_1d(
+                        (char *)l->tensors[t].data + row0 * row_bytes,
+                        arena + plan.offset[t], rows * row_bytes);
+                }
+            }
+            snrt_dma_wait_all();
+        }
+
+        if (snrt_is_compute_core() && i < l->num_nodes) {
+            graph_compute_node(l, &l->nodes[i], arena, &plan, params[i % 2],
+                               scratch, rows);
+        }
+
+        snrt_cluster_hw_barrier();
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Graph layer
+ * @details Runs the graph in the requested mode. GRAPH_RESIDENT falls back
+ *          to GRAPH_LAYERS if the tensors do not fit in TCDM.
+ *          Every cluster must call this function.
+ */
+static inline void graph_layer(graph_layer_t l) {
+    snrt_mcycle();
+    if (l.mode != GRAPH_RESIDENT || graph_run_resident(&l))
+        graph_run_layers(&l);
+    snrt_mcycle();
+
+    snrt_global_barrier();
+}
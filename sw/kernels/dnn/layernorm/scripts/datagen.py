@@ -27,16 +27,31 @@ torch.manual_seed(42)
 BURST_ALIGNMENT = 4096
 
 
-def golden_model(ifmap, eps):
-    # Compute the mean and variance considering the last dimension (embeddings)
-    # The dimensions for mean and variance calculations are (-1,), meaning the last dimension.
-    # Keep the dimensions for broadcasting in normalization.
-    mean = np.mean(ifmap, axis=(-1,), keepdims=True)
-    diff = ifmap - mean
-    var = np.mean(diff*diff, axis=(-1,), keepdims=True)
-
-    # Normalize the input tensor
-    ofmap = (ifmap - mean) / np.sqrt(var + eps)
+def golden_model(ifmap, eps, norm='LAYERNORM_STANDARD', gamma=None, beta=None, residual=None):
+    # Add the residual before normalization, as in the fused kernels
+    if residual is not None:
+        ifmap = ifmap + residual
+
+    # RMSNorm only scales the input by its root mean square
+    if norm == 'LAYERNORM_RMS':
+        ms = np.mean(ifmap*ifmap, axis=(-1,), keepdims=True)
+        ofmap = ifmap / np.sqrt(ms + eps)
+    else:
+        # Compute the mean and variance considering the last dimension (embeddings)
+        # The dimensions for mean and variance calculations are (-1,), meaning the last
+        # dimension. Keep the dimensions for broadcasting in normalization.
+        mean = np.mean(ifmap, axis=(-1,), keepdims=True)
+        diff = ifmap - mean
+        var = np.mean(diff*diff, axis=(-1,), keepdims=True)
+
+        # Normalize the input tensor
+        ofmap = (ifmap - mean) / np.sqrt(var + eps)
+
+    # Affine transformation
+    if gamma is not None:
+        ofmap = ofmap * gamma
+    if beta is not None:
+        ofmap = ofmap + beta
 
     return ofmap
 
@@ -52,8 +67,24 @@ def validate(**kwargs):
     seq_len = kwargs['input_dim']['seq_len']
     embeddings = kwargs['input_dim']['embeddings']
 
-    # Calculate total TCDM occupation
     prec = data_utils.size_from_precision_t(kwargs['prec'])
+
+    # Fused kernels
+    if kwargs.get('fused', False):
+        assert kwargs['prec'] in ['FP32', 'FP16'], 'Only FP32 and FP16 supported in fused' \
+                                                   ' kernels'
+        assert kwargs.get('norm', 'LAYERNORM_STANDARD') in \
+            ['LAYERNORM_STANDARD', 'LAYERNORM_RMS'], 'Unsupported norm'
+        assert (embeddings * prec) % 32 == 0, 'Row size must be a multiple of 32B'
+        assert embeddings % max(kwargs.get('concat_inputs', 1), 1) == 0, 'Embeddings must be' \
+            ' an integer multiple of concat_inputs'
+        # Double-buffered input, residual and output tiles, plus packed affine parameters
+        n_buffers = 6 if kwargs.get('residual', False) else 4
+        data_utils.validate_tcdm_footprint(n_buffers * kwargs['tile_rows'] * embeddings * prec +
+                                           2 * embeddings * prec)
+        return
+
+    # Calculate total TCDM occupation
     tiled_seq_len = seq_len / kwargs['n_tiles']
     total_size = batch_size * tiled_seq_len * embeddings * prec
     data_utils.validate_tcdm_footprint(total_size)
@@ -81,18 +112,32 @@ def emit_header(**kwargs):
     embeddings = kwargs['input_dim']['embeddings']
     eps = kwargs['eps']
     prec = kwargs['prec']
-    n_tiles = kwargs['n_tiles']
-    implementation = kwargs['implementation']
+    n_tiles = kwargs.get('n_tiles', 1)
+    implementation = kwargs.get('implementation', 'OPT')
+    fused = kwargs.get('fused', False)
+    norm = kwargs.get('norm', 'LAYERNORM_STANDARD')
+    affine = kwargs.get('affine', False)
+    residual = kwargs.get('residual', False)
+    # Number of tensors the input is concatenated from, through a tensor view
+    concat_inputs = kwargs.get('concat_inputs', 0)
 
     ff_desc = data_utils.ff_desc_from_precision_t(prec)
     ctype = data_utils.ctype_from_precision_t(prec)
 
-    # Generate random input
+    # Generate random input, and optional affine parameters and residual
     ifmap = ff.array(np.random.rand(batch_size, seq_len, embeddings), ff_desc)
-    ofmap = golden_model(ifmap, eps)
+    gamma = ff.array(np.random.rand(embeddings) + 0.5, ff_desc) if affine else None
+    beta = ff.array(np.random.randn(embeddings), ff_desc) if affine else None
+    res = ff.array(np.random.randn(batch_size, seq_len, embeddings), ff_desc) if residual \
+        else None
+    ofmap = golden_model(ifmap, eps, norm, gamma, beta, res)
 
     ifmap_uid = 'ifmap'
     ofmap_uid = 'ofmap'
+    # Underscore is used to disambiguate between this and the gamma function from "math.h"
+    gamma_uid = 'gamma_'
+    beta_uid = 'beta'
+    residual_uid = 'residual'
 
     layer_cfg = {
         **kwargs['input_dim'],
@@ -101,17 +146,55 @@ def emit_header(**kwargs):
         'ifmap': ifmap_uid,
         'ofmap': ofmap_uid,
         'eps': eps,
-        'dtype': prec
+        'dtype': prec,
+        'fused': int(fused),
+        'type': norm,
+        'tile_rows': kwargs.get('tile_rows'),
+        'gamma': gamma_uid if affine else None,
+        'beta': beta_uid if affine else None,
+        'residual': residual_uid if residual else None,
+        'ifmap_view': '&ifmap_view' if concat_inputs else None
     }
 
     data_str = [emit_license()]
     data_str += [format_array_declaration(f'extern {ctype}', ifmap_uid, ifmap.shape,
                  alignment=BURST_ALIGNMENT)]
+    if affine:
+        data_str += [format_array_declaration(f'extern {ctype}', gamma_uid, gamma.shape)]
+        data_str += [format_array_declaration(f'extern {ctype}', beta_uid, beta.shape)]
+    if residual:
+        data_str += [format_array_declaration(f'extern {ctype}', residual_uid, res.shape,
+                     alignment=BURST_ALIGNMENT)]
     data_str += [format_array_declaration(ctype, ofmap_uid, ofmap.shape,
                  alignment=BURST_ALIGNMENT)]
+    if concat_inputs:
+        # The input is additionally split along the embeddings into separate
+        # tensors, which the kernel concatenates through a tensor view
+        part_size = embeddings // concat_inputs
+        part_shape = (batch_size * seq_len, part_size)
+        parts = [ifmap.reshape(part_shape[0], embeddings)[:, i * part_size:(i + 1) * part_size]
+                 for i in range(concat_inputs)]
+        data_str += [format_array_declaration(f'extern {ctype}', f'ifmap_{i}', part_shape,
+                     alignment=BURST_ALIGNMENT) for i in range(concat_inputs)]
+        part_defs = [f'\t{{.ptr = ifmap_{i}, .x1_offset = 0, .x0_offset = {i * part_size},'
+                     f' .x1_size = {part_shape[0]}, .x0_size = {part_size}, .ld = {part_size}}}'
+                     for i in range(concat_inputs)]
+        data_str += [f'snrt_dma_view_part_t ifmap_parts[{concat_inputs}] = {{\n' +
+                     ',\n'.join(part_defs) + '\n};']
+        data_str += [format_struct_definition('snrt_dma_view_t', 'ifmap_view',
+                                              {'num_parts': concat_inputs,
+                                               'parts': 'ifmap_parts'})]
+        data_str += [format_array_definition(ctype, f'ifmap_{i}', part,
+                     alignment=BURST_ALIGNMENT) for i, part in enumerate(parts)]
     data_str += [format_struct_definition('layernorm_layer_t', 'layer', layer_cfg)]
     data_str += [format_array_definition(ctype, ifmap_uid, ifmap,
                  alignment=BURST_ALIGNMENT)]
+    if affine:
+        data_str += [format_array_definition(ctype, gamma_uid, gamma)]
+        data_str += [format_array_definition(ctype, beta_uid, beta)]
+    if residual:
+        data_str += [format_array_definition(ctype, residual_uid, res,
+                     alignment=BURST_ALIGNMENT)]
     result_def = format_array_definition(ctype, 'golden', ofmap, alignment=BURST_ALIGNMENT)
     data_str += [format_ifdef_wrapper('BIST', result_def)]
     data_str = '\n\n'.join(data_str)
@@ -28,7 +28,14 @@ class LayernormVerifier(Verifier):
             'eps': 'f',
             'ifmap_ptr': 'I',
             'ofmap_ptr': 'I',
-            'dtype': 'I'
+            'dtype': 'I',
+            'fused': 'I',
+            'type': 'I',
+            'tile_rows': 'I',
+            'gamma_ptr': 'I',
+            'beta_ptr': 'I',
+            'residual_ptr': 'I',
+            'ifmap_view': 'I'
         }
         self.layer = self.get_input_from_symbol('layer', self.layer_struct)
         self.batch_size = self.layer['batch_size']
@@ -36,6 +43,7 @@ class LayernormVerifier(Verifier):
         self.embeddings = self.layer['embeddings']
         self.eps = self.layer['eps']
         self.prec = self.layer['dtype']
+        self.norm = ['LAYERNORM_STANDARD', 'LAYERNORM_RMS'][self.layer['type']]
 
     def get_actual_results(self):
         return self.get_output_from_symbol('ofmap', ctype_from_precision_t(self.prec))
@@ -43,10 +51,20 @@ class LayernormVerifier(Verifier):
     def get_expected_results(self):
         ifmap = self.get_input_from_symbol('ifmap', ctype_from_precision_t(self.prec))
         ifmap = ifmap.reshape(self.batch_size, self.seq_len, self.embeddings)
-        return golden_model(ifmap, self.eps).flatten()
+        gamma, beta, residual = None, None, None
+        if self.layer['gamma_ptr']:
+            gamma = self.get_input_from_symbol('gamma_', ctype_from_precision_t(self.prec))
+        if self.layer['beta_ptr']:
+            beta = self.get_input_from_symbol('beta', ctype_from_precision_t(self.prec))
+        if self.layer['residual_ptr']:
+            residual = self.get_input_from_symbol('residual', ctype_from_precision_t(self.prec))
+            residual = residual.reshape(ifmap.shape)
+        return golden_model(ifmap, self.eps, self.norm, gamma, beta, residual).flatten()
 
     def check_results(self, *args):
-        return super().check_results(*args, atol=0.001)
+        # FP16 rows are normalized in half precision by the fused kernels
+        atol = 0.02 if self.prec == 2 and self.layer['fused'] else 0.001
+        return super().check_results(*args, atol=atol)
 
 
 if __name__ == "__main__":
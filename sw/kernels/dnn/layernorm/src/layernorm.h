@@ -12,7 +12,10 @@
 #include "layernorm_fp32.h"
 #include "layernorm_fp8.h"
 
-typedef enum { NAIVE, OPT } implementation_t;
+/**
+ * @brief Normalization performed by the fused layernorm kernels.
+ */
+typedef enum { LAYERNORM_STANDARD, LAYERNORM_RMS } layernorm_type_t;
 
 /**
  * @struct layernorm_layer_struct
@@ -30,6 +33,24 @@ typedef enum { NAIVE, OPT } implementation_t;
  * Pointer to input feature map
  * @var layernorm_layer_struct::ofmap
  * Pointer to output feature map
+ * @var layernorm_layer_struct::fused
+ * Use the single-pass fused kernels, which support the following fields,
+ * instead of the implementation selected by implementation
+ * @var layernorm_layer_struct::type
+ * Normalization to apply, LayerNorm or RMSNorm
+ * @var layernorm_layer_struct::tile_rows
+ * Number of rows in every tile
+ * @var layernorm_layer_struct::gamma
+ * Pointer to the scale parameters, or NULL for no scaling
+ * @var layernorm_layer_struct::beta
+ * Pointer to the shift parameters, or NULL for no shift
+ * @var layernorm_layer_struct::residual
+ * Pointer to a residual feature map, added to the input before
+ * normalization, or NULL for no residual
+ * @var layernorm_layer_struct::ifmap_view
+ * Tensor view of the (batch_size * seq_len) x embeddings input feature map,
+ * from which input tiles are loaded in place of ifmap, or NULL. Allows to
+ * fuse a preceding concatenation or slice
  */
 typedef struct layernorm_layer_struct {
     uint32_t batch_size;
@@ -41,12 +62,26 @@ typedef struct layernorm_layer_struct {
     void *ifmap;
     void *ofmap;
     precision_t dtype;
+    uint32_t fused;
+    layernorm_type_t type;
+    uint32_t tile_rows;
+    void *gamma;
+    void *beta;
+    void *residual;
+    snrt_dma_view_t *ifmap_view;
 } layernorm_layer_t;
 
+#include "layernorm_fused.h"
+
 // Tiles the seq_len axis (assumes seq_len is an integer multiple of n_tiles)
 // Distributes tiles to clusters (assumes n_tiles is an integer multiple of
 // the number of clusters)
 static inline void layernorm_layer(layernorm_layer_t l) {
+    if (l.fused) {
+        layernorm_fused_layer(l);
+        return;
+    }
+
     uint32_t data_type_size = l.dtype;
 
     snrt_mcycle();
@@ -0,0 +1,443 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Single-pass LayerNorm and RMSNorm, with fused affine transformation and
+// residual addition.
+//
+// Rows are streamed through TCDM in tiles, which are distributed across
+// clusters, and every compute core normalizes an interleaved subset of the
+// rows of a tile. Every row is read once to compute its statistics, and once
+// more to normalize it, instead of once per statistic as in the OPT kernels.
+
+/**
+ * @brief Replicate @p val over all SIMD lanes of a 64-bit word, in the
+ *        given precision.
+ */
+static inline double layernorm_fused_splat(float val, precision_t prec) {
+    v2s v2;
+    v4s v4;
+    if (prec == FP16) {
+        for (uint32_t i = 0; i < 4; i++) v4.vec[i] = (__fp16)val;
+        return v4.f64;
+    }
+    for (uint32_t i = 0; i < 2; i++) v2.vec[i] = val;
+    return v2.f64;
+}
+
+/**
+ * @brief Load element @p i of a row.
+ */
+static inline float layernorm_fused_load(void *row, uint32_t i,
+                                         precision_t prec) {
+    if (prec == FP16) return ((__fp16 *)row)[i];
+    return ((float *)row)[i];
+}
+
+/**
+ * @brief Compute the sum and sum of squares of the shifted elements
+ *        h - @p shift of a row, where h = x + r if a residual @p r is given,
+ *        and h = x otherwise.
+ * @details Shifting the data by a value in its range, e.g. its first
+ *          element, makes the single-pass variance numerically robust, as
+ *          Welford's algorithm does, without its per-element divisions.
+ *          Sums are accumulated in FP32, with up to four independent SIMD
+ *          accumulators. If a residual is given, h is stored to @p h.
+ */
+static inline void layernorm_fused_stats(void *x, void *r, void *h,
+                                         uint32_t n_words, float shift,
+                                         precision_t prec, float *sum,
+                                         float *sumsq) {
+    double s[4] = {0, 0, 0, 0};
+    double q[4] = {0, 0, 0, 0};
+    double t[4], u;
+    double k = layernorm_fused_splat(shift, FP32);
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, n_words, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, n_words, sizeof(double));
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, x);
+    if (r) {
+        snrt_ssr_loop_1d(SNRT_SSR_DM2, n_words, sizeof(double));
+        snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, r);
+        snrt_ssr_write(SNRT_SSR_DM2, SNRT_SSR_1D, h);
+    } else if (prec == FP16) {
+        // FP16 rows are widened in two halves, from two streams
+        snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, x);
+    }
+    snrt_ssr_enable();
+
+    if (prec == FP32 && !r) {
+        asm volatile(
+            "frep.o %[n_frep], 12, 0, 0 \n"
+            "vfsub.s %[t0], ft0, %[k] \n"
+            "vfsub.s %[t1], ft0, %[k] \n"
+            "vfsub.s %[t2], ft0, %[k] \n"
+            "vfsub.s %[t3], ft0, %[k] \n"
+            "vfadd.s %[s0], %[s0], %[t0] \n"
+            "vfadd.s %[s1], %[s1], %[t1] \n"
+            "vfadd.s %[s2], %[s2], %[t2] \n"
+            "vfadd.s %[s3], %[s3], %[t3] \n"
+            "vfmac.s %[q0], %[t0], %[t0] \n"
+            "vfmac.s %[q1], %[t1], %[t1] \n"
+            "vfmac.s %[q2], %[t2], %[t2] \n"
+            "vfmac.s %[q3], %[t3], %[t3] \n"
+            : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]), [ s2 ] "+f"(s[2]),
+              [ s3 ] "+f"(s[3]), [ q0 ] "+f"(q[0]), [ q1 ] "+f"(q[1]),
+              [ q2 ] "+f"(q[2]), [ q3 ] "+f"(q[3]), [ t0 ] "=&f"(t[0]),
+              [ t1 ] "=&f"(t[1]), [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+            : [ n_frep ] "r"(n_words / 4 - 1), [ k ] "f"(k)
+            : "ft0", "ft1", "ft2");
+    } else if (prec == FP32) {
+        // Two words per iteration, to fit the FREP sequencer
+        asm volatile(
+            "frep.o %[n_frep], 10, 0, 0 \n"
+            "vfadd.s %[t0], ft0, ft1 \n"
+            "vfadd.s %[t1], ft0, ft1 \n"
+            "vfsgnj.s ft2, %[t0], %[t0] \n"
+            "vfsgnj.s ft2, %[t1], %[t1] \n"
+            "vfsub.s %[t0], %[t0], %[k] \n"
+            "vfsub.s %[t1], %[t1], %[k] \n"
+            "vfadd.s %[s0], %[s0], %[t0] \n"
+            "vfadd.s %[s1], %[s1], %[t1] \n"
+            "vfmac.s %[q0], %[t0], %[t0] \n"
+            "vfmac.s %[q1], %[t1], %[t1] \n"
+            : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]), [ q0 ] "+f"(q[0]),
+              [ q1 ] "+f"(q[1]), [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1])
+            : [ n_frep ] "r"(n_words / 2 - 1), [ k ] "f"(k)
+            : "ft0", "ft1", "ft2");
+    } else if (!r) {
+        // Two words per iteration, each widened into a lower and an upper
+        // half
+        asm volatile(
+            "frep.o %[n_frep], 16, 0, 0 \n"
+            "vfcvt.s.h %[t0], ft0 \n"
+            "vfcvtu.s.h %[t1], ft1 \n"
+            "vfcvt.s.h %[t2], ft0 \n"
+            "vfcvtu.s.h %[t3], ft1 \n"
+            "vfsub.s %[t0], %[t0], %[k] \n"
+            "vfsub.s %[t1], %[t1], %[k] \n"
+            "vfsub.s %[t2], %[t2], %[k] \n"
+            "vfsub.s %[t3], %[t3], %[k] \n"
+            "vfadd.s %[s0], %[s0], %[t0] \n"
+            "vfadd.s %[s1], %[s1], %[t1] \n"
+            "vfadd.s %[s2], %[s2], %[t2] \n"
+            "vfadd.s %[s3], %[s3], %[t3] \n"
+            "vfmac.s %[q0], %[t0], %[t0] \n"
+            "vfmac.s %[q1], %[t1], %[t1] \n"
+            "vfmac.s %[q2], %[t2], %[t2] \n"
+            "vfmac.s %[q3], %[t3], %[t3] \n"
+            : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]), [ s2 ] "+f"(s[2]),
+              [ s3 ] "+f"(s[3]), [ q0 ] "+f"(q[0]), [ q1 ] "+f"(q[1]),
+              [ q2 ] "+f"(q[2]), [ q3 ] "+f"(q[3]), [ t0 ] "=&f"(t[0]),
+              [ t1 ] "=&f"(t[1]), [ t2 ] "=&f"(t[2]), [ t3 ] "=&f"(t[3])
+            : [ n_frep ] "r"(n_words / 2 - 1), [ k ] "f"(k)
+            : "ft0", "ft1", "ft2");
+    } else {
+        // One word per iteration, widened into a lower and an upper half
+        asm volatile(
+            "frep.o %[n_frep], 10, 0, 0 \n"
+            "vfadd.h %[u0], ft0, ft1 \n"
+            "vfsgnj.h ft2, %[u0], %[u0] \n"
+            "vfcvt.s.h %[t0], %[u0] \n"
+            "vfcvtu.s.h %[t1], %[u0] \n"
+            "vfsub.s %[t0], %[t0], %[k] \n"
+            "vfsub.s %[t1], %[t1], %[k] \n"
+            "vfadd.s %[s0], %[s0], %[t0] \n"
+            "vfadd.s %[s1], %[s1], %[t1] \n"
+            "vfmac.s %[q0], %[t0], %[t0] \n"
+            "vfmac.s %[q1], %[t1], %[t1] \n"
+            : [ s0 ] "+f"(s[0]), [ s1 ] "+f"(s[1]), [ q0 ] "+f"(q[0]),
+              [ q1 ] "+f"(q[1]), [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]),
+              [ u0 ] "=&f"(u)
+            : [ n_frep ] "r"(n_words - 1), [ k ] "f"(k)
+            : "ft0", "ft1", "ft2");
+    }
+
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+
+    // Reduce the accumulators
+    v2s v;
+    *sum = 0;
+    *sumsq = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+        v.f64 = s[i];
+        *sum += v.vec[0] + v.vec[1];
+        v.f64 = q[i];
+        *sumsq += v.vec[0] + v.vec[1];
+    }
+}
+
+/**
+ * @brief Normalize a row as y = (h - @p mean) * @p istd * gamma + beta.
+ * @details The scale and shift parameters are streamed from the interleaved
+ *          buffer @p gb, as packed by `layernorm_fused_pack_params()`.
+ *          Computation is performed in FP32. FP16 rows and parameters are
+ *          widened on the fly, and the results narrowed only when stored.
+ *          FP16 rows are normalized in C on FREP sequencers too small to
+ *          hold the 18-instruction loop body.
+ */
+static inline void layernorm_fused_normalize(void *h, void *y, void *gb,
+                                             uint32_t n_words, float mean,
+                                             float istd, precision_t prec) {
+    if (prec == FP16 && SNRT_NUM_SEQUENCER_INSNS < 18) {
+        __fp16 *h16 = (__fp16 *)h;
+        __fp16 *y16 = (__fp16 *)y;
+        __fp16 *gb16 = (__fp16 *)gb;
+        for (uint32_t i = 0; i < n_words * 4; i++) {
+            // Blocks of 16 elements of gamma followed by 16 of beta
+            uint32_t j = (i / 16) * 32 + i % 16;
+            float t = ((float)h16[i] - mean) * istd;
+            y16[i] = t * (float)gb16[j] + (float)gb16[j + 16];
+        }
+        return;
+    }
+
+    double m = layernorm_fused_splat(mean, FP32);
+    double a = layernorm_fused_splat(istd, FP32);
+    double t[4];
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, n_words, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, n_words, sizeof(double));
+    if (prec == FP32) {
+        snrt_ssr_loop_1d(SNRT_SSR_DM2, 2 * n_words, sizeof(double));
+    } else {
+        // Every word of the row is followed by its gamma and beta words
+        snrt_ssr_loop_3d(SNRT_SSR_DM2, 2, 4, n_words / 4,
+                         4 * sizeof(double), sizeof(double),
+                         8 * sizeof(double));
+    }
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, h);
+    snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_1D, y);
+    snrt_ssr_read(SNRT_SSR_DM2, prec == FP32 ? SNRT_SSR_1D : SNRT_SSR_3D,
+                  gb);
+    snrt_ssr_enable();
+
+    if (prec == FP32) {
+        asm volatile(
+            "frep.o %[n_frep], 16, 0, 0 \n"
+            "vfsub.s %[t0], ft0, %[m] \n"
+            "vfsub.s %[t1], ft0, %[m] \n"
+            "vfsub.s %[t2], ft0, %[m] \n"
+            "vfsub.s %[t3], ft0, %[m] \n"
+            "vfmul.s %[t0], %[t0], %[a] \n"
+            "vfmul.s %[t1], %[t1], %[a] \n"
+            "vfmul.s %[t2], %[t2], %[a] \n"
+            "vfmul.s %[t3], %[t3], %[a] \n"
+            "vfmul.s %[t0], %[t0], ft2 \n"
+            "vfmul.s %[t1], %[t1], ft2 \n"
+            "vfmul.s %[t2], %[t2], ft2 \n"
+            "vfmul.s %[t3], %[t3], ft2 \n"
+            "vfadd.s ft1, %[t0], ft2 \n"
+            "vfadd.s ft1, %[t1], ft2 \n"
+            "vfadd.s ft1, %[t2], ft2 \n"
+            "vfadd.s ft1, %[t3], ft2 \n"
+            : [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]), [ t2 ] "=&f"(t[2]),
+              [ t3 ] "=&f"(t[3])
+            : [ n_frep ] "r"(n_words / 4 - 1), [ m ] "f"(m), [ a ] "f"(a)
+            : "ft0", "ft1", "ft2");
+    } else {
+        // One word per iteration. The row, gamma and beta words are copied
+        // out of the streams, to be widened into a lower and an upper half.
+        // The narrowed halves are joined as FP32 values, which only alters
+        // those whose upper element is a NaN.
+        double b[2], u[3];
+        asm volatile(
+            "frep.o %[n_frep], 18, 0, 0 \n"
+            "fsgnj.d %[uh], ft0, ft0 \n"
+            "vfcvt.s.h %[t0], %[uh] \n"
+            "vfcvtu.s.h %[t1], %[uh] \n"
+            "fsgnj.d %[ug], ft2, ft2 \n"
+            "vfsub.s %[t0], %[t0], %[m] \n"
+            "vfsub.s %[t1], %[t1], %[m] \n"
+            "vfcvt.s.h %[t2], %[ug] \n"
+            "vfcvtu.s.h %[t3], %[ug] \n"
+            "vfmul.s %[t0], %[t0], %[a] \n"
+            "vfmul.s %[t1], %[t1], %[a] \n"
+            "fsgnj.d %[ub], ft2, ft2 \n"
+            "vfcvt.s.h %[b0], %[ub] \n"
+            "vfcvtu.s.h %[b1], %[ub] \n"
+            "vfmac.s %[b0], %[t0], %[t2] \n"
+            "vfmac.s %[b1], %[t1], %[t3] \n"
+            "vfcvt.h.s %[b0], %[b0] \n"
+            "vfcvt.h.s %[b1], %[b1] \n"
+            "vfcpka.s.s ft1, %[b0], %[b1] \n"
+            : [ t0 ] "=&f"(t[0]), [ t1 ] "=&f"(t[1]), [ t2 ] "=&f"(t[2]),
+              [ t3 ] "=&f"(t[3]), [ b0 ] "=&f"(b[0]), [ b1 ] "=&f"(b[1]),
+              [ uh ] "=&f"(u[0]), [ ug ] "=&f"(u[1]), [ ub ] "=&f"(u[2])
+            : [ n_frep ] "r"(n_words - 1), [ m ] "f"(m), [ a ] "f"(a)
+            : "ft0", "ft1", "ft2");
+    }
+
+    snrt_fpu_fence();
+    snrt_ssr_disable();
+}
+
+/**
+ * @brief Normalize a row of @p embeddings elements.
+ * @details If a residual row @p r is given, the sum x + r is normalized,
+ *          and the output row @p y holds the sum until it is normalized in
+ *          place.
+ */
+static inline void layernorm_fused_row(void *x, void *r, void *y, void *gb,
+                                       uint32_t embeddings,
+                                       layernorm_type_t type, float eps,
+                                       precision_t prec) {
+    uint32_t n_words = embeddings * prec / sizeof(double);
+
+    // Shift the data by its first element for LayerNorm. RMSNorm requires
+    // the plain sum of squares.
+    float shift = 0;
+    if (type == LAYERNORM_STANDARD) {
+        shift = layernorm_fused_load(x, 0, prec);
+        if (r) shift += layernorm_fused_load(r, 0, prec);
+    }
+
+    float sum, sumsq;
+    layernorm_fused_stats(x, r, y, n_words, shift, prec, &sum, &sumsq);
+
+    float mean = 0;
+    float istd;
+    if (type == LAYERNORM_STANDARD) {
+        float d = sum / embeddings;
+        mean = shift + d;
+        istd = 1.f / sqrtf(sumsq / embeddings - d * d + eps);
+    } else {
+        istd = 1.f / sqrtf(sumsq / embeddings + eps);
+    }
+
+    layernorm_fused_normalize(r ? y : x, y, gb, n_words, mean, istd, prec);
+}
+
+/**
+ * @brief Pack the scale and shift parameters in TCDM, such that they can be
+ *        streamed through a single SSR.
+ * @details Blocks of four words of gamma are followed by the corresponding
+ *          four words of beta. Missing parameters default to a scale of one
+ *          and a shift of zero. Must be called by all cores of the cluster.
+ */
+static inline void layernorm_fused_pack_params(void *gb, void *gamma,
+                                               void *beta, uint32_t embeddings,
+                                               precision_t prec) {
+    uint32_t block_bytes = 4 * sizeof(double);
+    uint32_t n_blocks = embeddings * prec / block_bytes;
+    char *g = (char *)gb;
+    char *b = g + block_bytes;
+
+    if (snrt_is_dm_core()) {
+        if (gamma)
+            snrt_dma_start_2d(g, gamma, block_bytes, 2 * block_bytes,
+                              block_bytes, n_blocks);
+        if (beta)
+            snrt_dma_start_2d(b, beta, block_bytes, 2 * block_bytes,
+                              block_bytes, n_blocks);
+        snrt_dma_wait_all();
+    } else {
+        uint32_t core_idx = snrt_cluster_core_idx();
+        uint32_t num_cores = snrt_cluster_compute_core_num();
+        double one = layernorm_fused_splat(1.f, prec);
+        for (uint32_t i = core_idx; i < n_blocks * 4; i += num_cores) {
+            uint32_t offset =
+                (i / 4) * 2 * block_bytes + (i % 4) * sizeof(double);
+            if (!gamma) *(double *)(g + offset) = one;
+            if (!beta) *(double *)(b + offset) = 0;
+        }
+    }
+    snrt_cluster_hw_barrier();
+}
+
+/**
+ * @brief Single-pass LayerNorm or RMSNorm layer, with optional affine
+ *        transformation and residual addition.
+ * @details Processes the batch_size * seq_len rows in tiles of tile_rows
+ *          rows, which are distributed across clusters and double-buffered,
+ *          so that the DMA core loads the next tile and stores the previous
+ *          one while the compute cores process the current one. The number
+ *          of rows needs not be a multiple of the tile size. Every cluster
+ *          must call this function.
+ */
+static inline void layernorm_fused_layer(layernorm_layer_t l) {
+    precision_t prec = l.dtype;
+    uint32_t row_bytes = l.embeddings * prec;
+    uint32_t n_rows = l.batch_size * l.seq_len;
+    uint32_t n_tiles_total = (n_rows + l.tile_rows - 1) / l.tile_rows;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t first_tile = n_tiles_total * cluster_idx / num_clusters;
+    uint32_t last_tile = n_tiles_total * (cluster_idx + 1) / num_clusters;
+    uint32_t n_tiles = last_tile - first_tile;
+    uint32_t tile_bytes = l.tile_rows * row_bytes;
+
+    // Allocate double buffers for the input, residual and output tiles,
+    // followed by the packed affine parameters
+    char *itile[2], *rtile[2], *otile[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        itile[i] =
+            (char *)snrt_l1_alloc_cluster_local(tile_bytes, alignof(double));
+        rtile[i] = NULL;
+        if (l.residual) {
+            rtile[i] = (char *)snrt_l1_alloc_cluster_local(tile_bytes,
+                                                           alignof(double));
+        }
+        otile[i] =
+            (char *)snrt_l1_alloc_cluster_local(tile_bytes, alignof(double));
+    }
+    void *gb = snrt_l1_alloc_cluster_local(2 * row_bytes, alignof(double));
+    layernorm_fused_pack_params(gb, l.gamma, l.beta, l.embeddings, prec);
+
+    // Software pipeline: in iteration i the DMA loads tile i and stores tile
+    // i - 2, while the compute cores process tile i - 1
+    snrt_mcycle();
+    for (uint32_t i = 0; i < n_tiles + 2; i++) {
+        if (snrt_is_dm_core()) {
+            if (i < n_tiles) {
+                uint32_t row = (first_tile + i) * l.tile_rows;
+                uint32_t size = (n_rows - row) < l.tile_rows
+                                    ? (n_rows - row) * row_bytes
+                                    : tile_bytes;
+                if (l.ifmap_view) {
+                    snrt_dma_load_2d_tile_view(itile[i % 2], l.ifmap_view,
+                                               first_tile + i, 0, l.tile_rows,
+                                               l.embeddings, prec);
+                } else {
+                    snrt_dma_start_1d(itile[i % 2],
+                                      (char *)l.ifmap + row * row_bytes, size);
+                }
+                if (l.residual)
+                    snrt_dma_start_1d(rtile[i % 2],
+                                      (char *)l.residual + row * row_bytes,
+                                      size);
+            }
+            if (i >= 2) {
+                uint32_t row = (first_tile + i - 2) * l.tile_rows;
+                uint32_t size = (n_rows - row) < l.tile_rows
+                                    ? (n_rows - row) * row_bytes
+                                    : tile_bytes;
+                snrt_dma_start_1d((char *)l.ofmap + row * row_bytes,
+                                  otile[i % 2], size);
+            }
+            snrt_dma_wait_all();
+        }
+
+        if (snrt_is_compute_core() && i >= 1 && i <= n_tiles) {
+            uint32_t b = (i - 1) % 2;
+            uint32_t row = (first_tile + i - 1) * l.tile_rows;
+            uint32_t tile_rows = (n_rows - row) < l.tile_rows
+                                     ? n_rows - row
+                                     : l.tile_rows;
+            for (uint32_t j = snrt_cluster_core_idx(); j < tile_rows;
+                 j += snrt_cluster_compute_core_num()) {
+                uint32_t offset = j * row_bytes;
+                layernorm_fused_row(itile[b] + offset,
+                                    l.residual ? rtile[b] + offset : NULL,
+                                    otile[b] + offset, gb, l.embeddings,
+                                    l.type, l.eps, prec);
+            }
+        }
+
+        snrt_cluster_hw_barrier();
+    }
+    snrt_mcycle();
+
+    snrt_global_barrier();
+}
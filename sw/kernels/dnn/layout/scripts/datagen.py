@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import pyflexfloat as ff
+import sys
+
+import snitch.util.sim.data_utils as du
+
+np.random.seed(42)
+
+# AXI splits bursts crossing 4KB address boundaries. To minimize
+# the occurrence of these splits the data should be aligned to 4KB
+BURST_ALIGNMENT = 4096
+
+
+class LayoutDataGen(du.DataGen):
+
+    LAYOUTS = ['LAYOUT_NCHW', 'LAYOUT_NHWC', 'LAYOUT_NCHWC']
+
+    @staticmethod
+    def to_layout(x, layout, block):
+        """Convert a feature map from NCHW to the given layout."""
+        N, C, H, W = x.shape
+        if layout == 'LAYOUT_NHWC':
+            return x.transpose(0, 2, 3, 1)
+        elif layout == 'LAYOUT_NCHWC':
+            return x.reshape(N, C // block, block, H, W).transpose(0, 1, 3, 4, 2)
+        return x
+
+    @staticmethod
+    def from_layout(x, layout, shape, block):
+        """Convert a flattened feature map in the given layout to NCHW."""
+        N, C, H, W = shape
+        if layout == 'LAYOUT_NHWC':
+            return x.reshape(N, H, W, C).transpose(0, 3, 1, 2)
+        elif layout == 'LAYOUT_NCHWC':
+            return x.reshape(N, C // block, H, W, block).transpose(0, 1, 4, 2, 3).reshape(shape)
+        return x.reshape(shape)
+
+    def golden_model(self, ifmap, src_layout, dst_layout, shape, block):
+        x = self.from_layout(ifmap, src_layout, shape, block)
+        return self.to_layout(x, dst_layout, block).flatten()
+
+    def validate(self, C, src_layout, dst_layout, block, tile_pixels, prec, **kwargs):
+        assert src_layout in self.LAYOUTS, f'Unsupported layout {src_layout}'
+        assert dst_layout in self.LAYOUTS, f'Unsupported layout {dst_layout}'
+        assert C % block == 0, 'block must divide the number of channels'
+
+        # Double-buffered tiles
+        du.validate_tcdm_footprint(2 * tile_pixels * C * du.size_from_precision_t(prec))
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        self.validate(**kwargs)
+
+        shape = (kwargs['N'], kwargs['C'], kwargs['H'], kwargs['W'])
+        prec = kwargs['prec']
+
+        ff_desc = du.ff_desc_from_precision_t(prec)
+        ctype = du.ctype_from_precision_t(prec)
+
+        x = ff.array(np.random.randn(*shape), ff_desc)
+        ifmap = self.to_layout(x, kwargs['src_layout'], kwargs['block']).flatten()
+
+        ifmap_uid = 'ifmap'
+        ofmap_uid = 'ofmap'
+
+        layer_cfg = {
+            'N': kwargs['N'],
+            'C': kwargs['C'],
+            'H': kwargs['H'],
+            'W': kwargs['W'],
+            'src_layout': kwargs['src_layout'],
+            'dst_layout': kwargs['dst_layout'],
+            'block': kwargs['block'],
+            'tile_pixels': kwargs['tile_pixels'],
+            'ifmap': ifmap_uid,
+            'ofmap': ofmap_uid,
+            'dtype': prec
+        }
+
+        header += [du.format_array_declaration(f'extern {ctype}', ifmap_uid, ifmap.shape,
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_declaration(ctype, ofmap_uid, ifmap.shape,
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_struct_definition('layout_layer_t', 'layer', layer_cfg)]
+        header += [du.format_array_definition(ctype, ifmap_uid, ifmap,
+                                              alignment=BURST_ALIGNMENT)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(LayoutDataGen().main())
@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import sys
+
+from datagen import LayoutDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+from snitch.util.sim.data_utils import ctype_from_precision_t
+
+
+class LayoutVerifier(Verifier):
+
+    OUTPUT_UIDS = ['ofmap']
+
+    def __init__(self):
+        super().__init__()
+        self.layer_struct = {
+            'N': 'I',
+            'C': 'I',
+            'H': 'I',
+            'W': 'I',
+            'src_layout': 'I',
+            'dst_layout': 'I',
+            'block': 'I',
+            'tile_pixels': 'I',
+            'ifmap': 'I',
+            'ofmap': 'I',
+            'dtype': 'I'
+        }
+        self.layer = self.get_input_from_symbol('layer', self.layer_struct)
+        self.prec = self.layer['dtype']
+        self.shape = (self.layer['N'], self.layer['C'], self.layer['H'], self.layer['W'])
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], ctype_from_precision_t(self.prec))
+
+    def get_expected_results(self):
+        ifmap = self.get_input_from_symbol('ifmap', ctype_from_precision_t(self.prec))
+        return LayoutDataGen().golden_model(ifmap,
+                                            LayoutDataGen.LAYOUTS[self.layer['src_layout']],
+                                            LayoutDataGen.LAYOUTS[self.layer['dst_layout']],
+                                            self.shape, self.layer['block'])
+
+    def check_results(self, *args):
+        return super().check_results(*args, atol=0)
+
+
+if __name__ == "__main__":
+    sys.exit(LayoutVerifier().main())
@@ -0,0 +1,260 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "snrt.h"
+
+/**
+ * @brief Supported tensor layouts.
+ * @details NCHWC denotes the channel-blocked layout (N, C/B, H, W, B), for a
+ *          channel block size B.
+ */
+typedef enum { LAYOUT_NCHW, LAYOUT_NHWC, LAYOUT_NCHWC } tensor_layout_t;
+
+/**
+ * @struct layout_layer_t
+ * @brief This structure contains all parameters necessary for converting
+ *        a feature map between two layouts.
+ * @details Conversions are performed entirely by the DMA engines, which
+ *          permute the elements of every tile while moving it from L3 to
+ *          TCDM, with strided 2D transfers. The compute cores are idle.
+ * @var layout_layer_t::N
+ * Batch size
+ * @var layout_layer_t::C
+ * Number of channels
+ * @var layout_layer_t::H
+ * Height of the feature map
+ * @var layout_layer_t::W
+ * Width of the feature map
+ * @var layout_layer_t::src_layout
+ * Layout of the input feature map
+ * @var layout_layer_t::dst_layout
+ * Layout of the output feature map
+ * @var layout_layer_t::block
+ * Channel block size of the NCHWC layout. Must divide @p C
+ * @var layout_layer_t::tile_pixels
+ * Number of pixels (H x W positions) in every tile, over all channels
+ * @var layout_layer_t::ifmap
+ * Pointer to the input feature map
+ * @var layout_layer_t::ofmap
+ * Pointer to the output feature map
+ * @var layout_layer_t::dtype
+ * Precision of the feature maps
+ */
+typedef struct {
+    uint32_t N;
+    uint32_t C;
+    uint32_t H;
+    uint32_t W;
+    tensor_layout_t src_layout;
+    tensor_layout_t dst_layout;
+    uint32_t block;
+    uint32_t tile_pixels;
+    void *ifmap;
+    void *ofmap;
+    precision_t dtype;
+} layout_layer_t;
+
+/**
+ * @brief Number of channels stored contiguously for every pixel.
+ * @details All supported layouts address element (c, p) of an image as
+ *          (c / e) * e * HW + (c % e) + p * e, where e is the returned
+ *          value: one for NCHW, @p C for NHWC and @p block for NCHWC.
+ */
+static inline uint32_t layout_inner_channels(tensor_layout_t layout,
+                                             uint32_t C, uint32_t block) {
+    switch (layout) {
+        case LAYOUT_NHWC:
+            return C;
+        case LAYOUT_NCHWC:
+            return block;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief Offset, in elements, of element (c, p) of an image with @p HW
+ *        pixels and @p e inner channels.
+ */
+static inline uint32_t layout_offset(uint32_t c, uint32_t p, uint32_t HW,
+                                     uint32_t e) {
+    return (c / e) * e * HW + (c % e) + p * e;
+}
+
+/**
+ * @brief Start the DMA transfers transposing an @p M x @p N matrix.
+ * @details Every element is moved by a separate beat of a 2D transfer.
+ *          One 2D transfer is issued for every row or column, whichever
+ *          is fewer.
+ * @param dst Pointer to the @p N x @p M output matrix
+ * @param src Pointer to the @p M x @p N input matrix
+ * @param M Number of rows of the input matrix
+ * @param N Number of columns of the input matrix
+ * @param dst_ld Leading dimension of the output matrix, in elements
+ * @param src_ld Leading dimension of the input matrix, in elements
+ * @param prec Size of every element, in bytes
+ */
+static inline void layout_dma_transpose(void *dst, void *src, uint32_t M,
+                                        uint32_t N, uint32_t dst_ld,
+                                        uint32_t src_ld, uint32_t prec) {
+    if (M <= N) {
+        for (uint32_t m = 0; m < M; m++) {
+            snrt_dma_start_2d((char *)dst + m * prec,
+                              (char *)src + m * src_ld * prec, prec,
+                              dst_ld * prec, prec, N);
+        }
+    } else {
+        for (uint32_t n = 0; n < N; n++) {
+            snrt_dma_start_2d((char *)dst + n * dst_ld * prec,
+                              (char *)src + n * prec, prec, prec,
+                              src_ld * prec, M);
+        }
+    }
+}
+
+/**
+ * @brief Start the DMA transfers copying a @p G x @p P matrix with
+ *        arbitrary element strides.
+ * @details Uses a single 2D transfer if the matrix is contiguous along the
+ *          same dimension in source and destination, and falls back to an
+ *          element-wise transpose otherwise. Source and destination must
+ *          each be contiguous along one of the two dimensions.
+ * @param dst_c Stride between successive rows at the destination, in elements
+ * @param dst_p Stride between successive columns at the destination
+ * @param src_c Stride between successive rows at the source
+ * @param src_p Stride between successive columns at the source
+ */
+static inline void layout_dma_copy(void *dst, void *src, uint32_t G,
+                                   uint32_t P, uint32_t dst_c, uint32_t dst_p,
+                                   uint32_t src_c, uint32_t src_p,
+                                   uint32_t prec) {
+    if (dst_c == 1 && src_c == 1) {
+        snrt_dma_start_2d(dst, src, G * prec, dst_p * prec, src_p * prec, P);
+    } else if (dst_p == 1 && src_p == 1) {
+        snrt_dma_start_2d(dst, src, P * prec, dst_c * prec, src_c * prec, G);
+    } else if (src_p == 1) {
+        layout_dma_transpose(dst, src, G, P, dst_p, src_c, prec);
+    } else {
+        layout_dma_transpose(dst, src, P, G, dst_c, src_p, prec);
+    }
+}
+
+/**
+ * @brief Start the DMA transfers converting the pixels [@p p0, @p p0 +
+ *        @p P) of an image between two layouts.
+ * @details Channels are processed in groups which are addressed by a
+ *          constant stride in both layouts, i.e. in groups of the largest
+ *          common block size.
+ * @param dst Pointer to the output image
+ * @param src Pointer to the input image
+ * @param dst_HW Number of pixels in the output image
+ * @param src_HW Number of pixels in the input image
+ * @param dst_e Inner channels of the output layout
+ * @param src_e Inner channels of the input layout
+ * @param dst_p0 First pixel in the output image
+ * @param src_p0 First pixel in the input image
+ */
+static inline void layout_dma_convert(void *dst, void *src, uint32_t C,
+                                      uint32_t P, uint32_t dst_HW,
+                                      uint32_t src_HW, uint32_t dst_e,
+                                      uint32_t src_e, uint32_t dst_p0,
+                                      uint32_t src_p0, uint32_t prec) {
+    // Size of the channel groups
+    uint32_t G = C;
+    if (dst_e > 1 && src_e > 1) {
+        uint32_t a = dst_e, b = src_e;
+        while (b) {
+            uint32_t t = a % b;
+            a = b;
+            b = t;
+        }
+        G = a;
+    } else if (dst_e > 1) {
+        G = dst_e;
+    } else if (src_e > 1) {
+        G = src_e;
+    }
+
+    // Strides within a group
+    uint32_t dst_c = (dst_e == 1) ? dst_HW : 1;
+    uint32_t src_c = (src_e == 1) ? src_HW : 1;
+
+    for (uint32_t c = 0; c < C; c += G) {
+        char *d = (char *)dst + layout_offset(c, dst_p0, dst_HW, dst_e) * prec;
+        char *s = (char *)src + layout_offset(c, src_p0, src_HW, src_e) * prec;
+        layout_dma_copy(d, s, G, P, dst_c, dst_e, src_c, src_e, prec);
+    }
+}
+
+/**
+ * @brief Layout conversion layer
+ * @details Tiles of @p tile_pixels pixels are distributed across clusters.
+ *          Every tile is permuted into the output layout while it is loaded
+ *          to TCDM, and then stored with long contiguous bursts. Loads and
+ *          stores of successive tiles overlap.
+ *          Every cluster must call this function.
+ */
+static inline void layout_layer(layout_layer_t l) {
+    uint32_t prec = l.dtype;
+    uint32_t HW = l.H * l.W;
+    uint32_t image_size = l.C * HW;
+    uint32_t src_e = layout_inner_channels(l.src_layout, l.C, l.block);
+    uint32_t dst_e = layout_inner_channels(l.dst_layout, l.C, l.block);
+
+    // Distribute tiles across clusters
+    uint32_t tiles_per_image = (HW + l.tile_pixels - 1) / l.tile_pixels;
+    uint32_t n_tiles = l.N * tiles_per_image;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t first_tile = n_tiles * cluster_idx / num_clusters;
+    uint32_t last_tile = n_tiles * (cluster_idx + 1) / num_clusters;
+
+    // Allocate double-buffered tiles
+    uint32_t tile_size = l.tile_pixels * l.C * prec;
+    char *tile[2];
+    tile[0] = (char *)snrt_l1_alloc_cluster_local(tile_size, alignof(double));
+    tile[1] = (char *)snrt_l1_alloc_cluster_local(tile_size, alignof(double));
+
+    if (snrt_is_dm_core()) {
+        snrt_mcycle();
+
+        for (uint32_t i = first_tile; i <= last_tile; i++) {
+            uint32_t buf = (i - first_tile) % 2;
+
+            // Store the previous tile. Tiles in TCDM are images of P pixels
+            // in the output layout, where every group of inner channels is
+            // stored contiguously.
+            if (i > first_tile) {
+                uint32_t n = (i - 1) / tiles_per_image;
+                uint32_t p0 = ((i - 1) % tiles_per_image) * l.tile_pixels;
+                uint32_t P = HW - p0;
+                if (P > l.tile_pixels) P = l.tile_pixels;
+                char *dst = (char *)l.ofmap +
+                            (n * image_size + p0 * dst_e) * prec;
+                snrt_dma_start_2d(dst, tile[!buf], P * dst_e * prec,
+                                  HW * dst_e * prec, P * dst_e * prec,
+                                  l.C / dst_e);
+            }
+
+            // Load and permute the current tile
+            if (i < last_tile) {
+                uint32_t n = i / tiles_per_image;
+                uint32_t p0 = (i % tiles_per_image) * l.tile_pixels;
+                uint32_t P = HW - p0;
+                if (P > l.tile_pixels) P = l.tile_pixels;
+                char *src = (char *)l.ifmap + n * image_size * prec;
+                layout_dma_convert(tile[buf], src, l.C, P, P, HW, dst_e,
+                                   src_e, 0, p0, prec);
+            }
+
+            snrt_dma_wait_all();
+        }
+
+        snrt_mcycle();
+    }
+
+    snrt_global_barrier();
+}
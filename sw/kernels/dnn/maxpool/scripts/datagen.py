@@ -7,113 +7,106 @@
 # Viviane Potocnik <vivianep@iis.ee.ethz.ch>
 # Luca Colagrande <colluca@iis.ee.ethz.ch>
 
-import argparse
-import pathlib
-import json5
-import torch
+import numpy as np
+import pyflexfloat as ff
+import sys
 
-from snitch.util.sim import data_utils
-from snitch.util.sim.data_utils import emit_license, format_struct_definition, \
-    format_array_definition, format_array_declaration, format_ifdef_wrapper
+import snitch.util.sim.data_utils as du
 
-torch.manual_seed(42)
+np.random.seed(42)
 
 # AXI splits bursts crossing 4KB address boundaries. To minimize
 # the occurrence of these splits the data should be aligned to 4KB
 BURST_ALIGNMENT = 4096
 
 
-def golden_model(ifmap, kernel):
-    max_pool = torch.nn.MaxPool2d(kernel_size=kernel)
-    return max_pool(ifmap)
-
-
-def emit_header(**kwargs):
-
-    in_channels = kwargs['channels']['in']
-    in_height = kwargs['input_dim']['height']
-    in_width = kwargs['input_dim']['width']
-    kernel_size = kwargs['kernel_size']
-    tile_ci = kwargs['tile_ci']
-    prec = kwargs['prec']
-
-    torch_type = data_utils.torch_type_from_precision_t(prec)
-    ctype = data_utils.ctype_from_precision_t(prec)
-
-    ifmap = torch.randn(1, in_channels, in_height, in_width, requires_grad=False, dtype=torch_type)
-    ofmap = golden_model(ifmap, kernel_size)
-
-    # convert from CHW to HWC format
-    ifmap = ifmap.permute(0, 2, 3, 1)
-    ofmap = ofmap.permute(0, 2, 3, 1)
-
-    n, ih, iw, ci = ifmap.shape
-    _, oh, ow, co = ofmap.shape
-
-    ifmap = data_utils.flatten(ifmap)
-    ofmap = data_utils.flatten(ofmap)
-
-    ifmap_uid = 'ifmap'
-    ofmap_uid = 'ofmap'
-
-    layer_cfg = {
-        'CO': co,
-        'CI': ci,
-        'IH': ih,
-        'IW': iw,
-        'OH': oh,
-        'OW': ow,
-        'FH': kernel_size,
-        'FW': kernel_size,
-        'tile_ci': tile_ci,
-        'ifmap': ifmap_uid,
-        'ofmap': ofmap_uid
-    }
-
-    data_str = [emit_license()]
-    # Array forward declarations
-    data_str += [format_array_declaration(f'extern {ctype}', ifmap_uid, ifmap.shape)]
-    data_str += [format_array_declaration(ctype, ofmap_uid, ofmap.shape)]
-    # Layer struct
-    data_str += [format_struct_definition('maxpool_layer_t', 'layer', layer_cfg)]
-    # Array definitions
-    data_str += [format_array_definition(ctype, ifmap_uid, ifmap)]
-    # Golden results for BIST
-    result_def = format_array_definition(ctype, 'golden', ofmap)
-    data_str += [format_ifdef_wrapper('BIST', result_def)]
-    data_str = '\n\n'.join(data_str)
-
-    return data_str
-
-
-def main():
-
-    parser = argparse.ArgumentParser(description='Generate data for layernorm kernel')
-    parser.add_argument(
-        "-c", "--cfg",
-        type=pathlib.Path,
-        required=True,
-        help='Select param config file kernel'
-    )
-    parser.add_argument(
-        '--section',
-        type=str,
-        help='Section to store matrices in')
-    parser.add_argument(
-        'output',
-        type=pathlib.Path,
-        help='Path of the output header file')
-    args = parser.parse_args()
-
-    # Load param config file
-    with args.cfg.open() as f:
-        param = json5.loads(f.read())
-    param['section'] = args.section
-
-    # Emit header file
-    with open(args.output, 'w') as f:
-        f.write(emit_header(**param))
+class MaxpoolDataGen(du.DataGen):
+
+    MODES = ['POOL_MAX', 'POOL_AVG']
+
+    @staticmethod
+    def golden_model(ifmap, mode, FH, FW, stride):
+        """Pooling of an HWC feature map."""
+        IH, IW, _ = ifmap.shape
+        OH = (IH - FH) // stride + 1
+        OW = (IW - FW) // stride + 1
+        x = ifmap.astype(np.float64)
+        windows = np.stack([x[fh:fh + (OH - 1) * stride + 1:stride,
+                              fw:fw + (OW - 1) * stride + 1:stride]
+                            for fh in range(FH) for fw in range(FW)])
+        return windows.max(axis=0) if mode == 'POOL_MAX' else windows.mean(axis=0)
+
+    def validate(self, channels, input_dim, kernel_size, stride, tile_oh, tile_ci, mode, prec,
+                 **kwargs):
+        size = du.size_from_precision_t(prec)
+        assert mode in self.MODES, f'Unsupported pooling mode {mode}'
+        assert channels['in'] == channels['out'], 'Pooling preserves the number of channels'
+        assert channels['in'] % tile_ci == 0, 'tile_ci must divide the number of channels'
+        assert (tile_ci * size) % 8 == 0, 'Channel tiles must fill a multiple of 64 bits'
+        assert kernel_size <= min(input_dim['height'], input_dim['width']), \
+            'Pooling window larger than the input'
+
+        # Double-buffered input and output tiles
+        OW = (input_dim['width'] - kernel_size) // stride + 1
+        halo_rows = (tile_oh - 1) * stride + kernel_size
+        du.validate_tcdm_footprint(
+            2 * (halo_rows * input_dim['width'] + tile_oh * OW) * tile_ci * size)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        # Windows do not overlap by default
+        kwargs.setdefault('stride', kwargs['kernel_size'])
+        kwargs.setdefault('mode', 'POOL_MAX')
+        kwargs.setdefault('tile_oh', 1)
+        self.validate(**kwargs)
+
+        C = kwargs['channels']['in']
+        IH = kwargs['input_dim']['height']
+        IW = kwargs['input_dim']['width']
+        F = kwargs['kernel_size']
+        stride = kwargs['stride']
+        prec = kwargs['prec']
+
+        ff_desc = du.ff_desc_from_precision_t(prec)
+        ctype = du.ctype_from_precision_t(prec)
+
+        ifmap = ff.array(np.random.randn(IH, IW, C), ff_desc)
+        OH = (IH - F) // stride + 1
+        OW = (IW - F) // stride + 1
+
+        ifmap_uid = 'ifmap'
+        ofmap_uid = 'ofmap'
+
+        layer_cfg = {
+            'CO': C,
+            'CI': C,
+            'IH': IH,
+            'IW': IW,
+            'OH': OH,
+            'OW': OW,
+            'FH': F,
+            'FW': F,
+            'tile_ci': kwargs['tile_ci'],
+            'ifmap': ifmap_uid,
+            'ofmap': ofmap_uid,
+            'dtype': prec,
+            'mode': kwargs['mode'],
+            'stride': stride,
+            'tile_oh': kwargs['tile_oh']
+        }
+
+        header += [du.format_array_declaration(f'extern {ctype}', ifmap_uid, ifmap.shape,
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_declaration(ctype, ofmap_uid, (OH, OW, C),
+                                               alignment=BURST_ALIGNMENT)]
+        header += [du.format_struct_definition('maxpool_layer_t', 'layer', layer_cfg)]
+        header += [du.format_array_definition(ctype, ifmap_uid, ifmap,
+                                              alignment=BURST_ALIGNMENT)]
+        header = '\n\n'.join(header)
+
+        return header
 
 
 if __name__ == '__main__':
-    main()
+    sys.exit(MaxpoolDataGen().main())
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+
+from datagen import MaxpoolDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+from snitch.util.sim.data_utils import ctype_from_precision_t
+
+
+class MaxpoolVerifier(Verifier):
+
+    OUTPUT_UIDS = ['ofmap']
+    # Maximum pooling is exact. Average pooling accumulates in the input
+    # precision, errors are measured relative to the largest output magnitude.
+    ERR_THRESHOLD = {8: 1e-10, 4: 1e-5, 2: 2e-2, 1: 0.25}
+
+    def __init__(self):
+        super().__init__()
+        self.layer_struct = {
+            'CO': 'I',
+            'CI': 'I',
+            'IH': 'I',
+            'IW': 'I',
+            'OH': 'I',
+            'OW': 'I',
+            'FH': 'I',
+            'FW': 'I',
+            'tile_ci': 'I',
+            'ifmap': 'I',
+            'ofmap': 'I',
+            'dtype': 'I',
+            'mode': 'I',
+            'stride': 'I',
+            'tile_oh': 'I'
+        }
+        self.layer = self.get_input_from_symbol('layer', self.layer_struct)
+        self.prec = self.layer['dtype']
+        self.ctype = ctype_from_precision_t(self.prec)
+        self.mode = MaxpoolDataGen.MODES[self.layer['mode']]
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], self.ctype).astype(np.float64)
+
+    def get_expected_results(self):
+        ifmap = self.get_input_from_symbol('ifmap', self.ctype)
+        ifmap = ifmap.reshape(self.layer['IH'], self.layer['IW'], self.layer['CI'])
+        return MaxpoolDataGen.golden_model(ifmap, self.mode, self.layer['FH'], self.layer['FW'],
+                                           self.layer['stride']).flatten()
+
+    def check_results(self, actual, expected):
+        atol = 0
+        if self.mode == 'POOL_AVG':
+            atol = self.ERR_THRESHOLD[self.prec] * np.max(np.abs(expected))
+        return super().check_results(actual, expected, atol=atol)
+
+
+if __name__ == "__main__":
+    sys.exit(MaxpoolVerifier().main())
@@ -2,36 +2,50 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#pragma once
+
 #include "snrt.h"
 
 /**
- * @struct conv_layer_struct
- * @brief This structure contains all parameters necessary for Convolutional
- * layers
- * @var conv_layer_struct::CO
+ * @brief Supported pooling operations.
+ */
+typedef enum { POOL_MAX, POOL_AVG } pool_mode_t;
+
+/**
+ * @struct maxpool_layer_struct
+ * @brief This structure contains all parameters necessary for pooling layers
+ * @details Feature maps are stored in HWC layout. Global average pooling is
+ *          obtained with a window covering the whole input feature map.
+ * @var maxpool_layer_struct::CO
  * Number of output channels
- * @var conv_layer_struct::CI
+ * @var maxpool_layer_struct::CI
  * Number of input channels
- * @var conv_layer_struct::IH
+ * @var maxpool_layer_struct::IH
  * Height of input feature map
- * @var conv_layer_struct::IW
+ * @var maxpool_layer_struct::IW
  * Width of input feature map
- * @var conv_layer_struct::OH
+ * @var maxpool_layer_struct::OH
  * Height of output feature map
- * @var conv_layer_struct::OW
+ * @var maxpool_layer_struct::OW
  * Width of output feature map
- * @var conv_layer_struct::FH
- * Height of filter
- * @var conv_layer_struct::FW
- * Width of filter
- * @var conv_layer_struct::ifmap
+ * @var maxpool_layer_struct::FH
+ * Height of the pooling window
+ * @var maxpool_layer_struct::FW
+ * Width of the pooling window
+ * @var maxpool_layer_struct::tile_ci
+ * Tiling factor of input channel
+ * @var maxpool_layer_struct::ifmap
  * Pointer to input feature map
- * @var conv_layer_struct::ofmap
+ * @var maxpool_layer_struct::ofmap
  * Pointer to output feature map
- * @var conv_layer_struct::tile_ci
- * Tiling factor of input channel
- * @var gemm_layer_struct::dtype
- * Precision of Convolution layer
+ * @var maxpool_layer_struct::dtype
+ * Precision of the feature maps
+ * @var maxpool_layer_struct::mode
+ * Pooling operation
+ * @var maxpool_layer_struct::stride
+ * Stride of the pooling window, along both spatial dimensions
+ * @var maxpool_layer_struct::tile_oh
+ * Number of output rows in every tile
  */
 typedef struct maxpool_layer_struct {
     uint32_t CO;
@@ -43,138 +57,276 @@ typedef struct maxpool_layer_struct {
     uint32_t FH;
     uint32_t FW;
     uint32_t tile_ci;
-    double *ifmap;
-    double *ofmap;
+    void *ifmap;
+    void *ofmap;
     precision_t dtype;
+    pool_mode_t mode;
+    uint32_t stride;
+    uint32_t tile_oh;
 } maxpool_layer_t;
 
+// Emits the reduction of a pooling window streamed through SSR0. The
+// first element initializes the accumulator, the remaining are combined with
+// the packed-SIMD instruction `op`.
+#define POOL_WINDOW_ASM(op)                       \
+    asm volatile(                                 \
+        "fmv.d %[acc], ft0 \n"                    \
+        "frep.o %[n_frep], 1, 0, 0 \n"            \
+        op " %[acc], %[acc], ft0 \n"              \
+        : [ acc ] "=&f"(acc)                      \
+        : [ n_frep ] "r"(n_frep)                  \
+        : "ft0", "ft1", "ft2")
+
 /**
- * @brief implementation of FP64 maxpooling
- *
- * @param ifmap pointer to input feature map
- * @param ofmap pointer to output feature map
- * @param CI number of input channels
- * @param FH height of filter
- * @param FW width of filter
- * @param compute_num number of compute units
+ * @brief Pack the scaling factor of an average pooling window in a 64-bit
+ *        word, replicated across all SIMD lanes.
  */
-static inline void maxpool_fp64(double *ifmap, double *ofmap, uint32_t CI,
-                                uint32_t FH, uint32_t FW,
-                                uint32_t compute_num) {
-    for (uint32_t ci = 0; ci < CI; ci += compute_num) {
-        volatile double max = ifmap[ci];
-        for (uint32_t fh = 0; fh < FH; fh++) {
-            for (uint32_t fw = 0; fw < FW; fw++) {
-                if (ifmap[(fh * FW + fw) * CI + ci] > max) {
-                    max = ifmap[(fh * FW + fw) * CI + ci];
-                }
-            }
+static inline double pool_avg_scale(precision_t prec, uint32_t window) {
+    float scale = 1.0f / (float)window;
+    switch (prec) {
+        case FP32: {
+            v2s v = {.vec = {scale, scale}};
+            return v.f64;
+        }
+        case FP16: {
+            v4s v;
+            for (uint32_t i = 0; i < 4; i++) v.vec[i] = (__fp16)scale;
+            return v.f64;
         }
-        ofmap[ci] = max;
+        case FP8: {
+            v8s v;
+            for (uint32_t i = 0; i < 8; i++) v.vec[i] = float_to_fp8(scale);
+            return v.f64;
+        }
+        default:
+            return (double)scale;
     }
 }
 
-static inline void maxpool_layer(const maxpool_layer_t *l) {
-    uint32_t cluster_num = snrt_cluster_num();
-    uint32_t cluster_id = snrt_cluster_idx();
-    uint32_t compute_num = snrt_cluster_compute_core_num();
-    uint32_t compute_id = snrt_global_core_idx();
-
-    // Each cluster loads one tile of kernel size
-    uint32_t ifmap_size = 2 * l->FH * l->FW * l->tile_ci;
-    uint32_t ofmap_size = 2 * l->tile_ci;
-
-    double *ptr = (double *)snrt_l1_next();
-    double *ifmap = ptr;
-    ptr += ifmap_size;
-    double *ofmap = ptr;
-    ptr += ofmap_size;
-
-    uint32_t read_buf = 0;
-    uint32_t write_buf = 0;
-
-    uint32_t prev_oh;
-    uint32_t prev_ow;
-    uint32_t prev_ci;
-
-    // tiles are distributed across clusters
-    for (uint32_t tile = cluster_id; tile < l->OH * l->OW;
-         tile += cluster_num) {
-        for (uint32_t ci = 0; ci < l->CI; ci += l->tile_ci) {
-            uint32_t oh = tile / l->OW;
-            uint32_t ow = tile % l->OW;
-
-            if (snrt_is_dm_core()) {
-                for (uint32_t fh = 0; fh < l->FH; fh++) {
-                    if (l->tile_ci == l->CI) {
-                        snrt_dma_start_1d(
-                            &ifmap[write_buf * (ifmap_size / 2) +
-                                   fh * l->FW * l->tile_ci], /* dst */
-                            &l->ifmap[((oh * l->FH + fh) * l->IW + ow * l->FW) *
-                                      l->CI], /* src */
-                            sizeof(double) * l->tile_ci * l->FW /* size */);
-                    } else {
-                        // printf("bubu\n");
-                        snrt_dma_start_2d(
-                            &ifmap[write_buf * (ifmap_size / 2) +
-                                   fh * l->FW * l->tile_ci], /* dst */
-                            &l->ifmap[((oh * l->FH + fh) * l->IW + ow * l->FW) *
-                                          l->CI +
-                                      ci],               /* src */
-                            sizeof(double) * l->tile_ci, /* size */
-                            sizeof(double) * l->tile_ci, /* dst_stride */
-                            sizeof(double) * l->CI,      /* src_stride */
-                            l->FW /* repetitions */);
-                    }
+/**
+ * @brief Pools a tile of a feature map in TCDM.
+ * @details Work is distributed across compute cores in units of one output
+ *          row by one 64-bit word of channels. Every unit streams its
+ *          pooling windows with a 3D SSR and writes the results with a 1D
+ *          SSR. Windows are reduced by packed-SIMD instructions, so the
+ *          channels of a pixel must fill a multiple of 64 bits.
+ *          Every compute core must call this function.
+ * @param ifmap Input tile, of shape (IH, IW, C)
+ * @param ofmap Output tile, of shape (OH, OW, C)
+ */
+static inline void pool_tile(pool_mode_t mode, precision_t prec, void *ifmap,
+                             void *ofmap, uint32_t IW, uint32_t C, uint32_t OH,
+                             uint32_t OW, uint32_t FH, uint32_t FW,
+                             uint32_t stride) {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t core_num = snrt_cluster_compute_core_num();
+    uint32_t pixel_bytes = C * prec;
+    uint32_t n_words = pixel_bytes / sizeof(double);
+    uint32_t n_units = OH * n_words;
+    uint32_t window = FH * FW;
+
+#ifdef SNRT_SUPPORTS_FREP
+    double scale = pool_avg_scale(prec, window);
+    uint32_t n_frep = window - 2;
+
+    snrt_ssr_loop_3d(SNRT_SSR_DM0, FW, FH, OW, pixel_bytes, IW * pixel_bytes,
+                     stride * pixel_bytes);
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, OW, pixel_bytes);
+
+    for (uint32_t u = core_idx; u < n_units; u += core_num) {
+        uint32_t oh = u / n_words;
+        uint32_t word = u % n_words;
+        char *src = (char *)ifmap + oh * stride * IW * pixel_bytes +
+                    word * sizeof(double);
+        char *dst = (char *)ofmap + oh * OW * pixel_bytes +
+                    word * sizeof(double);
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_3D, src);
+        snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_1D, dst);
+        snrt_ssr_enable();
+
+        for (uint32_t ow = 0; ow < OW; ow++) {
+            register double acc;
+            if (window == 1) {
+                asm volatile("fmv.d %[acc], ft0 \n" : [ acc ] "=f"(acc)::"ft0",
+                             "ft1", "ft2");
+            } else if (mode == POOL_MAX) {
+                switch (prec) {
+                    case FP64:
+                        POOL_WINDOW_ASM("fmax.d");
+                        break;
+                    case FP32:
+                        POOL_WINDOW_ASM("vfmax.s");
+                        break;
+                    case FP16:
+                        POOL_WINDOW_ASM("vfmax.h");
+                        break;
+                    default:
+                        POOL_WINDOW_ASM("vfmax.b");
+                        break;
                 }
-                snrt_dma_wait_all();
-
-                // synchronize with compute cores after loading data
-                snrt_cluster_hw_barrier();
-
-                if (!(tile == cluster_id && ci == 0)) {
-                    snrt_dma_start_2d(
-                        &l->ofmap[(prev_oh * l->OW + prev_ow) * l->CI +
-                                  prev_ci],                   /* dst */
-                        &ofmap[!read_buf * (ofmap_size / 2)], /* src */
-                        sizeof(double) * l->tile_ci,          /* size */
-                        sizeof(double) * l->CI,               /* dst_stride */
-                        sizeof(double) * l->tile_ci,          /* src_stride */
-                        1 /* repetitions */);
+            } else {
+                switch (prec) {
+                    case FP64:
+                        POOL_WINDOW_ASM("fadd.d");
+                        asm volatile("fmul.d %[acc], %[acc], %[scale] \n"
+                                     : [ acc ] "+f"(acc)
+                                     : [ scale ] "f"(scale));
+                        break;
+                    case FP32:
+                        POOL_WINDOW_ASM("vfadd.s");
+                        asm volatile("vfmul.s %[acc], %[acc], %[scale] \n"
+                                     : [ acc ] "+f"(acc)
+                                     : [ scale ] "f"(scale));
+                        break;
+                    case FP16:
+                        POOL_WINDOW_ASM("vfadd.h");
+                        asm volatile("vfmul.h %[acc], %[acc], %[scale] \n"
+                                     : [ acc ] "+f"(acc)
+                                     : [ scale ] "f"(scale));
+                        break;
+                    default:
+                        POOL_WINDOW_ASM("vfadd.b");
+                        asm volatile("vfmul.b %[acc], %[acc], %[scale] \n"
+                                     : [ acc ] "+f"(acc)
+                                     : [ scale ] "f"(scale));
+                        break;
                 }
+            }
+            asm volatile("fmv.d ft1, %[acc] \n" ::[acc] "f"(acc)
+                         : "ft0", "ft1", "ft2");
+        }
 
-                snrt_dma_wait_all();
-                write_buf = !write_buf;
-                read_buf = !read_buf;
-                prev_ci = ci;
-                prev_oh = oh;
-                prev_ow = ow;
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+    }
+#else
+    for (uint32_t u = core_idx; u < n_units; u += core_num) {
+        uint32_t oh = u / n_words;
+        uint32_t c0 = (u % n_words) * sizeof(double) / prec;
+        for (uint32_t c = c0; c < c0 + sizeof(double) / prec; c++) {
+            for (uint32_t ow = 0; ow < OW; ow++) {
+                float acc = mode == POOL_MAX ? -INFINITY : 0.0f;
+                for (uint32_t fh = 0; fh < FH; fh++) {
+                    for (uint32_t fw = 0; fw < FW; fw++) {
+                        uint32_t idx =
+                            ((oh * stride + fh) * IW + ow * stride + fw) * C +
+                            c;
+                        float x;
+                        switch (prec) {
+                            case FP64:
+                                x = ((double *)ifmap)[idx];
+                                break;
+                            case FP32:
+                                x = ((float *)ifmap)[idx];
+                                break;
+                            case FP16:
+                                x = ((__fp16 *)ifmap)[idx];
+                                break;
+                            default:
+                                x = fp8_to_float(((char *)ifmap)[idx]);
+                                break;
+                        }
+                        acc = mode == POOL_MAX ? fmaxf(acc, x) : acc + x;
+                    }
+                }
+                if (mode == POOL_AVG) acc /= window;
+                uint32_t idx = (oh * OW + ow) * C + c;
+                switch (prec) {
+                    case FP64:
+                        ((double *)ofmap)[idx] = acc;
+                        break;
+                    case FP32:
+                        ((float *)ofmap)[idx] = acc;
+                        break;
+                    case FP16:
+                        ((__fp16 *)ofmap)[idx] = acc;
+                        break;
+                    default:
+                        ((char *)ofmap)[idx] = float_to_fp8(acc);
+                        break;
+                }
             }
+        }
+    }
+#endif
+}
 
-            if (snrt_is_compute_core()) {
-                // wait for data to arrive
-                snrt_cluster_hw_barrier();
+/**
+ * @brief Pooling layer
+ * @details Tiles of tile_oh output rows by tile_ci channels are distributed
+ *          across clusters. Every tile loads the input rows covered by its
+ *          pooling windows, including the halo rows shared with the adjacent
+ *          tiles for overlapping windows. Loads and stores of the next and
+ *          previous tiles overlap with the pooling of the current tile.
+ *          Every cluster must call this function.
+ */
+static inline void maxpool_layer(const maxpool_layer_t *l) {
+    uint32_t prec = l->dtype;
 
-                maxpool_fp64(&ifmap[read_buf * ifmap_size / 2 + compute_id],
-                             &ofmap[write_buf * ofmap_size / 2 + compute_id],
-                             l->tile_ci, l->FH, l->FW, compute_num);
+    // Distribute tiles across clusters
+    uint32_t n_oh_tiles = (l->OH + l->tile_oh - 1) / l->tile_oh;
+    uint32_t n_tiles_total = n_oh_tiles * (l->CI / l->tile_ci);
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+    uint32_t first_tile = n_tiles_total * cluster_idx / num_clusters;
+    uint32_t last_tile = n_tiles_total * (cluster_idx + 1) / num_clusters;
+    uint32_t n_tiles = last_tile - first_tile;
+
+    // Allocate double buffers for the input and output tiles
+    uint32_t halo_rows = (l->tile_oh - 1) * l->stride + l->FH;
+    uint32_t itile_bytes = halo_rows * l->IW * l->tile_ci * prec;
+    uint32_t otile_bytes = l->tile_oh * l->OW * l->tile_ci * prec;
+    char *itile[2], *otile[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        itile[i] =
+            (char *)snrt_l1_alloc_cluster_local(itile_bytes, alignof(double));
+        otile[i] =
+            (char *)snrt_l1_alloc_cluster_local(otile_bytes, alignof(double));
+    }
 
-                write_buf = !write_buf;
-                read_buf = !read_buf;
+    // Software pipeline: in iteration i the DMA loads tile i and stores tile
+    // i - 2, while the compute cores pool tile i - 1
+    snrt_mcycle();
+    for (uint32_t i = 0; i < n_tiles + 2; i++) {
+        if (snrt_is_dm_core()) {
+            if (i < n_tiles) {
+                uint32_t tile = first_tile + i;
+                uint32_t oh0 = (tile % n_oh_tiles) * l->tile_oh;
+                uint32_t ci0 = (tile / n_oh_tiles) * l->tile_ci;
+                uint32_t rows = l->OH - oh0;
+                if (rows > l->tile_oh) rows = l->tile_oh;
+                rows = (rows - 1) * l->stride + l->FH;
+                char *src = (char *)l->ifmap +
+                            (oh0 * l->stride * l->IW * l->CI + ci0) * prec;
+                snrt_dma_start_2d(itile[i % 2], src, l->tile_ci * prec,
+                                  l->tile_ci * prec, l->CI * prec,
+                                  rows * l->IW);
             }
+            if (i >= 2) {
+                uint32_t tile = first_tile + i - 2;
+                uint32_t oh0 = (tile % n_oh_tiles) * l->tile_oh;
+                uint32_t ci0 = (tile / n_oh_tiles) * l->tile_ci;
+                uint32_t rows = l->OH - oh0;
+                if (rows > l->tile_oh) rows = l->tile_oh;
+                char *dst = (char *)l->ofmap +
+                            (oh0 * l->OW * l->CO + ci0) * prec;
+                snrt_dma_start_2d(dst, otile[i % 2], l->tile_ci * prec,
+                                  l->CO * prec, l->tile_ci * prec,
+                                  rows * l->OW);
+            }
+            snrt_dma_wait_all();
+        }
+
+        if (snrt_is_compute_core() && i >= 1 && i <= n_tiles) {
+            uint32_t b = (i - 1) % 2;
+            uint32_t oh0 = ((first_tile + i - 1) % n_oh_tiles) * l->tile_oh;
+            uint32_t rows = l->OH - oh0;
+            if (rows > l->tile_oh) rows = l->tile_oh;
+            pool_tile(l->mode, l->dtype, itile[b], otile[b], l->IW,
+                      l->tile_ci, rows, l->OW, l->FH, l->FW, l->stride);
         }
-    }
 
-    snrt_cluster_hw_barrier();
-
-    if (snrt_is_dm_core()) {
-        snrt_dma_start_2d(
-            &l->ofmap[(prev_oh * l->OW + prev_ow) * l->CI + prev_ci], /* dst */
-            &ofmap[!read_buf * (ofmap_size / 2)],                     /* src */
-            sizeof(double) * l->tile_ci,                              /* size */
-            sizeof(double) * l->CI,      /* dst_stride */
-            sizeof(double) * l->tile_ci, /* src_stride */
-            1 /* repetitions */);
-        snrt_dma_wait_all();
+        snrt_cluster_hw_barrier();
     }
+    snrt_mcycle();
 }
@@ -73,6 +73,23 @@ class MhaDataGen(du.DataGen):
             O_tiles.append(O_i)
         return np.concatenate(O_tiles, 0)
 
+    def fused_qkv_golden_model(self, X, W_qkv, W, num_heads, d, B_r, B_c, desc):
+        L = X.shape[0]
+        head_outputs = []
+        for head in range(num_heads):
+            # Packed QKV projection of the current head
+            W_qkv_h = W_qkv[head * 3 * d:(head + 1) * 3 * d, :]
+            QKV = ff.array(np.zeros((L, 3 * d)), desc)
+            QKV = GemmDataGen().exact_golden_model(1, X, np.transpose(W_qkv_h), 0, QKV)
+            Q = QKV[:, 0:d]
+            K = QKV[:, d:2 * d]
+            V = QKV[:, 2 * d:3 * d]
+            head_outputs.append(self.exact_flexfloat_golden_model(Q, K, V, B_r, B_c, desc))
+        # Concatenate heads and apply output projection
+        concat_output = np.concatenate(head_outputs, axis=1)
+        O = ff.array(np.zeros((L, d)), desc)
+        return GemmDataGen().exact_golden_model(1, concat_output, np.transpose(W), 0, O)
+
     # Verify layer parameters are valid
     def validate(self, num_heads, L, S, d, B_r, B_c, dtype, baseline, gemm_impl, **kwargs):
         assert num_heads > 0, 'num_heads must be greater than 0'
@@ -90,9 +107,12 @@ class MhaDataGen(du.DataGen):
         o_fa_size = B_r * d * prec
         m_i_size = B_r * prec
         l_i_size = B_r * prec
-        total_size = q_fa_size
-        total_size += k_fa_size
-        total_size += v_fa_size * 2  # V and V^t
+        total_size = v_fa_size  # V^t
+        if not kwargs.get('fused_qkv'):
+            # Q, K and V blocks, consumed in place from QKV when fused
+            total_size += q_fa_size
+            total_size += k_fa_size
+            total_size += v_fa_size
         # total_size *= num_heads ######## is this correct? jiayi #######
         total_size += s_fa_size
         total_size += p_fa_size
@@ -100,8 +120,29 @@ class MhaDataGen(du.DataGen):
         total_size += m_i_size * 2  # m_i and m_i_prev
         total_size += l_i_size
 
+        if kwargs.get('fused_qkv'):
+            d_model = kwargs['d_model']
+            assert L == S, 'Fused QKV projection requires L == S'
+            total_size += L * d_model * prec  # X
+            total_size += 3 * d * d_model * prec  # W_qkv
+            total_size += L * 3 * d * prec  # QKV
+
         du.validate_tcdm_footprint(total_size)
 
+        if kwargs.get('fused_qkv'):
+            # X*W_qkv^t
+            GemmDataGen().validate(
+                gemm_fp=gemm_impl, parallelize_m=0, parallelize_k=0, m_tiles=1, n_tiles=1,
+                k_tiles=1, transa=0, transb=1, m=L, n=3 * d, k=d_model, beta=0, load_a=0,
+                load_b=0, load_c=0
+            )
+            # Output projection
+            GemmDataGen().validate(
+                gemm_fp=gemm_impl, parallelize_m=1, parallelize_k=0, m_tiles=1, n_tiles=1,
+                k_tiles=1, transa=0, transb=1, m=L, n=d, k=num_heads * d, beta=0, load_a=1,
+                load_b=1, load_c=1
+            )
+
         # Q*K^t
         GemmDataGen().validate(
             gemm_fp=gemm_impl, parallelize_m=0, parallelize_k=0, m_tiles=1, n_tiles=1,
@@ -152,6 +193,9 @@ class MhaDataGen(du.DataGen):
         ff_desc = du.ff_desc_from_precision_t(prec)
         ctype = du.ctype_from_precision_t(prec)
 
+        if kwargs.get('fused_qkv'):
+            return self.emit_fused_qkv_header(header, gemm_impl, ff_desc, ctype, **kwargs)
+
         Q_list = []
         K_list = []
         V_list = []
@@ -215,6 +259,49 @@ class MhaDataGen(du.DataGen):
 
         return header
 
+    def emit_fused_qkv_header(self, header, gemm_impl, ff_desc, ctype, **kwargs):
+        num_heads = kwargs['num_heads']
+        L = kwargs['L']
+        d = kwargs['d']
+        d_model = kwargs['d_model']
+
+        # Scale weights to keep the attention scores in a range representable
+        # in all precisions
+        X = ff.array(np.random.rand(L, d_model), ff_desc)
+        W_qkv = ff.array(np.random.rand(num_heads * 3 * d, d_model) / d_model, ff_desc)
+        W = ff.array(np.random.rand(d, num_heads * d) / (num_heads * d), ff_desc)
+        concat_output = np.zeros((L, num_heads * d), dtype=ctype)
+        O_mha = np.zeros((L, d), dtype=ctype)
+
+        x_uid = 'X'
+        w_qkv_uid = 'W_qkv'
+        w_uid = 'W'
+        concat_uid = 'concat_output'
+        o_uid = 'O'
+
+        layer_cfg = {
+            **kwargs,
+            'gemm_implementation': gemm_impl,
+            'W': w_uid,
+            'O': o_uid,
+            'X': x_uid,
+            'W_qkv': w_qkv_uid,
+            'concat_output': concat_uid,
+        }
+
+        header += [du.format_array_declaration(f'extern {ctype}', x_uid, X.shape)]
+        header += [du.format_array_declaration(f'extern {ctype}', w_qkv_uid, W_qkv.shape)]
+        header += [du.format_array_declaration(f'extern {ctype}', w_uid, W.shape)]
+        header += [du.format_array_declaration(ctype, concat_uid, concat_output.shape)]
+        header += [du.format_array_declaration(ctype, o_uid, O_mha.shape)]
+        header += [du.format_struct_definition('mha_layer_t', 'layer', layer_cfg)]
+        header += [du.format_array_definition(ctype, x_uid, X)]
+        header += [du.format_array_definition(ctype, w_qkv_uid, W_qkv)]
+        header += [du.format_array_definition(ctype, w_uid, W)]
+        header = '\n\n'.join(header)
+
+        return header
+
 
 if __name__ == '__main__':
     sys.exit(MhaDataGen().main())
@@ -15,6 +15,7 @@ from snitch.util.sim.verif_utils import Verifier
 import snitch.util.sim.data_utils as du
 from snitch.blas.gemm.scripts.datagen import GemmDataGen
 from snitch.dnn.flashattention_2.scripts.datagen import FlashAttention2DataGen
+from datagen import MhaDataGen
 
 
 class MhaVerifier(Verifier):
@@ -42,7 +43,12 @@ class MhaVerifier(Verifier):
             'V': 'I',
             'W': 'I',
             'head_outputs': 'I',
-            'O': 'I'
+            'O': 'I',
+            'fused_qkv': 'I',
+            'd_model': 'I',
+            'X': 'I',
+            'W_qkv': 'I',
+            'concat_output': 'I'
         }
         self.layer = self.get_input_from_symbol('layer', self.layer_struct)
         self.L = self.layer['L']
@@ -53,8 +59,8 @@ class MhaVerifier(Verifier):
         self.prec = self.layer['dtype']
         self.num_heads = self.layer['num_heads']
         self.W = self.layer['W']
-        self.Q = [self.get_input_from_symbol('Q_' + str(head), du.ctype_from_precision_t(self.prec))
-                  for head in range(self.num_heads)]
+        self.fused_qkv = self.layer['fused_qkv']
+        self.d_model = self.layer['d_model']
 
     def get_actual_results(self):
         # Iterates over OUTPUT_UIDS in case we want to verify the intermediate outputs
@@ -65,7 +71,21 @@ class MhaVerifier(Verifier):
         results = np.concatenate(outputs, axis=None)
         return results
 
+    def get_input_tensor(self, uid, shape):
+        # Convert raw bytes to float using ff.FlexFloat.__float__, and reshape
+        ctype = du.ctype_from_precision_t(self.prec)
+        tensor = np.array([x.__float__() for x in self.get_input_from_symbol(uid, ctype)])
+        return ff.array(tensor.reshape(shape), du.ff_desc_from_precision_t(self.prec))
+
     def get_expected_results(self):
+        if self.fused_qkv:
+            X = self.get_input_tensor('X', (self.L, self.d_model))
+            W_qkv = self.get_input_tensor('W_qkv', (self.num_heads * 3 * self.d, self.d_model))
+            W = self.get_input_tensor('W', (self.d, self.num_heads * self.d))
+            return MhaDataGen().fused_qkv_golden_model(
+                X, W_qkv, W, self.num_heads, self.d, self.B_r, self.B_c,
+                du.ff_desc_from_precision_t(self.prec)).flatten()
+
         # FlashAttention-2 calculation for each head
         head_outputs = []
         for head in range(self.num_heads):
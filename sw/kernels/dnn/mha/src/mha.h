@@ -34,6 +34,26 @@
  * Pointer to output tensor of each head
  * @var mha_layer_t::O
  * Pointer to output tensor
+ * @var mha_layer_t::fused_qkv
+ * Compute the Q, K and V tensors of all heads from the input tensor X, with
+ * a single GEMM per head, instead of reading them from memory. In this case
+ * Q, K, V and head_outputs are unused
+ * @var mha_layer_t::W
+ * Pointer to output projection weights. Stored in (num_heads * d, d) form,
+ * i.e. O = concat(heads) * W, by default, and transposed, in
+ * (d, num_heads * d) form, i.e. O = concat(heads) * W^T, with fused_qkv, as
+ * the SIMD GEMM kernels used for FP16 and FP8 require a transposed B matrix
+ * @var mha_layer_t::d_model
+ * Embedding dimension of the input tensor X
+ * @var mha_layer_t::X
+ * Pointer to input tensor, of shape (L, d_model)
+ * @var mha_layer_t::W_qkv
+ * Pointer to packed QKV projection weights, of shape
+ * (num_heads * 3 * d, d_model). The rows of every head are contiguous, and
+ * hold the Q, K and V projections in this order
+ * @var mha_layer_t::concat_output
+ * Pointer to concatenated output tensor of all heads, of shape
+ * (L, num_heads * d)
  */
 typedef struct {
     uint32_t num_heads;
@@ -51,8 +71,19 @@ typedef struct {
     void *W;
     void **head_outputs;
     void *O;
+    uint32_t fused_qkv;
+    uint32_t d_model;
+    void *X;
+    void *W_qkv;
+    void *concat_output;
 } mha_layer_t;
 
 #include "../mha/src/mha_fp32.h"
+#include "../mha/src/mha_fused_qkv.h"
 
-static inline void mha_layer(mha_layer_t layer) { mha_fp32(layer); }
\ No newline at end of file
+static inline void mha_layer(mha_layer_t layer) {
+    if (layer.fused_qkv)
+        mha_fused_qkv(layer);
+    else
+        mha_fp32(layer);
+}
@@ -18,8 +18,13 @@ static inline void mha_fp32(mha_layer_t layer) {
         fa2_args.K = ((float **)layer.K)[snrt_cluster_idx()];
         fa2_args.V = ((float **)layer.V)[snrt_cluster_idx()];
         fa2_args.O = ((float **)layer.head_outputs)[snrt_cluster_idx()];
+        fa2_args.ld_qkv = layer.d;
+        fa2_args.ld_o = layer.d;
+        fa2_args.qkv_in_tcdm = 0;
         fa2_args.dtype = layer.dtype;
         fa2_args.baseline = layer.baseline;
+        fa2_args.causal = 0;
+        fa2_args.multicast = 0;
         fa2_args.gemm_implementation = layer.gemm_implementation;
 
         // Call FlashAttention-2
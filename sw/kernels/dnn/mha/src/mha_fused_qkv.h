@@ -0,0 +1,148 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @brief Multi-head attention layer with fused QKV projection.
+ * @details Heads are distributed across clusters in a round-robin fashion.
+ *          The packed Q, K and V projections of a head are computed with a
+ *          single GEMM over the input tensor, and kept in TCDM, where
+ *          FlashAttention-2 consumes their blocks in place, without copying
+ *          them. Only the head output is written back to memory, into its
+ *          slice of the concatenated output tensor, which is finally
+ *          projected by the output linear layer.
+ */
+static inline void mha_fused_qkv(mha_layer_t layer) {
+    uint32_t L = layer.L;
+    uint32_t d = layer.d;
+    uint32_t d_model = layer.d_model;
+    uint32_t num_heads = layer.num_heads;
+    uint32_t prec = layer.dtype;
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t num_clusters = snrt_cluster_num();
+
+    // Allocate TCDM buffers for the input, the packed QKV weights of a head
+    // and the resulting packed Q, K and V tensors, on clusters that are
+    // assigned heads
+    uint32_t x_size = L * d_model * prec;
+    uint32_t w_qkv_size = 3 * d * d_model * prec;
+    uint32_t qkv_size = L * 3 * d * prec;
+    void *X, *W_qkv, *QKV;
+    if (cluster_idx < num_heads) {
+        X = snrt_l1_alloc_cluster_local(x_size, alignof(double));
+        W_qkv = snrt_l1_alloc_cluster_local(w_qkv_size, alignof(double));
+        QKV = snrt_l1_alloc_cluster_local(qkv_size, alignof(double));
+        if (snrt_is_dm_core()) {
+            snrt_dma_start_1d(X, layer.X, x_size);
+            snrt_dma_wait_all();
+        }
+    }
+
+    for (uint32_t head_idx = cluster_idx; head_idx < num_heads;
+         head_idx += num_clusters) {
+        // Load the QKV weights of the current head
+        if (snrt_is_dm_core()) {
+            snrt_dma_load_1d_tile(W_qkv, layer.W_qkv, head_idx, 3 * d * d_model,
+                                  prec);
+            snrt_dma_wait_all();
+        }
+        snrt_cluster_hw_barrier();
+
+        // Packed QKV projection: [Q K V] = X * W_qkv^T, of shape (L, 3 * d)
+        sc_st_gemm_args_t gemm_args;
+        gemm_args.prec = prec;
+        gemm_args.setup_ssr = !layer.baseline;
+        gemm_args.partition_banks = 0;
+        gemm_args.transa = 0;
+        gemm_args.transb = 1;
+        gemm_args.m = L;
+        gemm_args.n = 3 * d;
+        gemm_args.k = d_model;
+        gemm_args.alpha = 1;
+        gemm_args.a = X;
+        gemm_args.lda = d_model;
+        gemm_args.b = W_qkv;
+        gemm_args.ldb = d_model;
+        gemm_args.beta = 0;
+        gemm_args.c = QKV;
+        gemm_args.ldc = 3 * d;
+        sc_st_gemm(layer.gemm_implementation, &gemm_args);
+        snrt_cluster_hw_barrier();
+
+        // Prepare arguments for FlashAttention-2. Q, K and V are strided
+        // views into the packed QKV tensor in TCDM, and the output is
+        // written to the head's columns of the concatenated output tensor.
+        flashattention_2_layer_t fa2_args;
+        fa2_args.L = L;
+        fa2_args.S = L;
+        fa2_args.d = d;
+        fa2_args.B_r = layer.B_r;
+        fa2_args.B_c = layer.B_c;
+        fa2_args.Q = QKV;
+        fa2_args.K = (void *)((uintptr_t)QKV + d * prec);
+        fa2_args.V = (void *)((uintptr_t)QKV + 2 * d * prec);
+        fa2_args.O =
+            (void *)((uintptr_t)layer.concat_output + head_idx * d * prec);
+        fa2_args.ld_qkv = 3 * d;
+        fa2_args.ld_o = num_heads * d;
+        fa2_args.qkv_in_tcdm = 1;
+        fa2_args.dtype = layer.dtype;
+        fa2_args.baseline = layer.baseline;
+        fa2_args.causal = 0;
+        fa2_args.multicast = 0;
+        fa2_args.gemm_implementation = layer.gemm_implementation;
+
+        // Call FlashAttention-2, releasing its TCDM buffers afterwards
+        void *l1_next = snrt_l1_next_v2();
+        switch (layer.dtype) {
+            case FP32:
+                flashattention_2_fp32(fa2_args);
+                break;
+            case FP16:
+                flashattention_2_fp16(fa2_args);
+                break;
+            case FP8:
+                flashattention_2_fp8(fa2_args);
+                break;
+            default:
+                break;
+        }
+        snrt_l1_update_next_v2(l1_next);
+        snrt_fpu_fence();
+        snrt_cluster_hw_barrier();
+    }
+
+    snrt_fpu_fence();
+    snrt_global_barrier();
+
+    // Output projection: O = concat_output * W^T
+    gemm_args_t gemm_args = {.m_tiles = snrt_cluster_num(),
+                             .n_tiles = 1,
+                             .k_tiles = 1,
+                             .parallelize_m = 1,
+                             .parallelize_k = 0,
+                             .load_a = 1,
+                             .load_b = 1,
+                             .load_c = 1,
+                             .double_buffer = 0,
+                             .gemm_fp = layer.gemm_implementation,
+                             .prec = layer.dtype,
+                             .setup_ssr = 1,
+                             .transa = 0,
+                             .transb = 1,
+                             .m = L,
+                             .n = d,
+                             .k = num_heads * d,
+                             .alpha = 1.0,
+                             .a = layer.concat_output,
+                             .lda = num_heads * d,
+                             .b = layer.W,
+                             .ldb = num_heads * d,
+                             .beta = 0,
+                             .c = layer.O,
+                             .ldc = d};
+
+    gemm(&gemm_args);
+
+    snrt_global_barrier();
+}
@@ -10,13 +10,14 @@
 import argparse
 import pathlib
 import json5
-import torch
+import numpy as np
+import pyflexfloat as ff
 
 from snitch.util.sim import data_utils
 from snitch.util.sim.data_utils import emit_license, format_struct_definition, \
     format_array_definition, format_array_declaration, format_ifdef_wrapper
 
-torch.manual_seed(42)
+np.random.seed(42)
 
 # AXI splits bursts crossing 4KB address boundaries. To minimize
 # the occurrence of these splits the data should be aligned to 4KB
@@ -24,28 +25,55 @@ BURST_ALIGNMENT = 4096
 
 
 def golden_model(ifmap, axis):
-    softmax = torch.nn.Softmax(dim=axis)
-    return softmax(ifmap)
+    # Intermediate results are computed in double precision, as in the OPT
+    # kernel. The single-precision NAIVE kernel is within the tolerance.
+    ifmap = ifmap.astype(np.float64)
+    exps = np.exp(ifmap - np.max(ifmap, axis=axis, keepdims=True))
+    return exps / np.sum(exps, axis=axis, keepdims=True)
 
 
-def emit_header(**kwargs):
+def validate(**kwargs):
     batch_size = kwargs['input_dim']['batch_size']
     seq_len = kwargs['input_dim']['seq_len']
     input_samples = kwargs['input_dim']['input_samples']
-    reduce_dim = kwargs['reduce_dim']
-    prec = kwargs['prec']
+    prec = data_utils.size_from_precision_t(kwargs['prec'])
+
+    assert kwargs['prec'] != "FP64", 'FP64 not supported'
+    if kwargs['implementation'] == "NAIVE":
+        assert kwargs['prec'] == "FP32", 'Only FP32 supported in naive implementation'
+        data_utils.validate_tcdm_footprint(2 * batch_size * seq_len * input_samples * prec)
+    else:
+        tile_rows = kwargs['tile_rows']
+        assert kwargs['reduce_dim'] in [-1, 2], 'Only reduction along the last dimension' \
+                                                ' supported'
+        assert input_samples % max(kwargs.get('concat_inputs', 1), 1) == 0, 'Input samples' \
+            ' must be an integer multiple of concat_inputs'
+        # Double-buffered input and output tiles, plus one FP64 row per core,
+        # aligned to 8 bytes
+        data_utils.validate_tcdm_footprint(4 * tile_rows * input_samples * prec + 7 +
+                                           8 * input_samples * 8)
 
-    torch_type = data_utils.torch_type_from_precision_t(prec)
-    ifmap = torch.randn(batch_size, seq_len, input_samples, requires_grad=False, dtype=torch_type)
 
-    ofmap = golden_model(ifmap, reduce_dim)
-    ofmap = ofmap.detach().numpy()
+def emit_header(**kwargs):
 
-    ifmap = data_utils.flatten(ifmap)
-    ofmap = data_utils.flatten(ofmap)
+    # Validate parameters
+    validate(**kwargs)
 
+    batch_size = kwargs['input_dim']['batch_size']
+    seq_len = kwargs['input_dim']['seq_len']
+    input_samples = kwargs['input_dim']['input_samples']
+    reduce_dim = kwargs['reduce_dim']
+    prec = kwargs['prec']
+    implementation = kwargs['implementation']
+    # Number of tensors the input is concatenated from, through a tensor view
+    concat_inputs = kwargs.get('concat_inputs', 0)
+
+    ff_desc = data_utils.ff_desc_from_precision_t(prec)
     ctype = data_utils.ctype_from_precision_t(prec)
 
+    ifmap = ff.array(np.random.randn(batch_size, seq_len, input_samples), ff_desc)
+    ofmap = ff.array(golden_model(ifmap, reduce_dim), ff_desc)
+
     ifmap_uid = 'ifmap'
     ofmap_uid = 'ofmap'
 
@@ -54,7 +82,10 @@ def emit_header(**kwargs):
         'reduce_dim': reduce_dim,
         'ifmap': ifmap_uid,
         'ofmap': ofmap_uid,
-        'dtype': prec
+        'dtype': prec,
+        'implementation': implementation,
+        'tile_rows': kwargs.get('tile_rows'),
+        'ifmap_view': '&ifmap_view' if concat_inputs else None
     }
 
     data_str = [emit_license()]
@@ -62,6 +93,25 @@ def emit_header(**kwargs):
                  alignment=BURST_ALIGNMENT)]
     data_str += [format_array_declaration(ctype, ofmap_uid, ofmap.shape,
                  alignment=BURST_ALIGNMENT)]
+    if concat_inputs:
+        # The input is additionally split along the samples into separate
+        # tensors, which the kernel concatenates through a tensor view
+        part_size = input_samples // concat_inputs
+        part_shape = (batch_size * seq_len, part_size)
+        parts = [ifmap.reshape(part_shape[0], input_samples)[:, i * part_size:(i + 1) * part_size]
+                 for i in range(concat_inputs)]
+        data_str += [format_array_declaration(f'extern {ctype}', f'ifmap_{i}', part_shape,
+                     alignment=BURST_ALIGNMENT) for i in range(concat_inputs)]
+        part_defs = [f'\t{{.ptr = ifmap_{i}, .x1_offset = 0, .x0_offset = {i * part_size},'
+                     f' .x1_size = {part_shape[0]}, .x0_size = {part_size}, .ld = {part_size}}}'
+                     for i in range(concat_inputs)]
+        data_str += [f'snrt_dma_view_part_t ifmap_parts[{concat_inputs}] = {{\n' +
+                     ',\n'.join(part_defs) + '\n};']
+        data_str += [format_struct_definition('snrt_dma_view_t', 'ifmap_view',
+                                              {'num_parts': concat_inputs,
+                                               'parts': 'ifmap_parts'})]
+        data_str += [format_array_definition(ctype, f'ifmap_{i}', part,
+                     alignment=BURST_ALIGNMENT) for i, part in enumerate(parts)]
     data_str += [format_struct_definition('softmax_layer_t', 'layer', layer_cfg)]
     data_str += [format_array_definition(ctype, ifmap_uid, ifmap,
                  alignment=BURST_ALIGNMENT)]
@@ -74,7 +124,7 @@ def emit_header(**kwargs):
 
 def main():
 
-    parser = argparse.ArgumentParser(description='Generate data for layernorm kernel')
+    parser = argparse.ArgumentParser(description='Generate data for softmax kernel')
     parser.add_argument(
         "-c", "--cfg",
         type=pathlib.Path,
@@ -7,7 +7,7 @@
 # Viviane Potocnik <vivianep@iis.ee.ethz.ch>
 
 import sys
-import torch
+import numpy as np
 from datagen import golden_model
 
 from snitch.util.sim.verif_utils import Verifier
@@ -27,7 +27,10 @@ class SoftmaxVerifier(Verifier):
             'reduce_dim': 'i',
             'ifmap_ptr': 'I',
             'ofmap_ptr': 'I',
-            'dtype': 'I'
+            'dtype': 'I',
+            'implementation': 'I',
+            'tile_rows': 'I',
+            'ifmap_view': 'I'
         }
         self.layer = self.get_input_from_symbol('layer', self.layer_struct)
         self.batch_size = self.layer['batch_size']
@@ -37,16 +40,18 @@ class SoftmaxVerifier(Verifier):
         self.prec = self.layer['dtype']
 
     def get_actual_results(self):
-        return self.get_output_from_symbol('ofmap', ctype_from_precision_t(self.prec))
+        ofmap = self.get_output_from_symbol('ofmap', ctype_from_precision_t(self.prec))
+        return ofmap.astype(np.float32)
 
     def get_expected_results(self):
         ifmap = self.get_input_from_symbol('ifmap', ctype_from_precision_t(self.prec))
         ifmap = ifmap.reshape(self.batch_size, self.seq_len, self.input_samples)
-        ifmap = torch.from_numpy(ifmap)
-        return golden_model(ifmap, self.reduce_dim).detach().numpy().flatten()
+        return golden_model(ifmap, self.reduce_dim).flatten()
 
     def check_results(self, *args):
-        return super().check_results(*args, atol=0.003)
+        # Outputs are in [0, 1], so the tolerance is set by the output precision
+        atol = {4: 0.003, 2: 0.003, 1: 0.07}[self.prec]
+        return super().check_results(*args, atol=atol)
 
 
 if __name__ == "__main__":
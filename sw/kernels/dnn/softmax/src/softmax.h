@@ -5,6 +5,7 @@
 #pragma once
 
 #include "math.h"
+#include "primitives/primitives.h"
 #include "snrt.h"
 
 /**
@@ -23,15 +24,30 @@
  * Pointer to input feature map
  * @var softmax_layer_struct::ofmap
  * Pointer to output feature map
+ * @var softmax_layer_struct::dtype
+ * Precision of the input and output feature maps
+ * @var softmax_layer_struct::implementation
+ * Selects the single-cluster FP32 baseline (NAIVE) or the tiled,
+ * multi-cluster implementation (OPT)
+ * @var softmax_layer_struct::tile_rows
+ * Number of rows in every tile (OPT implementation only)
+ * @var softmax_layer_struct::ifmap_view
+ * Tensor view of the (batch_size * seq_len) x input_samples input feature
+ * map, from which input tiles are loaded in place of ifmap, or NULL
+ * (OPT implementation only). Allows to fuse a preceding concatenation or
+ * slice
  */
 typedef struct softmax_layer_struct {
     uint32_t batch_size;
     uint32_t seq_len;
     uint32_t input_samples;
     int32_t reduce_dim;
-    float *ifmap;
-    float *ofmap;
+    void *ifmap;
+    void *ofmap;
     precision_t dtype;
+    implementation_t implementation;
+    uint32_t tile_rows;
+    snrt_dma_view_t *ifmap_view;
 } softmax_layer_t;
 
 /**
@@ -72,12 +88,12 @@ static inline void softmax_fp32(float *input, float *output, int32_t ldI,
 }
 
 /**
- * @brief  SoftMax layer
+ * @brief  Baseline SoftMax layer (FP32 only)
  *
  * @param l softmax_layer struct that holds addresses and parameters
  *
  */
-static inline void softmax_layer(softmax_layer_t const l) {
+static inline void softmax_layer_naive(softmax_layer_t const l) {
     uint32_t cluster_num = snrt_cluster_num();
     uint32_t cluster_id = snrt_cluster_idx();
     uint32_t compute_num = snrt_cluster_compute_core_num();
@@ -133,4 +149,304 @@ static inline void softmax_layer(softmax_layer_t const l) {
     }
 
     snrt_global_barrier();
-}
\ No newline at end of file
+}
+// Emits a packed-SIMD maximum over a row streamed through SSR0, into four
+// independent accumulators to hide the FPU latency, followed by the reduction
+// of the accumulators.
+#define SOFTMAX_ROW_MAX_ASM(fmt)                                     \
+    do {                                                             \
+        if (n_frep)                                                  \
+            asm volatile(                                            \
+                "frep.o  %[n_frep], 4, 0, 0 \n"                      \
+                "vfmax." fmt " %[max0], %[max0], ft0 \n"             \
+                "vfmax." fmt " %[max1], %[max1], ft0 \n"             \
+                "vfmax." fmt " %[max2], %[max2], ft0 \n"             \
+                "vfmax." fmt " %[max3], %[max3], ft0 \n"             \
+                : [ max0 ] "+f"(max0), [ max1 ] "+f"(max1),          \
+                  [ max2 ] "+f"(max2), [ max3 ] "+f"(max3)           \
+                : [ n_frep ] "r"(n_frep - 1)                         \
+                : "ft0", "ft1", "ft2");                              \
+        asm volatile(                                                \
+            "vfmax." fmt " %[max0], %[max0], %[max1] \n"             \
+            "vfmax." fmt " %[max2], %[max2], %[max3] \n"             \
+            "vfmax." fmt " %[max0], %[max0], %[max2] \n"             \
+            : [ max0 ] "+f"(max0), [ max2 ] "+f"(max2)               \
+            : [ max1 ] "f"(max1), [ max3 ] "f"(max3));               \
+    } while (0)
+
+/**
+ * @brief Maximum of a row in TCDM.
+ * @details The row is processed in blocks of 32 bytes by a packed-SIMD FREP
+ *          loop, if it is aligned to 8 bytes, and the remaining elements
+ *          one at a time.
+ */
+static inline float softmax_row_max(void *row, uint32_t len,
+                                    precision_t prec) {
+    float max = -INFINITY;
+    uint32_t done = 0;
+#ifdef SNRT_SUPPORTS_FREP
+    uint32_t n_blocks = (uintptr_t)row % sizeof(double) ? 0 : len * prec / 32;
+    if (n_blocks) {
+        double *words = (double *)row;
+        uint32_t n_words = 4 * n_blocks;
+        uint32_t n_frep = n_blocks - 1;
+
+        // Initialize the accumulators with the first four words of the row,
+        // and stream the remaining words
+        double max0 = words[0], max1 = words[1], max2 = words[2],
+               max3 = words[3];
+        if (n_frep) {
+            snrt_ssr_loop_1d(SNRT_SSR_DM0, n_words - 4, sizeof(double));
+            snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, words + 4);
+            snrt_ssr_enable();
+        }
+        switch (prec) {
+            case FP32:
+                SOFTMAX_ROW_MAX_ASM("s");
+                break;
+            case FP16:
+                SOFTMAX_ROW_MAX_ASM("h");
+                break;
+            case FP8:
+                SOFTMAX_ROW_MAX_ASM("b");
+                break;
+            default:
+                break;
+        }
+        snrt_fpu_fence();
+        if (n_frep) snrt_ssr_disable();
+
+        // Reduce the lanes of the packed maximum
+        switch (prec) {
+            case FP32: {
+                v2s v = {.f64 = max0};
+                for (uint32_t i = 0; i < 2; i++) max = fmaxf(max, v.vec[i]);
+                break;
+            }
+            case FP16: {
+                v4s v = {.f64 = max0};
+                for (uint32_t i = 0; i < 4; i++)
+                    max = fmaxf(max, (float)v.vec[i]);
+                break;
+            }
+            case FP8: {
+                v8s v = {.f64 = max0};
+                for (uint32_t i = 0; i < 8; i++)
+                    max = fmaxf(max, fp8_to_float(v.vec[i]));
+                break;
+            }
+            default:
+                break;
+        }
+        done = n_blocks * 32 / prec;
+    }
+#endif
+    for (uint32_t i = done; i < len; i++) {
+        switch (prec) {
+            case FP32:
+                max = fmaxf(max, ((float *)row)[i]);
+                break;
+            case FP16:
+                max = fmaxf(max, (float)((__fp16 *)row)[i]);
+                break;
+            case FP8:
+                max = fmaxf(max, fp8_to_float(((char *)row)[i]));
+                break;
+            default:
+                break;
+        }
+    }
+    return max;
+}
+
+/**
+ * @brief Computes exp(x - max) for every element of a row in TCDM.
+ * @details The row is widened to double precision in @p exps and shifted by
+ *          the maximum in a single scalar pass, as the SSRs stream 64-bit
+ *          words only. The exponentials are then computed in place and
+ *          summed in one pass by the SSR/FREP path of `vmath_vexp_sum`.
+ * @return The sum of the exponentials.
+ */
+static inline double softmax_row_exp(void *row, double *exps, uint32_t len,
+                                     precision_t prec, float max) {
+    switch (prec) {
+        case FP32:
+            for (uint32_t i = 0; i < len; i++)
+                exps[i] = ((float *)row)[i] - max;
+            break;
+        case FP16:
+            for (uint32_t i = 0; i < len; i++)
+                exps[i] = (float)((__fp16 *)row)[i] - max;
+            break;
+        case FP8:
+            for (uint32_t i = 0; i < len; i++)
+                exps[i] = fp8_to_float(((char *)row)[i]) - max;
+            break;
+        default:
+            break;
+    }
+    return vmath_vexp_sum(exps, exps, len);
+}
+
+/**
+ * @brief Scales the exponentials of a row by @p inv_sum and stores them in
+ *        the output precision.
+ */
+static inline void softmax_row_normalize(double *exps, void *out, uint32_t len,
+                                         precision_t prec, double inv_sum) {
+    switch (prec) {
+        case FP32:
+            for (uint32_t i = 0; i < len; i++)
+                ((float *)out)[i] = (float)(exps[i] * inv_sum);
+            break;
+        case FP16:
+            for (uint32_t i = 0; i < len; i++)
+                ((__fp16 *)out)[i] = (__fp16)(exps[i] * inv_sum);
+            break;
+        case FP8:
+            for (uint32_t i = 0; i < len; i++)
+                ((char *)out)[i] = float_to_fp8((float)(exps[i] * inv_sum));
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Computes the softmax of a tile of rows in TCDM.
+ * @details Rows are distributed to the compute cores in an interleaved
+ *          fashion. Every row is processed in two passes over the input:
+ *          the first computes the maximum, the second widens and shifts it.
+ *          The exponentials and their sum are then computed in one pass,
+ *          and the normalization is fused with the conversion to the output
+ *          precision. All intermediate results are kept in double
+ *          precision.
+ * @param scratch Per-core buffer of @p len doubles, holding the
+ *                exponentials of a row.
+ */
+static inline void softmax_tile_opt(void *itile, void *otile, double *scratch,
+                                    uint32_t n_rows, uint32_t len,
+                                    precision_t prec) {
+    uint32_t row_size = len * prec;
+    for (uint32_t r = snrt_cluster_core_idx(); r < n_rows;
+         r += snrt_cluster_compute_core_num()) {
+        char *irow = (char *)itile + r * row_size;
+        char *orow = (char *)otile + r * row_size;
+
+        float max = softmax_row_max(irow, len, prec);
+        double sum = softmax_row_exp(irow, scratch, len, prec, max);
+        softmax_row_normalize(scratch, orow, len, prec, 1.0 / sum);
+    }
+}
+
+// Number of rows in a tile, of which only the last one of the layer may be
+// partial
+static inline uint32_t softmax_tile_rows(softmax_layer_t const *l,
+                                         uint32_t tile) {
+    uint32_t n_rows = l->batch_size * l->seq_len;
+    uint32_t rem = n_rows - tile * l->tile_rows;
+    return rem < l->tile_rows ? rem : l->tile_rows;
+}
+
+/**
+ * @brief  Tiled, multi-cluster SoftMax layer
+ * @details The softmax is computed along the last dimension. The rows of the
+ *          input are split in tiles of `tile_rows` rows, the last of which
+ *          may be partial, and the tiles in contiguous blocks across
+ *          clusters. Every cluster processes its block one tile at a time,
+ *          double buffering the tiles in TCDM, such that the DMA transfers
+ *          of the input and output tiles overlap with the computation of
+ *          the current tile.
+ *
+ * @param l softmax_layer struct that holds addresses and parameters
+ */
+static inline void softmax_layer_opt(softmax_layer_t const l) {
+    uint32_t n_rows = l.batch_size * l.seq_len;
+    uint32_t row_size = l.input_samples * l.dtype;
+    uint32_t tile_size = l.tile_rows * row_size;
+
+    // Block of tiles assigned to the current cluster
+    uint32_t n_tiles_total = (n_rows + l.tile_rows - 1) / l.tile_rows;
+    uint32_t first_tile =
+        snrt_cluster_idx() * n_tiles_total / snrt_cluster_num();
+    uint32_t n_tiles =
+        (snrt_cluster_idx() + 1) * n_tiles_total / snrt_cluster_num() -
+        first_tile;
+    char *ifmap = (char *)l.ifmap + first_tile * tile_size;
+    char *ofmap = (char *)l.ofmap + first_tile * tile_size;
+
+    // Allocate double buffers for the input and output tiles, followed by
+    // a scratchpad for every compute core
+    char *itile[2], *otile[2];
+    itile[0] = (char *)snrt_l1_next();
+    itile[1] = itile[0] + tile_size;
+    otile[0] = itile[1] + tile_size;
+    otile[1] = otile[0] + tile_size;
+    double *scratch =
+        (double *)snrt_align_up(otile[1] + tile_size, sizeof(double)) +
+        snrt_cluster_core_idx() * l.input_samples;
+
+    // Software pipeline: in iteration i the DMA loads tile i and stores tile
+    // i - 2, while the compute cores process tile i - 1
+    snrt_mcycle();
+    for (uint32_t i = 0; i < n_tiles + 2; i++) {
+        if (snrt_is_dm_core()) {
+            if (i < n_tiles) {
+                uint32_t tile = first_tile + i;
+                uint32_t rows = softmax_tile_rows(&l, tile);
+                if (!l.ifmap_view) {
+                    snrt_dma_start_1d(itile[i % 2], ifmap + i * tile_size,
+                                      rows * row_size);
+                } else if (rows == l.tile_rows) {
+                    snrt_dma_load_2d_tile_view(itile[i % 2], l.ifmap_view,
+                                               tile, 0, l.tile_rows,
+                                               l.input_samples, l.dtype);
+                } else {
+                    // Views are addressed in units of the tile size, so the
+                    // partial tile is loaded row by row
+                    for (uint32_t r = 0; r < rows; r++)
+                        snrt_dma_load_2d_tile_view(
+                            itile[i % 2] + r * row_size, l.ifmap_view,
+                            tile * l.tile_rows + r, 0, 1, l.input_samples,
+                            l.dtype);
+                }
+            }
+            if (i >= 2) {
+                uint32_t rows = softmax_tile_rows(&l, first_tile + i - 2);
+                snrt_dma_start_1d(ofmap + (i - 2) * tile_size, otile[i % 2],
+                                  rows * row_size);
+            }
+            snrt_dma_wait_all();
+        }
+
+        if (snrt_is_compute_core() && i >= 1 && i <= n_tiles) {
+            softmax_tile_opt(itile[(i - 1) % 2], otile[(i - 1) % 2], scratch,
+                             softmax_tile_rows(&l, first_tile + i - 1),
+                             l.input_samples, l.dtype);
+        }
+
+        snrt_cluster_hw_barrier();
+    }
+    snrt_mcycle();
+
+    snrt_global_barrier();
+}
+
+/**
+ * @brief  SoftMax layer
+ *
+ * @param l softmax_layer struct that holds addresses and parameters
+ *
+ */
+static inline void softmax_layer(softmax_layer_t const l) {
+    switch (l.implementation) {
+        case NAIVE:
+            snrt_mcycle();
+            softmax_layer_naive(l);
+            snrt_mcycle();
+            break;
+        case OPT:
+            softmax_layer_opt(l);
+            break;
+    }
+}
@@ -27,6 +27,31 @@ typedef union {
 
 #define M_PI 3.14159265358979323846
 
+typedef enum { NAIVE, OPT } implementation_t;
+
+static inline float fp8_to_float(char val) {
+    float res;
+    asm volatile(
+        "fmv.b.x %[res], %[val]\n"
+        "fcvt.s.b %[res], %[res]\n"
+        : [ res ] "=f"(res)
+        : [ val ] "r"(val));
+    return res;
+}
+
+static inline char float_to_fp8(float val) {
+    char res;
+    asm volatile(
+        "fcvt.b.s ft3, %[val]\n"
+        "fmv.x.b %[res], ft3\n"
+        : [ res ] "=r"(res)
+        : [ val ] "f"(val)
+        : "ft3");
+    return res;
+}
+
+#include "vmath/vmath.h"
+
 /**
  * @struct network_t_
  * @brief This structure contains all parameters necessary for building a simple
@@ -189,16 +214,23 @@ typedef struct network_single_cluster_t_ {
 } network_single_cluster_t;
 
 // Level 1
+#include "../layout/src/layout.h"
+#include "../maxpool/src/maxpool.h"
 #include "../transpose/src/transpose.h"
 
 // Level 2
+#include "../activation/src/activation.h"
 #include "../batchnorm/src/batchnorm.h"
 #include "../concat/src/concat.h"
+#include "../conv2d_igemm/src/conv2d_igemm.h"
+#include "../decode_attention/src/decode_attention.h"
 // #include "../conv2d/src/conv2d.h"
 #include "../flashattention_2/src/flashattention_2.h"
 #include "../fused_concat_linear/src/fused_concat_linear.h"
 #include "../gelu/src/gelu.h"
 #include "../layernorm/src/layernorm.h"
-#include "../maxpool/src/maxpool.h"
 #include "../mha/src/mha.h"
 #include "../softmax/src/softmax.h"
+
+// Level 3
+#include "../graph/src/graph.h"
@@ -47,7 +47,8 @@ class TransposeDataGen(DataGen):
             'input': input_uid,
             'output': output_uid,
             'dtype': prec,
-            'baseline': kwargs['baseline']
+            'baseline': kwargs['baseline'],
+            'dma': kwargs.get('dma', False)
         }
 
         header += [format_array_declaration(f'extern {ctype}', input_uid, inp.shape,
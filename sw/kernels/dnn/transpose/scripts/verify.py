@@ -24,7 +24,8 @@ class TransposeVerifier(Verifier):
             'input_ptr': 'I',
             'output_ptr': 'I',
             'dtype': 'I',
-            'baseline': 'I'
+            'baseline': 'I',
+            'dma': 'I'
         }
         self.layer = self.get_input_from_symbol('layer', self.layer_struct)
         self.M = self.layer['M']
@@ -19,6 +19,13 @@
  * Pointer to input feature map
  * @var transpose_layer_t::output
  * Pointer to output feature map
+ * @var transpose_layer_t::dtype
+ * Precision of the matrix
+ * @var transpose_layer_t::baseline
+ * Selects the baseline kernel for FP64 matrices
+ * @var transpose_layer_t::dma
+ * Transposes the matrix with the DMA engine while loading it to TCDM,
+ * without involving the compute cores. Supports all precisions
  */
 typedef struct {
     uint32_t M;
@@ -27,6 +34,7 @@ typedef struct {
     void* output;
     precision_t dtype;
     uint32_t baseline;
+    uint32_t dma;
 } transpose_layer_t;
 
 /**
@@ -37,13 +45,16 @@ typedef struct {
  * @param output Pointer to output feature map
  * @param M First dimension of the matrix
  * @param N Second dimension of the matrix
+ * @param M_stride Row stride of the output
+ * @param N_stride Row stride of the input
  */
 template <typename T>
 static inline void transpose_baseline(T* input, T* output, uint32_t M,
-                                      uint32_t N, uint32_t M_stride) {
+                                      uint32_t N, uint32_t M_stride,
+                                      uint32_t N_stride) {
     for (uint32_t m = 0; m < M; m++) {
         for (uint32_t n = 0; n < N; n++) {
-            output[n * M_stride + m] = input[m * N + n];
+            output[n * M_stride + m] = input[m * N_stride + n];
         }
     }
 }
@@ -55,12 +66,15 @@ static inline void transpose_baseline(T* input, T* output, uint32_t M,
  * @param output Pointer to output feature map
  * @param M First dimension of the matrix
  * @param N Second dimension of the matrix
+ * @param M_stride Row stride of the output
+ * @param N_stride Row stride of the input
  */
 static inline void transpose_fp64_opt(double* input, double* output, uint32_t M,
-                                      uint32_t N, uint32_t M_stride) {
+                                      uint32_t N, uint32_t M_stride,
+                                      uint32_t N_stride) {
 #ifdef SNRT_SUPPORTS_FREP
     const uint32_t ssr_b[2] = {N, M};
-    const uint32_t ssr0_i[2] = {sizeof(double), N * sizeof(double)};
+    const uint32_t ssr0_i[2] = {sizeof(double), N_stride * sizeof(double)};
     const uint32_t ssr1_i[2] = {sizeof(double) * M_stride, sizeof(double)};
 
     snrt_ssr_loop_2d(SNRT_SSR_DM0, ssr_b[0], ssr_b[1], ssr0_i[0], ssr0_i[1]);
@@ -84,20 +98,27 @@ static inline void transpose_fp64_opt(double* input, double* output, uint32_t M,
 /**
  * @brief  Transpose kernel
  *
- * @param l transpose struct that holds addresses and parameters
+ * @param dtype Precision of the matrix
+ * @param input Pointer to the (M, N) input matrix
+ * @param output Pointer to the (N, M) output matrix
+ * @param M First dimension of the matrix
+ * @param N Second dimension of the matrix
+ * @param baseline Use the baseline kernel, in FP64
+ * @param ld Row stride of the input, in elements, or zero if equal to N
  *
  */
 static inline void transpose_kernel(precision_t dtype, void* input,
                                     void* output, uint32_t M, uint32_t N,
-                                    uint32_t baseline) {
+                                    uint32_t baseline, uint32_t ld = 0) {
     uint32_t frac_M = M / snrt_cluster_compute_core_num();
+    if (!ld) ld = N;
 
     if (snrt_is_compute_core()) {
         // determine the row offset for each core
         int32_t row_offset = snrt_cluster_core_idx() * frac_M;
 
         // calculate the input address offset
-        void* input_offset = (char*)input + row_offset * N * dtype;
+        void* input_offset = (char*)input + row_offset * ld * dtype;
 
         // caluclate the output address offset
         void* output_offset = (char*)output + row_offset * dtype;
@@ -105,25 +126,28 @@ static inline void transpose_kernel(precision_t dtype, void* input,
         switch (dtype) {
             case FP8:
                 transpose_baseline<char>((char*)input_offset,
-                                         (char*)output_offset, frac_M, N, M);
+                                         (char*)output_offset, frac_M, N, M,
+                                         ld);
                 break;
             case FP16:
                 transpose_baseline<__fp16>((__fp16*)input_offset,
                                            (__fp16*)output_offset, frac_M, N,
-                                           M);
+                                           M, ld);
                 break;
             case FP32:
                 transpose_baseline<float>((float*)input_offset,
-                                          (float*)output_offset, frac_M, N, M);
+                                          (float*)output_offset, frac_M, N, M,
+                                          ld);
                 break;
             case FP64:
                 if (baseline) {
                     transpose_baseline<double>((double*)input_offset,
                                                (double*)output_offset, frac_M,
-                                               N, M);
+                                               N, M, ld);
                 } else {
                     transpose_fp64_opt((double*)input_offset,
-                                       (double*)output_offset, frac_M, N, M);
+                                       (double*)output_offset, frac_M, N, M,
+                                       ld);
                 }
                 break;
             default:
@@ -132,6 +156,29 @@ static inline void transpose_kernel(precision_t dtype, void* input,
     }
 }
 
+/**
+ * @brief  Transpose layer using the DMA engine
+ * @details The matrix is transposed by strided DMA transfers while it is
+ *          loaded to TCDM, and stored back with a single contiguous
+ *          transfer.
+ *
+ * @param l transpose struct that holds addresses and parameters
+ */
+static inline void transpose_layer_dma(transpose_layer_t const l) {
+    uint32_t matrix_size = l.M * l.N * l.dtype;
+
+    void* output = snrt_l1_alloc_cluster_local(matrix_size, l.dtype);
+
+    if (snrt_is_dm_core()) {
+        layout_dma_transpose(output, l.input, l.M, l.N, l.M, l.N, l.dtype);
+        snrt_dma_wait_all();
+        snrt_dma_start_1d(l.output, output, matrix_size);
+        snrt_dma_wait_all();
+    }
+
+    snrt_global_barrier();
+}
+
 /**
  * @brief  Transpose layer
  *
@@ -141,6 +188,11 @@ static inline void transpose_kernel(precision_t dtype, void* input,
 static inline void transpose_layer(transpose_layer_t const l) {
     uint32_t matrix_size = l.M * l.N * l.dtype;
 
+    if (l.dma) {
+        transpose_layer_dma(l);
+        return;
+    }
+
     void* input = snrt_l1_alloc_cluster_local(matrix_size, l.dtype);
     void* output = snrt_l1_alloc_cluster_local(matrix_size, l.dtype);
 
@@ -18,21 +18,27 @@ BURST_ALIGNMENT = 4096
 
 class AtaxDataGen(du.DataGen):
 
+    NUM_CORES = 8
+
     def golden_model(self, A, x):
         return np.matmul(A.transpose(), np.matmul(A, x))
 
-    def validate(self, M, N, **kwargs):
-        assert (N % 8) == 0, "N must be an integer multiple of the number of cores"
+    def validate(self, M, N, tile_rows, **kwargs):
+        assert tile_rows > 0, "Tile size must be positive"
 
-        # Calculate total TCDM occupation
-        a_size = M * N * 8
+        # Calculate total TCDM occupation, for double-buffered tiles of A
+        # and q, which also serve as r, the input vector, and the partial y,
+        # padded to a multiple of the number of cores, and its reduction
+        # buffer
+        partial_len = -(-N // self.NUM_CORES) * self.NUM_CORES
+        tile_size = 2 * tile_rows * N * 8
+        q_size = 2 * tile_rows * 8
         x_size = N * 8
-        y_size = N * 8
-        tmp_size = M * 8
-        total_size = a_size
+        y_size = 2 * partial_len * 8
+        total_size = tile_size
+        total_size += q_size
         total_size += x_size
         total_size += y_size
-        total_size += tmp_size
         du.validate_tcdm_footprint(total_size)
 
     def emit_header(self, **kwargs):
@@ -52,6 +58,7 @@ class AtaxDataGen(du.DataGen):
 
         header += [du.format_scalar_definition('uint32_t', 'M', M)]
         header += [du.format_scalar_definition('uint32_t', 'N', N)]
+        header += [du.format_scalar_definition('uint32_t', 'tile_rows', kwargs['tile_rows'])]
         header += [du.format_array_definition('double', 'A', A, alignment=BURST_ALIGNMENT)]
         header += [du.format_array_definition('double', 'x', x, alignment=BURST_ALIGNMENT)]
         header += [du.format_array_declaration('double', 'y', y.shape, alignment=BURST_ALIGNMENT)]
@@ -10,7 +10,19 @@
 typedef struct {
     uint32_t M;
     uint32_t N;
+    uint32_t tile_rows;
     uint64_t A_addr;
     uint64_t x_addr;
     uint64_t y_addr;
 } atax_args_t;
+
+typedef struct {
+    uint32_t M;
+    uint32_t N;
+    uint32_t tile_rows;
+    uint64_t A_addr;
+    uint64_t p_addr;
+    uint64_t r_addr;
+    uint64_t q_addr;
+    uint64_t s_addr;
+} bicg_args_t;
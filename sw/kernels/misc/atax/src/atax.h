@@ -6,52 +6,257 @@
 //         Luca Colagrande <colluca@iis.ee.ethz.ch>
 
 #include <stdint.h>
+
 #include "args.h"
-#include "blas.h"
+#include "math.h"
 #include "snrt.h"
 
-static inline void atax(uint32_t M, uint32_t N, double *A, double *x, double *y,
-                        double *tmp) {
-    double tmp_fs;
-    int core_range, core_offset, cluster_core_offset;
+// Number of outputs computed together in the FREP loop of atax_gemv.
+// Must match the number of accumulators in the loop body.
+#define ATAX_UNROLL 4
 
-    // tmp = A * x
-    if (snrt_is_compute_core()) {
-        snrt_mcycle();
-        gemv(0, M, N, 1, A, x, 1, tmp);
-        snrt_mcycle();
+/**
+ * @brief Accumulate a strided matrix-vector product into `y`:
+ *        y[i] += sum_k a[i * lane_stride + k * inner_stride] * v[k], for
+ *        i in [0, n) and k in [0, len).
+ *
+ * @details For a row-major matrix with `lda` columns, `lane_stride = lda`
+ *          and `inner_stride = 1` compute A v, while `lane_stride = 1` and
+ *          `inner_stride = lda` compute A^T v, so both products are
+ *          streamed from the same layout. Outputs are computed in groups
+ *          of @ref ATAX_UNROLL by a single FREP loop: SSR 0 streams the
+ *          matrix, interleaving the elements of the outputs in the group,
+ *          and SSR 1 streams `v`, repeating every element for all outputs
+ *          in the group. Leftover outputs are computed one at a time.
+ */
+static inline void atax_gemv(const double *a, uint32_t lane_stride,
+                             uint32_t inner_stride, uint32_t n, uint32_t len,
+                             const double *v, double *y) {
+    uint32_t i = 0;
+
+#ifdef SNRT_SUPPORTS_FREP
+    uint32_t n_groups = n / ATAX_UNROLL;
+    if (n_groups && len) {
+        // Start of SSR region.
+        register volatile double ft0 asm("ft0");
+        register volatile double ft1 asm("ft1");
+        register volatile double ft2 asm("ft2");
+        asm volatile("" : "=f"(ft0), "=f"(ft1), "=f"(ft2));
+
+        snrt_ssr_loop_3d(SNRT_SSR_DM0, ATAX_UNROLL, len, n_groups,
+                         lane_stride * sizeof(double),
+                         inner_stride * sizeof(double),
+                         ATAX_UNROLL * lane_stride * sizeof(double));
+        snrt_ssr_loop_2d(SNRT_SSR_DM1, len, n_groups, sizeof(double), 0);
+        snrt_ssr_repeat(SNRT_SSR_DM1, ATAX_UNROLL);
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_3D, (void *)a);
+        snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_2D, (void *)v);
+        snrt_ssr_enable();
+
+        for (; i < n_groups * ATAX_UNROLL; i += ATAX_UNROLL) {
+            double acc0 = y[i];
+            double acc1 = y[i + 1];
+            double acc2 = y[i + 2];
+            double acc3 = y[i + 3];
+            asm volatile(
+                "frep.o %[n_frep], 4, 0, 0 \n"
+                "fmadd.d %[acc0], ft0, ft1, %[acc0] \n"
+                "fmadd.d %[acc1], ft0, ft1, %[acc1] \n"
+                "fmadd.d %[acc2], ft0, ft1, %[acc2] \n"
+                "fmadd.d %[acc3], ft0, ft1, %[acc3] \n"
+                : [ acc0 ] "+f"(acc0), [ acc1 ] "+f"(acc1),
+                  [ acc2 ] "+f"(acc2), [ acc3 ] "+f"(acc3)
+                : [ n_frep ] "r"(len - 1), "f"(ft0), "f"(ft1)
+                : "memory");
+            y[i] = acc0;
+            y[i + 1] = acc1;
+            y[i + 2] = acc2;
+            y[i + 3] = acc3;
+        }
+
+        // End of SSR region.
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+        snrt_ssr_repeat(SNRT_SSR_DM1, 1);
+        asm volatile("" : : "f"(ft0), "f"(ft1), "f"(ft2));
+    }
+#endif
+
+    for (; i < n; i++) {
+        double acc = y[i];
+        for (uint32_t k = 0; k < len; k++)
+            acc += a[i * lane_stride + k * inner_stride] * v[k];
+        y[i] = acc;
     }
+}
 
-    snrt_cluster_hw_barrier();
+/**
+ * @brief Compute q = A p and s = A^T r in a single pass over A, on all
+ *        clusters.
+ *
+ * @details A is `M` x `N`, row-major, in L3. Every cluster processes a
+ *          contiguous range of rows, which is streamed in tiles of
+ *          `tile_rows` rows through a double buffer in TCDM, so that the
+ *          next tile is loaded while the current one is processed. Both
+ *          products are computed from the resident tile, with
+ *          @ref atax_gemv: first the rows of the tile of q, distributed
+ *          over the compute cores, then the tile's contribution to s,
+ *          whose columns are distributed over the compute cores, so that
+ *          every core accumulates its own columns of the cluster's
+ *          partial s. The partial vectors are finally summed across
+ *          clusters by @ref snrt_global_reduction_dma, and cluster 0 stores
+ *          s. Must be invoked by all cores in all clusters, and s is
+ *          available to all of them on return.
+ *
+ * @param r If NULL, s = A^T q is computed instead, i.e. s = A^T A p.
+ * @param q If NULL, q is not stored.
+ */
+static inline void atax_stream(uint32_t M, uint32_t N, uint32_t tile_rows,
+                               double *A, double *p, double *r, double *q,
+                               double *s) {
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t cluster_num = snrt_cluster_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t n_cores = snrt_cluster_compute_core_num();
+
+    // Distribute rows to clusters, and divide them in tiles
+    uint32_t first_row = cluster_idx * M / cluster_num;
+    uint32_t n_local_rows = (cluster_idx + 1) * M / cluster_num - first_row;
+    uint32_t n_tiles = (n_local_rows + tile_rows - 1) / tile_rows;
+    size_t row_size = N * sizeof(double);
 
-    // y = At * tmp
+    // The partial s is padded to a multiple of the number of compute cores,
+    // as required by snrt_global_reduction_dma
+    uint32_t partial_len = (N + n_cores - 1) / n_cores * n_cores;
+
+    // Dynamically allocate space in TCDM. The allocation must be identical
+    // in all clusters, as the partial vectors are reduced at the same
+    // offsets in every cluster's TCDM.
+    double *tiles[2], *local_q[2], *local_r[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        tiles[i] = (double *)snrt_l1_alloc_cluster_local(tile_rows * row_size,
+                                                         sizeof(double));
+        local_q[i] = (double *)snrt_l1_alloc_cluster_local(
+            tile_rows * sizeof(double), sizeof(double));
+        local_r[i] = r ? (double *)snrt_l1_alloc_cluster_local(
+                             tile_rows * sizeof(double), sizeof(double))
+                       : local_q[i];
+    }
+    double *local_p =
+        (double *)snrt_l1_alloc_cluster_local(row_size, sizeof(double));
+    double *partial = (double *)snrt_l1_alloc_cluster_local(
+        partial_len * sizeof(double), sizeof(double));
+    double *red_dst = (double *)snrt_l1_alloc_cluster_local(
+        partial_len * sizeof(double), sizeof(double));
+
+    // Load p and the first tile
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(local_p, p, row_size);
+        if (n_tiles) {
+            uint32_t n = n_local_rows < tile_rows ? n_local_rows : tile_rows;
+            snrt_dma_start_1d(tiles[0], A + first_row * N, n * row_size);
+            if (r)
+                snrt_dma_start_1d(local_r[0], r + first_row,
+                                  n * sizeof(double));
+        }
+        snrt_dma_wait_all();
+    }
+
+    // Every core owns a range of columns of the partial s
+    uint32_t col_start = core_idx * N / n_cores;
+    uint32_t col_end = (core_idx + 1) * N / n_cores;
     if (snrt_is_compute_core()) {
-        snrt_mcycle();
-        core_range = N / snrt_global_compute_core_num();
-        core_offset = snrt_global_compute_core_idx() * core_range;
-        cluster_core_offset = snrt_cluster_core_idx() * core_range;
-        for (int j1 = 0; j1 < core_range; j1++) {
-            int j = core_offset + j1;
-            int cluster_j = cluster_core_offset + j1;
-            tmp_fs = 0.0;
-            for (int i = 0; i < M; i++) {
-                // The order of the for loops was exchanged, so that each loop
-                // reduces in y at position j, iterating through the i
-                // positions.
-                tmp_fs += A[i * N + j] * tmp[i];
-            }
-            y[cluster_j] = tmp_fs;
+        for (uint32_t i = core_idx; i < partial_len; i += n_cores)
+            partial[i] = 0;
+    }
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+
+    snrt_mcycle();
+
+    for (uint32_t tile_idx = 0; tile_idx < n_tiles; tile_idx++) {
+        uint32_t tile_start = tile_idx * tile_rows;
+        uint32_t n = n_local_rows - tile_start < tile_rows
+                         ? n_local_rows - tile_start
+                         : tile_rows;
+        double *tile = tiles[tile_idx % 2];
+        double *tile_q = local_q[tile_idx % 2];
+
+        // Prefetch the next tile
+        if (snrt_is_dm_core() && tile_idx + 1 < n_tiles) {
+            uint32_t next_start = tile_start + tile_rows;
+            uint32_t next_n = n_local_rows - next_start < tile_rows
+                                  ? n_local_rows - next_start
+                                  : tile_rows;
+            snrt_dma_start_1d(tiles[(tile_idx + 1) % 2],
+                              A + (first_row + next_start) * N,
+                              next_n * row_size);
+            if (r)
+                snrt_dma_start_1d(local_r[(tile_idx + 1) % 2],
+                                  r + first_row + next_start,
+                                  next_n * sizeof(double));
+        }
+
+        // Rows of q
+        if (snrt_is_compute_core()) {
+            uint32_t start = core_idx * n / n_cores;
+            uint32_t end = (core_idx + 1) * n / n_cores;
+            for (uint32_t i = start; i < end; i++) tile_q[i] = 0;
+            atax_gemv(tile + start * N, N, 1, end - start, N, local_p,
+                      tile_q + start);
+        }
+        snrt_fpu_fence();
+        snrt_cluster_hw_barrier();
+
+        // Store the rows of q, while the columns of s are accumulated
+        if (snrt_is_dm_core() && q)
+            snrt_dma_start_1d(q + first_row + tile_start, tile_q,
+                              n * sizeof(double));
+
+        // Columns of s
+        if (snrt_is_compute_core()) {
+            atax_gemv(tile + col_start, 1, N, col_end - col_start, n,
+                      local_r[tile_idx % 2], partial + col_start);
         }
+
+        if (snrt_is_dm_core()) snrt_dma_wait_all();
         snrt_fpu_fence();
-        snrt_mcycle();
+        snrt_cluster_hw_barrier();
     }
+
+    snrt_mcycle();
+
+    // Reduce the partial vectors across clusters and store s
+    snrt_global_reduction_dma(red_dst, partial, partial_len);
+    if (snrt_is_dm_core() && cluster_idx == 0) {
+        snrt_dma_start_1d(s, partial, row_size);
+        snrt_dma_wait_all();
+    }
+    snrt_global_barrier();
+
+    snrt_mcycle();
+
+    // Free memory
+    snrt_l1_update_next_v2(tiles[0]);
+}
+
+/**
+ * @brief y = A^T A x, see @ref atax_stream.
+ */
+static inline void atax(uint32_t M, uint32_t N, uint32_t tile_rows, double *A,
+                        double *x, double *y) {
+    atax_stream(M, N, tile_rows, A, x, NULL, NULL, y);
+}
+
+/**
+ * @brief The BiCG kernel: q = A p and s = A^T r, see @ref atax_stream.
+ */
+static inline void bicg(uint32_t M, uint32_t N, uint32_t tile_rows, double *A,
+                        double *p, double *r, double *q, double *s) {
+    atax_stream(M, N, tile_rows, A, p, r, q, s);
 }
 
 void atax_job(void *args) {
-    double *local_A;
-    double *local_x;
-    double *local_y;
-    double *local_tmp;
     atax_args_t *local_args;
 
 #ifndef JOB_ARGS_PRELOADED
@@ -69,52 +274,41 @@ void atax_job(void *args) {
     local_args = (atax_args_t *)args;
 #endif
 
-    // Aliases
-    uint32_t M = local_args->M;
-    uint32_t N = local_args->N;
-    double *A = (double *)(local_args->A_addr);
-    double *x = (double *)(local_args->x_addr);
-    double *y = (double *)(local_args->y_addr);
-
-    // Allocate local variables
-    size_t size_A = M * N * sizeof(double);
-    size_t size_x = N * sizeof(double);
-    size_t size_y = N * sizeof(double);
-    size_t size_tmp = M * sizeof(double);
-    size_t size_y_tile = size_y / snrt_cluster_num();
-    local_A = (double *)snrt_l1_alloc_cluster_local(size_A, sizeof(double));
-    local_x = (double *)snrt_l1_alloc_cluster_local(size_x, sizeof(double));
-    local_y =
-        (double *)snrt_l1_alloc_cluster_local(size_y_tile, sizeof(double));
-    local_tmp = (double *)snrt_l1_alloc_cluster_local(size_tmp, sizeof(double));
-
-    // Initialize input matrices
-    if (snrt_is_dm_core()) {
-        snrt_dma_start_1d(local_A, A, size_A);
-        snrt_dma_start_1d(local_x, x, size_x);
-        snrt_dma_wait_all();
-    }
-    snrt_mcycle();
-    snrt_cluster_hw_barrier();
+    atax(local_args->M, local_args->N, local_args->tile_rows,
+         (double *)(local_args->A_addr), (double *)(local_args->x_addr),
+         (double *)(local_args->y_addr));
 
-    // Compute
-    atax(M, N, local_A, local_x, local_y, local_tmp);
-    snrt_cluster_hw_barrier();
-    snrt_mcycle();
+    // Free memory
+#ifndef JOB_ARGS_PRELOADED
+    snrt_l1_update_next_v2(local_args);
+#endif
+}
 
-    // Writeback results
+void bicg_job(void *args) {
+    bicg_args_t *local_args;
+
+#ifndef JOB_ARGS_PRELOADED
+    // Allocate space for job arguments in TCDM
+    local_args = (bicg_args_t *)snrt_l1_alloc_cluster_local(sizeof(bicg_args_t),
+                                                            sizeof(double));
+
+    // Copy job arguments to TCDM
     if (snrt_is_dm_core()) {
-        snrt_dma_store_1d_tile(y, local_y, snrt_cluster_idx(),
-                               N / snrt_cluster_num(), sizeof(double));
+        snrt_dma_start_1d(local_args, args, sizeof(bicg_args_t));
         snrt_dma_wait_all();
-        snrt_mcycle();
     }
     snrt_cluster_hw_barrier();
+#else
+    local_args = (bicg_args_t *)args;
+#endif
+
+    bicg(local_args->M, local_args->N, local_args->tile_rows,
+         (double *)(local_args->A_addr), (double *)(local_args->p_addr),
+         (double *)(local_args->r_addr), (double *)(local_args->q_addr),
+         (double *)(local_args->s_addr));
 
     // Free memory
 #ifndef JOB_ARGS_PRELOADED
     snrt_l1_update_next_v2(local_args);
-#else
-    snrt_l1_update_next_v2(local_A);
 #endif
 }
@@ -13,7 +13,7 @@
 int main() {
     uint32_t nerr = 0;
 
-    atax_args_t args = {M, N, (uint64_t)A, (uint64_t)x, (uint64_t)y};
+    atax_args_t args = {M, N, tile_rows, (uint64_t)A, (uint64_t)x, (uint64_t)y};
     atax_job(&args);
 
 // Check computation is correct
@@ -0,0 +1,12 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+APP              := bicg
+$(APP)_BUILD_DIR ?= $(SN_ROOT)/sw/kernels/misc/$(APP)/build
+SRC_DIR          := $(SN_ROOT)/sw/kernels/misc/$(APP)/src
+SRCS             := $(SRC_DIR)/main.c
+$(APP)_INCDIRS   := $(SN_ROOT)/sw/kernels/misc
+
+include $(SN_ROOT)/sw/kernels/datagen.mk
+include $(SN_ROOT)/sw/kernels/common.mk
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+
+import snitch.util.sim.data_utils as du
+
+
+# AXI splits bursts crossing 4KB address boundaries. To minimize
+# the occurrence of these splits the data should be aligned to 4KB
+BURST_ALIGNMENT = 4096
+
+
+class BicgDataGen(du.DataGen):
+
+    NUM_CORES = 8
+
+    def golden_model(self, A, p, r):
+        return np.matmul(A, p), np.matmul(A.transpose(), r)
+
+    def validate(self, M, N, tile_rows, **kwargs):
+        assert tile_rows > 0, "Tile size must be positive"
+
+        # Calculate total TCDM occupation, for double-buffered tiles of A,
+        # q and r, the input vector p, and the partial s, padded to a
+        # multiple of the number of cores, and its reduction buffer
+        partial_len = -(-N // self.NUM_CORES) * self.NUM_CORES
+        tile_size = 2 * tile_rows * N * 8
+        q_size = 2 * tile_rows * 8
+        r_size = 2 * tile_rows * 8
+        p_size = N * 8
+        s_size = 2 * partial_len * 8
+        total_size = tile_size
+        total_size += q_size
+        total_size += r_size
+        total_size += p_size
+        total_size += s_size
+        du.validate_tcdm_footprint(total_size)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        # Validate parameters
+        self.validate(**kwargs)
+
+        M, N = kwargs['M'], kwargs['N']
+        A = du.generate_random_array((M, N))
+        p = du.generate_random_array((N, 1))
+        r = du.generate_random_array((M, 1))
+        q, s = self.golden_model(A, p, r)
+
+        A = A.flatten()
+        p = p.flatten()
+        r = r.flatten()
+        q = q.flatten()
+        s = s.flatten()
+
+        header += [du.format_scalar_definition('uint32_t', 'M', M)]
+        header += [du.format_scalar_definition('uint32_t', 'N', N)]
+        header += [du.format_scalar_definition('uint32_t', 'tile_rows', kwargs['tile_rows'])]
+        header += [du.format_array_definition('double', 'A', A, alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_definition('double', 'p', p, alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_definition('double', 'r', r, alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('double', 'q', q.shape, alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('double', 's', s.shape, alignment=BURST_ALIGNMENT)]
+        result_defs = [
+            du.format_array_definition('double', 'golden_q', q, alignment=BURST_ALIGNMENT),
+            du.format_array_definition('double', 'golden_s', s, alignment=BURST_ALIGNMENT)
+        ]
+        header += [du.format_ifdef_wrapper('BIST', '\n\n'.join(result_defs))]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    BicgDataGen().main()
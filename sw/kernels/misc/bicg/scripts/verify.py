@@ -0,0 +1,37 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import numpy as np
+import sys
+from datagen import BicgDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+
+
+class BicgVerifier(Verifier):
+
+    OUTPUT_UIDS = ['q', 's']
+
+    def get_actual_results(self):
+        q = self.get_output_from_symbol('q', 'double')
+        s = self.get_output_from_symbol('s', 'double')
+        return np.concatenate((q, s))
+
+    def get_expected_results(self):
+        A = self.get_input_from_symbol('A', 'double')
+        p = self.get_input_from_symbol('p', 'double')
+        r = self.get_input_from_symbol('r', 'double')
+        M = self.get_input_from_symbol('M', 'uint32_t')[0]
+        N = self.get_input_from_symbol('N', 'uint32_t')[0]
+        A = np.reshape(A, (M, N))
+        q, s = BicgDataGen().golden_model(A, p, r)
+        return np.concatenate((q, s))
+
+    def check_results(self, *args):
+        return super().check_results(*args, rtol=1e-10)
+
+
+if __name__ == "__main__":
+    sys.exit(BicgVerifier().main())
@@ -0,0 +1,28 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "atax/src/atax.h"
+#include "data.h"
+
+#define MAX_ERROR 1e-10
+
+int main() {
+    uint32_t nerr = 0;
+
+    bicg_args_t args = {M,           N,           tile_rows,   (uint64_t)A,
+                        (uint64_t)p, (uint64_t)r, (uint64_t)q, (uint64_t)s};
+    bicg_job(&args);
+
+// Check computation is correct
+#ifdef BIST
+    if (snrt_global_core_idx() == 0) {
+        for (int i = 0; i < M; i++)
+            if (fabs(golden_q[i] - q[i]) > MAX_ERROR) nerr++;
+        for (int i = 0; i < N; i++)
+            if (fabs(golden_s[i] - s[i]) > MAX_ERROR) nerr++;
+    }
+#endif
+
+    return nerr;
+}
@@ -8,6 +8,18 @@ APP              := box3d1r
 $(APP)_BUILD_DIR ?= $(SN_ROOT)/sw/kernels/misc/$(APP)/build
 SRC_DIR          := $(SN_ROOT)/sw/kernels/misc/$(APP)/src
 SRCS             := $(SRC_DIR)/main.c
+$(APP)_INCDIRS   := $(SN_ROOT)/sw/kernels/misc
+
+include $(SN_ROOT)/sw/kernels/datagen.mk
+include $(SN_ROOT)/sw/kernels/common.mk
+
+# Variant selecting the fastest implementation at run time
+APP                 := box3d1r_auto
+$(APP)_BUILD_DIR    ?= $(SN_ROOT)/sw/kernels/misc/box3d1r/build/auto
+SRC_DIR             := $(SN_ROOT)/sw/kernels/misc/box3d1r/src
+SRCS                := $(SRC_DIR)/main.c
+$(APP)_INCDIRS      := $(SN_ROOT)/sw/kernels/misc
+$(APP)_RISCV_CFLAGS := -DIMPL=IMPL_AUTO
 
 include $(SN_ROOT)/sw/kernels/datagen.mk
 include $(SN_ROOT)/sw/kernels/common.mk
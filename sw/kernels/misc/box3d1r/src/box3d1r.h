@@ -10,6 +10,8 @@
 #include "stdbool.h"
 #include "stdint.h"
 
+#include "dispatch.h"
+
 #include "box3d1r_baseline1.h"
 #include "box3d1r_baseline2.h"
 #include "box3d1r_baseline3.h"
@@ -25,6 +27,7 @@
 #define IMPL_BASELINE_4 4
 #define IMPL_OPTIMIZED_1 5
 #define IMPL_OPTIMIZED_2 6
+#define IMPL_AUTO 7
 
 #ifndef IMPL
 #define IMPL IMPL_OPTIMIZED_2
@@ -44,8 +47,53 @@
 #define FUNC_PTR box3d1r_opt1
 #elif IMPL == IMPL_OPTIMIZED_2
 #define FUNC_PTR box3d1r_opt2
+#elif IMPL == IMPL_AUTO
+#define FUNC_PTR box3d1r_auto
 #endif
 
+// All implementations, indexed by their IMPL value
+static void (*const box3d1r_impls[])(int, int, int, int, double*, double*,
+                                     double*) = {
+    box3d1r_naive,     box3d1r_baseline1, box3d1r_baseline2,
+    box3d1r_baseline3, box3d1r_baseline4, box3d1r_opt1,
+    box3d1r_opt2};
+
+// Fastest implementation per grid shape, private to every core
+__thread dispatch_table_t box3d1r_table = {
+    sizeof(box3d1r_impls) / sizeof(box3d1r_impls[0])};
+
+typedef struct {
+    int r, nx, ny, nz;
+    double *c, *A, *A_;
+} box3d1r_ctx_t;
+
+static inline void box3d1r_run(void* ctx, uint32_t impl) {
+    box3d1r_ctx_t* x = (box3d1r_ctx_t*)ctx;
+    box3d1r_impls[impl](x->r, x->nx, x->ny, x->nz, x->c, x->A, x->A_);
+}
+
+// Run the fastest implementation for the grid shape, timing all
+// implementations supporting the shape on its first occurrence. Every core
+// keeps its own table, so that multiple cores can invoke this function
+// concurrently, on disjoint grids.
+static inline void box3d1r_auto(int r, int nx, int ny, int nz, double* c,
+                                double* A, double* A_) {
+    box3d1r_ctx_t ctx = {r, nx, ny, nz, c, A, A_};
+    uint32_t key[DISPATCH_KEY_LEN] = {(uint32_t)r, (uint32_t)nx,
+                                      (uint32_t)ny, (uint32_t)nz};
+    // The SSR implementations compute two points per iteration in x and y,
+    // and all but baseline 3 and 4 keep the coefficients of a radius-1
+    // stencil in registers
+    uint32_t mask = 1 << IMPL_NAIVE;
+    if ((nx - 2 * r) % 2 == 0 && (ny - 2 * r) % 2 == 0) {
+        mask |= (1 << IMPL_BASELINE_3) | (1 << IMPL_BASELINE_4);
+        if (r == 1)
+            mask |= (1 << IMPL_BASELINE_1) | (1 << IMPL_BASELINE_2) |
+                    (1 << IMPL_OPTIMIZED_1) | (1 << IMPL_OPTIMIZED_2);
+    }
+    dispatch(&box3d1r_table, key, mask, box3d1r_run, &ctx, 0);
+}
+
 // The Kernel
 static inline void box3d1r(int r, int nx, int ny, int nz, double* c, double* A,
                            double* A_) {
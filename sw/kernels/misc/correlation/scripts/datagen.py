@@ -21,16 +21,22 @@ class CorrelationDataGen(du.DataGen):
     def golden_model(self, data):
         return np.corrcoef(data, rowvar=False)
 
-    def validate(self, M, N, **kwargs):
-        assert (M % 8) == 0, "M must be an integer multiple of the number of cores"
-
-        # Calculate total TCDM occupation
-        data_size = N * M * 8
-        corr_size = M * M * 8
-        stddev_size = M * 8
-        total_size = data_size
-        total_size += corr_size
-        total_size += stddev_size
+    def validate(self, M, N, m_tiles, k_tiles, gemm_fp, **kwargs):
+        assert (M % m_tiles) == 0, "M must be an integer multiple of m_tiles"
+        assert (N % k_tiles) == 0, "N must be an integer multiple of k_tiles"
+        assert N > 1, "N must be greater than one"
+        tile_m = M // m_tiles
+        tile_k = N // k_tiles
+        if gemm_fp == "gemm_fp64_opt":
+            assert (tile_m % 8) == 0, "M tile size must be an integer multiple of the unroll (8)"
+            assert tile_k >= 3, "N tile size must be greater or equal to 3"
+
+        # Calculate TCDM occupation of the GEMM phase, which dominates, with
+        # double-buffered A, B and C tiles, and the statistics vectors
+        a_tile_size = tile_m * tile_k * 8
+        c_tile_size = tile_m * tile_m * 8
+        total_size = 2 * (2 * a_tile_size + c_tile_size)
+        total_size += 2 * M * 8
         du.validate_tcdm_footprint(total_size)
 
     def emit_header(self, **kwargs):
@@ -43,14 +49,26 @@ class CorrelationDataGen(du.DataGen):
         data = du.generate_random_array((N, M))
         corr = self.golden_model(data)
 
-        data = data.flatten()
+        # Store one row of observations per variable
+        data = data.transpose().flatten()
         corr = corr.flatten()
 
-        header += [du.format_scalar_definition('uint32_t', 'M', M)]
-        header += [du.format_scalar_definition('uint32_t', 'N', N)]
+        cfg = {
+            'N': N,
+            'M': M,
+            'data': 'data',
+            'corr': 'corr',
+            'stats': 'stats',
+            'm_tiles': kwargs['m_tiles'],
+            'k_tiles': kwargs['k_tiles'],
+            'gemm_fp': kwargs['gemm_fp']
+        }
+
         header += [du.format_array_definition('double', 'data', data, alignment=BURST_ALIGNMENT)]
         header += [du.format_array_declaration('double', 'corr', corr.shape,
                                                alignment=BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('double', 'stats', (2 * M,))]
+        header += [du.format_struct_definition('correlation_args_t', 'args', cfg)]
         result_def = du.format_array_definition('double', 'golden', corr,
                                                 alignment=BURST_ALIGNMENT)
         header += [du.format_ifdef_wrapper('BIST', result_def)]
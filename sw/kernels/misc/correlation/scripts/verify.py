@@ -20,10 +20,9 @@ class CorrelationVerifier(Verifier):
         return self.get_output_from_symbol('corr', 'double')
 
     def get_expected_results(self):
-        M = self.get_input_from_symbol('M', 'uint32_t')[0]
-        N = self.get_input_from_symbol('N', 'uint32_t')[0]
+        N, M = self.get_input_from_symbol('args', 'uint32_t')[0:2]
         data = self.get_input_from_symbol('data', 'double')
-        data = np.reshape(data, (N, M))
+        data = np.reshape(data, (M, N)).transpose()
         return CorrelationDataGen().golden_model(data).flatten()
 
     def check_results(self, *args):
@@ -7,9 +7,34 @@
 #pragma once
 #include <stdint.h>
 
+#include "blas.h"
+
+/**
+ * @struct correlation_args_t
+ * @brief Arguments of the correlation kernel.
+ *
+ * @var correlation_args_t::data
+ * Input matrix in L3, with one row of `N` observations for each of the `M`
+ * variables.
+ * @var correlation_args_t::corr
+ * Output `M` x `M` correlation matrix in L3.
+ * @var correlation_args_t::stats
+ * Scratch vector of `2 * M` doubles in L3, to exchange the means and
+ * standard deviations of the variables between clusters.
+ * @var correlation_args_t::m_tiles
+ * Number of tiles in each dimension of the correlation matrix.
+ * @var correlation_args_t::k_tiles
+ * Number of tiles along the observations, which are streamed through TCDM.
+ * @var correlation_args_t::gemm_fp
+ * Tile kernel of the GEMM driver.
+ */
 typedef struct {
     uint32_t N;
     uint32_t M;
-    uint64_t data_addr;
-    uint64_t corr_addr;
+    double *data;
+    double *corr;
+    double *stats;
+    uint32_t m_tiles;
+    uint32_t k_tiles;
+    gemm_fp_t gemm_fp;
 } correlation_args_t;
@@ -13,15 +13,15 @@
 int main() {
     uint32_t nerr = 0;
 
-    correlation_args_t args = {N, M, (uint64_t)data, (uint64_t)corr};
     correlation_job(&args);
 
 #ifdef BIST
     // Check computation is correct
     if (snrt_cluster_core_idx() == 0) {
-        for (int i = 0; i < M; i++) {
-            for (int j = 0; j < M; j++) {
-                double diff = fabs(golden[i * M + j] - corr[i * M + j]);
+        for (int i = 0; i < args.M; i++) {
+            for (int j = 0; j < args.M; j++) {
+                double diff =
+                    fabs(golden[i * args.M + j] - corr[i * args.M + j]);
                 if (diff > MAX_ERROR) {
                     nerr++;
                 }
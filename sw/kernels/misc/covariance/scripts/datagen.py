@@ -12,34 +12,34 @@ import snitch.util.sim.data_utils as du
 
 np.random.seed(42)
 
-DOUBLE_BUFFER = True
-
 
 class CovarianceDataGen(du.DataGen):
 
-    # Function pointers to alternative implementations
-    FUNCPTRS = ["covariance_naive", "covariance_baseline", "covariance_opt"]
+    # Tile kernels of the GEMM driver
+    GEMM_FPS = ["gemm_fp64_naive", "gemm_fp64_opt"]
 
     def golden_model(self, data):
         return np.cov(data, rowvar=False)
 
     def validate(self, **kwargs):
-        n_cores = 8
-        assert (kwargs['m'] % kwargs['m_tiles']) == 0, "m must be an integer multiple of m_tiles"
-        m_per_tile = kwargs['m'] / kwargs['m_tiles']
-        assert (m_per_tile % n_cores) == 0, \
-            "m_per_tile must be an integer multiple of the number of cores"
-        assert (m_per_tile % 4) == 0, "m_per_tile must be an integer multiple of unroll1 = 4"
-        m_per_core = m_per_tile / n_cores
-        assert (m_per_core % 2) == 0, "m_per_core must be an integer multiple of the unroll0 = 2"
-        assert kwargs['funcptr'] in self.FUNCPTRS, f"Function pointer must be among {self.FUNCPTRS}"
-
-        # Calculate total TCDM occupation
-        a_tile_size = m_per_tile * kwargs['n'] * 8
-        b_tile_size = m_per_tile * m_per_tile * 8
-        total_size = 2 * a_tile_size + b_tile_size
-        if DOUBLE_BUFFER:
-            total_size *= 2
+        m, n = kwargs['m'], kwargs['n']
+        m_tiles, k_tiles = kwargs['m_tiles'], kwargs['k_tiles']
+        assert (m % m_tiles) == 0, "m must be an integer multiple of m_tiles"
+        assert (n % k_tiles) == 0, "n must be an integer multiple of k_tiles"
+        assert n > 1, "n must be greater than one"
+        assert kwargs['gemm_fp'] in self.GEMM_FPS, f"GEMM kernel must be among {self.GEMM_FPS}"
+        tile_m = m // m_tiles
+        tile_k = n // k_tiles
+        if kwargs['gemm_fp'] == "gemm_fp64_opt":
+            assert (tile_m % 8) == 0, "m tile size must be an integer multiple of the unroll (8)"
+            assert tile_k >= 3, "k tile size must be greater or equal to 3"
+
+        # Calculate TCDM occupation of the GEMM phase, which dominates, with
+        # double-buffered A, B and C tiles, and the statistics vectors
+        a_tile_size = tile_m * tile_k * 8
+        c_tile_size = tile_m * tile_m * 8
+        total_size = 2 * (2 * a_tile_size + c_tile_size)
+        total_size += 2 * m * 8
         du.validate_tcdm_footprint(total_size)
 
     def emit_header(self, **kwargs):
@@ -55,20 +55,22 @@ class CovarianceDataGen(du.DataGen):
 
         data_uid = 'data'
         cov_uid = 'cov'
+        stats_uid = 'stats'
 
         cfg = {
             'm': kwargs['m'],
             'n': kwargs['n'],
-            'inv_n': 1 / kwargs['n'],
-            'inv_n_m1': 1 / (kwargs['n'] - 1),
             'data': data_uid,
             'cov': cov_uid,
+            'stats': stats_uid,
             'm_tiles': kwargs['m_tiles'],
-            'funcptr': kwargs['funcptr']
+            'k_tiles': kwargs['k_tiles'],
+            'gemm_fp': kwargs['gemm_fp']
         }
 
         header += [du.format_array_definition('double', data_uid, data)]
         header += [du.format_array_declaration('double', cov_uid, cov.shape)]
+        header += [du.format_array_declaration('double', stats_uid, (2 * kwargs['m'],))]
         header += [du.format_struct_definition('covariance_args_t', 'args', cfg)]
         header = '\n\n'.join(header)
 
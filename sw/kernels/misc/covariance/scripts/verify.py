@@ -21,12 +21,12 @@ class CovarianceVerifier(Verifier):
         self.func_args = {
             'm': 'I',
             'n': 'I',
-            'inv_n': 'd',
-            'inv_n_m1': 'd',
             'data': 'I',
             'cov': 'I',
+            'stats': 'I',
             'm_tiles': 'I',
-            'funcptr': 'I'
+            'k_tiles': 'I',
+            'gemm_fp': 'I'
         }
         self.func_args = self.get_input_from_symbol('args', self.func_args)
 
@@ -7,17 +7,35 @@
 #pragma once
 #include <stdint.h>
 
-typedef void (*covariance_fp_t)(uint32_t m, uint32_t n, double inv_n,
-                                double inv_n_m1, double *data, double *datat,
-                                double *cov);
+#include "blas.h"
 
+/**
+ * @struct covariance_args_t
+ * @brief Arguments of the covariance kernel.
+ *
+ * @var covariance_args_t::data
+ * Input matrix in L3, with one row of `n` observations for each of the `m`
+ * variables.
+ * @var covariance_args_t::cov
+ * Output `m` x `m` covariance matrix in L3.
+ * @var covariance_args_t::stats
+ * Scratch vector of `2 * m` elements in L3, to exchange the statistics of
+ * the variables between clusters.
+ * @var covariance_args_t::m_tiles
+ * Number of tiles in each dimension of the covariance matrix. The rows of
+ * tiles are distributed cyclically across clusters.
+ * @var covariance_args_t::k_tiles
+ * Number of tiles along the observations, which are streamed through TCDM.
+ * @var covariance_args_t::gemm_fp
+ * Tile kernel of the GEMM driver.
+ */
 typedef struct {
     uint32_t m;
     uint32_t n;
-    double inv_n;
-    double inv_n_m1;
     double *data;
     double *cov;
+    double *stats;
     uint32_t m_tiles;
-    covariance_fp_t funcptr;
+    uint32_t k_tiles;
+    gemm_fp_t gemm_fp;
 } covariance_args_t;
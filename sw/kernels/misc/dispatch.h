@@ -0,0 +1,188 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Run-time selection among the implementations ("variants") of a kernel.
+//
+// Every variant of a kernel is compiled into the binary, and identified by
+// its index in a table of function pointers. A dispatch table records, for
+// every problem shape it has seen, the fastest variant, which is determined
+// by timing all eligible variants on the first invocation with that shape
+// (calibration). Subsequent invocations only look up the table.
+//
+// A kernel exposes its variants through a `dispatch_run_t` function, which
+// invokes the variant with the given index on the arguments packed in `ctx`.
+// Tables are meant to be thread-local (`__thread`), so that every core
+// maintains its own and no synchronization is required to update them.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "snrt.h"
+
+// Maximum number of shape parameters identifying an entry
+#define DISPATCH_KEY_LEN 4
+// Maximum number of shapes recorded in a table
+#define DISPATCH_MAX_ENTRIES 8
+
+typedef void (*dispatch_run_t)(void *ctx, uint32_t variant);
+
+/**
+ * @struct dispatch_entry_t
+ * @brief Fastest variant for a problem shape.
+ *
+ * @var dispatch_entry_t::key
+ * Shape parameters, unused parameters must be zero.
+ * @var dispatch_entry_t::cycles
+ * Runtime of the variant measured during calibration.
+ */
+typedef struct {
+    uint32_t key[DISPATCH_KEY_LEN];
+    uint32_t variant;
+    uint32_t cycles;
+} dispatch_entry_t;
+
+/**
+ * @struct dispatch_table_t
+ * @brief Table of the fastest variants of a kernel.
+ *
+ * Tables can be statically initialized with entries from earlier
+ * calibrations, to skip calibrating the respective shapes. When the table is
+ * full, the oldest entries are replaced first.
+ *
+ * @var dispatch_table_t::nvariants
+ * Number of variants of the kernel.
+ * @var dispatch_table_t::nentries
+ * Number of valid entries.
+ * @var dispatch_table_t::next
+ * Index of the next entry to be replaced, once the table is full.
+ */
+typedef struct {
+    uint32_t nvariants;
+    uint32_t nentries;
+    uint32_t next;
+    dispatch_entry_t entries[DISPATCH_MAX_ENTRIES];
+} dispatch_table_t;
+
+static inline uint32_t dispatch_key_match(const uint32_t *a,
+                                          const uint32_t *b) {
+    for (uint32_t i = 0; i < DISPATCH_KEY_LEN; i++)
+        if (a[i] != b[i]) return 0;
+    return 1;
+}
+
+/**
+ * @brief Look up the entry of a shape.
+ * @return Pointer to the entry, or NULL if the shape was never calibrated.
+ */
+static inline dispatch_entry_t *dispatch_lookup(dispatch_table_t *table,
+                                                const uint32_t *key) {
+    for (uint32_t i = 0; i < table->nentries; i++)
+        if (dispatch_key_match(table->entries[i].key, key))
+            return &table->entries[i];
+    return NULL;
+}
+
+/**
+ * @brief Record the fastest variant for a shape, replacing the existing
+ *        entry of the shape, if any.
+ */
+static inline void dispatch_record(dispatch_table_t *table,
+                                   const uint32_t *key, uint32_t variant,
+                                   uint32_t cycles) {
+    dispatch_entry_t *entry = dispatch_lookup(table, key);
+    if (!entry) {
+        if (table->nentries < DISPATCH_MAX_ENTRIES) {
+            entry = &table->entries[table->nentries++];
+        } else {
+            entry = &table->entries[table->next];
+            table->next = (table->next + 1) % DISPATCH_MAX_ENTRIES;
+        }
+        for (uint32_t i = 0; i < DISPATCH_KEY_LEN; i++) entry->key[i] = key[i];
+    }
+    entry->variant = variant;
+    entry->cycles = cycles;
+}
+
+/**
+ * @brief Time every eligible variant on a shape and record the fastest.
+ *
+ * @details Every variant is run twice, and only the second run is timed, so
+ *          that instruction cache misses do not bias the selection. Variants
+ *          must thus produce the same result when invoked repeatedly on the
+ *          same arguments. TCDM allocated by the variants is released after
+ *          every run.
+ *
+ * @param mask Bit mask of the variants which support the shape.
+ * @param collective If set, the function must be invoked by all cores in the
+ *                   cluster, which run every variant together. The variants
+ *                   are timed on core 0, whose selection is recorded by all
+ *                   cores. Otherwise, only the calling core runs the
+ *                   variants.
+ * @return Index of the fastest variant.
+ */
+static inline uint32_t dispatch_calibrate(dispatch_table_t *table,
+                                          const uint32_t *key, uint32_t mask,
+                                          dispatch_run_t run, void *ctx,
+                                          uint32_t collective) {
+    void *l1_next = snrt_l1_next_v2();
+    // Selection of core 0, broadcast to the other cores
+    uint32_t *selection = NULL;
+    if (collective)
+        selection = (uint32_t *)snrt_l1_alloc_cluster_local(
+            2 * sizeof(uint32_t), sizeof(uint32_t));
+    void *l1_run = snrt_l1_next_v2();
+
+    uint32_t best = 0;
+    uint32_t best_cycles = UINT32_MAX;
+    for (uint32_t variant = 0; variant < table->nvariants; variant++) {
+        if (!(mask & (1 << variant))) continue;
+        uint32_t cycles = 0;
+        for (uint32_t i = 0; i < 2; i++) {
+            if (collective) snrt_cluster_hw_barrier();
+            uint32_t start = snrt_mcycle();
+            run(ctx, variant);
+            if (collective) snrt_cluster_hw_barrier();
+            cycles = snrt_mcycle() - start;
+            snrt_l1_update_next_v2(l1_run);
+        }
+        if (cycles < best_cycles) {
+            best = variant;
+            best_cycles = cycles;
+        }
+    }
+
+    if (collective) {
+        if (snrt_cluster_core_idx() == 0) {
+            selection[0] = best;
+            selection[1] = best_cycles;
+        }
+        snrt_cluster_hw_barrier();
+        best = selection[0];
+        best_cycles = selection[1];
+        snrt_cluster_hw_barrier();
+    }
+    dispatch_record(table, key, best, best_cycles);
+
+    snrt_l1_update_next_v2(l1_next);
+    return best;
+}
+
+/**
+ * @brief Run the fastest variant for a shape, calibrating the shape first
+ *        if it is not yet in the table.
+ *
+ * @details See @ref dispatch_calibrate for the meaning of the arguments.
+ * @return Index of the variant which was run.
+ */
+static inline uint32_t dispatch(dispatch_table_t *table, const uint32_t *key,
+                                uint32_t mask, dispatch_run_t run, void *ctx,
+                                uint32_t collective) {
+    dispatch_entry_t *entry = dispatch_lookup(table, key);
+    uint32_t variant =
+        entry ? entry->variant
+              : dispatch_calibrate(table, key, mask, run, ctx, collective);
+    run(ctx, variant);
+    return variant;
+}
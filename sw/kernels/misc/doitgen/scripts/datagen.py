@@ -11,13 +11,11 @@ import snitch.util.sim.data_utils as du
 
 np.random.seed(42)
 
-DOUBLE_BUFFER = True
-
 
 class DoitgenDataGen(du.DataGen):
 
-    # Function pointers to alternative implementations
-    FUNCPTRS = ["doitgen_naive", "doitgen_baseline", "doitgen_opt"]
+    # Function pointers to alternative GEMM tile kernels
+    FUNCPTRS = ["gemm_fp64_naive", "gemm_fp64_opt"]
 
     def golden_model(self, A, x):
         R, Q, S = A.shape
@@ -32,22 +30,15 @@ class DoitgenDataGen(du.DataGen):
         return Aout
 
     def validate(self, **kwargs):
-        n_cores = 8
-        assert (kwargs['r'] % kwargs['r_tiles']) == 0, "r must be an integer multiple of r_tiles"
-        assert (kwargs['q'] % kwargs['q_tiles']) == 0, "q must be an integer multiple of q_tiles"
-        if kwargs['funcptr'] != 'doitgen_naive':
-            assert (kwargs['s'] % 4) == 0, "s must be an integer multiple of unrolling factor"
-        r_per_tile = kwargs['r'] / kwargs['r_tiles']
-        q_per_tile = kwargs['q'] / kwargs['q_tiles']
-        assert (r_per_tile % n_cores) == 0, "r_per_tile must be an integer multiple of n_cores"
+        if kwargs['funcptr'] != 'gemm_fp64_naive':
+            assert (kwargs['s'] % 8) == 0, "s must be an integer multiple of unrolling factor"
         assert kwargs['funcptr'] in self.FUNCPTRS, f"Function pointer must be among {self.FUNCPTRS}"
 
-        # Calculate total TCDM occupation
-        a_tile_size = r_per_tile * q_per_tile * kwargs['s'] * 8
+        # Calculate total TCDM occupation, for double-buffered input and
+        # output slices of A, and x
+        a_slice_size = kwargs['q'] * kwargs['s'] * 8
         x_size = kwargs['s'] * kwargs['s'] * 8
-        total_size = 2 * a_tile_size + x_size
-        if DOUBLE_BUFFER:
-            total_size *= 2
+        total_size = 4 * a_slice_size + x_size
         du.validate_tcdm_footprint(total_size)
 
     def emit_header(self, **kwargs):
@@ -72,8 +63,7 @@ class DoitgenDataGen(du.DataGen):
             's': kwargs['s'],
             'A': A_uid,
             'x': x_uid,
-            'r_tiles': kwargs['r_tiles'],
-            'q_tiles': kwargs['q_tiles'],
+            'multicast': kwargs['multicast'],
             'funcptr': kwargs['funcptr']
         }
 
@@ -24,8 +24,7 @@ class DoitgenVerifier(Verifier):
             's': 'I',
             'A': 'I',
             'x': 'I',
-            'r_tiles': 'I',
-            'q_tiles': 'I',
+            'multicast': 'I',
             'funcptr': 'I'
         }
         self.func_args = self.get_input_from_symbol('args', self.func_args)
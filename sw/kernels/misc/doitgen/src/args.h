@@ -7,16 +7,27 @@
 #pragma once
 #include <stdint.h>
 
-typedef void (*doitgen_fp_t)(uint32_t r, uint32_t q, uint32_t s, double *A,
-                             double *x, double *Aout);
+#include "blas.h"
 
+/**
+ * @struct doitgen_args_t
+ * @brief Arguments of the DOITGEN kernel.
+ *
+ * @var doitgen_args_t::A
+ * Input tensor of shape (`r`, `q`, `s`) in L3, overwritten with the result.
+ * @var doitgen_args_t::x
+ * Input matrix of shape (`s`, `s`) in L3.
+ * @var doitgen_args_t::multicast
+ * Whether to multicast `x` to all clusters.
+ * @var doitgen_args_t::funcptr
+ * Tile kernel of the GEMM driver.
+ */
 typedef struct {
     uint32_t r;
     uint32_t q;
     uint32_t s;
     double *A;
     double *x;
-    uint32_t r_tiles;
-    uint32_t q_tiles;
-    doitgen_fp_t funcptr;
+    uint32_t multicast;
+    gemm_fp_t funcptr;
 } doitgen_args_t;
@@ -4,6 +4,8 @@
 //
 // Luca Colagrande <colluca@iis.ee.ethz.ch>
 
+#include "dispatch.h"
+
 #ifndef LEN
 #define LEN 1024
 #endif
@@ -16,6 +18,8 @@
 #define IMPL_BASELINE 1
 #define IMPL_OPTIMIZED 2
 #define IMPL_OPTIMIZED_V2 3
+#define IMPL_VMATH 4
+#define IMPL_AUTO 5
 
 #ifndef IMPL
 #define IMPL IMPL_BASELINE
@@ -29,6 +33,10 @@
 #define FUNC_PTR vexpf_optimized
 #elif IMPL == IMPL_OPTIMIZED_V2
 #define FUNC_PTR vexpf_optimized_v2
+#elif IMPL == IMPL_VMATH
+#define FUNC_PTR vexpf_vmath
+#elif IMPL == IMPL_AUTO
+#define FUNC_PTR vexpf_auto
 #endif
 
 #define ALLOCATE_BUFFER(type, size) \
@@ -60,6 +68,35 @@ __thread const double C[4] = {0x1.c6af84b912394p-5 / N / N / N,
 #include "vexpf_naive.h"
 #include "vexpf_optimized.h"
 #include "vexpf_optimized_v2.h"
+#include "vexpf_vmath.h"
+
+// All implementations, indexed by their IMPL value
+static void (*const vexpf_impls[])(double *, double *) = {
+    vexpf_naive, vexpf_baseline, vexpf_optimized, vexpf_optimized_v2,
+    vexpf_vmath};
+
+// Fastest implementation per problem size, private to every core
+__thread dispatch_table_t vexpf_table = {sizeof(vexpf_impls) /
+                                         sizeof(vexpf_impls[0])};
+
+typedef struct {
+    double *a;
+    double *b;
+} vexpf_ctx_t;
+
+static inline void vexpf_run(void *ctx, uint32_t impl) {
+    vexpf_ctx_t *x = (vexpf_ctx_t *)ctx;
+    vexpf_impls[impl](x->a, x->b);
+}
+
+// Run the fastest implementation for the problem size, timing all
+// implementations on its first occurrence. Like the implementations, must be
+// invoked by all cores in the cluster.
+static inline void vexpf_auto(double *a, double *b) {
+    vexpf_ctx_t ctx = {a, b};
+    uint32_t key[DISPATCH_KEY_LEN] = {LEN, BATCH_SIZE, 0, 0};
+    dispatch(&vexpf_table, key, (1 << IMPL_AUTO) - 1, vexpf_run, &ctx, 1);
+}
 
 static inline void vexpf_kernel(double *a, double *b) {
     snrt_mcycle();
@@ -8,6 +8,18 @@ APP              := j3d27pt
 $(APP)_BUILD_DIR ?= $(SN_ROOT)/sw/kernels/misc/$(APP)/build
 SRC_DIR          := $(SN_ROOT)/sw/kernels/misc/$(APP)/src
 SRCS             := $(SRC_DIR)/main.c
+$(APP)_INCDIRS   := $(SN_ROOT)/sw/kernels/misc
+
+include $(SN_ROOT)/sw/kernels/datagen.mk
+include $(SN_ROOT)/sw/kernels/common.mk
+
+# Variant selecting the fastest implementation at run time
+APP                 := j3d27pt_auto
+$(APP)_BUILD_DIR    ?= $(SN_ROOT)/sw/kernels/misc/j3d27pt/build/auto
+SRC_DIR             := $(SN_ROOT)/sw/kernels/misc/j3d27pt/src
+SRCS                := $(SRC_DIR)/main.c
+$(APP)_INCDIRS      := $(SN_ROOT)/sw/kernels/misc
+$(APP)_RISCV_CFLAGS := -DIMPL=IMPL_AUTO
 
 include $(SN_ROOT)/sw/kernels/datagen.mk
 include $(SN_ROOT)/sw/kernels/common.mk
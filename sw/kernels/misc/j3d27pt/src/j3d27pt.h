@@ -10,6 +10,8 @@
 #include "stdbool.h"
 #include "stdint.h"
 
+#include "dispatch.h"
+
 #include "j3d27pt_baseline1.h"
 #include "j3d27pt_baseline2.h"
 #include "j3d27pt_baseline3.h"
@@ -25,6 +27,7 @@
 #define IMPL_BASELINE_4 4
 #define IMPL_OPTIMIZED_1 5
 #define IMPL_OPTIMIZED_2 6
+#define IMPL_AUTO 7
 
 #ifndef IMPL
 #define IMPL IMPL_OPTIMIZED_2
@@ -44,8 +47,46 @@
 #define FUNC_PTR j3d27pt_opt1
 #elif IMPL == IMPL_OPTIMIZED_2
 #define FUNC_PTR j3d27pt_opt2
+#elif IMPL == IMPL_AUTO
+#define FUNC_PTR j3d27pt_auto
 #endif
 
+// All implementations, indexed by their IMPL value
+static void (*const j3d27pt_impls[])(int, int, int, int, double*, double*,
+                                     double*) = {
+    j3d27pt_naive,     j3d27pt_baseline1, j3d27pt_baseline2,
+    j3d27pt_baseline3, j3d27pt_baseline4, j3d27pt_opt1,
+    j3d27pt_opt2};
+
+// Fastest implementation per grid shape, private to every core
+__thread dispatch_table_t j3d27pt_table = {
+    sizeof(j3d27pt_impls) / sizeof(j3d27pt_impls[0])};
+
+typedef struct {
+    int fac, nx, ny, nz;
+    double *c, *A, *A_;
+} j3d27pt_ctx_t;
+
+static inline void j3d27pt_run(void* ctx, uint32_t impl) {
+    j3d27pt_ctx_t* x = (j3d27pt_ctx_t*)ctx;
+    j3d27pt_impls[impl](x->fac, x->nx, x->ny, x->nz, x->c, x->A, x->A_);
+}
+
+// Run the fastest implementation for the grid shape, timing all
+// implementations supporting the shape on its first occurrence. Every core
+// keeps its own table, so that multiple cores can invoke this function
+// concurrently, on disjoint grids.
+static inline void j3d27pt_auto(int fac, int nx, int ny, int nz, double* c,
+                                double* A, double* A_) {
+    j3d27pt_ctx_t ctx = {fac, nx, ny, nz, c, A, A_};
+    uint32_t key[DISPATCH_KEY_LEN] = {(uint32_t)nx, (uint32_t)ny,
+                                      (uint32_t)nz, 0};
+    // The SSR implementations compute two points per iteration in x and y
+    uint32_t mask = 1 << IMPL_NAIVE;
+    if (nx % 2 == 0 && ny % 2 == 0) mask = (1 << IMPL_AUTO) - 1;
+    dispatch(&j3d27pt_table, key, mask, j3d27pt_run, &ctx, 0);
+}
+
 // The Kernel
 static inline void j3d27pt(int fac, int nx, int ny, int nz, double* c,
                            double* A, double* A_) {
@@ -19,6 +19,8 @@ BURST_ALIGNMENT = 4096
 
 class KmeansDataGen(du.DataGen):
 
+    NUM_CORES = 8
+
     def parser(self):
         p = super().parser()
         p.add_argument(
@@ -58,8 +60,15 @@ class KmeansDataGen(du.DataGen):
         plt.show()
 
     def validate(self, **kwargs):
-        assert (kwargs['n_samples'] % 8) == 0, 'Number of samples must be a multiple of the' \
-                                               ' number of cores'
+        assert kwargs['tile_size'] > 0, 'Tile size must be positive'
+
+        # Samples are streamed, so only the tiles must fit in TCDM, together
+        # with the centroids, their weights and norms, and the per-core
+        # partial sums plus the reduction buffer
+        k, f = kwargs['n_clusters'], kwargs['n_features']
+        partial_len = -(-k * (f + 1) // self.NUM_CORES) * self.NUM_CORES
+        du.validate_tcdm_footprint(8 * (2 * kwargs['tile_size'] * f + 2 * k * f + k +
+                                        (self.NUM_CORES + 1) * partial_len))
 
     def emit_header(self, **kwargs):
         header = [super().emit_header()]
@@ -73,6 +82,7 @@ class KmeansDataGen(du.DataGen):
         n_clusters = kwargs['n_clusters']
         seed = kwargs['seed']
         max_iter = kwargs['max_iter']
+        tile_size = kwargs['tile_size']
 
         # Generate random samples
         X, _ = make_blobs(
@@ -95,6 +105,7 @@ class KmeansDataGen(du.DataGen):
         header += [du.format_scalar_definition('uint32_t', 'n_features', n_features)]
         header += [du.format_scalar_definition('uint32_t', 'n_clusters', n_clusters)]
         header += [du.format_scalar_definition('uint32_t', 'n_iter', n_iter)]
+        header += [du.format_scalar_definition('uint32_t', 'tile_size', tile_size)]
         header += [du.format_array_definition('double', 'centroids', initial_centroids.flatten(),
                    alignment=BURST_ALIGNMENT, section=kwargs['section'])]
         header += [du.format_array_definition('double', 'samples', X.flatten(),
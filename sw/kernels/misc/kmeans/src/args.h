@@ -7,11 +7,26 @@
 #pragma once
 #include <stdint.h>
 
+/**
+ * @struct kmeans_args_t
+ * @brief Arguments of the k-means kernel.
+ *
+ * @var kmeans_args_t::tile_size
+ * Number of samples loaded to TCDM at once by every cluster. The samples of
+ * a cluster are streamed from L3 in tiles of this size, through a double
+ * buffer, so the dataset needs not fit in TCDM.
+ * @var kmeans_args_t::samples_addr
+ * Samples in L3, in row-major order (one sample of `n_features` features
+ * per row).
+ * @var kmeans_args_t::centroids_addr
+ * Initial centroids in L3, overwritten with the final centroids.
+ */
 typedef struct {
     uint32_t n_samples;
     uint32_t n_features;
     uint32_t n_clusters;
     uint32_t n_iter;
+    uint32_t tile_size;
     uint64_t samples_addr;
     uint64_t centroids_addr;
 } kmeans_args_t;
@@ -10,180 +10,248 @@
 #include "math.h"
 #include "snrt.h"
 
+// Number of samples assigned together in the FREP loop of kmeans_assign.
+// Must match the number of accumulators in the loop body.
+#define KMEANS_UNROLL 4
+
 // Explicitly place in TCDM, through thread-local storage.
 // Otherwise every core loads it from DRAM.
 __thread double inf = INFINITY;
 
-double euclidean_distance_squared(uint32_t n_features, double* point1,
-                                  double* point2) {
-    double sum = 0;
-    for (uint32_t i = 0; i < n_features; i++) {
-        double diff = point1[i] - point2[i];
-        sum += diff * diff;
-    }
-    return sum;
+/**
+ * @brief Length of the partial sums of a core, in doubles.
+ *
+ * @details The partial sums hold the sums of the samples assigned to every
+ *          centroid (`n_clusters` x `n_features`), followed by the number of
+ *          samples assigned to every centroid, so that both are reduced
+ *          together. The length is padded to a multiple of the number of
+ *          compute cores, as required by @ref snrt_global_reduction_dma.
+ */
+static inline uint32_t kmeans_partial_len(uint32_t n_clusters,
+                                          uint32_t n_features) {
+    uint32_t n_cores = snrt_cluster_compute_core_num();
+    uint32_t len = n_clusters * (n_features + 1);
+    return (len + n_cores - 1) / n_cores * n_cores;
 }
 
-static inline void kmeans_iteration(uint32_t n_samples_per_core,
-                                    uint32_t n_clusters, uint32_t n_features,
-                                    double* samples, uint32_t* membership,
-                                    uint32_t* partial_membership_cnt,
-                                    double* initial_centroids,
-                                    double* partial_centroids) {
-    // Distribute work
-    uint32_t start_sample_idx;
-    uint32_t end_sample_idx;
+/**
+ * @brief Precompute the terms of the distances which only depend on the
+ *        centroids.
+ *
+ * @param weights Centroids scaled by -2.
+ * @param norms Squared norms of the centroids.
+ */
+static inline void kmeans_prepare(const double* centroids, uint32_t n_clusters,
+                                  uint32_t n_features, double* weights,
+                                  double* norms) {
     if (snrt_is_compute_core()) {
-        start_sample_idx = snrt_cluster_core_idx() * n_samples_per_core;
-        end_sample_idx = start_sample_idx + n_samples_per_core;
+        for (uint32_t centroid_idx = snrt_cluster_core_idx();
+             centroid_idx < n_clusters;
+             centroid_idx += snrt_cluster_compute_core_num()) {
+            const double* centroid = centroids + centroid_idx * n_features;
+            double norm = 0;
+            for (uint32_t feature_idx = 0; feature_idx < n_features;
+                 feature_idx++) {
+                double feature = centroid[feature_idx];
+                weights[centroid_idx * n_features + feature_idx] = -2 * feature;
+                norm += feature * feature;
+            }
+            norms[centroid_idx] = norm;
+        }
+    }
+}
 
-        snrt_mcycle();
+static inline void kmeans_accumulate(const double* sample,
+                                     uint32_t centroid_idx,
+                                     uint32_t n_clusters, uint32_t n_features,
+                                     double* partial) {
+    double* sum = partial + centroid_idx * n_features;
+    for (uint32_t feature_idx = 0; feature_idx < n_features; feature_idx++)
+        sum[feature_idx] += sample[feature_idx];
+    partial[n_clusters * n_features + centroid_idx] += 1;
+}
 
-        // Assignment step
-        for (uint32_t centroid_idx = 0; centroid_idx < n_clusters;
-             centroid_idx++) {
-            partial_membership_cnt[centroid_idx] = 0;
-        }
-        snrt_fpu_fence();
-        for (uint32_t sample_idx = start_sample_idx;
-             sample_idx < end_sample_idx; sample_idx++) {
-            double min_dist = inf;
-            membership[sample_idx] = 0;
+/**
+ * @brief Assign samples to their nearest centroid, and accumulate them into
+ *        the partial sums of the calling core.
+ *
+ * @details Distances are computed as ||c||^2 - 2 x.c, dropping the ||x||^2
+ *          term, which does not affect the nearest centroid. Samples are
+ *          processed in groups of @ref KMEANS_UNROLL: SSR 0 streams the
+ *          weights, repeating every weight for all samples in the group, and
+ *          SSR 1 streams the features of the samples, so that a single FREP
+ *          loop computes the distances of the group to a centroid. Leftover
+ *          samples are processed one at a time.
+ *
+ * @param samples Samples, in row-major order.
+ * @param weights Centroids scaled by -2, see @ref kmeans_prepare.
+ * @param norms Squared norms of the centroids.
+ * @param partial Partial sums of the core, see @ref kmeans_partial_len.
+ */
+static inline void kmeans_assign(const double* samples, uint32_t n_samples,
+                                 uint32_t n_clusters, uint32_t n_features,
+                                 const double* weights, const double* norms,
+                                 double* partial) {
+    uint32_t sample_idx = 0;
+
+#ifdef SNRT_SUPPORTS_FREP
+    uint32_t n_groups = n_samples / KMEANS_UNROLL;
+    if (n_groups) {
+        // Start of SSR region.
+        register volatile double ft0 asm("ft0");
+        register volatile double ft1 asm("ft1");
+        register volatile double ft2 asm("ft2");
+        asm volatile("" : "=f"(ft0), "=f"(ft1), "=f"(ft2));
+
+        snrt_ssr_loop_3d(SNRT_SSR_DM0, n_features, n_clusters, n_groups,
+                         sizeof(double), n_features * sizeof(double), 0);
+        snrt_ssr_repeat(SNRT_SSR_DM0, KMEANS_UNROLL);
+        snrt_ssr_loop_4d(SNRT_SSR_DM1, KMEANS_UNROLL, n_features, n_clusters,
+                         n_groups, n_features * sizeof(double), sizeof(double),
+                         0, KMEANS_UNROLL * n_features * sizeof(double));
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_3D, (void*)weights);
+        snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_4D, (void*)samples);
+        snrt_ssr_enable();
+
+        for (; sample_idx < n_groups * KMEANS_UNROLL;
+             sample_idx += KMEANS_UNROLL) {
+            double min_dist[KMEANS_UNROLL];
+            uint32_t membership[KMEANS_UNROLL];
+            for (uint32_t i = 0; i < KMEANS_UNROLL; i++) {
+                min_dist[i] = inf;
+                membership[i] = 0;
+            }
 
             for (uint32_t centroid_idx = 0; centroid_idx < n_clusters;
                  centroid_idx++) {
-                double dist = euclidean_distance_squared(
-                    n_features, &samples[sample_idx * n_features],
-                    &initial_centroids[centroid_idx * n_features]);
-                if (dist < min_dist) {
-                    min_dist = dist;
-                    membership[sample_idx] = centroid_idx;
+                double dist0 = norms[centroid_idx];
+                double dist1 = dist0;
+                double dist2 = dist0;
+                double dist3 = dist0;
+                asm volatile(
+                    "frep.o %[n_frep], 4, 0, 0 \n"
+                    "fmadd.d %[dist0], ft0, ft1, %[dist0] \n"
+                    "fmadd.d %[dist1], ft0, ft1, %[dist1] \n"
+                    "fmadd.d %[dist2], ft0, ft1, %[dist2] \n"
+                    "fmadd.d %[dist3], ft0, ft1, %[dist3] \n"
+                    : [ dist0 ] "+f"(dist0), [ dist1 ] "+f"(dist1),
+                      [ dist2 ] "+f"(dist2), [ dist3 ] "+f"(dist3)
+                    : [ n_frep ] "r"(n_features - 1), "f"(ft0), "f"(ft1)
+                    : "memory");
+                double dist[KMEANS_UNROLL] = {dist0, dist1, dist2, dist3};
+                for (uint32_t i = 0; i < KMEANS_UNROLL; i++) {
+                    if (dist[i] < min_dist[i]) {
+                        min_dist[i] = dist[i];
+                        membership[i] = centroid_idx;
+                    }
                 }
             }
-            partial_membership_cnt[membership[sample_idx]]++;
-        }
-    }
-
-    snrt_mcycle();
 
-    // snrt_global_barrier();
+            for (uint32_t i = 0; i < KMEANS_UNROLL; i++)
+                kmeans_accumulate(samples + (sample_idx + i) * n_features,
+                                  membership[i], n_clusters, n_features,
+                                  partial);
+        }
 
-    snrt_mcycle();
+        // End of SSR region.
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+        snrt_ssr_repeat(SNRT_SSR_DM0, 1);
+        asm volatile("" : : "f"(ft0), "f"(ft1), "f"(ft2));
+    }
+#endif
 
-    if (snrt_is_compute_core()) {
-        // Update step
+    for (; sample_idx < n_samples; sample_idx++) {
+        const double* sample = samples + sample_idx * n_features;
+        double min_dist = inf;
+        uint32_t membership = 0;
         for (uint32_t centroid_idx = 0; centroid_idx < n_clusters;
              centroid_idx++) {
+            double dist = norms[centroid_idx];
             for (uint32_t feature_idx = 0; feature_idx < n_features;
                  feature_idx++) {
-                // Initialize centroids to zero
-                // TODO: Can be optimized w/ DMA
-                partial_centroids[centroid_idx * n_features + feature_idx] = 0;
+                dist += weights[centroid_idx * n_features + feature_idx] *
+                        sample[feature_idx];
             }
-        }
-        snrt_fpu_fence();
-        for (uint32_t sample_idx = start_sample_idx;
-             sample_idx < end_sample_idx; sample_idx++) {
-            for (uint32_t feature_idx = 0; feature_idx < n_features;
-                 feature_idx++) {
-                partial_centroids[membership[sample_idx] * n_features +
-                                  feature_idx] +=
-                    samples[sample_idx * n_features + feature_idx];
+            if (dist < min_dist) {
+                min_dist = dist;
+                membership = centroid_idx;
             }
         }
+        kmeans_accumulate(sample, membership, n_clusters, n_features, partial);
     }
+}
 
-    snrt_mcycle();
-
-    snrt_cluster_hw_barrier();
-
-    snrt_mcycle();
-
-    if (snrt_is_compute_core()) {
-        if (snrt_cluster_core_idx() == 0) {
-            // Intra-cluster reduction
-            for (uint32_t core_idx = 1;
-                 core_idx < snrt_cluster_compute_core_num(); core_idx++) {
-                // Pointers to variables of the other core
-                uint32_t* remote_partial_membership_cnt =
-                    (uint32_t*)snrt_compute_core_local_ptr(
-                        partial_membership_cnt, core_idx,
-                        n_clusters * sizeof(uint32_t));
-                double* remote_partial_centroids =
-                    (double*)snrt_compute_core_local_ptr(
-                        partial_centroids, core_idx,
-                        n_clusters * n_features * sizeof(double));
-                for (uint32_t centroid_idx = 0; centroid_idx < n_clusters;
-                     centroid_idx++) {
-                    // Accumulate membership counters
-                    partial_membership_cnt[centroid_idx] +=
-                        remote_partial_membership_cnt[centroid_idx];
-                    // Accumulate centroid features
-                    for (uint32_t feature_idx = 0; feature_idx < n_features;
-                         feature_idx++) {
-                        partial_centroids[centroid_idx * n_features +
-                                          feature_idx] +=
-                            remote_partial_centroids[centroid_idx * n_features +
-                                                     feature_idx];
-                    }
-                }
+/**
+ * @brief Sum the partial sums of all compute cores into those of core 0.
+ *
+ * @details The partial sums are reduced in a binary tree. At every level,
+ *          the cores are divided in groups of twice the stride, and the
+ *          partial sums of the second half of a group are added to those of
+ *          the first half by all cores in the group together, so that all
+ *          cores stay busy at every level. Must be invoked by all cores in
+ *          the cluster.
+ *
+ * @param partial Partial sums of all compute cores, `len` doubles apart.
+ */
+static inline void kmeans_reduce_cores(double* partial, uint32_t len) {
+    uint32_t n_cores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+
+    for (uint32_t stride = 1; stride < n_cores; stride *= 2) {
+        if (snrt_is_compute_core()) {
+            uint32_t group = core_idx - core_idx % (2 * stride);
+            uint32_t rank = core_idx - group;
+            if (group + stride < n_cores) {
+                uint32_t group_size = n_cores - group < 2 * stride
+                                          ? n_cores - group
+                                          : 2 * stride;
+                double* dst = partial + group * len;
+                double* src = dst + stride * len;
+                uint32_t start = rank * len / group_size;
+                uint32_t end = (rank + 1) * len / group_size;
+                for (uint32_t i = start; i < end; i++) dst[i] += src[i];
             }
+        }
+        snrt_fpu_fence();
+        snrt_cluster_hw_barrier();
+    }
+}
 
-            snrt_mcycle();
-
-#if !defined(KMEANS_REDUCTION_ON_HOST)
-            snrt_inter_cluster_barrier();
-
-            if (snrt_cluster_idx() == 0) {
-                snrt_mcycle();
-
-                // Inter-cluster reduction
-                for (uint32_t cluster_idx = 1; cluster_idx < snrt_cluster_num();
-                     cluster_idx++) {
-                    // Pointers to variables of remote clusters
-                    uint32_t* remote_partial_membership_cnt =
-                        (uint32_t*)snrt_remote_l1_ptr(partial_membership_cnt, 0,
-                                                      cluster_idx);
-                    double* remote_partial_centroids =
-                        (double*)snrt_remote_l1_ptr(partial_centroids, 0,
-                                                    cluster_idx);
-                    for (uint32_t centroid_idx = 0; centroid_idx < n_clusters;
-                         centroid_idx++) {
-                        // Accumulate membership counters
-                        partial_membership_cnt[centroid_idx] +=
-                            remote_partial_membership_cnt[centroid_idx];
-                        // Accumulate centroid features
-                        for (uint32_t feature_idx = 0; feature_idx < n_features;
-                             feature_idx++) {
-                            partial_centroids[centroid_idx * n_features +
-                                              feature_idx] +=
-                                remote_partial_centroids[centroid_idx *
-                                                             n_features +
-                                                         feature_idx];
-                        }
-                    }
-                }
-
-                snrt_mcycle();
-
-                // Normalize
-                for (uint32_t centroid_idx = 0; centroid_idx < n_clusters;
-                     centroid_idx++) {
-                    for (uint32_t feature_idx = 0; feature_idx < n_features;
-                         feature_idx++) {
-                        partial_centroids[centroid_idx * n_features +
-                                          feature_idx] /=
-                            partial_membership_cnt[centroid_idx];
-                    }
-                }
+/**
+ * @brief Compute the new centroids from the sums of all clusters.
+ * @details Centroids without assigned samples keep their previous value.
+ */
+static inline void kmeans_update(const double* sums, uint32_t n_clusters,
+                                 uint32_t n_features, double* centroids) {
+    if (snrt_is_compute_core()) {
+        const double* counts = sums + n_clusters * n_features;
+        for (uint32_t centroid_idx = snrt_cluster_core_idx();
+             centroid_idx < n_clusters;
+             centroid_idx += snrt_cluster_compute_core_num()) {
+            if (counts[centroid_idx] == 0) continue;
+            double scale = 1 / counts[centroid_idx];
+            for (uint32_t feature_idx = 0; feature_idx < n_features;
+                 feature_idx++) {
+                uint32_t i = centroid_idx * n_features + feature_idx;
+                centroids[i] = sums[i] * scale;
             }
-
-            snrt_mcycle();
-#endif
         }
     }
 }
 
+/**
+ * @brief Lloyd's k-means algorithm, on all clusters.
+ *
+ * @details Every cluster processes a contiguous range of the samples, which
+ *          is streamed from L3 in tiles, through a double buffer in TCDM, in
+ *          every iteration. If the range fits in a single tile, it is only
+ *          loaded once. The partial sums of the cores are reduced within a
+ *          cluster by @ref kmeans_reduce_cores, and across clusters, into
+ *          cluster 0, by @ref snrt_global_reduction_dma. Cluster 0 computes
+ *          the new centroids, which the other clusters then fetch from its
+ *          TCDM. Must be invoked by all cores in all clusters.
+ */
 void kmeans_job(kmeans_args_t* args) {
     snrt_mcycle();
 
@@ -195,61 +263,133 @@ void kmeans_job(kmeans_args_t* args) {
     double* samples = (double*)(args->samples_addr);
     double* centroids = (double*)(args->centroids_addr);
 
-    // Distribute work
-    uint32_t n_samples_per_cluster = n_samples / snrt_cluster_num();
-    uint32_t n_samples_per_core =
-        n_samples_per_cluster / snrt_cluster_compute_core_num();
-
-    // Dynamically allocate space in TCDM
-    double* local_samples = (double*)snrt_l1_alloc_cluster_local(
-        n_samples_per_cluster * n_features * sizeof(double), sizeof(double));
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t cluster_num = snrt_cluster_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t n_cores = snrt_cluster_compute_core_num();
+
+    // Distribute samples to clusters, and divide them in tiles
+    uint32_t first_sample = cluster_idx * n_samples / cluster_num;
+    uint32_t n_local_samples =
+        (cluster_idx + 1) * n_samples / cluster_num - first_sample;
+    uint32_t tile_size = args->tile_size;
+    uint32_t n_tiles = (n_local_samples + tile_size - 1) / tile_size;
+    uint32_t sample_size = n_features * sizeof(double);
+    size_t centroids_size = n_clusters * n_features * sizeof(double);
+    uint32_t partial_len = kmeans_partial_len(n_clusters, n_features);
+
+    // Dynamically allocate space in TCDM. The allocation must be identical
+    // in all clusters, as the reduction and the new centroids are exchanged
+    // at the same offsets in every cluster's TCDM.
+    double* tiles[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        tiles[i] = (double*)snrt_l1_alloc_cluster_local(
+            tile_size * sample_size, sizeof(double));
+    }
     double* local_centroids = (double*)snrt_l1_alloc_cluster_local(
-        n_clusters * n_features * sizeof(double), sizeof(double));
-    uint32_t* membership = (uint32_t*)snrt_l1_alloc_cluster_local(
-        n_samples_per_cluster * sizeof(uint32_t), sizeof(uint32_t));
-    uint32_t* partial_membership_cnt =
-        (uint32_t*)snrt_l1_alloc_compute_core_local(
-            n_clusters * sizeof(uint32_t), sizeof(uint32_t));
-    // First core's partial centroids will store final centroids
-    double* partial_centroids = (double*)snrt_l1_alloc_compute_core_local(
-        n_clusters * n_features * sizeof(double), sizeof(double));
-    double* final_centroids = (double*)snrt_compute_core_local_ptr(
-        partial_centroids, 0, n_clusters * n_features * sizeof(double));
-    final_centroids =
-        (double*)snrt_remote_l1_ptr(final_centroids, snrt_cluster_idx(), 0);
-
-    snrt_mcycle();
-
-    // Transfer samples and initial centroids with DMA
-    size_t size;
-    size_t offset;
+        centroids_size, sizeof(double));
+    double* weights = (double*)snrt_l1_alloc_cluster_local(centroids_size,
+                                                           sizeof(double));
+    double* norms = (double*)snrt_l1_alloc_cluster_local(
+        n_clusters * sizeof(double), sizeof(double));
+    // Core 0's partial sums also hold the sums of the cluster
+    double* partial = (double*)snrt_l1_alloc_cluster_local(
+        n_cores * partial_len * sizeof(double), sizeof(double));
+    double* red_dst = (double*)snrt_l1_alloc_cluster_local(
+        partial_len * sizeof(double), sizeof(double));
+
+    // Transfer initial centroids with DMA
     if (snrt_is_dm_core()) {
-        size = n_samples_per_cluster * n_features;
-        offset = snrt_cluster_idx() * size;
-        snrt_dma_start_1d(local_samples, samples + offset,
-                          size * sizeof(double));
-        size = n_clusters * n_features * sizeof(double);
-        snrt_dma_start_1d(local_centroids, centroids, size * sizeof(double));
+        snrt_dma_start_1d(local_centroids, centroids, centroids_size);
         snrt_dma_wait_all();
     }
 
-    snrt_cluster_hw_barrier();
-
     snrt_mcycle();
 
     // Iterations of Lloyd's K-means algorithm
     for (uint32_t iter_idx = 0; iter_idx < n_iter; iter_idx++) {
-        kmeans_iteration(n_samples_per_core, n_clusters, n_features,
-                         local_samples, membership, partial_membership_cnt,
-                         local_centroids, partial_centroids);
+        snrt_cluster_hw_barrier();
+
+        kmeans_prepare(local_centroids, n_clusters, n_features, weights,
+                       norms);
+        if (snrt_is_compute_core()) {
+            double* core_partial = partial + core_idx * partial_len;
+            for (uint32_t i = 0; i < partial_len; i++) core_partial[i] = 0;
+        }
+
+        // Load the first tile, unless it is still resident from the
+        // previous iteration
+        if (snrt_is_dm_core() && n_tiles && (iter_idx == 0 || n_tiles > 1)) {
+            uint32_t n = n_local_samples < tile_size ? n_local_samples
+                                                     : tile_size;
+            snrt_dma_start_1d(tiles[0], samples + first_sample * n_features,
+                              n * sample_size);
+            snrt_dma_wait_all();
+        }
+        snrt_fpu_fence();
+        snrt_cluster_hw_barrier();
+
+        snrt_mcycle();
+
+        // Assignment step, accumulating the samples into the partial sums
+        for (uint32_t tile_idx = 0; tile_idx < n_tiles; tile_idx++) {
+            uint32_t tile_start = tile_idx * tile_size;
+            uint32_t n = n_local_samples - tile_start < tile_size
+                             ? n_local_samples - tile_start
+                             : tile_size;
+
+            // Prefetch the next tile
+            if (snrt_is_dm_core() && tile_idx + 1 < n_tiles) {
+                uint32_t next_start = tile_start + tile_size;
+                uint32_t next_n = n_local_samples - next_start < tile_size
+                                      ? n_local_samples - next_start
+                                      : tile_size;
+                snrt_dma_start_1d(
+                    tiles[(tile_idx + 1) % 2],
+                    samples + (first_sample + next_start) * n_features,
+                    next_n * sample_size);
+            }
+
+            if (snrt_is_compute_core()) {
+                uint32_t start = core_idx * n / n_cores;
+                uint32_t end = (core_idx + 1) * n / n_cores;
+                kmeans_assign(tiles[tile_idx % 2] + start * n_features,
+                              end - start, n_clusters, n_features, weights,
+                              norms, partial + core_idx * partial_len);
+            }
+
+            if (snrt_is_dm_core()) snrt_dma_wait_all();
+            snrt_fpu_fence();
+            snrt_cluster_hw_barrier();
+        }
+
+        snrt_mcycle();
+
+        // Update step
+        kmeans_reduce_cores(partial, partial_len);
+        snrt_global_reduction_dma(red_dst, partial, partial_len);
+        if (cluster_idx == 0) {
+            kmeans_update(partial, n_clusters, n_features, local_centroids);
+            snrt_fpu_fence();
+        }
         snrt_global_barrier();
-        local_centroids = final_centroids;
+
+        // Broadcast the new centroids from cluster 0's TCDM
+        if (snrt_is_dm_core() && cluster_idx != 0) {
+            snrt_dma_start_1d(
+                local_centroids,
+                snrt_remote_l1_ptr(local_centroids, cluster_idx, 0),
+                centroids_size);
+            snrt_dma_wait_all();
+        }
+
         snrt_mcycle();
     }
 
     // Transfer final centroids with DMA
-    if (snrt_is_dm_core() && snrt_cluster_idx() == 0) {
-        snrt_dma_start_1d((void*)centroids, (void*)final_centroids, size);
+    if (snrt_is_dm_core() && cluster_idx == 0) {
+        snrt_dma_start_1d(centroids, local_centroids, centroids_size);
         snrt_dma_wait_all();
     }
+    snrt_cluster_hw_barrier();
 }
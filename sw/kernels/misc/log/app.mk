@@ -6,6 +6,16 @@
 
 APP              := log
 SRCS             := $(SN_ROOT)/sw/kernels/misc/$(APP)/main.c
+$(APP)_INCDIRS   := $(SN_ROOT)/sw/kernels/misc
 $(APP)_BUILD_DIR ?= $(SN_ROOT)/sw/kernels/misc/$(APP)/build
 
 include $(SN_ROOT)/sw/kernels/common.mk
+
+# Variant selecting the fastest implementation at run time
+APP                 := log_auto
+SRCS                := $(SN_ROOT)/sw/kernels/misc/log/main.c
+$(APP)_INCDIRS      := $(SN_ROOT)/sw/kernels/misc
+$(APP)_BUILD_DIR    ?= $(SN_ROOT)/sw/kernels/misc/log/build/auto
+$(APP)_RISCV_CFLAGS := -DIMPL=IMPL_AUTO
+
+include $(SN_ROOT)/sw/kernels/common.mk
@@ -4,6 +4,8 @@
 //
 // Luca Colagrande <colluca@iis.ee.ethz.ch>
 
+#include "dispatch.h"
+
 #ifndef LEN
 #define LEN 1024
 #endif
@@ -17,6 +19,8 @@
 #define IMPL_OPTIMIZED 2
 #define IMPL_ISSR 3
 #define IMPL_OPTIMIZED_V2 4
+#define IMPL_VMATH 5
+#define IMPL_AUTO 6
 
 #ifndef IMPL
 #define IMPL IMPL_BASELINE
@@ -26,10 +30,16 @@
 #define FUNC_PTR vlogf_naive
 #elif IMPL == IMPL_BASELINE
 #define FUNC_PTR vlogf_baseline
-#elif IMPL == IMPL_OPTIMIZED || IMPL == IMPL_ISSR
+#elif IMPL == IMPL_OPTIMIZED
 #define FUNC_PTR vlogf_optimized
+#elif IMPL == IMPL_ISSR
+#define FUNC_PTR vlogf_issr
 #elif IMPL == IMPL_OPTIMIZED_V2
 #define FUNC_PTR vlogf_optimized_v2
+#elif IMPL == IMPL_VMATH
+#define FUNC_PTR vlogf_vmath
+#elif IMPL == IMPL_AUTO
+#define FUNC_PTR vlogf_auto
 #endif
 
 #define ALLOCATE_BUFFER(type, size) \
@@ -68,6 +78,36 @@ __thread const uint32_t OFF = 0x3f330000;
 #include "vlogf_naive.h"
 #include "vlogf_optimized.h"
 #include "vlogf_optimized_v2.h"
+#include "vlogf_vmath.h"
+
+// All implementations, indexed by their IMPL value
+static void (*const vlogf_impls[])(float *, double *) = {
+    vlogf_naive, vlogf_baseline, vlogf_optimized, vlogf_issr,
+    vlogf_optimized_v2, vlogf_vmath};
+
+// Fastest implementation per problem size, private to every core
+__thread dispatch_table_t vlogf_table = {sizeof(vlogf_impls) /
+                                         sizeof(vlogf_impls[0])};
+
+typedef struct {
+    float *a;
+    double *b;
+} vlogf_ctx_t;
+
+static inline void vlogf_run(void *ctx, uint32_t impl) {
+    vlogf_ctx_t *x = (vlogf_ctx_t *)ctx;
+    vlogf_impls[impl](x->a, x->b);
+}
+
+// Run the fastest implementation for the problem size, timing all
+// implementations on its first occurrence. Like the implementations, must be
+// invoked by all cores in the cluster.
+static inline void vlogf_auto(float *a, double *b) {
+    vlogf_ctx_t ctx = {a, b};
+    uint32_t key[DISPATCH_KEY_LEN] = {LEN, BATCH_SIZE, 0, 0};
+    uint32_t mask = (1 << IMPL_AUTO) - 1;
+    dispatch(&vlogf_table, key, mask, vlogf_run, &ctx, 1);
+}
 
 static inline void vlogf_kernel(float *a, double *b) {
     snrt_mcycle();
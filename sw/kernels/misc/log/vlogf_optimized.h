@@ -8,7 +8,9 @@
 
 #include "vlogf_optimized_asm.h"
 
-static inline void vlogf_optimized(float *a, double *b) {
+// If `issr` is set, the table entries are loaded in the FP phase through an
+// indirect SSR, instead of being gathered in the INT phase
+static inline void vlogf_optimized_common(float *a, double *b, uint32_t issr) {
 #ifdef SNRT_SUPPORTS_FREP
     // Derived parameters
     unsigned int n_stages = 4;  // DMA in, INT, FP, DMA out
@@ -31,15 +33,15 @@ static inline void vlogf_optimized(float *a, double *b) {
     z_buffers[1] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
     k_buffers[0] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
     k_buffers[1] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
-#if IMPL == IMPL_ISSR
-    idx_buffers[0] = ALLOCATE_BUFFER(uint8_t, BATCH_SIZE * 2);
-    idx_buffers[1] = ALLOCATE_BUFFER(uint8_t, BATCH_SIZE * 2);
-#else
-    invc_buffers[0] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
-    invc_buffers[1] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
-    logc_buffers[0] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
-    logc_buffers[1] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
-#endif
+    if (issr) {
+        idx_buffers[0] = ALLOCATE_BUFFER(uint8_t, BATCH_SIZE * 2);
+        idx_buffers[1] = ALLOCATE_BUFFER(uint8_t, BATCH_SIZE * 2);
+    } else {
+        invc_buffers[0] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
+        invc_buffers[1] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
+        logc_buffers[0] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
+        logc_buffers[1] = ALLOCATE_BUFFER(uint64_t, BATCH_SIZE);
+    }
 
     // Define buffer pointers for every phase (int and fp)
     unsigned int dma_a_idx = 0;
@@ -126,20 +128,20 @@ static inline void vlogf_optimized(float *a, double *b) {
                                      N_BUFFERS * BATCH_SIZE * sizeof(uint64_t),
                                      sizeof(uint64_t) * unroll_factor);
                     snrt_ssr_loop_1d(SNRT_SSR_DM2, BATCH_SIZE, sizeof(double));
-#if IMPL == IMPL_ISSR
+                    if (!issr)
+                        snrt_ssr_loop_3d(
+                            SNRT_SSR_DM1, unroll_factor, 2,
+                            BATCH_SIZE / unroll_factor, sizeof(uint64_t),
+                            N_BUFFERS * BATCH_SIZE * sizeof(uint64_t),
+                            sizeof(uint64_t) * unroll_factor);
                 }
-                // Load invc and logc using an ISSR
-                snrt_issr_read(SNRT_SSR_DM1, (void *)T, fp_idx_ptr,
-                               2 * BATCH_SIZE, SNRT_SSR_IDXSIZE_U8);
-#else
-                    snrt_ssr_loop_3d(SNRT_SSR_DM1, unroll_factor, 2,
-                                     BATCH_SIZE / unroll_factor,
-                                     sizeof(uint64_t),
-                                     N_BUFFERS * BATCH_SIZE * sizeof(uint64_t),
-                                     sizeof(uint64_t) * unroll_factor);
+                if (issr) {
+                    // Load invc and logc using an ISSR
+                    snrt_issr_read(SNRT_SSR_DM1, (void *)T, fp_idx_ptr,
+                                   2 * BATCH_SIZE, SNRT_SSR_IDXSIZE_U8);
+                } else {
+                    snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_3D, fp_invc_ptr);
                 }
-                snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_3D, fp_invc_ptr);
-#endif
                 snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_3D, fp_z_ptr);
                 snrt_ssr_write(SNRT_SSR_DM2, SNRT_SSR_1D, fp_b_ptr);
                 snrt_ssr_enable();
@@ -174,22 +176,35 @@ static inline void vlogf_optimized(float *a, double *b) {
                 // Avoid further unrolling by the compiler so that loop fits in
                 // L0 cache
                 int unroll_factor = 4;
+                if (issr) {
 #pragma nounroll
-                for (int i = 0; i < BATCH_SIZE; i += unroll_factor) {
-                    asm volatile(INT_ASM_BODY
-                                 :
-                                 : [ a ] "r"(int_a_ptr + i), [ OFF ] "r"(OFF),
-                                   [ T ] "r"(T), [ z ] "r"(int_z_ptr + i),
-                                   [ k ] "r"(int_k_ptr + i),
-#if IMPL == IMPL_ISSR
-                                   [ idx ] "r"(int_idx_ptr + 2 * i)
-#else
-                                   [ invc ] "r"(int_invc_ptr + i),
-                                   [ logc ] "r"(int_logc_ptr + i)
-#endif
-                                 : "a0", "a1", "a2", "a3", "a4", "a5", "a6",
-                                   "a7", "t0", "t1", "t2", "t3", "t4", "t5",
-                                   "t6", "s0", "memory");
+                    for (int i = 0; i < BATCH_SIZE; i += unroll_factor) {
+                        asm volatile(
+                            INT_ASM_BODY_ISSR
+                            :
+                            : [ a ] "r"(int_a_ptr + i), [ OFF ] "r"(OFF),
+                              [ T ] "r"(T), [ z ] "r"(int_z_ptr + i),
+                              [ k ] "r"(int_k_ptr + i),
+                              [ idx ] "r"(int_idx_ptr + 2 * i)
+                            : "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7",
+                              "t0", "t1", "t2", "t3", "t4", "t5", "t6", "s0",
+                              "memory");
+                    }
+                } else {
+#pragma nounroll
+                    for (int i = 0; i < BATCH_SIZE; i += unroll_factor) {
+                        asm volatile(
+                            INT_ASM_BODY
+                            :
+                            : [ a ] "r"(int_a_ptr + i), [ OFF ] "r"(OFF),
+                              [ T ] "r"(T), [ z ] "r"(int_z_ptr + i),
+                              [ k ] "r"(int_k_ptr + i),
+                              [ invc ] "r"(int_invc_ptr + i),
+                              [ logc ] "r"(int_logc_ptr + i)
+                            : "a0", "a1", "a2", "a3", "a4", "a5", "a6", "a7",
+                              "t0", "t1", "t2", "t3", "t4", "t5", "t6", "s0",
+                              "memory");
+                    }
                 }
 
                 // Increment buffer indices for next iteration
@@ -207,3 +222,11 @@ static inline void vlogf_optimized(float *a, double *b) {
     }
 #endif
 }
+
+static inline void vlogf_optimized(float *a, double *b) {
+    vlogf_optimized_common(a, b, 0);
+}
+
+static inline void vlogf_issr(float *a, double *b) {
+    vlogf_optimized_common(a, b, 1);
+}
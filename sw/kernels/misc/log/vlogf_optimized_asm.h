@@ -42,8 +42,9 @@
     "fmadd.d      ft2, ft9, fa5, ft3         \n" \
     "fmadd.d      ft2, ft10, fa6, ft4        \n"
 
-#if IMPL == IMPL_ISSR
-#define INT_ASM_BODY          \
+// Integer phase of the ISSR variant, which stores the indices of the table
+// entries rather than the entries themselves
+#define INT_ASM_BODY_ISSR     \
     "lw   a0,  0(%[a])    \n" \
     "lw   a4,  4(%[a])    \n" \
     "lw   a5,  8(%[a])    \n" \
@@ -96,7 +97,7 @@
     "sb   a7, 5(%[idx])   \n" \
     "sb   t0, 6(%[idx])   \n" \
     "sb   t1, 7(%[idx])   \n"
-#else
+
 #define INT_ASM_BODY          \
     "lw   a0,  0(%[a])    \n" \
     "lw   a4,  4(%[a])    \n" \
@@ -174,4 +175,3 @@
     "sw   t6, 28(%[invc]) \n" \
     "sw   s0, 24(%[logc]) \n" \
     "sw   t1, 28(%[logc]) \n"
-#endif
\ No newline at end of file
@@ -0,0 +1,66 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "vmath/vmath.h"
+
+#define N_BUFFERS 2
+
+// Same double-buffered structure as `vlogf_baseline`, computing every batch
+// with the vector math library
+static inline void vlogf_vmath(float *a, double *b) {
+    int n_batches = LEN / BATCH_SIZE;
+    int n_iterations = n_batches + 2;
+
+    float *a_buffers[N_BUFFERS];
+    double *b_buffers[N_BUFFERS];
+
+    a_buffers[0] = ALLOCATE_BUFFER(float, BATCH_SIZE);
+    a_buffers[1] = ALLOCATE_BUFFER(float, BATCH_SIZE);
+    b_buffers[0] = ALLOCATE_BUFFER(double, BATCH_SIZE);
+    b_buffers[1] = ALLOCATE_BUFFER(double, BATCH_SIZE);
+
+    unsigned int dma_a_idx = 0;
+    unsigned int dma_b_idx = 0;
+    unsigned int comp_idx = 0;
+
+    // Iterate over batches
+    for (int iteration = 0; iteration < n_iterations; iteration++) {
+        snrt_mcycle();
+
+        // DMA cores
+        if (snrt_is_dm_core()) {
+            // DMA in phase
+            if (iteration < n_iterations - 2) {
+                snrt_dma_load_1d_tile(a_buffers[dma_a_idx], a, iteration,
+                                      BATCH_SIZE, sizeof(float));
+                dma_a_idx += 1;
+                dma_a_idx %= N_BUFFERS;
+            }
+
+            // DMA out phase
+            if (iteration > 1) {
+                snrt_dma_store_1d_tile(b, b_buffers[dma_b_idx], iteration - 2,
+                                       BATCH_SIZE, sizeof(double));
+                dma_b_idx += 1;
+                dma_b_idx %= N_BUFFERS;
+            }
+            snrt_dma_wait_all();
+        }
+
+        // Compute phase
+        if (snrt_cluster_core_idx() == 0) {
+            if (iteration > 0 && iteration < n_iterations - 1) {
+                float *comp_a_ptr = a_buffers[comp_idx];
+                double *comp_b_ptr = b_buffers[comp_idx];
+                for (int i = 0; i < BATCH_SIZE; i++)
+                    comp_b_ptr[i] = vmath_logf(comp_a_ptr[i]);
+                comp_idx += 1;
+                comp_idx %= N_BUFFERS;
+            }
+        }
+
+        // Synchronize cores
+        snrt_cluster_hw_barrier();
+    }
+}
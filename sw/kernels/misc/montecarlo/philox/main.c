@@ -0,0 +1,107 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Monte Carlo benchmark of the Philox generator on all harts of all
+// clusters. Every compute core draws from its own stream, in batches
+// written to TCDM by the bulk fill functions, and the results of all cores
+// are combined at the end. The throughput in variates per kilocycle, over
+// all clusters, is printed by the first core.
+//
+// With the uniform distribution, pi is estimated from the fraction of
+// points of the unit square falling into the unit circle. With the normal
+// distribution, the second moment, which should be one, is estimated.
+
+#include <math.h>
+
+#include "primitives/primitives.h"
+#include "prng/fill.h"
+#include "snrt.h"
+
+// Number of variates drawn by every core
+#ifndef N_SAMPLES
+#define N_SAMPLES 2048
+#endif
+
+// Number of variates per fill
+#ifndef BATCH_SIZE
+#define BATCH_SIZE 256
+#endif
+
+#define DISTRIBUTION_UNIFORM 0
+#define DISTRIBUTION_NORMAL 1
+
+#ifndef DISTRIBUTION
+#define DISTRIBUTION DISTRIBUTION_UNIFORM
+#endif
+
+// Whether to overlap integer generation and conversion with COPIFT
+#ifndef USE_COPIFT
+#define USE_COPIFT 1
+#endif
+
+#define SEED 42
+
+int main() {
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t n_cores = snrt_cluster_compute_core_num();
+
+    // Per-core batch and staging buffers
+    double *batches = (double *)snrt_l1_alloc_cluster_local(
+        n_cores * BATCH_SIZE * sizeof(double), sizeof(double));
+    uint64_t *stagings = (uint64_t *)snrt_l1_alloc_cluster_local(
+        n_cores * 2 * PRNG_BATCH * sizeof(uint64_t), sizeof(uint64_t));
+    double *batch = batches + core_idx * BATCH_SIZE;
+    uint64_t *staging = USE_COPIFT ? stagings + core_idx * 2 * PRNG_BATCH : 0;
+
+    philox4x32_t philox = prng_init_hart(SEED);
+
+    snrt_global_barrier();
+    uint32_t start = snrt_mcycle();
+
+    double acc = 0;
+    if (snrt_is_compute_core()) {
+        for (uint32_t i = 0; i < N_SAMPLES; i += BATCH_SIZE) {
+#if DISTRIBUTION == DISTRIBUTION_UNIFORM
+            if (USE_COPIFT)
+                prng_fill_uniform_f64_copift(&philox, batch, BATCH_SIZE,
+                                             staging);
+            else
+                prng_fill_uniform_f64(&philox, batch, BATCH_SIZE);
+            for (uint32_t j = 0; j < BATCH_SIZE; j += 2) {
+                double x = batch[j];
+                double y = batch[j + 1];
+                acc += (x * x + y * y) < 1.0;
+            }
+#elif DISTRIBUTION == DISTRIBUTION_NORMAL
+            prng_fill_normal_f64(&philox, batch, BATCH_SIZE, staging);
+            for (uint32_t j = 0; j < BATCH_SIZE; j++)
+                acc += batch[j] * batch[j];
+#endif
+        }
+    }
+
+    snrt_global_barrier();
+    uint32_t cycles = snrt_mcycle() - start;
+
+    // Combine the results of all cores
+    acc = prim_allreduce<double>(acc, 1);
+
+    uint32_t nerr = 0;
+    if (snrt_global_core_idx() == 0) {
+        uint32_t n_total = N_SAMPLES * n_cores * snrt_cluster_num();
+        printf("%u variates in %u cycles (%u per kilocycle)\n", n_total,
+               cycles, (uint32_t)((1000ull * n_total) / cycles));
+
+#if DISTRIBUTION == DISTRIBUTION_UNIFORM
+        double estimate = 4 * acc / (n_total / 2);
+        double golden = M_PI;
+#elif DISTRIBUTION == DISTRIBUTION_NORMAL
+        double estimate = acc / n_total;
+        double golden = 1.0;
+#endif
+        if (fabs(estimate - golden) > 0.1) nerr = 1;
+    }
+
+    return nerr;
+}
@@ -0,0 +1,52 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "snrt.h"
+
+/**
+ * @brief Gather an array from every cluster into the TCDM of every cluster.
+ *
+ * @details The DMA core of every cluster writes its array to its slot in the
+ *          buffer of every cluster. On return, the buffers are identical.
+ *          The writes only start once all clusters have reached the call,
+ *          as the buffer may still be in use as scratch space of a
+ *          preceding call in another cluster. Must be invoked by all cores
+ *          in all clusters.
+ *
+ * @param buf Buffer of `len` elements per cluster, in TCDM, at the same
+ *            offset in all clusters.
+ * @param src Array of `len` elements of the calling cluster.
+ */
+template <typename T>
+static inline void prim_allgather(T *buf, const T *src, uint32_t len) {
+    snrt_global_barrier();
+    if (snrt_is_dm_core()) {
+        uint32_t cluster_idx = snrt_cluster_idx();
+        T *dst = buf + cluster_idx * len;
+        for (uint32_t c = 0; c < snrt_cluster_num(); c++) {
+            if (c == cluster_idx && dst == src) continue;
+            snrt_dma_start_1d(snrt_remote_l1_ptr(dst, cluster_idx, c),
+                              (void *)src, len * sizeof(T));
+        }
+        snrt_dma_wait_all();
+    }
+    snrt_global_barrier();
+}
+
+/**
+ * @brief Gather a value from every cluster into the TCDM of every cluster.
+ *
+ * @param value Value of the calling cluster, as seen by its DMA core.
+ * @see prim_allgather(T *, const T *, uint32_t)
+ */
+template <typename T>
+static inline void prim_allgather(T *buf, T value) {
+    uint32_t cluster_idx = snrt_cluster_idx();
+    if (snrt_is_dm_core()) buf[cluster_idx] = value;
+    prim_allgather(buf, buf + cluster_idx, 1);
+}
@@ -0,0 +1,56 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "scan.h"
+#include "snrt.h"
+
+/**
+ * @brief Stream compaction: copy the elements of an array satisfying a
+ *        predicate, preserving their order.
+ *
+ * @details Every compute core counts the selected elements of a contiguous
+ *          slice of the array. The exclusive scan of the counts provides the
+ *          output offset of every slice, where the core then copies its
+ *          selected elements.
+ *
+ * @param y Output array, with space for all selected elements.
+ * @param pred Function, or function object, returning non-zero for the
+ *             elements to select.
+ * @param global If set, every cluster passes its own input array, and the
+ *               selected elements of all clusters are written to the same
+ *               output array, in cluster order. The output array must then
+ *               be accessible by all clusters, e.g. lie in L3.
+ * @return The number of selected elements, on all cores.
+ */
+template <typename T, typename Pred>
+static inline uint32_t prim_compact(const T *x, uint32_t n, T *y, Pred pred,
+                                    uint32_t global = 0) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t is_compute = snrt_is_compute_core();
+    uint32_t i0 = core_idx * n / ncores;
+    uint32_t i1 = (core_idx + 1) * n / ncores;
+
+    uint32_t count = 0;
+    if (is_compute)
+        for (uint32_t i = i0; i < i1; i++) count += pred(x[i]) ? 1 : 0;
+    uint32_t total;
+    uint32_t offset = prim_exscan(count, &total, global);
+
+    if (is_compute) {
+        T *out = y + offset;
+        for (uint32_t i = i0; i < i1; i++)
+            if (pred(x[i])) *out++ = x[i];
+    }
+    snrt_fpu_fence();
+    if (global)
+        snrt_global_barrier();
+    else
+        snrt_cluster_hw_barrier();
+    return total;
+}
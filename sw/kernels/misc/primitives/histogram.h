@@ -0,0 +1,74 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "allgather.h"
+#include "snrt.h"
+
+/**
+ * @brief Histogram of an array in TCDM.
+ *
+ * @details Every compute core counts a contiguous slice of the array in a
+ *          private histogram, avoiding atomics. The private histograms are
+ *          then summed, every core summing a contiguous range of bins.
+ *
+ * @param nbins Number of bins.
+ * @param hist Histogram of `nbins` counters, in TCDM.
+ * @param bin Function, or function object, mapping an element to its bin.
+ * @param global If set, every cluster passes its own array, and the
+ *               histogram covers the arrays of all clusters. The per-cluster
+ *               histograms are gathered in every cluster.
+ */
+template <typename T, typename Bin>
+static inline void prim_histogram(const T *x, uint32_t n, uint32_t nbins,
+                                  uint32_t *hist, Bin bin,
+                                  uint32_t global = 0) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t is_compute = snrt_is_compute_core();
+    uint32_t d0 = core_idx * nbins / ncores;
+    uint32_t d1 = (core_idx + 1) * nbins / ncores;
+    void *l1_next = snrt_l1_next_v2();
+    uint32_t *private_hist = (uint32_t *)snrt_l1_alloc_cluster_local(
+        ncores * nbins * sizeof(uint32_t), sizeof(uint32_t));
+
+    if (is_compute) {
+        uint32_t *own = private_hist + core_idx * nbins;
+        for (uint32_t d = 0; d < nbins; d++) own[d] = 0;
+        uint32_t i1 = (core_idx + 1) * n / ncores;
+        for (uint32_t i = core_idx * n / ncores; i < i1; i++) own[bin(x[i])]++;
+    }
+    snrt_cluster_hw_barrier();
+
+    if (is_compute) {
+        for (uint32_t d = d0; d < d1; d++) {
+            uint32_t count = 0;
+            for (uint32_t c = 0; c < ncores; c++)
+                count += private_hist[c * nbins + d];
+            hist[d] = count;
+        }
+    }
+    snrt_cluster_hw_barrier();
+
+    if (global && snrt_cluster_num() > 1) {
+        uint32_t nclusters = snrt_cluster_num();
+        uint32_t *buf = (uint32_t *)snrt_l1_alloc_cluster_local(
+            nclusters * nbins * sizeof(uint32_t), sizeof(uint32_t));
+        prim_allgather(buf, hist, nbins);
+        if (is_compute) {
+            for (uint32_t d = d0; d < d1; d++) {
+                uint32_t count = 0;
+                for (uint32_t c = 0; c < nclusters; c++)
+                    count += buf[c * nbins + d];
+                hist[d] = count;
+            }
+        }
+        snrt_cluster_hw_barrier();
+    }
+
+    snrt_l1_update_next_v2(l1_next);
+}
@@ -0,0 +1,34 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Parallel primitives: reductions, scans, histograms and stream compaction.
+//
+// The primitives operate hierarchically. Every compute core first processes
+// a contiguous slice of the input. Only the sequential sums and scans of
+// doubles (prim_sum_seq and prim_scan_seq) stream their slice through SSRs.
+// The histogram and the stream compaction evaluate arbitrary functors, and
+// index or store through integer registers, so their slices are processed
+// by scalar loops on the integer core. The per-core results are then
+// combined through TCDM in a tree of logarithmic depth. Finally, if
+// requested, the per-cluster results are exchanged between clusters through
+// DMA transfers to the TCDM of every cluster, and combined redundantly, in
+// the same order, by all clusters.
+//
+// All primitives are collective: they must be invoked with the same
+// arguments by all cores in the cluster, including the DMA core, or by all
+// cores in all clusters for the global variants. Scratch space is allocated
+// in TCDM and released on return. As the allocation sequence is the same in
+// all clusters, the scratch buffers lie at the same offset in every TCDM,
+// which the inter-cluster exchanges rely on.
+//
+// Sums are computed in a fixed order, thus results are deterministic, but
+// floating-point results differ from a sequential sum.
+
+#pragma once
+
+#include "allgather.h"
+#include "compact.h"
+#include "histogram.h"
+#include "reduce.h"
+#include "scan.h"
@@ -0,0 +1,230 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "allgather.h"
+#include "snrt.h"
+
+/**
+ * @brief Sum of an array, computed by the calling core.
+ */
+template <typename T>
+static inline T prim_sum_seq(const T *x, uint32_t n) {
+    T acc = 0;
+    for (uint32_t i = 0; i < n; i++) acc += x[i];
+    return acc;
+}
+
+/**
+ * @brief Sum of an array of doubles, computed by the calling core.
+ *
+ * @details SSR 0 streams the array, four accumulators hide the latency of
+ *          the FPU.
+ */
+static inline double prim_sum_seq(const double *x, uint32_t n) {
+    if (!n) return 0;
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, n, sizeof(double));
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, (void *)x);
+    snrt_ssr_enable();
+
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0;
+    if (n >= 4) {
+        asm volatile(
+            "frep.o %[n_frep], 4, 0, 0 \n"
+            "fadd.d %[acc0], ft0, %[acc0] \n"
+            "fadd.d %[acc1], ft0, %[acc1] \n"
+            "fadd.d %[acc2], ft0, %[acc2] \n"
+            "fadd.d %[acc3], ft0, %[acc3] \n"
+            : [ acc0 ] "+f"(acc0), [ acc1 ] "+f"(acc1), [ acc2 ] "+f"(acc2),
+              [ acc3 ] "+f"(acc3)
+            : [ n_frep ] "r"(n / 4 - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    }
+    if (n % 4) {
+        asm volatile(
+            "frep.o %[n_frep], 1, 0, 0 \n"
+            "fadd.d %[acc0], ft0, %[acc0] \n"
+            : [ acc0 ] "+f"(acc0)
+            : [ n_frep ] "r"(n % 4 - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    }
+    asm volatile(
+        "fadd.d %[acc0], %[acc0], %[acc1] \n"
+        "fadd.d %[acc2], %[acc2], %[acc3] \n"
+        "fadd.d %[acc0], %[acc0], %[acc2] \n"
+        : [ acc0 ] "+f"(acc0), [ acc2 ] "+f"(acc2)
+        : [ acc1 ] "f"(acc1), [ acc3 ] "f"(acc3)
+        : "ft0", "ft1", "ft2");
+
+    snrt_ssr_disable();
+    snrt_fpu_fence();
+    return acc0;
+}
+
+/**
+ * @brief Sum of a value over the compute cores of the cluster.
+ *
+ * @details The values are combined in a binary tree in TCDM, where at every
+ *          level every core whose index is a multiple of twice the stride
+ *          accumulates the value of its partner.
+ *
+ * @param value Value of the calling core, ignored on the DMA core.
+ * @return The sum, on all cores.
+ */
+template <typename T>
+static inline T prim_cluster_allreduce(T value) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    void *l1_next = snrt_l1_next_v2();
+    T *buf = (T *)snrt_l1_alloc_cluster_local(ncores * sizeof(T), sizeof(T));
+
+    if (snrt_is_compute_core()) buf[core_idx] = value;
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+
+    for (uint32_t stride = 1; stride < ncores; stride *= 2) {
+        if (core_idx % (2 * stride) == 0 && core_idx + stride < ncores)
+            buf[core_idx] += buf[core_idx + stride];
+        snrt_fpu_fence();
+        snrt_cluster_hw_barrier();
+    }
+
+    T result = buf[0];
+    snrt_cluster_hw_barrier();
+    snrt_l1_update_next_v2(l1_next);
+    return result;
+}
+
+/**
+ * @brief Sum of a value over the compute cores of the cluster, or of all
+ *        clusters.
+ *
+ * @param global If set, sum over all clusters. The per-cluster sums are
+ *               gathered in every cluster and summed in cluster order, with
+ *               the scalar loop, as the DMA core has no SSRs or FREP.
+ * @see prim_cluster_allreduce
+ */
+template <typename T>
+static inline T prim_allreduce(T value, uint32_t global = 0) {
+    T result = prim_cluster_allreduce(value);
+    if (!global || snrt_cluster_num() == 1) return result;
+
+    void *l1_next = snrt_l1_next_v2();
+    T *buf = (T *)snrt_l1_alloc_cluster_local(snrt_cluster_num() * sizeof(T),
+                                              sizeof(T));
+    prim_allgather(buf, result);
+    result = prim_sum_seq<T>(buf, snrt_cluster_num());
+    snrt_cluster_hw_barrier();
+    snrt_l1_update_next_v2(l1_next);
+    return result;
+}
+
+/**
+ * @brief Sum of an array in TCDM.
+ *
+ * @details Every compute core sums a contiguous slice of the array.
+ *
+ * @param global If set, every cluster passes its own array, and the sum
+ *               covers the arrays of all clusters.
+ * @return The sum, on all cores.
+ */
+template <typename T>
+static inline T prim_reduce(const T *x, uint32_t n, uint32_t global = 0) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    T partial = 0;
+    if (snrt_is_compute_core()) {
+        uint32_t i0 = core_idx * n / ncores;
+        uint32_t i1 = (core_idx + 1) * n / ncores;
+        partial = prim_sum_seq(x + i0, i1 - i0);
+    }
+    return prim_allreduce(partial, global);
+}
+
+/**
+ * @brief First index in `[0, n)` whose offset is not less than `value`, or
+ *        `n` if there is none.
+ */
+static inline uint32_t prim_lower_bound(const uint32_t *offsets, uint32_t n,
+                                        uint32_t value) {
+    uint32_t lo = 0, hi = n;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (offsets[mid] < value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Sum of every segment of an array in TCDM.
+ *
+ * @details The elements, rather than the segments, are divided evenly among
+ *          the compute cores, so that long segments do not unbalance the
+ *          work. A core writes the sums of the segments starting in its
+ *          slice, and records its contribution to the segment continuing
+ *          from the previous slice. Every segment continuing past the end of
+ *          a slice is then completed by the core it starts on, adding the
+ *          contributions of the following cores.
+ *
+ * @param offsets Offsets of the `nseg` segments, followed by the offset past
+ *                the end of the last segment, like the row pointers of a CSR
+ *                matrix. Segments can be empty.
+ * @param y Array of `nseg` sums.
+ */
+template <typename T>
+static inline void prim_segmented_reduce(const T *x, const uint32_t *offsets,
+                                         uint32_t nseg, T *y) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t is_compute = snrt_is_compute_core();
+    void *l1_next = snrt_l1_next_v2();
+    T *carry = (T *)snrt_l1_alloc_cluster_local(ncores * sizeof(T), sizeof(T));
+    uint32_t *carry_seg = (uint32_t *)snrt_l1_alloc_cluster_local(
+        ncores * sizeof(uint32_t), sizeof(uint32_t));
+
+    // Slice of the core, and segments starting in it
+    uint32_t base = offsets[0];
+    uint32_t n = offsets[nseg] - base;
+    uint32_t i0 = base + core_idx * n / ncores;
+    uint32_t i1 = base + (core_idx + 1) * n / ncores;
+    uint32_t s0 = prim_lower_bound(offsets, nseg, i0);
+    uint32_t s1 = core_idx == ncores - 1 ? nseg
+                                         : prim_lower_bound(offsets, nseg, i1);
+
+    if (is_compute) {
+        // Contribution to the segment continuing from the previous slice
+        carry_seg[core_idx] = UINT32_MAX;
+        if (s0 > 0 && offsets[s0] > i0) {
+            uint32_t end = offsets[s0] < i1 ? offsets[s0] : i1;
+            carry[core_idx] = prim_sum_seq(x + i0, end - i0);
+            carry_seg[core_idx] = s0 - 1;
+        }
+        for (uint32_t s = s0; s < s1; s++) {
+            uint32_t end = offsets[s + 1] < i1 ? offsets[s + 1] : i1;
+            y[s] = prim_sum_seq(x + offsets[s], end - offsets[s]);
+        }
+    }
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+
+    // Complete the last segment, if it continues past the slice
+    if (is_compute && s1 > s0 && offsets[s1] > i1) {
+        T sum = y[s1 - 1];
+        for (uint32_t c = core_idx + 1; c < ncores; c++) {
+            if (carry_seg[c] != s1 - 1) break;
+            sum += carry[c];
+        }
+        y[s1 - 1] = sum;
+    }
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+    snrt_l1_update_next_v2(l1_next);
+}
@@ -0,0 +1,181 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "allgather.h"
+#include "reduce.h"
+#include "snrt.h"
+
+/**
+ * @brief Prefix sums of an array, computed by the calling core.
+ *
+ * @param init Value added to all prefix sums.
+ * @param inclusive If set, the i-th prefix sum includes the i-th element.
+ * @note The input and output arrays may coincide.
+ */
+template <typename T>
+static inline void prim_scan_seq(const T *x, T *y, uint32_t n, T init,
+                                 uint32_t inclusive) {
+    T acc = init;
+    for (uint32_t i = 0; i < n; i++) {
+        T xi = x[i];
+        if (inclusive) acc += xi;
+        y[i] = acc;
+        if (!inclusive) acc += xi;
+    }
+}
+
+/**
+ * @brief Prefix sums of an array of doubles, computed by the calling core.
+ *
+ * @details SSR 0 streams the input and SSR 1 the output.
+ * @see prim_scan_seq(const T *, T *, uint32_t, T, uint32_t)
+ */
+static inline void prim_scan_seq(const double *x, double *y, uint32_t n,
+                                 double init, uint32_t inclusive) {
+    if (!n) return;
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, n, sizeof(double));
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, n, sizeof(double));
+    snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, (void *)x);
+    snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_1D, y);
+    snrt_ssr_enable();
+
+    double acc = init;
+    if (inclusive) {
+        asm volatile(
+            "frep.o %[n_frep], 2, 0, 0 \n"
+            "fadd.d %[acc], ft0, %[acc] \n"
+            "fmv.d ft1, %[acc] \n"
+            : [ acc ] "+f"(acc)
+            : [ n_frep ] "r"(n - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    } else {
+        asm volatile(
+            "frep.o %[n_frep], 2, 0, 0 \n"
+            "fmv.d ft1, %[acc] \n"
+            "fadd.d %[acc], ft0, %[acc] \n"
+            : [ acc ] "+f"(acc)
+            : [ n_frep ] "r"(n - 1)
+            : "ft0", "ft1", "ft2", "memory");
+    }
+
+    snrt_ssr_disable();
+    snrt_fpu_fence();
+}
+
+/**
+ * @brief Exclusive prefix sum of a value over the compute cores of the
+ *        cluster.
+ *
+ * @details Hillis-Steele scan in TCDM: at the level with stride `d`, every
+ *          core adds the partial sum of the core `d` positions before it,
+ *          alternating between two buffers.
+ *
+ * @param value Value of the calling core, ignored on the DMA core.
+ * @param total If not NULL, receives the sum of all values.
+ * @return The sum of the values of the preceding cores, zero on the DMA
+ *         core.
+ */
+template <typename T>
+static inline T prim_cluster_exscan(T value, T *total = NULL) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t is_compute = snrt_is_compute_core();
+    void *l1_next = snrt_l1_next_v2();
+    T *src = (T *)snrt_l1_alloc_cluster_local(2 * ncores * sizeof(T),
+                                              sizeof(T));
+    T *dst = src + ncores;
+
+    if (is_compute) src[core_idx] = value;
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+
+    for (uint32_t d = 1; d < ncores; d *= 2) {
+        if (is_compute) {
+            T sum = src[core_idx];
+            if (core_idx >= d) sum += src[core_idx - d];
+            dst[core_idx] = sum;
+        }
+        snrt_fpu_fence();
+        snrt_cluster_hw_barrier();
+        T *tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    T result = (is_compute && core_idx > 0) ? src[core_idx - 1] : 0;
+    if (total) *total = src[ncores - 1];
+    snrt_cluster_hw_barrier();
+    snrt_l1_update_next_v2(l1_next);
+    return result;
+}
+
+/**
+ * @brief Exclusive prefix sum of a value over the compute cores of the
+ *        cluster, or of all clusters.
+ *
+ * @param global If set, the values are ordered by cluster, then by core.
+ *               The per-cluster sums are gathered in every cluster.
+ * @see prim_cluster_exscan
+ */
+template <typename T>
+static inline T prim_exscan(T value, T *total = NULL, uint32_t global = 0) {
+    T cluster_total;
+    T result = prim_cluster_exscan(value, &cluster_total);
+    if (!global || snrt_cluster_num() == 1) {
+        if (total) *total = cluster_total;
+        return result;
+    }
+
+    uint32_t nclusters = snrt_cluster_num();
+    void *l1_next = snrt_l1_next_v2();
+    T *buf = (T *)snrt_l1_alloc_cluster_local(nclusters * sizeof(T),
+                                              sizeof(T));
+    prim_allgather(buf, cluster_total);
+    // Summed with the scalar loop, as the DMA core has no SSRs or FREP
+    T offset = prim_sum_seq<T>(buf, snrt_cluster_idx());
+    if (total)
+        *total = offset + prim_sum_seq<T>(buf + snrt_cluster_idx(),
+                                          nclusters - snrt_cluster_idx());
+    snrt_cluster_hw_barrier();
+    snrt_l1_update_next_v2(l1_next);
+    return offset + result;
+}
+
+/**
+ * @brief Prefix sums of an array in TCDM.
+ *
+ * @details Every compute core first sums a contiguous slice of the array.
+ *          The exclusive scan of the slice sums then provides the initial
+ *          value of the prefix sums of every slice.
+ *
+ * @param inclusive If set, the i-th prefix sum includes the i-th element.
+ * @param global If set, every cluster passes its own array, and the prefix
+ *               sums run over the concatenation of the arrays of all
+ *               clusters, in cluster order.
+ * @return The sum of all elements, on all cores.
+ * @note The input and output arrays may coincide.
+ */
+template <typename T>
+static inline T prim_scan(const T *x, T *y, uint32_t n, uint32_t inclusive,
+                          uint32_t global = 0) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t i0 = core_idx * n / ncores;
+    uint32_t i1 = (core_idx + 1) * n / ncores;
+
+    T partial = 0;
+    if (snrt_is_compute_core()) partial = prim_sum_seq(x + i0, i1 - i0);
+    T total;
+    T offset = prim_exscan(partial, &total, global);
+    if (snrt_is_compute_core())
+        prim_scan_seq(x + i0, y + i0, i1 - i0, offset, inclusive);
+    snrt_fpu_fence();
+    snrt_cluster_hw_barrier();
+    return total;
+}
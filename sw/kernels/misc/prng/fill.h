@@ -0,0 +1,198 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Bulk generation of uniform and normal variates into TCDM buffers, from
+// Philox streams.
+//
+// Every function is called by a single hart on its own generator. The
+// uniform variates lie in the open interval (0, 1), i.e. an integer output
+// x maps to (x + 0.5) / 2^32, so they can be safely passed to a logarithm.
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include "philox.h"
+#include "snrt.h"
+
+// Number of variates converted by every FREP loop of the COPIFT fill
+#define PRNG_BATCH 64
+
+#define PRNG_INV_2_32 (1.0 / 4294967296.0)
+#define PRNG_INV_2_23 (1.0f / 8388608.0f)
+
+// Initializes a generator on a stream unique to the calling hart
+static inline philox4x32_t prng_init_hart(uint64_t seed) {
+    return philox4x32_init(seed, snrt_global_core_idx());
+}
+
+static inline void prng_fill_u32(philox4x32_t *philox, uint32_t *dst,
+                                 uint32_t n) {
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) philox4x32_next(philox, dst + i);
+    if (i < n) {
+        uint32_t out[4];
+        philox4x32_next(philox, out);
+        for (uint32_t j = 0; i < n; i++, j++) dst[i] = out[j];
+    }
+}
+
+static inline void prng_fill_uniform_f64(philox4x32_t *philox, double *dst,
+                                         uint32_t n) {
+    for (uint32_t i = 0; i < n; i += 4) {
+        uint32_t out[4];
+        philox4x32_next(philox, out);
+        for (uint32_t j = 0; j < 4 && i + j < n; j++)
+            dst[i + j] = ((double)out[j] + 0.5) * PRNG_INV_2_32;
+    }
+}
+
+// Uses the upper 23 bits of every output, so that the variates, offset by
+// half a step, are represented exactly
+static inline void prng_fill_uniform_f32(philox4x32_t *philox, float *dst,
+                                         uint32_t n) {
+    for (uint32_t i = 0; i < n; i += 4) {
+        uint32_t out[4];
+        philox4x32_next(philox, out);
+        for (uint32_t j = 0; j < 4 && i + j < n; j++)
+            dst[i + j] = ((float)(out[j] >> 9) + 0.5f) * PRNG_INV_2_23;
+    }
+}
+
+/**
+ * @brief Fills a buffer with uniform doubles, overlapping the integer
+ *        generation with the conversion on the FPU.
+ *
+ * @details The integer core generates a batch of outputs, zero-extended to
+ *          64 bits, in a staging buffer, while an FREP loop converts the
+ *          previous batch with `fcvt.d.wu.copift`, streaming the staging
+ *          buffer in and `dst` out through SSRs. The first `n` rounded down
+ *          to a multiple of `PRNG_BATCH` elements are produced this way, and
+ *          the rest by `prng_fill_uniform_f64`. The variates equal those of
+ *          `prng_fill_uniform_f64` for a generator in the same state.
+ *
+ * @param staging Buffer of `2 * PRNG_BATCH` elements in TCDM, private to
+ *                the hart.
+ */
+static inline void prng_fill_uniform_f64_copift(philox4x32_t *philox,
+                                                double *dst, uint32_t n,
+                                                uint64_t *staging) {
+#if defined(SNRT_SUPPORTS_SSR) && defined(SNRT_SUPPORTS_FREP) && \
+    defined(SNRT_SUPPORTS_COPIFT)
+    uint32_t n_batches = n / PRNG_BATCH;
+    uint32_t *staging_words = (uint32_t *)staging;
+    double scale = PRNG_INV_2_32;
+    double offset = 0.5 * PRNG_INV_2_32;
+
+    // Only the lower words are written from here on
+    for (uint32_t i = 0; i < 2 * PRNG_BATCH; i++) staging[i] = 0;
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM0, PRNG_BATCH, sizeof(uint64_t));
+    snrt_ssr_loop_1d(SNRT_SSR_DM1, PRNG_BATCH, sizeof(double));
+
+    // Convert batch i - 1 while generating batch i
+    for (uint32_t i = 0; i <= n_batches; i++) {
+        if (i > 0) {
+            snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D,
+                          staging + ((i - 1) % 2) * PRNG_BATCH);
+            snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_1D,
+                           dst + (i - 1) * PRNG_BATCH);
+            snrt_ssr_enable();
+            asm volatile(
+                "frep.o %[n_frep], 8, 0, 0 \n"
+                "fcvt.d.wu.copift fa0, ft0 \n"
+                "fcvt.d.wu.copift fa1, ft0 \n"
+                "fcvt.d.wu.copift fa2, ft0 \n"
+                "fcvt.d.wu.copift fa3, ft0 \n"
+                "fmadd.d ft1, fa0, %[scale], %[offset] \n"
+                "fmadd.d ft1, fa1, %[scale], %[offset] \n"
+                "fmadd.d ft1, fa2, %[scale], %[offset] \n"
+                "fmadd.d ft1, fa3, %[scale], %[offset] \n"
+                :
+                : [ n_frep ] "r"(PRNG_BATCH / 4 - 1), [ scale ] "f"(scale),
+                  [ offset ] "f"(offset)
+                : "ft0", "ft1", "ft2", "fa0", "fa1", "fa2", "fa3", "memory");
+        }
+
+        if (i < n_batches) {
+            uint32_t *words = staging_words + (i % 2) * 2 * PRNG_BATCH;
+            for (uint32_t j = 0; j < PRNG_BATCH; j += 4) {
+                uint32_t out[4];
+                philox4x32_next(philox, out);
+                words[2 * j + 0] = out[0];
+                words[2 * j + 2] = out[1];
+                words[2 * j + 4] = out[2];
+                words[2 * j + 6] = out[3];
+            }
+        }
+
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+    }
+
+    uint32_t done = n_batches * PRNG_BATCH;
+    prng_fill_uniform_f64(philox, dst + done, n - done);
+#else
+    prng_fill_uniform_f64(philox, dst, n);
+#endif
+}
+
+// Box-Muller transform of an even number of uniform variates, in place
+static inline void prng_box_muller_f64(double *x, uint32_t n) {
+    for (uint32_t i = 0; i < n; i += 2) {
+        double r = sqrt(-2.0 * log(x[i]));
+        double theta = 2.0 * M_PI * x[i + 1];
+        x[i] = r * cos(theta);
+        x[i + 1] = r * sin(theta);
+    }
+}
+
+static inline void prng_box_muller_f32(float *x, uint32_t n) {
+    for (uint32_t i = 0; i < n; i += 2) {
+        float r = sqrtf(-2.0f * logf(x[i]));
+        float theta = 2.0f * (float)M_PI * x[i + 1];
+        x[i] = r * cosf(theta);
+        x[i + 1] = r * sinf(theta);
+    }
+}
+
+/**
+ * @brief Fills a buffer with standard normal doubles, with the Box-Muller
+ *        transform.
+ *
+ * @details The uniform variates are generated in `dst`, with the COPIFT
+ *          fill if `staging` is given, and transformed in place. For an odd
+ *          `n`, the last variate comes from an extra pair.
+ *
+ * @param staging Staging buffer of `prng_fill_uniform_f64_copift`, or NULL.
+ */
+static inline void prng_fill_normal_f64(philox4x32_t *philox, double *dst,
+                                        uint32_t n, uint64_t *staging) {
+    uint32_t n_even = n & ~1u;
+    if (staging)
+        prng_fill_uniform_f64_copift(philox, dst, n_even, staging);
+    else
+        prng_fill_uniform_f64(philox, dst, n_even);
+    prng_box_muller_f64(dst, n_even);
+    if (n_even < n) {
+        double pair[2];
+        prng_fill_uniform_f64(philox, pair, 2);
+        prng_box_muller_f64(pair, 2);
+        dst[n_even] = pair[0];
+    }
+}
+
+static inline void prng_fill_normal_f32(philox4x32_t *philox, float *dst,
+                                        uint32_t n) {
+    uint32_t n_even = n & ~1u;
+    prng_fill_uniform_f32(philox, dst, n_even);
+    prng_box_muller_f32(dst, n_even);
+    if (n_even < n) {
+        float pair[2];
+        prng_fill_uniform_f32(philox, pair, 2);
+        prng_box_muller_f32(pair, 2);
+        dst[n_even] = pair[0];
+    }
+}
@@ -0,0 +1,69 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Philox4x32-10 counter-based generator, from Salmon et al., "Parallel
+// random numbers: as easy as 1, 2, 3", SC'11.
+//
+// Every output block is a pure function of a 128-bit counter and a 64-bit
+// key, so any number of generators can draw from disjoint streams without
+// sharing state, and any element of a stream can be computed directly. We
+// use the key for the seed, the upper half of the counter for the stream,
+// e.g. the global index of a hart, and the lower half for the position in
+// the stream.
+
+#pragma once
+
+#include <stdint.h>
+
+#define PHILOX_M0 0xD2511F53
+#define PHILOX_M1 0xCD9E8D57
+#define PHILOX_W0 0x9E3779B9
+#define PHILOX_W1 0xBB67AE85
+#define PHILOX_ROUNDS 10
+
+typedef struct {
+    uint32_t ctr[4];
+    uint32_t key[2];
+} philox4x32_t;
+
+// Computes the output block of a counter under a key
+static inline void philox4x32_block(const uint32_t ctr[4],
+                                    const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int r = 0; r < PHILOX_ROUNDS; r++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t)p1;
+        c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t)p0;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// Initializes a generator at the start of stream `stream` of `seed`
+static inline philox4x32_t philox4x32_init(uint64_t seed, uint64_t stream) {
+    philox4x32_t philox = {
+        .ctr = {0, 0, (uint32_t)stream, (uint32_t)(stream >> 32)},
+        .key = {(uint32_t)seed, (uint32_t)(seed >> 32)}};
+    return philox;
+}
+
+// Moves a generator to the `block`-th block of its stream
+static inline void philox4x32_seek(philox4x32_t* philox, uint64_t block) {
+    philox->ctr[0] = (uint32_t)block;
+    philox->ctr[1] = (uint32_t)(block >> 32);
+}
+
+// Returns the next four outputs of a generator
+static inline void philox4x32_next(philox4x32_t* philox, uint32_t out[4]) {
+    philox4x32_block(philox->ctr, philox->key, out);
+    if (++philox->ctr[0] == 0) philox->ctr[1]++;
+}
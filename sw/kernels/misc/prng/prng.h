@@ -16,5 +16,6 @@ double rand_int_to_unit_double(uint32_t x) {
 }
 
 #include "lcg.h"
+#include "philox.h"
 #include "splitmix64.h"
 #include "xoshiro128p.h"
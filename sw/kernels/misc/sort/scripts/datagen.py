@@ -6,41 +6,101 @@
 # Author: Nico Canzani <ncanzani@ethz.ch>
 # Author: Luca Colagrande <colluca@iis.ee.ethz.ch>
 
-import random
 import numpy as np
 import sys
 
 import snitch.util.sim.data_utils as du
 
+np.random.seed(42)
+
 
 class SortDataGen(du.DataGen):
     # AXI splits bursts crossing 4KB address boundaries. To minimize
     # the occurrence of these splits the data should be aligned to 4KB
     BURST_ALIGNMENT = 4096
+    ALGORITHMS = ['bucket', 'radix', 'sample']
+    # Number of compute cores per cluster
+    NUM_CORES = 8
+    # Number of buckets of the bucket sort
+    N_BUCKETS = 8
+    # Maximum number of bins of a partitioning pass
+    MAX_BINS = 256
+
+    def golden_model(self, keys, values):
+        order = np.argsort(keys, kind='stable')
+        return keys[order], values[order]
 
-    def golden_model(self, x):
-        return np.sort(x)
+    def validate(self, algorithm, n, min, max, pairs, block, n_clusters, **kwargs):
+        assert algorithm in self.ALGORITHMS, f'algorithm must be one of {self.ALGORITHMS}'
+        assert np.iinfo(np.int32).min <= min <= max <= np.iinfo(np.int32).max, \
+            'min and max must be 32-bit integers, with min <= max'
+        if algorithm == 'bucket':
+            assert not pairs, 'The bucket sort does not support values'
+            assert (n % self.NUM_CORES) == 0, \
+                f'n must be an integer multiple of the number of cores ({self.NUM_CORES})'
+            # The keys, and a buffer of n keys per bucket
+            du.validate_tcdm_footprint(n * 4 * (1 + self.N_BUCKETS) + self.N_BUCKETS * 4)
+        else:
+            # Histograms, scan arrays and two input and staging blocks
+            elem_size = 8 if pairs else 4
+            du.validate_tcdm_footprint((self.NUM_CORES + 7 + n_clusters) * self.MAX_BINS * 4 +
+                                       self.NUM_CORES * 4 + 4 * block * elem_size)
 
     def emit_header(self, **kwargs):
         header = [super().emit_header()]
 
+        kwargs.setdefault('algorithm', 'bucket')
+        kwargs.setdefault('pairs', False)
+        kwargs.setdefault('block', 512)
+        kwargs.setdefault('n_clusters', 1)
+        self.validate(**kwargs)
         n = kwargs['n']
-        self.min = kwargs['min']
-        self.max = kwargs['max']
-        x = np.asarray([random.randrange(self.min, self.max + 1, 1) for i in range(n)])
-        g = self.golden_model(x)
+        pairs = kwargs['pairs']
+
+        keys = np.random.randint(kwargs['min'], kwargs['max'] + 1, n, dtype=np.int64)
+        keys = keys.astype(np.int32)
+        values = np.random.randint(0, 1 << 32, n, dtype=np.uint64).astype(np.uint32)
 
-        assert (n % 8) == 0, "n must be an integer multiple of the number of cores (8)"
+        keys_uid = 'keys'
+        values_uid = 'values'
+        keys_out_uid = 'keys_out'
+        values_out_uid = 'values_out'
+        keys_tmp_uid = 'keys_tmp'
+        values_tmp_uid = 'values_tmp'
 
-        header += [du.format_scalar_definition('const uint32_t', 'n', n)]
-        header += [du.format_scalar_definition('const int32_t', 'min', self.min)]
-        header += [du.format_scalar_definition('const int32_t', 'max', self.max)]
-        header += [du.format_array_definition('int32_t', 'x', x, alignment=self.BURST_ALIGNMENT,
+        args = {
+            'algorithm': f'SORT_{kwargs["algorithm"].upper()}',
+            'n': n,
+            'keys': keys_uid,
+            'values': values_uid if pairs else 'NULL',
+            'keys_out': keys_out_uid,
+            'values_out': values_out_uid if pairs else 'NULL',
+            'keys_tmp': keys_tmp_uid,
+            'values_tmp': values_tmp_uid if pairs else 'NULL',
+            'block': kwargs['block'],
+            'min': kwargs['min'],
+            'max': kwargs['max']
+        }
+
+        header += [du.format_array_declaration('extern int32_t', keys_uid, keys.shape,
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('extern uint32_t', values_uid, values.shape,
+                                               alignment=self.BURST_ALIGNMENT)]
+        for uid in [keys_out_uid, keys_tmp_uid]:
+            header += [du.format_array_declaration('int32_t', uid, [n],
+                                                   alignment=self.BURST_ALIGNMENT,
+                                                   section=kwargs['section'])]
+        for uid in [values_out_uid, values_tmp_uid]:
+            header += [du.format_array_declaration('uint32_t', uid, [n],
+                                                   alignment=self.BURST_ALIGNMENT,
+                                                   section=kwargs['section'])]
+        header += [du.format_struct_definition('sort_args_t', 'args', args)]
+        header += [du.format_array_definition('int32_t', keys_uid, keys,
+                                              alignment=self.BURST_ALIGNMENT,
+                                              section=kwargs['section'])]
+        header += [du.format_array_definition('uint32_t', values_uid, values,
+                                              alignment=self.BURST_ALIGNMENT,
                                               section=kwargs['section'])]
-        header += [du.format_array_declaration('int32_t', 'z', [n], alignment=self.BURST_ALIGNMENT,
-                                               section=kwargs['section'])]
-        result_def = du.format_array_definition('int32_t', 'g', g)
-        header += [du.format_ifdef_wrapper('BIST', result_def)]
         header = '\n\n'.join(header)
 
         return header
@@ -6,6 +6,7 @@
 # Author: Nico Canzani <ncanzani@ethz.ch>
 # Author: Luca Colagrande <colluca@iis.ee.ethz.ch>
 
+import numpy as np
 import sys
 from datagen import SortDataGen
 
@@ -14,17 +15,43 @@ from snitch.util.sim.verif_utils import Verifier
 
 class SortVerifier(Verifier):
 
-    OUTPUT_UIDS = ['z']
+    OUTPUT_UIDS = ['keys_out', 'values_out']
+
+    def __init__(self):
+        super().__init__()
+        self.func_args = {
+            'algorithm': 'I',
+            'n': 'I',
+            'keys': 'I',
+            'values': 'I',
+            'keys_out': 'I',
+            'values_out': 'I',
+            'keys_tmp': 'I',
+            'values_tmp': 'I',
+            'block': 'I',
+            'min': 'i',
+            'max': 'i'
+        }
+        self.func_args = self.get_input_from_symbol('args', self.func_args)
 
     def get_actual_results(self):
-        return self.get_output_from_symbol('z', 'int32_t')
+        results = [self.get_output_from_symbol('keys_out', 'int32_t')]
+        # Values are only sorted along with the keys if present
+        if self.func_args['values']:
+            results += [self.get_output_from_symbol('values_out', 'uint32_t')]
+        return np.concatenate(results, axis=None, dtype=np.int64)
 
     def get_expected_results(self):
-        x = self.get_input_from_symbol('x', 'int32_t')
-        return SortDataGen().golden_model(x)
+        keys = self.get_input_from_symbol('keys', 'int32_t')
+        values = self.get_input_from_symbol('values', 'uint32_t')
+        keys, values = SortDataGen().golden_model(keys, values)
+        results = [keys]
+        if self.func_args['values']:
+            results += [values]
+        return np.concatenate(results, axis=None, dtype=np.int64)
 
     def check_results(self, *args):
-        return super().check_results(*args, rtol=1e-10)
+        return super().check_results(*args, atol=0)
 
 
 if __name__ == "__main__":
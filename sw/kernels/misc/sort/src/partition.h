@@ -0,0 +1,448 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Stable partitioning of 32-bit keys, and optional 32-bit values, into bins.
+// This is the building block of the radix and sample sorts.
+//
+// A partitioning pass moves the elements of a range of a source array in L3
+// to the same range of a destination array in L3, grouped by bin, preserving
+// the relative order of the elements within every bin. The range can be
+// partitioned by all clusters together, every cluster processing a
+// contiguous chunk of it, or by a single cluster.
+//
+// The pass streams the chunk of a cluster through TCDM twice, in blocks, with
+// the loads of the next block overlapping the computation on the current one:
+//
+// 1. Every core counts the elements of its slice of every block in a private
+//    histogram, avoiding atomics. The histograms are then reduced to the
+//    histogram of the chunk.
+// 2. The clusters exchange their histograms through L3. An exclusive scan
+//    over the bins and clusters, parallelized across the cores, yields the
+//    destination offset of every bin of the chunk.
+// 3. Every block is partitioned in TCDM, each core writing its slice to
+//    private offsets within a staging buffer, where the elements are grouped
+//    by bin. The DMA core then writes every bin of the staging buffer to its
+//    destination with a single transfer, while the cores partition the next
+//    block.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "snrt.h"
+
+// Maximum number of bins of a partitioning pass
+#define SORT_MAX_BINS 256
+
+/**
+ * @struct sort_binning_t
+ * @brief Mapping of keys to bins.
+ *
+ * @var sort_binning_t::nbins
+ * Number of bins, at most `SORT_MAX_BINS`.
+ * @var sort_binning_t::shift
+ * If `splitters` is NULL, the bin of a key is its 8-bit digit starting at
+ * this bit position. The sign bit is flipped, to order negative keys first.
+ * @var sort_binning_t::splitters
+ * Ascending array of `nbins - 1` keys. The bin of a key is the number of
+ * splitters not greater than the key.
+ */
+typedef struct {
+    uint32_t nbins;
+    uint32_t shift;
+    const int32_t *splitters;
+} sort_binning_t;
+
+/**
+ * @struct sort_ctx_t
+ * @brief TCDM buffers of the partitioning passes.
+ *
+ * @var sort_ctx_t::block
+ * Number of elements per block.
+ * @var sort_ctx_t::hist
+ * Histograms of the compute cores, `SORT_MAX_BINS` entries per core.
+ * @var sort_ctx_t::partial
+ * Partial sums of the scans, one per compute core.
+ * @var sort_ctx_t::tot
+ * Bin sizes of the current block.
+ * @var sort_ctx_t::base
+ * Bin offsets of the current block.
+ * @var sort_ctx_t::ctot
+ * Bin sizes of the chunk of the cluster.
+ * @var sort_ctx_t::gtot
+ * Bin sizes of the range, as computed by the last pass.
+ * @var sort_ctx_t::gbase
+ * Bin offsets of the range, as computed by the last pass.
+ * @var sort_ctx_t::run
+ * Next destination index of every bin of the chunk.
+ * @var sort_ctx_t::all
+ * Bin sizes of the chunks of all clusters.
+ * @var sort_ctx_t::l1_blocks
+ * Start of the block buffers, which are the last allocation. TCDM past this
+ * address can be reused outside of the partitioning passes.
+ */
+typedef struct {
+    uint32_t block;
+    uint32_t *hist;
+    uint32_t *partial;
+    uint32_t *tot;
+    uint32_t *base;
+    uint32_t *ctot;
+    uint32_t *gtot;
+    uint32_t *gbase;
+    uint32_t *run;
+    uint32_t *all;
+    void *l1_blocks;
+    int32_t *keys[2];
+    uint32_t *values[2];
+    int32_t *stage_keys[2];
+    uint32_t *stage_values[2];
+} sort_ctx_t;
+
+// Histograms of the chunks of all clusters, exchanged through L3
+static uint32_t sort_hist_l3[SNRT_CLUSTER_NUM * SORT_MAX_BINS];
+
+/**
+ * @brief Allocate the buffers of the partitioning passes in TCDM.
+ *
+ * @param pairs Reserve space for values along with the keys.
+ */
+static inline void sort_ctx_init(sort_ctx_t *ctx, uint32_t block,
+                                 uint32_t pairs) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t bins_size = SORT_MAX_BINS * sizeof(uint32_t);
+
+    ctx->block = block;
+    ctx->hist = (uint32_t *)snrt_l1_alloc_cluster_local(ncores * bins_size,
+                                                        sizeof(uint32_t));
+    ctx->partial = (uint32_t *)snrt_l1_alloc_cluster_local(
+        ncores * sizeof(uint32_t), sizeof(uint32_t));
+    ctx->tot = (uint32_t *)snrt_l1_alloc_cluster_local(bins_size,
+                                                       sizeof(uint32_t));
+    ctx->base = (uint32_t *)snrt_l1_alloc_cluster_local(bins_size,
+                                                        sizeof(uint32_t));
+    ctx->ctot = (uint32_t *)snrt_l1_alloc_cluster_local(bins_size,
+                                                        sizeof(uint32_t));
+    ctx->gtot = (uint32_t *)snrt_l1_alloc_cluster_local(bins_size,
+                                                        sizeof(uint32_t));
+    ctx->gbase = (uint32_t *)snrt_l1_alloc_cluster_local(bins_size,
+                                                         sizeof(uint32_t));
+    ctx->run = (uint32_t *)snrt_l1_alloc_cluster_local(bins_size,
+                                                       sizeof(uint32_t));
+    ctx->all = (uint32_t *)snrt_l1_alloc_cluster_local(
+        snrt_cluster_num() * bins_size, sizeof(uint32_t));
+
+    ctx->l1_blocks = snrt_l1_next_v2();
+    for (uint32_t i = 0; i < 2; i++) {
+        ctx->keys[i] = (int32_t *)snrt_l1_alloc_cluster_local(
+            block * sizeof(int32_t), sizeof(int32_t));
+        ctx->stage_keys[i] = (int32_t *)snrt_l1_alloc_cluster_local(
+            block * sizeof(int32_t), sizeof(int32_t));
+        ctx->values[i] = NULL;
+        ctx->stage_values[i] = NULL;
+        if (pairs) {
+            ctx->values[i] = (uint32_t *)snrt_l1_alloc_cluster_local(
+                block * sizeof(uint32_t), sizeof(uint32_t));
+            ctx->stage_values[i] = (uint32_t *)snrt_l1_alloc_cluster_local(
+                block * sizeof(uint32_t), sizeof(uint32_t));
+        }
+    }
+}
+
+static inline uint32_t sort_min(uint32_t a, uint32_t b) {
+    return a < b ? a : b;
+}
+
+/**
+ * @brief Bin of a key.
+ */
+static inline uint32_t sort_bin(const sort_binning_t *binning, int32_t key) {
+    if (!binning->splitters)
+        return (((uint32_t)key ^ 0x80000000) >> binning->shift) &
+               (SORT_MAX_BINS - 1);
+    uint32_t lo = 0, hi = binning->nbins - 1;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (key < binning->splitters[mid])
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+/**
+ * @brief Add the bins of the keys of the current core's slice of a block to
+ *        the core's histogram.
+ */
+static inline void sort_count(sort_ctx_t *ctx, const sort_binning_t *binning,
+                              const int32_t *keys, uint32_t n) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t *hist = ctx->hist + core_idx * SORT_MAX_BINS;
+    uint32_t i1 = (core_idx + 1) * n / ncores;
+    for (uint32_t i = core_idx * n / ncores; i < i1; i++)
+        hist[sort_bin(binning, keys[i])]++;
+}
+
+/**
+ * @brief Stable partitioning of a block in TCDM, computed by all cores in
+ *        the cluster.
+ *
+ * @details Every core counts the bins of its slice of the block, then the
+ *          cores scan the histograms, each over a subset of the bins, to
+ *          derive the offset of every bin of every core. Finally, every core
+ *          copies its slice to the output, grouped by bin. The bin sizes and
+ *          offsets within the output are returned in `ctx->tot` and
+ *          `ctx->base`.
+ *
+ * @param values Values of the elements, or NULL if the elements are keys.
+ */
+static inline void sort_block(sort_ctx_t *ctx, const sort_binning_t *binning,
+                              const int32_t *keys, const uint32_t *values,
+                              uint32_t n, int32_t *out_keys,
+                              uint32_t *out_values) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t is_compute = snrt_is_compute_core();
+    uint32_t nbins = binning->nbins;
+    uint32_t d0 = core_idx * nbins / ncores;
+    uint32_t d1 = (core_idx + 1) * nbins / ncores;
+    uint32_t *hist = ctx->hist + core_idx * SORT_MAX_BINS;
+
+    // Histogram of the core's slice
+    if (is_compute) {
+        for (uint32_t d = 0; d < nbins; d++) hist[d] = 0;
+        sort_count(ctx, binning, keys, n);
+    }
+    snrt_cluster_hw_barrier();
+
+    // Bin sizes, and total size of the core's bins
+    if (is_compute) {
+        uint32_t sum = 0;
+        for (uint32_t d = d0; d < d1; d++) {
+            uint32_t tot = 0;
+            for (uint32_t c = 0; c < ncores; c++)
+                tot += ctx->hist[c * SORT_MAX_BINS + d];
+            ctx->tot[d] = tot;
+            sum += tot;
+        }
+        ctx->partial[core_idx] = sum;
+    }
+    snrt_cluster_hw_barrier();
+
+    // Turn the histograms into the offsets of the bins of every core
+    if (is_compute) {
+        uint32_t offset = 0;
+        for (uint32_t c = 0; c < core_idx; c++) offset += ctx->partial[c];
+        for (uint32_t d = d0; d < d1; d++) {
+            ctx->base[d] = offset;
+            for (uint32_t c = 0; c < ncores; c++) {
+                uint32_t count = ctx->hist[c * SORT_MAX_BINS + d];
+                ctx->hist[c * SORT_MAX_BINS + d] = offset;
+                offset += count;
+            }
+        }
+    }
+    snrt_cluster_hw_barrier();
+
+    // Copy the core's slice to its offsets
+    if (is_compute) {
+        uint32_t i1 = (core_idx + 1) * n / ncores;
+        for (uint32_t i = core_idx * n / ncores; i < i1; i++) {
+            uint32_t pos = hist[sort_bin(binning, keys[i])]++;
+            out_keys[pos] = keys[i];
+            if (values) out_values[pos] = values[i];
+        }
+    }
+    snrt_cluster_hw_barrier();
+}
+
+/**
+ * @brief Stable partitioning pass from a source to a destination array in
+ *        L3.
+ *
+ * @details Must be invoked by all cores in the participating clusters. On
+ *          return, `ctx->gtot` and `ctx->gbase` hold the size and offset of
+ *          every bin of the range.
+ *
+ * @param src_values Values of the elements, or NULL if the elements are
+ *                   keys.
+ * @param lo First index of the range.
+ * @param hi Index past the end of the range.
+ * @param global If set, the range is partitioned by all clusters, otherwise
+ *               by the calling cluster only.
+ * @return Zero if all elements fall into the same bin, in which case the
+ *         partitioning is the identity and the destination is not written.
+ */
+static inline uint32_t sort_pass(sort_ctx_t *ctx, const sort_binning_t *binning,
+                                 const int32_t *src_keys,
+                                 const uint32_t *src_values, int32_t *dst_keys,
+                                 uint32_t *dst_values, uint32_t lo, uint32_t hi,
+                                 uint32_t global) {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+    uint32_t is_compute = snrt_is_compute_core();
+    uint32_t is_dm = snrt_is_dm_core();
+    uint32_t nclusters = global ? snrt_cluster_num() : 1;
+    uint32_t cluster_idx = global ? snrt_cluster_idx() : 0;
+    uint32_t nbins = binning->nbins;
+    uint32_t d0 = core_idx * nbins / ncores;
+    uint32_t d1 = (core_idx + 1) * nbins / ncores;
+    uint32_t block = ctx->block;
+    snrt_dma_txid_t txid = 0;
+
+    // Chunk of the cluster
+    uint32_t c0 = lo + cluster_idx * (hi - lo) / nclusters;
+    uint32_t c1 = lo + (cluster_idx + 1) * (hi - lo) / nclusters;
+    uint32_t nblocks = (c1 - c0 + block - 1) / block;
+
+    // Histogram of the chunk
+    if (is_compute) {
+        uint32_t *hist = ctx->hist + core_idx * SORT_MAX_BINS;
+        for (uint32_t d = 0; d < nbins; d++) hist[d] = 0;
+    }
+    if (is_dm && nblocks)
+        txid = snrt_dma_start_1d(ctx->keys[0], (void *)(src_keys + c0),
+                                 sort_min(block, c1 - c0) * sizeof(int32_t));
+    for (uint32_t i = 0; i < nblocks; i++) {
+        uint32_t start = c0 + i * block;
+        if (is_dm) {
+            snrt_dma_wait(txid);
+            if (i + 1 < nblocks)
+                txid = snrt_dma_start_1d(
+                    ctx->keys[(i + 1) % 2], (void *)(src_keys + start + block),
+                    sort_min(block, c1 - start - block) * sizeof(int32_t));
+        }
+        snrt_cluster_hw_barrier();
+        if (is_compute)
+            sort_count(ctx, binning, ctx->keys[i % 2],
+                       sort_min(block, c1 - start));
+        snrt_cluster_hw_barrier();
+    }
+    if (is_compute) {
+        for (uint32_t d = d0; d < d1; d++) {
+            uint32_t tot = 0;
+            for (uint32_t c = 0; c < ncores; c++)
+                tot += ctx->hist[c * SORT_MAX_BINS + d];
+            ctx->ctot[d] = tot;
+        }
+    }
+    snrt_cluster_hw_barrier();
+
+    // Exchange the histograms of the clusters
+    if (global) {
+        if (is_dm) {
+            snrt_dma_start_1d(sort_hist_l3 + cluster_idx * SORT_MAX_BINS,
+                              ctx->ctot, nbins * sizeof(uint32_t));
+            snrt_dma_wait_all();
+        }
+        snrt_global_barrier();
+        if (is_dm) {
+            snrt_dma_start_1d(ctx->all, sort_hist_l3,
+                              nclusters * SORT_MAX_BINS * sizeof(uint32_t));
+            snrt_dma_wait_all();
+        }
+        snrt_cluster_hw_barrier();
+    }
+
+    // Bin sizes of the range, and offset of every bin of the chunk within
+    // its bin in the range
+    if (is_compute) {
+        uint32_t sum = 0;
+        for (uint32_t d = d0; d < d1; d++) {
+            uint32_t tot = ctx->ctot[d];
+            uint32_t before = 0;
+            if (global) {
+                tot = 0;
+                for (uint32_t c = 0; c < nclusters; c++) {
+                    if (c == cluster_idx) before = tot;
+                    tot += ctx->all[c * SORT_MAX_BINS + d];
+                }
+            }
+            ctx->gtot[d] = tot;
+            ctx->run[d] = before;
+            sum += tot;
+        }
+        ctx->partial[core_idx] = sum;
+    }
+    snrt_cluster_hw_barrier();
+
+    // Bin offsets of the range, and destination of every bin of the chunk
+    if (is_compute) {
+        uint32_t offset = lo;
+        for (uint32_t c = 0; c < core_idx; c++) offset += ctx->partial[c];
+        for (uint32_t d = d0; d < d1; d++) {
+            ctx->gbase[d] = offset;
+            ctx->run[d] += offset;
+            offset += ctx->gtot[d];
+        }
+    }
+    snrt_cluster_hw_barrier();
+
+    uint32_t moved = 1;
+    for (uint32_t d = 0; d < nbins; d++)
+        if (ctx->gtot[d] == hi - lo) moved = 0;
+
+    // Partition the blocks, and write every bin of the staging buffer to its
+    // destination. The writes of a block are issued after the load of the
+    // next block, so waiting for the latter also ensures that the staging
+    // buffer of the previous block can be overwritten.
+    if (moved) {
+        if (is_dm && nblocks) {
+            uint32_t len = sort_min(block, c1 - c0);
+            txid = snrt_dma_start_1d(ctx->keys[0], (void *)(src_keys + c0),
+                                     len * sizeof(int32_t));
+            if (src_values)
+                txid = snrt_dma_start_1d(ctx->values[0],
+                                         (void *)(src_values + c0),
+                                         len * sizeof(uint32_t));
+        }
+        for (uint32_t i = 0; i < nblocks; i++) {
+            uint32_t start = c0 + i * block;
+            if (is_dm) {
+                snrt_dma_wait(txid);
+                if (i + 1 < nblocks) {
+                    uint32_t next = start + block;
+                    uint32_t len = sort_min(block, c1 - next);
+                    txid = snrt_dma_start_1d(ctx->keys[(i + 1) % 2],
+                                             (void *)(src_keys + next),
+                                             len * sizeof(int32_t));
+                    if (src_values)
+                        txid = snrt_dma_start_1d(ctx->values[(i + 1) % 2],
+                                                 (void *)(src_values + next),
+                                                 len * sizeof(uint32_t));
+                }
+            }
+            snrt_cluster_hw_barrier();
+            sort_block(ctx, binning, ctx->keys[i % 2],
+                       src_values ? ctx->values[i % 2] : NULL,
+                       sort_min(block, c1 - start), ctx->stage_keys[i % 2],
+                       ctx->stage_values[i % 2]);
+            if (is_dm) {
+                for (uint32_t d = 0; d < nbins; d++) {
+                    uint32_t tot = ctx->tot[d];
+                    if (!tot) continue;
+                    uint32_t run = ctx->run[d];
+                    uint32_t base = ctx->base[d];
+                    snrt_dma_start_1d(dst_keys + run,
+                                      ctx->stage_keys[i % 2] + base,
+                                      tot * sizeof(int32_t));
+                    if (src_values)
+                        snrt_dma_start_1d(dst_values + run,
+                                          ctx->stage_values[i % 2] + base,
+                                          tot * sizeof(uint32_t));
+                    ctx->run[d] = run + tot;
+                }
+            }
+        }
+        if (is_dm) snrt_dma_wait_all();
+    }
+
+    if (global)
+        snrt_global_barrier();
+    else
+        snrt_cluster_hw_barrier();
+    return moved;
+}
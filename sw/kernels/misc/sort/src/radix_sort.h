@@ -0,0 +1,88 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Least-significant-digit radix sort of 32-bit keys, and optional 32-bit
+// values, in four stable partitioning passes over 8-bit digits.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "partition.h"
+
+/**
+ * @brief Radix sort of a range of an array in L3.
+ *
+ * @details The passes alternate between the output and the scratch arrays,
+ *          starting from the input. Passes where all keys share the same
+ *          digit are skipped, and the result is copied to the output if the
+ *          last pass did not write it. Must be invoked by all cores in the
+ *          participating clusters.
+ *
+ * @param values Values of the elements, or NULL to sort keys only. The value
+ *               arrays are ignored in the latter case.
+ * @param global If set, the range is sorted by all clusters, otherwise by the
+ *               calling cluster only.
+ */
+static inline void radix_sort(sort_ctx_t *ctx, const int32_t *keys,
+                              const uint32_t *values, int32_t *out_keys,
+                              uint32_t *out_values, int32_t *tmp_keys,
+                              uint32_t *tmp_values, uint32_t lo, uint32_t hi,
+                              uint32_t global) {
+    const int32_t *src_keys = keys;
+    const uint32_t *src_values = values;
+
+    for (uint32_t shift = 0; shift < 32; shift += 8) {
+        sort_binning_t binning = {SORT_MAX_BINS, shift, NULL};
+        uint32_t to_out = src_keys != out_keys;
+        int32_t *dst_keys = to_out ? out_keys : tmp_keys;
+        uint32_t *dst_values = NULL;
+        if (values) dst_values = to_out ? out_values : tmp_values;
+        if (sort_pass(ctx, &binning, src_keys, src_values, dst_keys,
+                      dst_values, lo, hi, global)) {
+            src_keys = dst_keys;
+            src_values = dst_values;
+        }
+    }
+
+    if (src_keys != out_keys) {
+        uint32_t nclusters = global ? snrt_cluster_num() : 1;
+        uint32_t cluster_idx = global ? snrt_cluster_idx() : 0;
+        uint32_t c0 = lo + cluster_idx * (hi - lo) / nclusters;
+        uint32_t c1 = lo + (cluster_idx + 1) * (hi - lo) / nclusters;
+        if (snrt_is_dm_core() && c1 > c0) {
+            snrt_dma_start_1d(out_keys + c0, (void *)(src_keys + c0),
+                              (c1 - c0) * sizeof(int32_t));
+            if (values)
+                snrt_dma_start_1d(out_values + c0, (void *)(src_values + c0),
+                                  (c1 - c0) * sizeof(uint32_t));
+            snrt_dma_wait_all();
+        }
+        if (global)
+            snrt_global_barrier();
+        else
+            snrt_cluster_hw_barrier();
+    }
+}
+
+/**
+ * @brief Radix sort of an array in TCDM, computed by all cores in the
+ *        cluster.
+ *
+ * @details The passes alternate between the array and the scratch array, so
+ *          that the result ends up in the array.
+ *
+ * @param values Values of the elements, or NULL to sort keys only.
+ */
+static inline void radix_sort_tcdm(sort_ctx_t *ctx, int32_t *keys,
+                                   uint32_t *values, uint32_t n,
+                                   int32_t *tmp_keys, uint32_t *tmp_values) {
+    for (uint32_t shift = 0; shift < 32; shift += 16) {
+        sort_binning_t lower = {SORT_MAX_BINS, shift, NULL};
+        sort_binning_t upper = {SORT_MAX_BINS, shift + 8, NULL};
+        sort_block(ctx, &lower, keys, values, n, tmp_keys, tmp_values);
+        sort_block(ctx, &upper, tmp_keys, values ? tmp_values : NULL, n, keys,
+                   values);
+    }
+}
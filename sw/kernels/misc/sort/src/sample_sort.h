@@ -0,0 +1,136 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Multi-cluster sample sort of 32-bit keys, and optional 32-bit values.
+//
+// The clusters agree on splitters, drawn from a regular sample of the keys,
+// which divide the keys into one bucket per cluster. A single partitioning
+// pass across all clusters moves every key to its bucket, after which every
+// cluster sorts its bucket independently. Compared to the radix sort, the
+// elements are exchanged between clusters only once, and buckets fitting in
+// TCDM are sorted there, with a single load and store.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "partition.h"
+#include "radix_sort.h"
+
+// Number of keys sampled by every cluster
+#define SORT_SAMPLES 16
+
+// Samples of all clusters, exchanged through L3
+static int32_t sort_samples_l3[SNRT_CLUSTER_NUM * SORT_SAMPLES];
+
+/**
+ * @brief Sample sort of an array in L3, computed by all clusters.
+ *
+ * @details The buckets are first moved to the scratch arrays. A bucket is
+ *          then sorted in TCDM if it fits in the TCDM past the block buffers
+ *          of the partitioning passes, and otherwise with a radix sort from
+ *          L3 to L3 by its cluster alone. The sort is stable, and the
+ *          buckets are only balanced if the keys are mostly distinct.
+ *
+ * @param values Values of the elements, or NULL to sort keys only. The value
+ *               arrays are ignored in the latter case.
+ */
+static inline void sample_sort(sort_ctx_t *ctx, const int32_t *keys,
+                               const uint32_t *values, uint32_t n,
+                               int32_t *out_keys, uint32_t *out_values,
+                               int32_t *tmp_keys, uint32_t *tmp_values) {
+    uint32_t nclusters = snrt_cluster_num();
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t nsamples = nclusters * SORT_SAMPLES;
+    void *l1_next = snrt_l1_next_v2();
+    int32_t *samples = (int32_t *)snrt_l1_alloc_cluster_local(
+        nsamples * sizeof(int32_t), sizeof(int32_t));
+
+    // Regular sample of the chunk of the cluster
+    if (snrt_is_dm_core()) {
+        uint32_t c0 = cluster_idx * n / nclusters;
+        uint32_t len = (cluster_idx + 1) * n / nclusters - c0;
+        for (uint32_t i = 0; i < SORT_SAMPLES; i++)
+            snrt_dma_start_1d(
+                sort_samples_l3 + cluster_idx * SORT_SAMPLES + i,
+                (void *)(keys + c0 + i * len / SORT_SAMPLES), sizeof(int32_t));
+        snrt_dma_wait_all();
+    }
+    snrt_global_barrier();
+
+    // Every cluster sorts all samples, and selects the same splitters
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(samples, sort_samples_l3,
+                          nsamples * sizeof(int32_t));
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+    if (snrt_cluster_core_idx() == 0) {
+        for (uint32_t i = 1; i < nsamples; i++) {
+            int32_t key = samples[i];
+            uint32_t j = i;
+            for (; j > 0 && samples[j - 1] > key; j--)
+                samples[j] = samples[j - 1];
+            samples[j] = key;
+        }
+        for (uint32_t i = 0; i + 1 < nclusters; i++)
+            samples[i] = samples[(i + 1) * SORT_SAMPLES];
+    }
+    snrt_cluster_hw_barrier();
+
+    // Move every key to the bucket of its cluster
+    sort_binning_t binning = {nclusters, 0, samples};
+    uint32_t moved = sort_pass(ctx, &binning, keys, values, tmp_keys,
+                               tmp_values, 0, n, 1);
+    const int32_t *src_keys = moved ? tmp_keys : keys;
+    const uint32_t *src_values = moved ? tmp_values : values;
+    uint32_t lo = ctx->gbase[cluster_idx];
+    uint32_t hi = lo + ctx->gtot[cluster_idx];
+    uint32_t len = hi - lo;
+
+    // Sort the bucket of the cluster
+    uint32_t elem_size = (values ? 2 : 1) * sizeof(int32_t);
+    uint32_t avail = snrt_l1_allocator_v2()->end - (uintptr_t)ctx->l1_blocks;
+    if (2 * len * elem_size <= avail) {
+        void *l1_pass = snrt_l1_next_v2();
+        snrt_l1_update_next_v2(ctx->l1_blocks);
+        int32_t *l1_keys = (int32_t *)snrt_l1_alloc_cluster_local(
+            len * sizeof(int32_t), sizeof(int32_t));
+        int32_t *l1_tmp_keys = (int32_t *)snrt_l1_alloc_cluster_local(
+            len * sizeof(int32_t), sizeof(int32_t));
+        uint32_t *l1_values = NULL, *l1_tmp_values = NULL;
+        if (values) {
+            l1_values = (uint32_t *)snrt_l1_alloc_cluster_local(
+                len * sizeof(uint32_t), sizeof(uint32_t));
+            l1_tmp_values = (uint32_t *)snrt_l1_alloc_cluster_local(
+                len * sizeof(uint32_t), sizeof(uint32_t));
+        }
+
+        if (snrt_is_dm_core() && len) {
+            snrt_dma_start_1d(l1_keys, (void *)(src_keys + lo),
+                              len * sizeof(int32_t));
+            if (values)
+                snrt_dma_start_1d(l1_values, (void *)(src_values + lo),
+                                  len * sizeof(uint32_t));
+            snrt_dma_wait_all();
+        }
+        snrt_cluster_hw_barrier();
+        radix_sort_tcdm(ctx, l1_keys, l1_values, len, l1_tmp_keys,
+                        l1_tmp_values);
+        if (snrt_is_dm_core() && len) {
+            snrt_dma_start_1d(out_keys + lo, l1_keys, len * sizeof(int32_t));
+            if (values)
+                snrt_dma_start_1d(out_values + lo, l1_values,
+                                  len * sizeof(uint32_t));
+            snrt_dma_wait_all();
+        }
+        snrt_l1_update_next_v2(l1_pass);
+    } else {
+        radix_sort(ctx, src_keys, src_values, out_keys, out_values, tmp_keys,
+                   tmp_values, lo, hi, 0);
+    }
+
+    snrt_global_barrier();
+    snrt_l1_update_next_v2(l1_next);
+}
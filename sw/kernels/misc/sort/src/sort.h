@@ -5,8 +5,51 @@
 // Author: Nico Canzani <ncanzani@ethz.ch>
 // Author: Luca Colagrande <colluca@iis.ee.ethz.ch>
 
+#pragma once
+
 #include "snrt.h"
 
+#include "primitives/primitives.h"
+#include "radix_sort.h"
+#include "sample_sort.h"
+
+// Number of buckets of the bucket sort, use multiple of 8
+#define N_BUCKETS 8
+
+typedef enum { SORT_BUCKET, SORT_RADIX, SORT_SAMPLE } sort_algorithm_t;
+
+/**
+ * @struct sort_args_t
+ * @brief Arguments of the sort of 32-bit keys, and optional 32-bit values.
+ *
+ * @var sort_args_t::algorithm
+ * The bucket sort is the single-cluster baseline, it does not support
+ * values, and requires `n` to be a multiple of the number of compute cores
+ * and the keys to lie within [`min`, `max`].
+ * @var sort_args_t::values
+ * Values of the elements, or NULL to sort keys only. The other value arrays
+ * are ignored in the latter case.
+ * @var sort_args_t::keys_tmp
+ * Scratch array of `n` keys, and `values_tmp` of `n` values, used by the
+ * radix and sample sorts.
+ * @var sort_args_t::block
+ * Number of elements per block streamed through TCDM by the radix and sample
+ * sorts.
+ */
+typedef struct {
+    sort_algorithm_t algorithm;
+    uint32_t n;
+    int32_t *keys;
+    uint32_t *values;
+    int32_t *keys_out;
+    uint32_t *values_out;
+    int32_t *keys_tmp;
+    uint32_t *values_tmp;
+    uint32_t block;
+    int32_t min;
+    int32_t max;
+} sort_args_t;
+
 void swap(int32_t* a, int32_t* b) {
     int32_t temp = *a;
     *a = *b;
@@ -36,16 +79,6 @@ void quicksort(int32_t* low, int32_t* high) {
     }
 }
 
-void prefixSum(const int* a, int* b, size_t n) {
-    // Initialize the first element of the prefix sum array to 0
-    b[0] = 0;
-
-    // Loop through the array and compute prefix sums
-    for (size_t i = 1; i < n; ++i) {
-        b[i] = b[i - 1] + a[i - 1];
-    }
-}
-
 void bucketSort(int32_t* x, uint32_t n, uint32_t numBuckets, int32_t maximum,
                 int32_t minimum) {
     snrt_mcycle();
@@ -102,19 +135,79 @@ void bucketSort(int32_t* x, uint32_t n, uint32_t numBuckets, int32_t maximum,
     snrt_mcycle();
 
     // Make a cumulative sum array, to know the offset per bucket
-    int idx_offset[numBuckets];
-    prefixSum(bucket_count, idx_offset, numBuckets);
+    int32_t* idx_offset = snrt_l1_alloc_cluster_local<int32_t>(numBuckets);
+    prim_scan(bucket_count, idx_offset, numBuckets, 0);
 
     // Merge buckets and store into x
     if (snrt_is_compute_core()) {
         for (uint8_t next_bucket = 0 + core_idx; next_bucket < numBuckets;
              next_bucket += snrt_cluster_compute_core_num()) {
             uint32_t i_x;
-            for (uint32_t j = 0; j < bucket_count[core_idx]; j++) {
-                i_x = j + idx_offset[core_idx];
-                x[i_x] = buckets[core_idx][j];
+            for (uint32_t j = 0; j < bucket_count[next_bucket]; j++) {
+                i_x = j + idx_offset[next_bucket];
+                x[i_x] = buckets[next_bucket][j];
             }
         }
     }
     snrt_mcycle();
 }
+
+/**
+ * @brief Bucket sort of the whole array on the first cluster.
+ */
+static inline void sort_bucket(sort_args_t *args) {
+    void *l1_next = snrt_l1_next_v2();
+    int32_t *x = snrt_l1_alloc_cluster_local<int32_t>(args->n);
+
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(x, args->keys, args->n * sizeof(int32_t));
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+
+    bucketSort(x, args->n, N_BUCKETS, args->max, args->min);
+    snrt_cluster_hw_barrier();
+
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(args->keys_out, x, args->n * sizeof(int32_t));
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+
+    snrt_l1_update_next_v2(l1_next);
+}
+
+/**
+ * @brief Sort an array in L3 with the selected algorithm.
+ *
+ * @details Must be invoked by all cores in all clusters. The sort is
+ *          enclosed in a dedicated region on every participating core. The
+ *          TCDM allocations are released on return.
+ */
+static inline void sort(sort_args_t *args) {
+    if (args->algorithm == SORT_BUCKET) {
+        if (snrt_cluster_idx() == 0) {
+            snrt_mcycle();
+            sort_bucket(args);
+            snrt_mcycle();
+        }
+        return;
+    }
+
+    void *l1_next = snrt_l1_next_v2();
+    sort_ctx_t ctx;
+    sort_ctx_init(&ctx, args->block, args->values != NULL);
+    snrt_global_barrier();
+
+    snrt_mcycle();
+    if (args->algorithm == SORT_RADIX)
+        radix_sort(&ctx, args->keys, args->values, args->keys_out,
+                   args->values_out, args->keys_tmp, args->values_tmp, 0,
+                   args->n, 1);
+    else
+        sample_sort(&ctx, args->keys, args->values, args->n, args->keys_out,
+                    args->values_out, args->keys_tmp, args->values_tmp);
+    snrt_mcycle();
+
+    snrt_l1_update_next_v2(l1_next);
+}
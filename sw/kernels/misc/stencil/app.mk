@@ -0,0 +1,18 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+APP              := stencil
+$(APP)_BUILD_DIR ?= $(SN_ROOT)/sw/kernels/misc/$(APP)/build
+SRC_DIR          := $(SN_ROOT)/sw/kernels/misc/$(APP)/src
+SRCS             := $(SRC_DIR)/main.c
+$(APP)_INCDIRS   := $(SN_ROOT)/sw/kernels/misc/box3d1r/src
+$(APP)_INCDIRS   += $(SN_ROOT)/sw/kernels/misc/j3d27pt/src
+$(APP)_INCDIRS   += $(SN_ROOT)/sw/kernels/misc
+$(APP)_DATAGEN_ARGS := --hw-cfg $(SN_CFG)
+
+include $(SN_ROOT)/sw/kernels/datagen.mk
+include $(SN_ROOT)/sw/kernels/common.mk
+
+# The datagen validates the data against the number of clusters
+$(DATA_H): $(SN_CFG)
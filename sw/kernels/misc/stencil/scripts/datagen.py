@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import json5
+import numpy as np
+import pathlib
+import sys
+
+import snitch.util.sim.data_utils as du
+
+np.random.seed(42)
+
+
+class StencilDataGen(du.DataGen):
+
+    # AXI splits bursts crossing 4KB address boundaries. To minimize
+    # the occurrence of these splits the data should be aligned to 4KB
+    BURST_ALIGNMENT = 4096
+    KERNELS = ['BOX3D1R', 'J3D27PT']
+    # Maximum offset addressable by the 16-bit indices of the SSR kernels
+    MAX_OFFSET = 1 << 16
+
+    def parser(self):
+        parser = super().parser()
+        parser.add_argument(
+            '--hw-cfg',
+            type=pathlib.Path,
+            help='Hardware configuration file, from which the number of clusters is read')
+        return parser
+
+    def parse_args(self):
+        self.args = super().parse_args()
+        return self.args
+
+    def num_clusters(self):
+        """Number of clusters of the hardware configuration, if provided."""
+        hw_cfg = getattr(self, 'args', None) and self.args.hw_cfg
+        if not hw_cfg:
+            return 1
+        with hw_cfg.open() as f:
+            return json5.loads(f.read()).get('nr_clusters', 1)
+
+    @staticmethod
+    def radius(kernel, param):
+        return param if kernel == 'BOX3D1R' else 1
+
+    def golden_model(self, kernel, param, steps, c, a):
+        """Apply the stencil `steps` times, with fixed boundary conditions."""
+        r = self.radius(kernel, param)
+        nz, ny, nx = a.shape
+        c = c.reshape(2 * r + 1, 2 * r + 1, 2 * r + 1)
+        scale = 1 / param if kernel == 'J3D27PT' else 1
+        for _ in range(steps):
+            acc = np.zeros((nz - 2 * r, ny - 2 * r, nx - 2 * r))
+            for dz in range(2 * r + 1):
+                for dy in range(2 * r + 1):
+                    for dx in range(2 * r + 1):
+                        acc += c[dz, dy, dx] * a[dz:nz - 2 * r + dz,
+                                                 dy:ny - 2 * r + dy,
+                                                 dx:nx - 2 * r + dx]
+            a = a.copy()
+            a[r:nz - r, r:ny - r, r:nx - r] = scale * acc
+        return a
+
+    def validate(self, kernel, param, nx, ny, nz, steps, tsteps, resident, tile_z,
+                 n_clusters, **kwargs):
+        assert kernel in self.KERNELS, f'kernel must be one of {self.KERNELS}'
+        r = self.radius(kernel, param)
+        assert steps > 0 and tsteps > 0, 'steps and tsteps must be positive'
+        assert min(nx, ny, nz) > 2 * r, 'The grid has no interior points'
+        # The SSR kernels compute two points in x and y per iteration
+        assert (nx - 2 * r) % 2 == 0 and (ny - 2 * r) % 2 == 0, \
+            'nx - 2r and ny - 2r must be even'
+        assert (2 * r + 1) * (nx * ny + nx + 1) < self.MAX_OFFSET, \
+            'The neighbourhood of a point must be addressable by 16-bit offsets'
+        h = tsteps * r
+        plane = nx * ny * 8
+        if resident:
+            assert nz // n_clusters >= h, \
+                'Every subdomain must hold at least tsteps * r planes'
+            max_planes = -(-nz // n_clusters) + 2 * h
+            du.validate_tcdm_footprint(2 * max_planes * plane)
+        else:
+            assert tile_z > 0, 'tile_z must be positive'
+            du.validate_tcdm_footprint(4 * (tile_z + 2 * h) * plane)
+
+    def emit_header(self, **kwargs):
+        header = [super().emit_header()]
+
+        # The resident subdomains depend on the number of clusters the kernel
+        # runs on, which is taken from the hardware configuration
+        kwargs.setdefault('n_clusters', self.num_clusters())
+        self.validate(**kwargs)
+        kernel, param = kwargs['kernel'], kwargs['param']
+        nx, ny, nz = kwargs['nx'], kwargs['ny'], kwargs['nz']
+        r = self.radius(kernel, param)
+
+        # Normalize the coefficients to keep the values bounded over time
+        c = np.random.uniform(0, 2, (2 * r + 1) ** 3) / (2 * r + 1) ** 3
+        if kernel == 'J3D27PT':
+            c *= param
+        a = np.random.uniform(-1, 1, (nz, ny, nx))
+
+        c_uid = 'c'
+        a_uid = 'A'
+        a__uid = 'A_'
+        tmp_uid = 'tmp'
+
+        args = {
+            'type': f'STENCIL_{kernel}',
+            'param': param,
+            'r': r,
+            'nx': nx,
+            'ny': ny,
+            'nz': nz,
+            'steps': kwargs['steps'],
+            'tsteps': kwargs['tsteps'],
+            'resident': kwargs['resident'],
+            'tile_z': kwargs['tile_z'],
+            'c': c_uid,
+            'A': a_uid,
+            'A_': a__uid,
+            'tmp': tmp_uid
+        }
+
+        header += [du.format_array_declaration('extern double', c_uid, c.shape,
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('extern double', a_uid, (a.size,),
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('double', a__uid, (a.size,),
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_declaration('double', tmp_uid, (a.size,),
+                                               alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_struct_definition('stencil_args_t', 'args', args)]
+        header += [du.format_array_definition('double', c_uid, c,
+                                              alignment=self.BURST_ALIGNMENT)]
+        header += [du.format_array_definition('double', a_uid, a.flatten(),
+                                              alignment=self.BURST_ALIGNMENT)]
+        header = '\n\n'.join(header)
+
+        return header
+
+
+if __name__ == '__main__':
+    sys.exit(StencilDataGen().main())
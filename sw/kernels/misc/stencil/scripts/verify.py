@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import sys
+
+from datagen import StencilDataGen
+
+from snitch.util.sim.verif_utils import Verifier
+
+
+class StencilVerifier(Verifier):
+
+    OUTPUT_UIDS = ['A_']
+
+    def __init__(self):
+        super().__init__()
+        self.func_args = {
+            'type': 'I',
+            'param': 'I',
+            'r': 'I',
+            'nx': 'I',
+            'ny': 'I',
+            'nz': 'I',
+            'steps': 'I',
+            'tsteps': 'I',
+            'resident': 'I',
+            'tile_z': 'I',
+            'c': 'I',
+            'A': 'I',
+            'A_': 'I',
+            'tmp': 'I'
+        }
+        self.func_args = self.get_input_from_symbol('args', self.func_args)
+
+    def get_actual_results(self):
+        return self.get_output_from_symbol(self.OUTPUT_UIDS[0], 'double')
+
+    def get_expected_results(self):
+        kernel = StencilDataGen.KERNELS[self.func_args['type']]
+        nx, ny, nz = self.func_args['nx'], self.func_args['ny'], self.func_args['nz']
+        c = self.get_input_from_symbol('c', 'double')
+        a = self.get_input_from_symbol('A', 'double').reshape(nz, ny, nx)
+        return StencilDataGen().golden_model(kernel, self.func_args['param'],
+                                             self.func_args['steps'], c, a).flatten()
+
+    def check_results(self, *args):
+        return super().check_results(*args, atol=1e-10)
+
+
+if __name__ == "__main__":
+    sys.exit(StencilVerifier().main())
@@ -0,0 +1,22 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#include "stencil.h"
+
+// Both micro-kernel headers select their implementation through the IMPL
+// macro and define FUNC_PTR accordingly
+#include "box3d1r.h"
+#undef FUNC_PTR
+#include "j3d27pt.h"
+
+#include "data.h"
+
+int main() {
+    stencil_kernel_t kernel =
+        args.type == STENCIL_J3D27PT ? j3d27pt : box3d1r;
+    stencil(&args, kernel);
+    return 0;
+}
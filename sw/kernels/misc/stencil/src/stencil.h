@@ -0,0 +1,421 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+#include "snrt.h"
+
+/**
+ * @brief Signature of the 3D stencil micro-kernels, e.g. `box3d1r` and
+ *        `j3d27pt`.
+ *
+ * A micro-kernel computes the points of `A_` at distance at least `r` from
+ * every face of the `nz * ny * nx` grid `A`, `r` being its radius, and leaves
+ * the remaining points of `A_` untouched. The first argument is the radius of
+ * `box3d1r` and the normalization factor of `j3d27pt`.
+ */
+typedef void (*stencil_kernel_t)(int, int, int, int, double *, double *,
+                                 double *);
+
+typedef enum { STENCIL_BOX3D1R, STENCIL_J3D27PT } stencil_type_t;
+
+/**
+ * @struct stencil_args_t
+ * @brief Arguments of an iterated 3D stencil.
+ *
+ * The stencil is applied `steps` times to the `nz * ny * nx` grid `A`, with
+ * fixed boundary conditions: the points within distance `r` from a face of
+ * the grid retain their initial values.
+ *
+ * @var stencil_args_t::type
+ * Micro-kernel used to apply the stencil.
+ * @var stencil_args_t::param
+ * First argument of the micro-kernel.
+ * @var stencil_args_t::r
+ * Radius of the stencil.
+ * @var stencil_args_t::tsteps
+ * Number of time steps applied to every subdomain or tile in TCDM, before
+ * exchanging halos or writing it back (temporal blocking).
+ * @var stencil_args_t::resident
+ * If set, every cluster keeps its subdomain in TCDM for all time steps.
+ * Otherwise, subdomains are streamed from L3 in tiles of `tile_z` planes.
+ * @var stencil_args_t::c
+ * The `(2r + 1)^3` coefficients of the stencil.
+ * @var stencil_args_t::A_
+ * Result grid.
+ * @var stencil_args_t::tmp
+ * Scratch grid in L3, used by the streaming mode when `steps > tsteps`.
+ */
+typedef struct {
+    stencil_type_t type;
+    uint32_t param;
+    uint32_t r;
+    uint32_t nx;
+    uint32_t ny;
+    uint32_t nz;
+    uint32_t steps;
+    uint32_t tsteps;
+    uint32_t resident;
+    uint32_t tile_z;
+    double *c;
+    double *A;
+    double *A_;
+    double *tmp;
+} stencil_args_t;
+
+/**
+ * @brief Range of z-planes of a subdomain or tile.
+ *
+ * @var stencil_range_t::z0
+ * First plane owned by the subdomain or tile.
+ * @var stencil_range_t::z1
+ * End of the owned planes.
+ * @var stencil_range_t::lo
+ * First plane held in TCDM, including the halo.
+ * @var stencil_range_t::hi
+ * End of the planes held in TCDM, including the halo.
+ */
+typedef struct {
+    uint32_t z0;
+    uint32_t z1;
+    uint32_t lo;
+    uint32_t hi;
+} stencil_range_t;
+
+/**
+ * @brief Planes `[z0, z1)` extended by a halo of `h` planes on either side,
+ *        clipped to the grid.
+ */
+static inline stencil_range_t stencil_range(uint32_t z0, uint32_t z1,
+                                            uint32_t h, uint32_t nz) {
+    stencil_range_t range;
+    range.z0 = z0;
+    range.z1 = z1;
+    range.lo = z0 > h ? z0 - h : 0;
+    range.hi = z1 + h < nz ? z1 + h : nz;
+    return range;
+}
+
+/**
+ * @brief Subdomain of a cluster, with a halo of `h` planes.
+ *
+ * @details The grid is decomposed into slabs of consecutive z-planes, which
+ *          are contiguous in memory.
+ */
+static inline stencil_range_t stencil_subdomain(uint32_t nz, uint32_t h,
+                                                uint32_t cluster) {
+    uint32_t nclusters = snrt_cluster_num();
+    return stencil_range(cluster * nz / nclusters,
+                         (cluster + 1) * nz / nclusters, h, nz);
+}
+
+/**
+ * @brief Apply the `s`-th time step (counting from 1) since the planes
+ *        `[range.lo, range.hi)` were last valid, from `src` to `dst`.
+ *
+ * @details After `s` steps, only the planes at distance at least `s * r`
+ *          from a halo boundary are valid, so the computed range shrinks
+ *          by `r` planes per step on every side which does not coincide
+ *          with a face of the grid. The computed planes are distributed
+ *          among the compute cores, each of which invokes the micro-kernel
+ *          on the sub-grid made of its planes and their neighbourhood.
+ *
+ * @param src Pointer to plane `range.lo` in the source buffer.
+ * @param dst Pointer to plane `range.lo` in the destination buffer.
+ */
+static inline void stencil_step(stencil_args_t *args, stencil_kernel_t kernel,
+                                double *c, stencil_range_t range, uint32_t s,
+                                double *src, double *dst) {
+    uint32_t r = args->r;
+    uint32_t plane = args->nx * args->ny;
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t core_idx = snrt_cluster_core_idx();
+
+    uint32_t a = range.lo == 0 ? r : range.lo + s * r;
+    uint32_t b = range.hi == args->nz ? args->nz - r : range.hi - s * r;
+    if (b <= a) return;
+
+    uint32_t p0 = a + core_idx * (b - a) / ncores;
+    uint32_t p1 = a + (core_idx + 1) * (b - a) / ncores;
+    if (p1 <= p0) return;
+
+    uint32_t offset = (p0 - r - range.lo) * plane;
+    kernel(args->param, args->nx, args->ny, p1 - p0 + 2 * r, c, src + offset,
+           dst + offset);
+}
+
+/**
+ * @brief Load planes `[range.lo, range.hi)` of `src` to both TCDM buffers.
+ *
+ * @details The micro-kernels only write the interior of the destination
+ *          buffer, so both buffers must hold the faces of the grid. The
+ *          second copy is made from TCDM, not to double the traffic to L3.
+ */
+static inline void stencil_load(stencil_args_t *args, stencil_range_t range,
+                                double *src, double *buf0, double *buf1) {
+    size_t size = (range.hi - range.lo) * args->nx * args->ny * sizeof(double);
+    snrt_dma_start_1d(buf0, src + range.lo * args->nx * args->ny, size);
+    snrt_dma_wait_all();
+    snrt_dma_start_1d(buf1, buf0, size);
+    snrt_dma_wait_all();
+}
+
+/**
+ * @brief Store the owned planes `[range.z0, range.z1)` of a TCDM buffer,
+ *        holding planes from `range.lo` on, to `dst`.
+ */
+static inline void stencil_store(stencil_args_t *args, stencil_range_t range,
+                                 double *buf, double *dst) {
+    uint32_t plane = args->nx * args->ny;
+    snrt_dma_start_1d(dst + range.z0 * plane,
+                      buf + (range.z0 - range.lo) * plane,
+                      (range.z1 - range.z0) * plane * sizeof(double));
+    snrt_dma_wait_all();
+}
+
+/**
+ * @brief Send the halos of the subdomain of the current cluster to the
+ *        TCDM of its neighbours.
+ *
+ * @details Every cluster holds its subdomain at the same TCDM offset, namely
+ *          `h` planes past `buf`, so the halo planes of a neighbour are
+ *          addressed relative to its own subdomain.
+ *
+ * @param buf Pointer to the start of the buffer, where plane `z0 - h` of
+ *            the subdomain would reside.
+ */
+static inline void stencil_exchange_halos(stencil_args_t *args, uint32_t h,
+                                          double *buf) {
+    uint32_t plane = args->nx * args->ny;
+    uint32_t cluster = snrt_cluster_idx();
+    stencil_range_t self = stencil_subdomain(args->nz, h, cluster);
+
+    // Lower planes to the upper halo of the previous cluster
+    if (cluster > 0) {
+        stencil_range_t prev = stencil_subdomain(args->nz, h, cluster - 1);
+        double *remote =
+            (double *)snrt_remote_l1_ptr(buf, cluster, cluster - 1);
+        snrt_dma_start_1d(remote + (self.z0 - prev.z0 + h) * plane,
+                          buf + h * plane, h * plane * sizeof(double));
+    }
+    // Upper planes to the lower halo of the next cluster
+    if (cluster < snrt_cluster_num() - 1) {
+        double *remote =
+            (double *)snrt_remote_l1_ptr(buf, cluster, cluster + 1);
+        snrt_dma_start_1d(remote,
+                          buf + (self.z1 - self.z0) * plane,
+                          h * plane * sizeof(double));
+    }
+    snrt_dma_wait_all();
+}
+
+/**
+ * @brief Apply the stencil with every subdomain resident in TCDM.
+ *
+ * @details Every cluster loads its subdomain with a halo of
+ *          `h = tsteps * r` planes, which suffices to compute `tsteps`
+ *          steps without communication. The halos are then refreshed with
+ *          the updated planes of the neighbouring clusters, which are
+ *          written directly to their TCDM by DMA. Clusters synchronize
+ *          twice every `tsteps` steps, rather than every step.
+ */
+static inline void stencil_resident(stencil_args_t *args,
+                                    stencil_kernel_t kernel, double *c) {
+    uint32_t h = args->tsteps * args->r;
+    uint32_t plane = args->nx * args->ny;
+    uint32_t nclusters = snrt_cluster_num();
+    uint32_t max_planes = (args->nz + nclusters - 1) / nclusters + 2 * h;
+    stencil_range_t range = stencil_subdomain(args->nz, h, snrt_cluster_idx());
+
+    // All clusters allocate the buffers at the same offset
+    double *buf[2];
+    for (uint32_t i = 0; i < 2; i++)
+        buf[i] = (double *)snrt_l1_alloc_cluster_local(
+            max_planes * plane * sizeof(double), sizeof(double));
+    // Location of plane `range.lo` in the buffers
+    uint32_t offset = (range.lo + h - range.z0) * plane;
+
+    if (snrt_is_dm_core())
+        stencil_load(args, range, args->A, buf[0] + offset, buf[1] + offset);
+    snrt_cluster_hw_barrier();
+
+    uint32_t cur = 0;
+    for (uint32_t t = 0; t < args->steps; t += args->tsteps) {
+        uint32_t nsteps = args->steps - t;
+        if (nsteps > args->tsteps) nsteps = args->tsteps;
+
+        for (uint32_t s = 1; s <= nsteps; s++) {
+            if (snrt_is_compute_core())
+                stencil_step(args, kernel, c, range, s, buf[cur] + offset,
+                             buf[cur ^ 1] + offset);
+            cur ^= 1;
+            snrt_cluster_hw_barrier();
+        }
+
+        // The neighbours must have completed their steps before their halos
+        // are overwritten, and the halos must be updated before the next
+        // steps
+        if (t + nsteps < args->steps) {
+            snrt_global_barrier();
+            if (snrt_is_dm_core()) stencil_exchange_halos(args, h, buf[cur]);
+            snrt_global_barrier();
+        }
+    }
+
+    if (snrt_is_dm_core())
+        stencil_store(args, range, buf[cur] + offset, args->A_);
+    snrt_cluster_hw_barrier();
+}
+
+/**
+ * @brief The `tile`-th tile of a subdomain, with a halo of `h` planes.
+ */
+static inline stencil_range_t stencil_tile(stencil_args_t *args,
+                                           stencil_range_t slab,
+                                           uint32_t tile, uint32_t h) {
+    uint32_t z0 = slab.z0 + tile * args->tile_z;
+    uint32_t z1 = z0 + args->tile_z < slab.z1 ? z0 + args->tile_z : slab.z1;
+    return stencil_range(z0, z1, h, args->nz);
+}
+
+/**
+ * @brief DMA transfers of the `phase`-th phase of the streaming pipeline.
+ *
+ * @details While tile `tile` is computed, the result of the previous tile is
+ *          stored (phase 0), and the next tile is loaded (phase 1) and
+ *          duplicated (phase 2) to the buffers released by the former.
+ */
+static inline void stencil_stream_dma(stencil_args_t *args, uint32_t phase,
+                                      stencil_range_t slab, uint32_t h,
+                                      uint32_t tile, uint32_t ntiles,
+                                      uint32_t nsteps, double *src,
+                                      double *dst, double *buf[2][2]) {
+    uint32_t plane = args->nx * args->ny;
+    double **set = buf[(tile + 1) % 2];
+
+    if (phase == 0 && tile > 0) {
+        stencil_range_t prev = stencil_tile(args, slab, tile - 1, h);
+        stencil_store(args, prev, set[nsteps % 2], dst);
+    } else if (phase > 0 && tile + 1 < ntiles) {
+        stencil_range_t next = stencil_tile(args, slab, tile + 1, h);
+        size_t size = (next.hi - next.lo) * plane * sizeof(double);
+        if (phase == 1)
+            snrt_dma_start_1d(set[0], src + next.lo * plane, size);
+        else
+            snrt_dma_start_1d(set[1], set[0], size);
+        snrt_dma_wait_all();
+    }
+}
+
+/**
+ * @brief Apply the stencil streaming every subdomain from L3.
+ *
+ * @details Every cluster partitions its subdomain into tiles of `tile_z`
+ *          planes, which are loaded with a halo of `h = tsteps * r` planes
+ *          and advanced by `tsteps` steps before being written back, so that
+ *          the grid only crosses the L3 interface once every `tsteps` steps.
+ *          The halo planes are recomputed by the tiles sharing them, so
+ *          that tiles and subdomains are independent and clusters only
+ *          synchronize once every `tsteps` steps.
+ *
+ *          Tiles are double-buffered: the DMA core stores the previous and
+ *          prefetches the next tile while the compute cores advance the
+ *          current one, spreading its transfers over the time steps.
+ */
+static inline void stencil_stream(stencil_args_t *args,
+                                  stencil_kernel_t kernel, double *c) {
+    uint32_t h = args->tsteps * args->r;
+    uint32_t plane = args->nx * args->ny;
+    stencil_range_t slab = stencil_subdomain(args->nz, 0, snrt_cluster_idx());
+    uint32_t ntiles = (slab.z1 - slab.z0 + args->tile_z - 1) / args->tile_z;
+
+    double *buf[2][2];
+    for (uint32_t i = 0; i < 2; i++)
+        for (uint32_t j = 0; j < 2; j++)
+            buf[i][j] = (double *)snrt_l1_alloc_cluster_local(
+                (args->tile_z + 2 * h) * plane * sizeof(double),
+                sizeof(double));
+
+    uint32_t nsweeps = (args->steps + args->tsteps - 1) / args->tsteps;
+    double *src = args->A;
+    for (uint32_t sweep = 0; sweep < nsweeps; sweep++) {
+        uint32_t nsteps = args->steps - sweep * args->tsteps;
+        if (nsteps > args->tsteps) nsteps = args->tsteps;
+        // Alternate between the scratch and the result grid, such that the
+        // last sweep writes to the latter
+        double *dst = (nsweeps - 1 - sweep) % 2 ? args->tmp : args->A_;
+
+        if (snrt_is_dm_core() && ntiles > 0)
+            stencil_load(args, stencil_tile(args, slab, 0, h), src, buf[0][0],
+                         buf[0][1]);
+        snrt_cluster_hw_barrier();
+
+        for (uint32_t tile = 0; tile < ntiles; tile++) {
+            stencil_range_t range = stencil_tile(args, slab, tile, h);
+            double **set = buf[tile % 2];
+
+            for (uint32_t s = 1; s <= nsteps; s++) {
+                if (snrt_is_compute_core()) {
+                    stencil_step(args, kernel, c, range, s, set[(s - 1) % 2],
+                                 set[s % 2]);
+                } else {
+                    // Issue phase s - 1 in step s, and the remaining phases
+                    // in the last step. There are only three phases, so
+                    // nothing is left to issue in the later steps.
+                    uint32_t last = s == nsteps ? 2 : s - 1;
+                    if (last > 2) last = 2;
+                    for (uint32_t phase = s - 1; phase <= last; phase++)
+                        stencil_stream_dma(args, phase, slab, h, tile,
+                                           ntiles, nsteps, src, dst, buf);
+                }
+                snrt_cluster_hw_barrier();
+            }
+        }
+
+        if (snrt_is_dm_core() && ntiles > 0)
+            stencil_stream_dma(args, 0, slab, h, ntiles, ntiles, nsteps, src,
+                               dst, buf);
+
+        // The next sweep reads the planes written by the neighbours
+        snrt_global_barrier();
+        src = dst;
+    }
+}
+
+/**
+ * @brief Apply an iterated 3D stencil to a grid in L3, on all clusters.
+ *
+ * @details The grid is decomposed into one slab of z-planes per cluster.
+ *          Depending on `args->resident`, the slabs are either kept in TCDM,
+ *          exchanging halos between neighbouring clusters by DMA, or
+ *          streamed from L3 in tiles (see @ref stencil_resident and
+ *          @ref stencil_stream). In both cases `args->tsteps` steps are
+ *          applied to the data in TCDM at a time. The TCDM allocations are
+ *          released on return.
+ */
+static inline void stencil(stencil_args_t *args, stencil_kernel_t kernel) {
+    void *l1_next = snrt_l1_next_v2();
+    uint32_t npoints = (2 * args->r + 1) * (2 * args->r + 1) *
+                       (2 * args->r + 1);
+
+    double *c = (double *)snrt_l1_alloc_cluster_local(
+        npoints * sizeof(double), sizeof(double));
+    if (snrt_is_dm_core()) {
+        snrt_dma_start_1d(c, args->c, npoints * sizeof(double));
+        snrt_dma_wait_all();
+    }
+    snrt_cluster_hw_barrier();
+
+    snrt_mcycle();
+    if (args->resident)
+        stencil_resident(args, kernel, c);
+    else
+        stencil_stream(args, kernel, c);
+    snrt_mcycle();
+
+    snrt_l1_update_next_v2(l1_next);
+    snrt_global_barrier();
+}
@@ -0,0 +1,10 @@
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+APP              := vmath
+SRCS             := $(SN_ROOT)/sw/kernels/misc/$(APP)/main.c
+$(APP)_INCDIRS   := $(SN_ROOT)/sw/kernels/misc
+$(APP)_BUILD_DIR ?= $(SN_ROOT)/sw/kernels/misc/$(APP)/build
+
+include $(SN_ROOT)/sw/kernels/common.mk
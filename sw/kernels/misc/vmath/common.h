@@ -0,0 +1,47 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <stdint.h>
+
+// Number of elements processed per SSR/FREP loop by the array functions with
+// a vectorized fast path. Their scratch buffers hold twice as many elements
+// and are allocated on the stack, which resides in TCDM.
+#define VMATH_CHUNK 64
+
+// Bit-level view of a double, whose upper word holds the sign, the exponent
+// and the upper 20 bits of the mantissa
+typedef union {
+    double f64;
+    uint64_t u64;
+    uint32_t u32[2];
+} vmath_bits_t;
+
+typedef union {
+    float f32;
+    uint32_t u32;
+} vmath_bits32_t;
+
+/**
+ * @brief Applies an element function to an array, in the array precision.
+ */
+template <double (*F)(double)>
+static inline void vmath_map(const double *x, double *y, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) y[i] = F(x[i]);
+}
+
+template <float (*F)(float)>
+static inline void vmath_map(const float *x, float *y, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) y[i] = F(x[i]);
+}
+
+/**
+ * @brief Applies a single-precision element function to a half-precision
+ *        array.
+ */
+template <float (*F)(float)>
+static inline void vmath_map(const __fp16 *x, __fp16 *y, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) y[i] = (__fp16)F((float)x[i]);
+}
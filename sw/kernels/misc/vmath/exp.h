@@ -0,0 +1,297 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Exponential, following the table-driven algorithm of glibc's `exp` and
+// `expf`, also used in `sw/kernels/misc/exp`. The argument is reduced as
+// x = (k/N) ln2 + r, with |r| <= ln2/(2N), and exp(x) = 2^(k/N) * exp(r),
+// where 2^(k/N) is assembled from a table and exp(r) approximated by a
+// polynomial. In double precision, the result is assembled as
+// s + s * (exp(r) - 1), with s = 2^(k/N), to round the sum only once.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+#include "snrt.h"
+
+#define VMATH_EXP_TABLE_BITS 5
+#define VMATH_EXP_N (1 << VMATH_EXP_TABLE_BITS)
+
+// Double-precision inputs are clamped to this range, within which the
+// result and the scale factor 2^(k/N) are normal numbers. This also maps
+// NaN to exp(VMATH_EXP_MIN).
+#define VMATH_EXP_MIN -708.0
+#define VMATH_EXP_MAX 708.0
+
+// Single-precision inputs are clamped to this range, outside of which the
+// result rounds to zero or overflows. This also maps NaN and -inf to zero.
+#define VMATH_EXPF_MIN -104.0f
+#define VMATH_EXPF_MAX 89.0f
+
+#define VMATH_EXP_SHIFT 0x1.8p+52
+#define VMATH_EXP_INV_LN2_N (0x1.71547652b82fep+0 * VMATH_EXP_N)
+// ln2/N split in two, the first part with enough trailing zeros for its
+// product with k to be exact
+#define VMATH_EXP_LN2HI_N 0x1.62e42fefa0000p-6
+#define VMATH_EXP_LN2LO_N 0x1.cf79abc9e3b3ap-45
+
+// Taylor coefficients of exp(r), from r^2 to r^6
+#define VMATH_EXP_C2 (1.0 / 2)
+#define VMATH_EXP_C3 (1.0 / 6)
+#define VMATH_EXP_C4 (1.0 / 24)
+#define VMATH_EXP_C5 (1.0 / 120)
+#define VMATH_EXP_C6 (1.0 / 720)
+
+// Bit patterns of 2^(i/N) - (i << 52) / N for i in [0, N), so that k can
+// simply be added to the exponent field
+__thread uint64_t vmath_exp_table[VMATH_EXP_N] = {
+    0x3ff0000000000000, 0x3fefd9b0d3158574, 0x3fefb5586cf9890f,
+    0x3fef9301d0125b51, 0x3fef72b83c7d517b, 0x3fef54873168b9aa,
+    0x3fef387a6e756238, 0x3fef1e9df51fdee1, 0x3fef06fe0a31b715,
+    0x3feef1a7373aa9cb, 0x3feedea64c123422, 0x3feece086061892d,
+    0x3feebfdad5362a27, 0x3feeb42b569d4f82, 0x3feeab07dd485429,
+    0x3feea47eb03a5585, 0x3feea09e667f3bcd, 0x3fee9f75e8ec5f74,
+    0x3feea11473eb0187, 0x3feea589994cce13, 0x3feeace5422aa0db,
+    0x3feeb737b0cdc5e5, 0x3feec49182a3f090, 0x3feed503b23e255d,
+    0x3feee89f995ad3ad, 0x3feeff76f2fb5e47, 0x3fef199bdd85529c,
+    0x3fef3720dcef9069, 0x3fef5818dcfba487, 0x3fef7c97337b9b5f,
+    0x3fefa4afa2a490da, 0x3fefd0765b6e4540,
+};
+
+/**
+ * @brief Replaces k, in the lower word of a double as left by the addition of
+ *        `VMATH_EXP_SHIFT`, with the bits of 2^(k/N).
+ * @details Only the upper word is affected by the exponent update. Operates
+ *          on words, so that no FP instruction is issued.
+ */
+static inline void vmath_exp_scale(uint32_t *w) {
+    uint32_t ki = w[0];
+    uint64_t t = vmath_exp_table[ki % VMATH_EXP_N];
+    w[0] = (uint32_t)t;
+    w[1] = (uint32_t)(t >> 32) + (ki << (52 - 32 - VMATH_EXP_TABLE_BITS));
+}
+
+static inline double vmath_exp(double x) {
+    if (!(x > VMATH_EXP_MIN)) x = VMATH_EXP_MIN;
+    if (x > VMATH_EXP_MAX) x = VMATH_EXP_MAX;
+
+    // x*N/ln2 = k + r*N/ln2, with k rounded to the nearest integer by the
+    // addition of the shift, which leaves k in the low bits of the mantissa
+    vmath_bits_t kd;
+    kd.f64 = x * VMATH_EXP_INV_LN2_N + VMATH_EXP_SHIFT;
+    double k = kd.f64 - VMATH_EXP_SHIFT;
+    double r = x - k * VMATH_EXP_LN2HI_N;
+    r = r - k * VMATH_EXP_LN2LO_N;
+
+    double p = VMATH_EXP_C6 * r + VMATH_EXP_C5;
+    p = p * r + VMATH_EXP_C4;
+    p = p * r + VMATH_EXP_C3;
+    p = p * r + VMATH_EXP_C2;
+    p = p * r + 1.0;
+    p = p * r;
+    vmath_exp_scale(kd.u32);
+    return p * kd.f64 + kd.f64;
+}
+
+/**
+ * @brief Single-precision exponential, returned before the final rounding.
+ * @details The argument is reduced in units of ln2/N and exp(r) is
+ *          approximated by a cubic polynomial, accurate to the precision of
+ *          a float. The result is only valid for single-precision inputs.
+ */
+static inline double vmath_expf_core(double x) {
+    const double inv_ln2_n = VMATH_EXP_INV_LN2_N;
+    const double c0 = 0x1.c6af84b912394p-5 / VMATH_EXP_N / VMATH_EXP_N /
+                      VMATH_EXP_N;
+    const double c1 = 0x1.ebfce50fac4f3p-3 / VMATH_EXP_N / VMATH_EXP_N;
+    const double c2 = 0x1.62e42ff0c52d6p-1 / VMATH_EXP_N;
+
+    double z = inv_ln2_n * x;
+    vmath_bits_t kd;
+    kd.f64 = z + VMATH_EXP_SHIFT;
+    double r = z - (kd.f64 - VMATH_EXP_SHIFT);
+
+    // 2^(r/N) ~= C0*r^3 + C1*r^2 + C2*r + 1
+    double y = (c0 * r + c1) * (r * r) + (c2 * r + 1.0);
+    vmath_exp_scale(kd.u32);
+    return y * kd.f64;
+}
+
+static inline float vmath_expf(float x) {
+    if (!(x > VMATH_EXPF_MIN)) x = VMATH_EXPF_MIN;
+    if (x > VMATH_EXPF_MAX) x = VMATH_EXPF_MAX;
+    return (float)vmath_expf_core((double)x);
+}
+
+/**
+ * @brief Exponential of an array of doubles in TCDM, optionally returning
+ *        the sum of the results.
+ *
+ * @details The FPU and the integer core split the work. For every chunk of
+ *          `VMATH_CHUNK` elements, an FREP loop reduces the arguments,
+ *          streaming k out to a scratch buffer and exp(r) - 1 out to `y`.
+ *          The integer core then replaces every k with its scale factor
+ *          s = 2^(k/N) while the FPU reduces the next chunk, and a second
+ *          FREP loop combines the two streams. Remaining elements, and all
+ *          elements if the FREP sequencer cannot hold the reduction loop,
+ *          are computed with `vmath_exp`. If `sum` is set, the results are
+ *          also accumulated by the combining FREP loop.
+ *
+ *          Must be called by a single hart, `x` and `y` may alias.
+ *
+ * @return The sum of the results if `sum` is set, zero otherwise.
+ */
+static inline double vmath_vexp_common(const double *x, double *y,
+                                       uint32_t n, uint32_t sum) {
+    uint32_t done = 0;
+    double acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+    // The body of the reduction loop must fit in the FREP sequencer
+#if defined(SNRT_SUPPORTS_SSR) && defined(SNRT_SUPPORTS_FREP) && \
+    SNRT_NUM_SEQUENCER_INSNS >= 26
+    uint32_t n_chunks = n / VMATH_CHUNK;
+    uint32_t k[2][2 * VMATH_CHUNK];
+
+    const double lo = VMATH_EXP_MIN, hi = VMATH_EXP_MAX;
+    const double inv_ln2_n = VMATH_EXP_INV_LN2_N, shift = VMATH_EXP_SHIFT;
+    const double ln2hi = VMATH_EXP_LN2HI_N, ln2lo = VMATH_EXP_LN2LO_N;
+    const double c2 = VMATH_EXP_C2, c3 = VMATH_EXP_C3, c4 = VMATH_EXP_C4;
+    const double c5 = VMATH_EXP_C5, c6 = VMATH_EXP_C6, one = 1.0;
+
+    snrt_ssr_loop_1d(SNRT_SSR_DM_ALL, VMATH_CHUNK, sizeof(double));
+
+    // Reduce chunk c while assembling the scale factors of chunk c - 1
+    for (uint32_t c = 0; c <= n_chunks; c++) {
+        if (c < n_chunks) {
+            snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D,
+                          (void *)(x + c * VMATH_CHUNK));
+            snrt_ssr_write(SNRT_SSR_DM1, SNRT_SSR_1D, k[c % 2]);
+            snrt_ssr_write(SNRT_SSR_DM2, SNRT_SSR_1D, y + c * VMATH_CHUNK);
+            snrt_ssr_enable();
+            // Two elements per iteration, interleaved to hide the latency
+            // of the FPU
+            asm volatile(
+                "frep.o %[n_frep], 26, 0, 0 \n"
+                "fmax.d fa0, ft0, %[lo] \n"
+                "fmax.d fa1, ft0, %[lo] \n"
+                "fmin.d fa0, fa0, %[hi] \n"
+                "fmin.d fa1, fa1, %[hi] \n"
+                "fmadd.d fa2, fa0, %[inv_ln2_n], %[shift] \n"
+                "fmadd.d fa3, fa1, %[inv_ln2_n], %[shift] \n"
+                "fsgnj.d ft1, fa2, fa2 \n"
+                "fsgnj.d ft1, fa3, fa3 \n"
+                "fsub.d fa2, fa2, %[shift] \n"
+                "fsub.d fa3, fa3, %[shift] \n"
+                "fnmsub.d fa0, fa2, %[ln2hi], fa0 \n"
+                "fnmsub.d fa1, fa3, %[ln2hi], fa1 \n"
+                "fnmsub.d fa0, fa2, %[ln2lo], fa0 \n"
+                "fnmsub.d fa1, fa3, %[ln2lo], fa1 \n"
+                "fmadd.d fa2, fa0, %[c6], %[c5] \n"
+                "fmadd.d fa3, fa1, %[c6], %[c5] \n"
+                "fmadd.d fa2, fa2, fa0, %[c4] \n"
+                "fmadd.d fa3, fa3, fa1, %[c4] \n"
+                "fmadd.d fa2, fa2, fa0, %[c3] \n"
+                "fmadd.d fa3, fa3, fa1, %[c3] \n"
+                "fmadd.d fa2, fa2, fa0, %[c2] \n"
+                "fmadd.d fa3, fa3, fa1, %[c2] \n"
+                "fmadd.d fa2, fa2, fa0, %[one] \n"
+                "fmadd.d fa3, fa3, fa1, %[one] \n"
+                "fmul.d ft2, fa2, fa0 \n"
+                "fmul.d ft2, fa3, fa1 \n"
+                :
+                : [ n_frep ] "r"(VMATH_CHUNK / 2 - 1), [ lo ] "f"(lo),
+                  [ hi ] "f"(hi), [ inv_ln2_n ] "f"(inv_ln2_n),
+                  [ shift ] "f"(shift), [ ln2hi ] "f"(ln2hi),
+                  [ ln2lo ] "f"(ln2lo), [ c2 ] "f"(c2), [ c3 ] "f"(c3),
+                  [ c4 ] "f"(c4), [ c5 ] "f"(c5), [ c6 ] "f"(c6),
+                  [ one ] "f"(one)
+                : "ft0", "ft1", "ft2", "fa0", "fa1", "fa2", "fa3", "memory");
+        }
+
+        if (c > 0) {
+            uint32_t *kc = k[(c - 1) % 2];
+            for (uint32_t i = 0; i < VMATH_CHUNK; i++)
+                vmath_exp_scale(kc + 2 * i);
+        }
+
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+
+        if (c > 0) {
+            double *yc = y + (c - 1) * VMATH_CHUNK;
+            snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D, yc);
+            snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, k[(c - 1) % 2]);
+            snrt_ssr_write(SNRT_SSR_DM2, SNRT_SSR_1D, yc);
+            snrt_ssr_enable();
+            if (sum)
+                asm volatile(
+                    "frep.o %[n_frep], 16, 0, 0 \n"
+                    "fsgnj.d fa0, ft1, ft1 \n"
+                    "fsgnj.d fa1, ft1, ft1 \n"
+                    "fsgnj.d fa2, ft1, ft1 \n"
+                    "fsgnj.d fa3, ft1, ft1 \n"
+                    "fmadd.d fa0, ft0, fa0, fa0 \n"
+                    "fmadd.d fa1, ft0, fa1, fa1 \n"
+                    "fmadd.d fa2, ft0, fa2, fa2 \n"
+                    "fmadd.d fa3, ft0, fa3, fa3 \n"
+                    "fsgnj.d ft2, fa0, fa0 \n"
+                    "fsgnj.d ft2, fa1, fa1 \n"
+                    "fsgnj.d ft2, fa2, fa2 \n"
+                    "fsgnj.d ft2, fa3, fa3 \n"
+                    "fadd.d %[acc0], %[acc0], fa0 \n"
+                    "fadd.d %[acc1], %[acc1], fa1 \n"
+                    "fadd.d %[acc2], %[acc2], fa2 \n"
+                    "fadd.d %[acc3], %[acc3], fa3 \n"
+                    : [ acc0 ] "+f"(acc0), [ acc1 ] "+f"(acc1),
+                      [ acc2 ] "+f"(acc2), [ acc3 ] "+f"(acc3)
+                    : [ n_frep ] "r"(VMATH_CHUNK / 4 - 1)
+                    : "ft0", "ft1", "ft2", "fa0", "fa1", "fa2", "fa3",
+                      "memory");
+            else
+                asm volatile(
+                    "frep.o %[n_frep], 8, 0, 0 \n"
+                    "fsgnj.d fa0, ft1, ft1 \n"
+                    "fsgnj.d fa1, ft1, ft1 \n"
+                    "fsgnj.d fa2, ft1, ft1 \n"
+                    "fsgnj.d fa3, ft1, ft1 \n"
+                    "fmadd.d ft2, ft0, fa0, fa0 \n"
+                    "fmadd.d ft2, ft0, fa1, fa1 \n"
+                    "fmadd.d ft2, ft0, fa2, fa2 \n"
+                    "fmadd.d ft2, ft0, fa3, fa3 \n"
+                    :
+                    : [ n_frep ] "r"(VMATH_CHUNK / 4 - 1)
+                    : "ft0", "ft1", "ft2", "fa0", "fa1", "fa2", "fa3",
+                      "memory");
+            snrt_fpu_fence();
+            snrt_ssr_disable();
+        }
+    }
+    done = n_chunks * VMATH_CHUNK;
+#endif
+    vmath_map<vmath_exp>(x + done, y + done, n - done);
+    if (!sum) return 0;
+    for (uint32_t i = done; i < n; i++) acc0 += y[i];
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+static inline void vmath_vexp(const double *x, double *y, uint32_t n) {
+    vmath_vexp_common(x, y, n, 0);
+}
+
+/**
+ * @brief Exponential of an array of doubles in TCDM, see
+ *        @ref vmath_vexp_common.
+ * @return The sum of the results.
+ */
+static inline double vmath_vexp_sum(const double *x, double *y, uint32_t n) {
+    return vmath_vexp_common(x, y, n, 1);
+}
+
+static inline void vmath_vexp(const float *x, float *y, uint32_t n) {
+    vmath_map<vmath_expf>(x, y, n);
+}
+
+static inline void vmath_vexp(const __fp16 *x, __fp16 *y, uint32_t n) {
+    vmath_map<vmath_expf>(x, y, n);
+}
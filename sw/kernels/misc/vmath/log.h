@@ -0,0 +1,144 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Natural logarithm. The double-precision variant follows fdlibm's `log`:
+// x = 2^k * (1 + f), with 1 + f in [sqrt(2)/2, sqrt(2)), and
+// log(1 + f) = 2 atanh(s), with s = f / (2 + f), approximated by a minimax
+// polynomial in s^2. The single-precision variant follows glibc's `logf`,
+// also used in `sw/kernels/misc/log`, which looks up log(c) and 1/c for a c
+// close to 1 + f in a table and approximates log(1 + f) - log(c) by a cubic
+// polynomial.
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include "common.h"
+
+#define VMATH_LN2HI 0x1.62e42feep-1
+#define VMATH_LN2LO 0x1.a39ef35793c76p-33
+
+#define VMATH_LOG_LG1 6.666666666666735130e-01
+#define VMATH_LOG_LG2 3.999999999940941908e-01
+#define VMATH_LOG_LG3 2.857142874366239149e-01
+#define VMATH_LOG_LG4 2.222219843214978396e-01
+#define VMATH_LOG_LG5 1.818357216161805012e-01
+#define VMATH_LOG_LG6 1.531383769920937332e-01
+#define VMATH_LOG_LG7 1.479819860511658591e-01
+
+#define VMATH_LOGF_TABLE_BITS 4
+#define VMATH_LOGF_N (1 << VMATH_LOGF_TABLE_BITS)
+#define VMATH_LOGF_OFF 0x3f330000
+
+typedef struct {
+    double invc, logc;
+} vmath_logf_entry_t;
+
+__thread const vmath_logf_entry_t vmath_logf_table[VMATH_LOGF_N] = {
+    {0x1.661ec79f8f3bep+0, -0x1.57bf7808caadep-2},
+    {0x1.571ed4aaf883dp+0, -0x1.2bef0a7c06ddbp-2},
+    {0x1.49539f0f010bp+0, -0x1.01eae7f513a67p-2},
+    {0x1.3c995b0b80385p+0, -0x1.b31d8a68224e9p-3},
+    {0x1.30d190c8864a5p+0, -0x1.6574f0ac07758p-3},
+    {0x1.25e227b0b8eap+0, -0x1.1aa2bc79c81p-3},
+    {0x1.1bb4a4a1a343fp+0, -0x1.a4e76ce8c0e5ep-4},
+    {0x1.12358f08ae5bap+0, -0x1.1973c5a611cccp-4},
+    {0x1.0953f419900a7p+0, -0x1.252f438e10c1ep-5},
+    {0x1p+0, 0x0p+0},
+    {0x1.e608cfd9a47acp-1, 0x1.aa5aa5df25984p-5},
+    {0x1.ca4b31f026aap-1, 0x1.c5e53aa362eb4p-4},
+    {0x1.b2036576afce6p-1, 0x1.526e57720db08p-3},
+    {0x1.9c2d163a1aa2dp-1, 0x1.bc2860d22477p-3},
+    {0x1.886e6037841edp-1, 0x1.1058bc8a07ee1p-2},
+    {0x1.767dcf5534862p-1, 0x1.4043057b6ee09p-2}};
+
+static inline double vmath_log(double x);
+
+// Zero, negative, subnormal and non-finite inputs
+static inline double vmath_log_special(double x) {
+    if (x == 0) return -INFINITY;
+    if (!(x > 0)) return NAN;
+    if (x == INFINITY) return x;
+    return vmath_log(x * 0x1p54) - 54 * (VMATH_LN2HI + VMATH_LN2LO);
+}
+
+static inline double vmath_log(double x) {
+    if (!(x >= 0x1p-1022 && x < INFINITY)) return vmath_log_special(x);
+
+    // Reduce x to 1 + f in [sqrt(2)/2, sqrt(2)), by offsetting the upper
+    // word such that the exponent is incremented for mantissas above
+    // sqrt(2)
+    vmath_bits_t b;
+    b.f64 = x;
+    uint32_t hx = b.u32[1] + (0x3ff00000 - 0x3fe6a09e);
+    int32_t k = (int32_t)(hx >> 20) - 0x3ff;
+    b.u32[1] = (hx & 0x000fffff) + 0x3fe6a09e;
+
+    double f = b.f64 - 1.0;
+    double hfsq = 0.5 * f * f;
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double w = z * z;
+    double t1 = w * (VMATH_LOG_LG2 + w * (VMATH_LOG_LG4 + w * VMATH_LOG_LG6));
+    double t2 =
+        z * (VMATH_LOG_LG1 +
+             w * (VMATH_LOG_LG3 + w * (VMATH_LOG_LG5 + w * VMATH_LOG_LG7)));
+    double dk = k;
+    return s * (hfsq + t1 + t2) + dk * VMATH_LN2LO - hfsq + f +
+           dk * VMATH_LN2HI;
+}
+
+static inline float vmath_logf(float x);
+
+static inline float vmath_logf_special(float x) {
+    if (x == 0) return -INFINITY;
+    if (!(x > 0)) return NAN;
+    if (x == INFINITY) return x;
+    return (float)((double)vmath_logf(x * 0x1p23f) -
+                   23 * (VMATH_LN2HI + VMATH_LN2LO));
+}
+
+static inline float vmath_logf(float x) {
+    const double a0 = -0x1.00ea348b88334p-2;
+    const double a1 = 0x1.5575b0be00b6ap-2;
+    const double a2 = -0x1.ffffef20a4123p-2;
+    const double ln2 = 0x1.62e42fefa39efp-1;
+
+    vmath_bits32_t b;
+    b.f32 = x;
+    uint32_t ix = b.u32;
+    if (ix - 0x00800000 >= 0x7f800000 - 0x00800000)
+        return vmath_logf_special(x);
+
+    // x = 2^k z, with z in [OFF, 2 OFF) and the table index i given by the
+    // upper bits of the mantissa of z
+    uint32_t tmp = ix - VMATH_LOGF_OFF;
+    uint32_t i = (tmp >> (23 - VMATH_LOGF_TABLE_BITS)) % VMATH_LOGF_N;
+    int32_t k = (int32_t)tmp >> 23;
+    b.u32 = ix - (tmp & (0x1ffu << 23));
+    double invc = vmath_logf_table[i].invc;
+    double logc = vmath_logf_table[i].logc;
+
+    // log(x) = log1p(z/c - 1) + log(c) + k*ln2
+    double r = (double)b.f32 * invc - 1.0;
+    double y0 = logc + (double)k * ln2;
+    double r2 = r * r;
+    double y = a1 * r + a2;
+    y = a0 * r2 + y;
+    y = y * r2 + (y0 + r);
+    return (float)y;
+}
+
+static inline void vmath_vlog(const double *x, double *y, uint32_t n) {
+    vmath_map<vmath_log>(x, y, n);
+}
+
+static inline void vmath_vlog(const float *x, float *y, uint32_t n) {
+    vmath_map<vmath_logf>(x, y, n);
+}
+
+static inline void vmath_vlog(const __fp16 *x, __fp16 *y, uint32_t n) {
+    vmath_map<vmath_logf>(x, y, n);
+}
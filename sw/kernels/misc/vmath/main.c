@@ -0,0 +1,123 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Benchmark of the vector math library. For every function, the first core
+// times a libm loop over a double-precision array and the library's array
+// function in double, single and half precision, and measures the maximum
+// error of the latter, in units in the last place of the respective
+// precision, against libm in double precision. The double-precision errors
+// thus include the error of libm.
+
+#include <math.h>
+
+#include "snrt.h"
+#include "vmath/vmath.h"
+
+#ifndef LEN
+#define LEN 256
+#endif
+
+typedef void (*vmath_f64_t)(const double *, double *, uint32_t);
+typedef void (*vmath_f32_t)(const float *, float *, uint32_t);
+typedef void (*vmath_f16_t)(const __fp16 *, __fp16 *, uint32_t);
+
+typedef struct {
+    const char *name;
+    double (*ref)(double);
+    vmath_f64_t f64;
+    vmath_f32_t f32;
+    vmath_f16_t f16;
+    // Input range
+    double lo, hi;
+    // Maximum errors tolerated in double and in single or half precision
+    double max_ulp_f64, max_ulp_f32;
+} vmath_bench_t;
+
+static double ref_exp(double x) { return exp(x); }
+static double ref_log(double x) { return log(x); }
+static double ref_sin(double x) { return sin(x); }
+static double ref_cos(double x) { return cos(x); }
+static double ref_tanh(double x) { return tanh(x); }
+static double ref_sigmoid(double x) { return 1.0 / (1.0 + exp(-x)); }
+static double ref_rsqrt(double x) { return 1.0 / sqrt(x); }
+
+static const vmath_bench_t benches[] = {
+    {"exp", ref_exp, vmath_vexp, vmath_vexp, vmath_vexp, -8, 8, 2, 1},
+    {"log", ref_log, vmath_vlog, vmath_vlog, vmath_vlog, 0.01, 100, 2, 1},
+    {"sin", ref_sin, vmath_vsin, vmath_vsin, vmath_vsin, -10, 10, 2.5, 1},
+    {"cos", ref_cos, vmath_vcos, vmath_vcos, vmath_vcos, -10, 10, 2.5, 1},
+    {"tanh", ref_tanh, vmath_vtanh, vmath_vtanh, vmath_vtanh, -5, 5, 3.5, 1},
+    {"sigmoid", ref_sigmoid, vmath_vsigmoid, vmath_vsigmoid, vmath_vsigmoid,
+     -10, 10, 4, 1},
+    {"rsqrt", ref_rsqrt, vmath_vrsqrt, vmath_vrsqrt, vmath_vrsqrt, 0.01, 100,
+     2, 1},
+};
+
+// Error of y in units in the last place of a precision with `digits`
+// significant bits, at the reference value
+static inline double ulp_error(double y, double ref, int digits) {
+    int e;
+    frexp(ref, &e);
+    return fabs(y - ref) / ldexp(1.0, e - digits);
+}
+
+int main() {
+    if (snrt_cluster_idx() != 0 || snrt_cluster_core_idx() != 0) return 0;
+
+    double *x64 = snrt_l1_alloc_cluster_local<double>(LEN);
+    double *y64 = snrt_l1_alloc_cluster_local<double>(LEN);
+    float *x32 = snrt_l1_alloc_cluster_local<float>(LEN);
+    float *y32 = snrt_l1_alloc_cluster_local<float>(LEN);
+    __fp16 *x16 = snrt_l1_alloc_cluster_local<__fp16>(LEN);
+    __fp16 *y16 = snrt_l1_alloc_cluster_local<__fp16>(LEN);
+
+    uint32_t n_err = 0;
+    for (uint32_t b = 0; b < sizeof(benches) / sizeof(benches[0]); b++) {
+        const vmath_bench_t *bench = &benches[b];
+
+        // Evenly spaced inputs
+        for (uint32_t i = 0; i < LEN; i++) {
+            x64[i] = bench->lo + (bench->hi - bench->lo) * (i + 0.5) / LEN;
+            x32[i] = (float)x64[i];
+            x16[i] = (__fp16)x64[i];
+        }
+
+        uint32_t start = snrt_mcycle();
+        for (uint32_t i = 0; i < LEN; i++) y64[i] = bench->ref(x64[i]);
+        uint32_t cycles_libm = snrt_mcycle() - start;
+
+        start = snrt_mcycle();
+        bench->f64(x64, y64, LEN);
+        uint32_t cycles_f64 = snrt_mcycle() - start;
+
+        start = snrt_mcycle();
+        bench->f32(x32, y32, LEN);
+        uint32_t cycles_f32 = snrt_mcycle() - start;
+
+        start = snrt_mcycle();
+        bench->f16(x16, y16, LEN);
+        uint32_t cycles_f16 = snrt_mcycle() - start;
+
+        double err_f64 = 0, err_f32 = 0, err_f16 = 0;
+        for (uint32_t i = 0; i < LEN; i++) {
+            err_f64 = fmax(err_f64,
+                           ulp_error(y64[i], bench->ref(x64[i]), 53));
+            err_f32 = fmax(err_f32,
+                           ulp_error(y32[i], bench->ref(x32[i]), 24));
+            err_f16 = fmax(err_f16,
+                           ulp_error(y16[i], bench->ref(x16[i]), 11));
+        }
+
+        printf("%-8s libm %6u | f64 %6u cycles %.2f ulp | f32 %6u cycles "
+               "%.2f ulp | f16 %6u cycles %.2f ulp\n",
+               bench->name, cycles_libm, cycles_f64, err_f64, cycles_f32,
+               err_f32, cycles_f16, err_f16);
+
+        n_err += err_f64 > bench->max_ulp_f64;
+        n_err += err_f32 > bench->max_ulp_f32;
+        n_err += err_f16 > bench->max_ulp_f32;
+    }
+
+    return n_err;
+}
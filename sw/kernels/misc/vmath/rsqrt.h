@@ -0,0 +1,152 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Reciprocal square root, without divisions or square roots: an initial
+// guess with a relative error below 3.5% is derived from the bits of the
+// argument, and refined by Newton-Raphson iterations
+// y' = y + y (1/2 - x/2 y^2), each of which roughly squares the error.
+//
+// Inputs must be positive normal numbers, other inputs return unspecified
+// values.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+#include "snrt.h"
+
+#define VMATH_RSQRT_MAGIC 0x5fe6eb50c7b537a9ull
+// Iterations required for double and single precision
+#define VMATH_RSQRT_ITERS 4
+#define VMATH_RSQRTF_ITERS 3
+
+static inline uint64_t vmath_rsqrt_guess(uint64_t x) {
+    return VMATH_RSQRT_MAGIC - (x >> 1);
+}
+
+static inline double vmath_rsqrt_newton(double x, double y, int iters) {
+    double hx = 0.5 * x;
+    for (int i = 0; i < iters; i++) {
+        double t = y * y;
+        double r = 0.5 - hx * t;
+        y = y * r + y;
+    }
+    return y;
+}
+
+static inline double vmath_rsqrt(double x) {
+    vmath_bits_t y;
+    y.f64 = x;
+    y.u64 = vmath_rsqrt_guess(y.u64);
+    return vmath_rsqrt_newton(x, y.f64, VMATH_RSQRT_ITERS);
+}
+
+static inline float vmath_rsqrtf(float x) {
+    vmath_bits_t y;
+    y.f64 = (double)x;
+    y.u64 = vmath_rsqrt_guess(y.u64);
+    return (float)vmath_rsqrt_newton((double)x, y.f64, VMATH_RSQRTF_ITERS);
+}
+
+// Writes the initial guesses of an array to a scratch buffer, operating on
+// words, so that no FP instruction is issued
+static inline void vmath_rsqrt_guess_chunk(const double *x, uint32_t *g,
+                                           uint32_t n) {
+    const uint32_t *w = (const uint32_t *)x;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t b = ((uint64_t)w[2 * i + 1] << 32) | w[2 * i];
+        b = vmath_rsqrt_guess(b);
+        g[2 * i] = (uint32_t)b;
+        g[2 * i + 1] = (uint32_t)(b >> 32);
+    }
+}
+
+/**
+ * @brief Reciprocal square root of an array of doubles in TCDM.
+ *
+ * @details For every chunk of `VMATH_CHUNK` elements, an FREP loop streams
+ *          the arguments and their initial guesses in and applies the
+ *          Newton-Raphson iterations, while the integer core computes the
+ *          guesses of the next chunk. Remaining elements, and all
+ *          elements if the FREP sequencer cannot hold the loop, are
+ *          computed with `vmath_rsqrt`.
+ *
+ *          Must be called by a single hart, `x` and `y` may alias.
+ */
+static inline void vmath_vrsqrt(const double *x, double *y, uint32_t n) {
+    uint32_t done = 0;
+    // The body of the Newton-Raphson loop must fit in the FREP sequencer
+#if defined(SNRT_SUPPORTS_SSR) && defined(SNRT_SUPPORTS_FREP) && \
+    SNRT_NUM_SEQUENCER_INSNS >= 28
+    uint32_t n_chunks = n / VMATH_CHUNK;
+    uint32_t g[2][2 * VMATH_CHUNK];
+    const double half = 0.5;
+
+    if (n_chunks) vmath_rsqrt_guess_chunk(x, g[0], VMATH_CHUNK);
+    snrt_ssr_loop_1d(SNRT_SSR_DM_ALL, VMATH_CHUNK, sizeof(double));
+
+    for (uint32_t c = 0; c < n_chunks; c++) {
+        snrt_ssr_read(SNRT_SSR_DM0, SNRT_SSR_1D,
+                      (void *)(x + c * VMATH_CHUNK));
+        snrt_ssr_read(SNRT_SSR_DM1, SNRT_SSR_1D, g[c % 2]);
+        snrt_ssr_write(SNRT_SSR_DM2, SNRT_SSR_1D, y + c * VMATH_CHUNK);
+        snrt_ssr_enable();
+        // Two elements per iteration, interleaved to hide the latency of
+        // the FPU
+        asm volatile(
+            "frep.o %[n_frep], 28, 0, 0 \n"
+            "fmul.d fa0, ft0, %[half] \n"
+            "fmul.d fa1, ft0, %[half] \n"
+            "fsgnj.d fa2, ft1, ft1 \n"
+            "fsgnj.d fa3, ft1, ft1 \n"
+            "fmul.d fa4, fa2, fa2 \n"
+            "fmul.d fa5, fa3, fa3 \n"
+            "fnmsub.d fa4, fa0, fa4, %[half] \n"
+            "fnmsub.d fa5, fa1, fa5, %[half] \n"
+            "fmadd.d fa2, fa2, fa4, fa2 \n"
+            "fmadd.d fa3, fa3, fa5, fa3 \n"
+            "fmul.d fa4, fa2, fa2 \n"
+            "fmul.d fa5, fa3, fa3 \n"
+            "fnmsub.d fa4, fa0, fa4, %[half] \n"
+            "fnmsub.d fa5, fa1, fa5, %[half] \n"
+            "fmadd.d fa2, fa2, fa4, fa2 \n"
+            "fmadd.d fa3, fa3, fa5, fa3 \n"
+            "fmul.d fa4, fa2, fa2 \n"
+            "fmul.d fa5, fa3, fa3 \n"
+            "fnmsub.d fa4, fa0, fa4, %[half] \n"
+            "fnmsub.d fa5, fa1, fa5, %[half] \n"
+            "fmadd.d fa2, fa2, fa4, fa2 \n"
+            "fmadd.d fa3, fa3, fa5, fa3 \n"
+            "fmul.d fa4, fa2, fa2 \n"
+            "fmul.d fa5, fa3, fa3 \n"
+            "fnmsub.d fa4, fa0, fa4, %[half] \n"
+            "fnmsub.d fa5, fa1, fa5, %[half] \n"
+            "fmadd.d ft2, fa2, fa4, fa2 \n"
+            "fmadd.d ft2, fa3, fa5, fa3 \n"
+            :
+            : [ n_frep ] "r"(VMATH_CHUNK / 2 - 1), [ half ] "f"(half)
+            : "ft0", "ft1", "ft2", "fa0", "fa1", "fa2", "fa3", "fa4", "fa5",
+              "memory");
+
+        // Overlap the guesses of the next chunk with the FREP loop
+        if (c + 1 < n_chunks)
+            vmath_rsqrt_guess_chunk(x + (c + 1) * VMATH_CHUNK, g[(c + 1) % 2],
+                                    VMATH_CHUNK);
+
+        snrt_fpu_fence();
+        snrt_ssr_disable();
+    }
+    done = n_chunks * VMATH_CHUNK;
+#endif
+    vmath_map<vmath_rsqrt>(x + done, y + done, n - done);
+}
+
+static inline void vmath_vrsqrt(const float *x, float *y, uint32_t n) {
+    vmath_map<vmath_rsqrtf>(x, y, n);
+}
+
+static inline void vmath_vrsqrt(const __fp16 *x, __fp16 *y, uint32_t n) {
+    vmath_map<vmath_rsqrtf>(x, y, n);
+}
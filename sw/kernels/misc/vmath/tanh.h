@@ -0,0 +1,93 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Hyperbolic tangent and logistic sigmoid, derived from the exponential.
+// Close to zero, where tanh(x) = (e^2x - 1) / (e^2x + 1) would cancel, tanh
+// is evaluated with its Taylor series instead.
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "exp.h"
+
+// Below this magnitude the Taylor series is used
+#define VMATH_TANH_SMALL 0.3
+// Above this magnitude tanh rounds to +-1 in double and single precision
+#define VMATH_TANH_MAX 20.0
+#define VMATH_TANHF_MAX 10.0
+
+// Taylor coefficients of tanh(x), from x^3 to x^23
+static const double vmath_tanh_taylor[] = {
+    -0x1.5555555555555p-2, 0x1.1111111111111p-3,  -0x1.ba1ba1ba1ba1cp-5,
+    0x1.664f4882c10fap-6,  -0x1.226e355e6c23dp-7, 0x1.d6d3d0e157de0p-9,
+    -0x1.7da36452b75e3p-10, 0x1.3558248036744p-11, -0x1.f57d7734d1664p-13,
+    0x1.967e18afcafadp-14, -0x1.497d8eea25259p-15};
+
+// Evaluates the Taylor series up to the term of degree 2m + 1
+static inline double vmath_tanh_series(double a, int m) {
+    double z = a * a;
+    double p = vmath_tanh_taylor[m - 1];
+    for (int i = m - 2; i >= 0; i--) p = p * z + vmath_tanh_taylor[i];
+    return a + a * z * p;
+}
+
+static inline double vmath_tanh(double x) {
+    double a = fabs(x);
+    double t;
+    if (a < VMATH_TANH_SMALL) {
+        t = vmath_tanh_series(a, 11);
+    } else {
+        double e = vmath_exp(2.0 * fmin(a, VMATH_TANH_MAX));
+        t = (e - 1.0) / (e + 1.0);
+    }
+    return copysign(t, x);
+}
+
+static inline float vmath_tanhf(float x) {
+    double a = fabs((double)x);
+    double t;
+    if (a < VMATH_TANH_SMALL) {
+        t = vmath_tanh_series(a, 5);
+    } else {
+        double e = vmath_expf_core(2.0 * fmin(a, VMATH_TANHF_MAX));
+        t = (e - 1.0) / (e + 1.0);
+    }
+    return (float)copysign(t, (double)x);
+}
+
+static inline double vmath_sigmoid(double x) {
+    return 1.0 / (1.0 + vmath_exp(-x));
+}
+
+static inline float vmath_sigmoidf(float x) {
+    double nx = fmin(fmax(-(double)x, VMATH_EXPF_MIN), -VMATH_EXPF_MIN);
+    return (float)(1.0 / (1.0 + vmath_expf_core(nx)));
+}
+
+static inline void vmath_vtanh(const double *x, double *y, uint32_t n) {
+    vmath_map<vmath_tanh>(x, y, n);
+}
+
+static inline void vmath_vtanh(const float *x, float *y, uint32_t n) {
+    vmath_map<vmath_tanhf>(x, y, n);
+}
+
+static inline void vmath_vtanh(const __fp16 *x, __fp16 *y, uint32_t n) {
+    vmath_map<vmath_tanhf>(x, y, n);
+}
+
+static inline void vmath_vsigmoid(const double *x, double *y, uint32_t n) {
+    vmath_map<vmath_sigmoid>(x, y, n);
+}
+
+static inline void vmath_vsigmoid(const float *x, float *y, uint32_t n) {
+    vmath_map<vmath_sigmoidf>(x, y, n);
+}
+
+static inline void vmath_vsigmoid(const __fp16 *x, __fp16 *y, uint32_t n) {
+    vmath_map<vmath_sigmoidf>(x, y, n);
+}
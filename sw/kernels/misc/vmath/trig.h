@@ -0,0 +1,140 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Sine and cosine. The argument is reduced as x = k pi/2 + r, with
+// |r| <= pi/4, subtracting k pi/2 in three parts (Cody-Waite), and sin(r)
+// or cos(r) is selected and negated according to the quadrant k mod 4. The
+// double-precision variants use fdlibm's minimax polynomials, the
+// single-precision variants shorter Taylor polynomials evaluated in double
+// precision.
+//
+// The reduction is accurate for |x| < 2^20 pi/2, beyond which no
+// Payne-Hanek fallback is provided.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#define VMATH_TRIG_SHIFT 0x1.8p+52
+#define VMATH_TRIG_INV_PIO2 0x1.45f306dc9c883p-1
+// pi/2 split in 33-bit parts, whose products with k are exact
+#define VMATH_TRIG_PIO2_1 0x1.921fb544p+0
+#define VMATH_TRIG_PIO2_2 0x1.0b4611a6p-34
+#define VMATH_TRIG_PIO2_3 0x1.3198a2ep-69
+
+#define VMATH_SIN_S1 -1.66666666666666324348e-01
+#define VMATH_SIN_S2 8.33333333332248946124e-03
+#define VMATH_SIN_S3 -1.98412698298579493134e-04
+#define VMATH_SIN_S4 2.75573137070700676789e-06
+#define VMATH_SIN_S5 -2.50507602534068634195e-08
+#define VMATH_SIN_S6 1.58969099521155010221e-10
+
+#define VMATH_COS_C1 4.16666666666666019037e-02
+#define VMATH_COS_C2 -1.38888888888741095749e-03
+#define VMATH_COS_C3 2.48015872894767294178e-05
+#define VMATH_COS_C4 -2.75573143513906633035e-07
+#define VMATH_COS_C5 2.08757232129817482790e-09
+#define VMATH_COS_C6 -1.13596475577881948265e-11
+
+/**
+ * @brief Reduces x to r in [-pi/4, pi/4] and returns the quadrant k.
+ *
+ * @param parts Number of parts of pi/2 subtracted, three for double
+ *              precision, two suffice for single precision.
+ */
+static inline uint32_t vmath_trig_reduce(double x, double *r, int parts) {
+    vmath_bits_t kd;
+    kd.f64 = x * VMATH_TRIG_INV_PIO2 + VMATH_TRIG_SHIFT;
+    double k = kd.f64 - VMATH_TRIG_SHIFT;
+    double y = x - k * VMATH_TRIG_PIO2_1;
+    y = y - k * VMATH_TRIG_PIO2_2;
+    if (parts > 2) y = y - k * VMATH_TRIG_PIO2_3;
+    *r = y;
+    return kd.u32[0];
+}
+
+static inline double vmath_sin_kernel(double r) {
+    double z = r * r;
+    double p = VMATH_SIN_S2 +
+               z * (VMATH_SIN_S3 +
+                    z * (VMATH_SIN_S4 + z * (VMATH_SIN_S5 + z * VMATH_SIN_S6)));
+    return r + z * r * (VMATH_SIN_S1 + z * p);
+}
+
+static inline double vmath_cos_kernel(double r) {
+    double z = r * r;
+    double p =
+        z * (VMATH_COS_C1 +
+             z * (VMATH_COS_C2 +
+                  z * (VMATH_COS_C3 +
+                       z * (VMATH_COS_C4 +
+                            z * (VMATH_COS_C5 + z * VMATH_COS_C6)))));
+    // 1 - z/2 rounded, with its rounding error recovered in the tail
+    double hz = 0.5 * z;
+    double w = 1.0 - hz;
+    return w + (((1.0 - w) - hz) + z * p);
+}
+
+// Taylor polynomials, accurate to single precision for |r| <= pi/4
+static inline double vmath_sinf_kernel(double r) {
+    double z = r * r;
+    double p = 1.0 / 120 + z * (-1.0 / 5040 + z * (1.0 / 362880));
+    return r + z * r * (-1.0 / 6 + z * p);
+}
+
+static inline double vmath_cosf_kernel(double r) {
+    double z = r * r;
+    double p = 1.0 / 24 +
+               z * (-1.0 / 720 + z * (1.0 / 40320 + z * (-1.0 / 3628800)));
+    return 1.0 - 0.5 * z + z * z * p;
+}
+
+// sin(x) for q = 0, cos(x) = sin(x + pi/2) for q = 1
+static inline double vmath_sincos(double x, uint32_t q) {
+    double r;
+    q += vmath_trig_reduce(x, &r, 3);
+    double y = (q & 1) ? vmath_cos_kernel(r) : vmath_sin_kernel(r);
+    return (q & 2) ? -y : y;
+}
+
+static inline float vmath_sincosf(float x, uint32_t q) {
+    double r;
+    q += vmath_trig_reduce((double)x, &r, 2);
+    double y = (q & 1) ? vmath_cosf_kernel(r) : vmath_sinf_kernel(r);
+    return (float)((q & 2) ? -y : y);
+}
+
+static inline double vmath_sin(double x) { return vmath_sincos(x, 0); }
+
+static inline double vmath_cos(double x) { return vmath_sincos(x, 1); }
+
+static inline float vmath_sinf(float x) { return vmath_sincosf(x, 0); }
+
+static inline float vmath_cosf(float x) { return vmath_sincosf(x, 1); }
+
+static inline void vmath_vsin(const double *x, double *y, uint32_t n) {
+    vmath_map<vmath_sin>(x, y, n);
+}
+
+static inline void vmath_vsin(const float *x, float *y, uint32_t n) {
+    vmath_map<vmath_sinf>(x, y, n);
+}
+
+static inline void vmath_vsin(const __fp16 *x, __fp16 *y, uint32_t n) {
+    vmath_map<vmath_sinf>(x, y, n);
+}
+
+static inline void vmath_vcos(const double *x, double *y, uint32_t n) {
+    vmath_map<vmath_cos>(x, y, n);
+}
+
+static inline void vmath_vcos(const float *x, float *y, uint32_t n) {
+    vmath_map<vmath_cosf>(x, y, n);
+}
+
+static inline void vmath_vcos(const __fp16 *x, __fp16 *y, uint32_t n) {
+    vmath_map<vmath_cosf>(x, y, n);
+}
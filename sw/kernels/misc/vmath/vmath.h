@@ -0,0 +1,39 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Vector math library: exp, log, sin, cos, tanh, sigmoid and rsqrt.
+//
+// Every function comes as an inlinable element function, `vmath_<f>` in
+// double and `vmath_<f>f` in single precision, free of libm calls, and as an
+// array function `vmath_v<f>` overloaded for double, float and __fp16 arrays
+// in TCDM. Half-precision arrays are evaluated in single precision. The
+// array functions are called by a single hart, so parallel kernels split
+// their arrays among the cores. The double-precision exp and rsqrt arrays
+// take a vectorized path, in which SSR-fed FREP loops on the FPU overlap
+// with the integer work on the integer core. All other array functions are
+// loops over the element functions.
+//
+// Single-precision functions compute in double precision internally, like
+// glibc's. Maximum errors, in units in the last place, measured against a
+// higher-precision reference over random arguments:
+//
+//   function  double    float   notes
+//   exp       1.01      0.51    clamped to [-708, 708] and [-104, 89]
+//   log       0.86      0.82
+//   sin, cos  1.5/2.3   0.53    |x| <= 10 / |x| < 2^20 pi/2
+//   tanh      2.3       0.52
+//   sigmoid   2.9       0.51
+//   rsqrt     1.01      0.50    positive normal inputs only
+//
+// Only log treats special values as IEEE 754 prescribes. The other
+// functions saturate or return unspecified values, see the individual
+// headers.
+
+#pragma once
+
+#include "exp.h"
+#include "log.h"
+#include "rsqrt.h"
+#include "tanh.h"
+#include "trig.h"
@@ -13,6 +13,7 @@
 #include "eu.c"
 #include "kmp.c"
 #include "omp.c"
+#include "perf_prof.c"
 #include "printf.c"
 #include "putchar.c"
 #include "riscv.c"
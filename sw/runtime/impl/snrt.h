@@ -37,6 +37,7 @@
 #include "kmp.h"
 #include "omp.h"
 #include "perf_cnt.h"
+#include "perf_prof.h"
 #include "printf.h"
 #include "riscv.h"
 #include "snitch_cluster_global_interrupts.h"
@@ -90,3 +90,28 @@ extern snrt_dma_txid_t snrt_dma_store_2d_tile_from_banks(
     void *dst, void *src, size_t tile_x1_idx, size_t tile_x0_idx,
     size_t tile_x1_size, size_t tile_x0_size, size_t full_x0_size,
     uint32_t prec, size_t num_banks);
+
+extern snrt_dma_txid_t snrt_dma_2d_tile_view(
+    void *tile, const snrt_dma_view_t *view, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec, size_t tile_ld, uint32_t store);
+
+extern snrt_dma_txid_t snrt_dma_load_2d_tile_view(
+    void *dst, const snrt_dma_view_t *src, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec, size_t tile_ld);
+
+extern snrt_dma_txid_t snrt_dma_load_2d_tile_view(
+    void *dst, const snrt_dma_view_t *src, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec);
+
+extern snrt_dma_txid_t snrt_dma_store_2d_tile_view(
+    const snrt_dma_view_t *dst, void *src, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec, size_t tile_ld);
+
+extern snrt_dma_txid_t snrt_dma_store_2d_tile_view(
+    const snrt_dma_view_t *dst, void *src, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec);
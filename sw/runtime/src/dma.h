@@ -767,3 +767,164 @@ inline snrt_dma_txid_t snrt_dma_store_2d_tile_from_banks(
                                   tile_x1_size_in_banks, tile_x0_size_in_banks,
                                   full_x0_size, prec, tile_ld);
 }
+
+/**
+ * @struct snrt_dma_view_part_t
+ * @brief A 2D array backing a rectangular region of a tensor view.
+ * @var snrt_dma_view_part_t::ptr
+ * Pointer to the first element of the region in the backing array.
+ * @var snrt_dma_view_part_t::x1_offset
+ * Outermost coordinate of the region in the view.
+ * @var snrt_dma_view_part_t::x0_offset
+ * Innermost coordinate of the region in the view.
+ * @var snrt_dma_view_part_t::x1_size
+ * Number of elements in the outermost dimension of the region.
+ * @var snrt_dma_view_part_t::x0_size
+ * Number of elements in the innermost dimension of the region.
+ * @var snrt_dma_view_part_t::ld
+ * Number of elements in the innermost dimension of the backing array.
+ */
+typedef struct {
+    void *ptr;
+    uint32_t x1_offset;
+    uint32_t x0_offset;
+    uint32_t x1_size;
+    uint32_t x0_size;
+    uint32_t ld;
+} snrt_dma_view_part_t;
+
+/**
+ * @struct snrt_dma_view_t
+ * @brief A 2D tensor view composed of regions of other arrays.
+ *
+ * Views describe concatenations, splits and slices of tensors without
+ * materializing them. A concatenation along the innermost dimension, for
+ * instance, is a view with one part per input, placed at increasing
+ * `x0_offset`s. Tiles of a view are loaded and stored with one strided DMA
+ * transfer per overlapping part.
+ *
+ * @var snrt_dma_view_t::num_parts
+ * Number of parts composing the view.
+ * @var snrt_dma_view_t::parts
+ * Pointer to an array of non-overlapping parts.
+ */
+typedef struct {
+    uint32_t num_parts;
+    snrt_dma_view_part_t *parts;
+} snrt_dma_view_t;
+
+/**
+ * @brief Transfer a 2D tile between a tensor view and a tile.
+ * @param tile Pointer to the tile.
+ * @param view Pointer to the view.
+ * @param tile_x1_idx Outermost coordinate of the tile in the view.
+ * @param tile_x0_idx Innermost coordinate of the tile in the view.
+ * @param tile_x1_size Number of elements in the outermost dimension of the
+ *                     tile.
+ * @param tile_x0_size Number of elements in the innermost dimension of the
+ *                     tile.
+ * @param prec Number of bytes of each element in the view.
+ * @param tile_ld Leading dimension of the tile, in bytes.
+ * @param store Transfer from the tile to the view, if set, and from the view
+ *              to the tile otherwise.
+ * @return The DMA transfer ID of the last transfer.
+ */
+inline snrt_dma_txid_t snrt_dma_2d_tile_view(
+    void *tile, const snrt_dma_view_t *view, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec, size_t tile_ld, uint32_t store) {
+    snrt_dma_txid_t txid = 0;
+    // Coordinates of the tile in the view
+    size_t x1_start = tile_x1_idx * tile_x1_size;
+    size_t x0_start = tile_x0_idx * tile_x0_size;
+    size_t x1_end = x1_start + tile_x1_size;
+    size_t x0_end = x0_start + tile_x0_size;
+    for (uint32_t i = 0; i < view->num_parts; i++) {
+        const snrt_dma_view_part_t *part = &view->parts[i];
+        // Intersect the tile with the part
+        size_t x1_lo = x1_start > part->x1_offset ? x1_start : part->x1_offset;
+        size_t x0_lo = x0_start > part->x0_offset ? x0_start : part->x0_offset;
+        size_t x1_hi = part->x1_offset + part->x1_size;
+        size_t x0_hi = part->x0_offset + part->x0_size;
+        if (x1_end < x1_hi) x1_hi = x1_end;
+        if (x0_end < x0_hi) x0_hi = x0_end;
+        if (x1_lo >= x1_hi || x0_lo >= x0_hi) continue;
+        // Byte offsets of the intersection in the part and in the tile
+        uint64_t part_addr =
+            (uint64_t)part->ptr + ((x1_lo - part->x1_offset) * part->ld +
+                                   (x0_lo - part->x0_offset)) *
+                                      prec;
+        uint64_t tile_addr = (uint64_t)tile + (x1_lo - x1_start) * tile_ld +
+                             (x0_lo - x0_start) * prec;
+        size_t size = (x0_hi - x0_lo) * prec;
+        size_t part_ld = part->ld * prec;
+        if (store) {
+            txid = snrt_dma_start_2d(part_addr, tile_addr, size, part_ld,
+                                     tile_ld, x1_hi - x1_lo);
+        } else {
+            txid = snrt_dma_start_2d(tile_addr, part_addr, size, tile_ld,
+                                     part_ld, x1_hi - x1_lo);
+        }
+    }
+    return txid;
+}
+
+/**
+ * @brief Load a 2D tile of a tensor view.
+ * @param dst Pointer to the tile destination.
+ * @param src Pointer to the source view.
+ *
+ * @see snrt_dma_2d_tile_view() for a description of the other parameters.
+ */
+inline snrt_dma_txid_t snrt_dma_load_2d_tile_view(
+    void *dst, const snrt_dma_view_t *src, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec, size_t tile_ld) {
+    return snrt_dma_2d_tile_view(dst, src, tile_x1_idx, tile_x0_idx,
+                                 tile_x1_size, tile_x0_size, prec, tile_ld, 0);
+}
+
+/**
+ * @brief Load a 2D tile of a tensor view into a contiguous tile.
+ *
+ * @see snrt_dma_load_2d_tile_view(void *, const snrt_dma_view_t *, size_t, size_t, size_t, size_t, uint32_t, size_t)
+ *      for a detailed description of the parameters.
+ */
+inline snrt_dma_txid_t snrt_dma_load_2d_tile_view(
+    void *dst, const snrt_dma_view_t *src, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec) {
+    return snrt_dma_load_2d_tile_view(dst, src, tile_x1_idx, tile_x0_idx,
+                                      tile_x1_size, tile_x0_size, prec,
+                                      tile_x0_size * prec);
+}
+
+/**
+ * @brief Store a 2D tile to a tensor view.
+ * @param dst Pointer to the destination view.
+ * @param src Pointer to the source tile.
+ *
+ * @see snrt_dma_2d_tile_view() for a description of the other parameters.
+ */
+inline snrt_dma_txid_t snrt_dma_store_2d_tile_view(
+    const snrt_dma_view_t *dst, void *src, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec, size_t tile_ld) {
+    return snrt_dma_2d_tile_view(src, dst, tile_x1_idx, tile_x0_idx,
+                                 tile_x1_size, tile_x0_size, prec, tile_ld, 1);
+}
+
+/**
+ * @brief Store a contiguous 2D tile to a tensor view.
+ *
+ * @see snrt_dma_store_2d_tile_view(const snrt_dma_view_t *, void *, size_t, size_t, size_t, size_t, uint32_t, size_t)
+ *      for a detailed description of the parameters.
+ */
+inline snrt_dma_txid_t snrt_dma_store_2d_tile_view(
+    const snrt_dma_view_t *dst, void *src, size_t tile_x1_idx,
+    size_t tile_x0_idx, size_t tile_x1_size, size_t tile_x0_size,
+    uint32_t prec) {
+    return snrt_dma_store_2d_tile_view(dst, src, tile_x1_idx, tile_x0_idx,
+                                       tile_x1_size, tile_x0_size, prec,
+                                       tile_x0_size * prec);
+}
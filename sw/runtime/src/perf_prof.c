@@ -0,0 +1,23 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+//================================================================================
+// Data
+//================================================================================
+
+__thread snrt_prof_state_t snrt_prof_state;
+
+//================================================================================
+// Functions
+//================================================================================
+
+extern size_t snrt_prof_buffer_size(uint32_t capacity);
+
+extern void snrt_prof_init(void *buffer, uint32_t capacity,
+                           const snrt_prof_event_t *events,
+                           uint32_t num_events);
+
+extern void snrt_prof_region_start(uint32_t region);
+
+extern void snrt_prof_region_end();
@@ -0,0 +1,240 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * @file
+ * @brief Region-based profiling on top of the cluster performance counters.
+ *
+ * The cluster peripheral provides a small, fixed number of performance
+ * counters (@ref SNRT_NUM_PERF_CNTS), each of which tracks one metric for one
+ * hart. This profiling layer lets an application request an arbitrary number
+ * of (metric, hart) events and annotate code regions with
+ * @ref snrt_prof_region_start and @ref snrt_prof_region_end.
+ *
+ * Events are partitioned into groups of @ref SNRT_NUM_PERF_CNTS events. On
+ * every invocation of a region, the next group (round-robin, tracked
+ * separately for every region) is programmed into the counters. Over repeated
+ * invocations of a region all events are thus sampled, and the host can
+ * extrapolate per-invocation averages for every event.
+ *
+ * For every region invocation a fixed-size record is appended to a buffer,
+ * which is typically placed in L3 and inspected after the simulation with
+ * `util/bench/prof.py`. The buffer layout is:
+ * @code{.c}
+ * snrt_prof_header_t header;
+ * snrt_prof_record_t records[capacity];
+ * @endcode
+ *
+ * Since the counters are a cluster-global resource, a single hart per cluster
+ * must initialize the profiler and delimit regions. Regions must not be
+ * nested.
+ */
+
+#pragma once
+
+/// Magic number identifying a profiling buffer ("SNPF").
+#define SNRT_PROF_MAGIC 0x46504e53
+
+/// Version of the profiling buffer layout.
+#define SNRT_PROF_VERSION 2
+
+/// Maximum number of events which can be multiplexed on the counters.
+#define SNRT_PROF_MAX_EVENTS 64
+
+/// Maximum number of distinct region IDs.
+#define SNRT_PROF_MAX_REGIONS 32
+
+/**
+ * @brief A (metric, hart) pair to be tracked by a performance counter.
+ */
+typedef struct {
+    uint16_t metric; /**< One of the `PERF_METRIC__*` values */
+    uint16_t hart;   /**< Cluster-local hart index (ignored for global metrics) */
+} snrt_prof_event_t;
+
+/**
+ * @brief Header of a profiling buffer.
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t cluster_idx;
+    uint16_t hartid;
+    uint16_t num_cnts;
+    uint16_t num_events;
+    uint16_t reserved;
+    uint32_t capacity;
+    uint32_t num_records;
+    uint32_t num_dropped;
+    snrt_prof_event_t events[SNRT_PROF_MAX_EVENTS];
+} snrt_prof_header_t;
+
+/**
+ * @brief Profiling record of a single region invocation.
+ *
+ * Counter `i` holds the value of event `group * num_cnts + i`. Counters
+ * beyond the last event are left at zero.
+ */
+typedef struct {
+    uint16_t region;
+    uint16_t group;
+    uint32_t tstart;
+    uint32_t tend;
+    uint32_t values[SNRT_NUM_PERF_CNTS];
+} snrt_prof_record_t;
+
+/**
+ * @brief Profiling state of the calling hart.
+ */
+typedef struct {
+    snrt_prof_header_t *header;
+    snrt_prof_record_t *records;
+    uint32_t num_groups;
+    uint32_t active_region;
+    uint32_t active_group;
+    uint32_t tstart;
+    uint16_t invocations[SNRT_PROF_MAX_REGIONS];
+} snrt_prof_state_t;
+
+extern __thread snrt_prof_state_t snrt_prof_state;
+
+/**
+ * @brief Default event set covering DMA, TCDM, I$ and FPU behaviour.
+ * @details Hart-local events are tracked for hart @p hart, DMA-local events
+ *          for the cluster's DMA.
+ */
+#define SNRT_PROF_DEFAULT_EVENTS(hart)                                        \
+    {                                                                         \
+        {PERF_METRIC__TCDM_ACCESSED, 0}, {PERF_METRIC__TCDM_CONGESTED, 0},    \
+            {PERF_METRIC__ISSUE_FPU, hart},                                   \
+            {PERF_METRIC__ISSUE_CORE_TO_FPU, hart},                           \
+            {PERF_METRIC__RETIRED_INSTR, hart},                               \
+            {PERF_METRIC__RETIRED_LOAD, hart},                                \
+            {PERF_METRIC__ICACHE_MISS, hart},                                 \
+            {PERF_METRIC__ICACHE_HIT, hart},                                  \
+            {PERF_METRIC__ICACHE_STALL, hart},                                \
+            {PERF_METRIC__DMA_BUSY, 0}, {PERF_METRIC__DMA_AR_BW, 0},          \
+            {PERF_METRIC__DMA_AW_BW, 0}, {PERF_METRIC__DMA_AR_STALL, 0},      \
+            {PERF_METRIC__DMA_AW_STALL, 0}, {PERF_METRIC__DMA_R_STALL, 0},    \
+            {PERF_METRIC__DMA_W_STALL, 0}, {PERF_METRIC__DMA_BUF_R_STALL, 0}, \
+            {PERF_METRIC__DMA_BUF_W_STALL, 0},                                \
+    }
+
+/**
+ * @brief Get the size of a profiling buffer.
+ * @param capacity The maximum number of records in the buffer.
+ * @return The size of the buffer in bytes.
+ */
+inline size_t snrt_prof_buffer_size(uint32_t capacity) {
+    return sizeof(snrt_prof_header_t) + capacity * sizeof(snrt_prof_record_t);
+}
+
+/**
+ * @brief Initialize the profiler on the calling hart.
+ * @param buffer Pointer to a buffer of at least
+ *               @ref snrt_prof_buffer_size(@p capacity) bytes. Every cluster
+ *               must use a distinct buffer.
+ * @param capacity The maximum number of records in the buffer. Further
+ *                 records are dropped, and counted in the header.
+ * @param events The events to track.
+ * @param num_events The number of events. At most @ref SNRT_PROF_MAX_EVENTS.
+ */
+inline void snrt_prof_init(void *buffer, uint32_t capacity,
+                           const snrt_prof_event_t *events,
+                           uint32_t num_events) {
+    snrt_prof_state_t *s = &snrt_prof_state;
+    if (num_events > SNRT_PROF_MAX_EVENTS) num_events = SNRT_PROF_MAX_EVENTS;
+
+    // Initialize header
+    s->header = (snrt_prof_header_t *)buffer;
+    s->records = (snrt_prof_record_t *)(s->header + 1);
+    s->header->magic = SNRT_PROF_MAGIC;
+    s->header->version = SNRT_PROF_VERSION;
+    s->header->cluster_idx = snrt_cluster_idx();
+    s->header->hartid = snrt_hartid();
+    s->header->num_cnts = SNRT_NUM_PERF_CNTS;
+    s->header->num_events = num_events;
+    s->header->reserved = 0;
+    s->header->capacity = capacity;
+    s->header->num_records = 0;
+    s->header->num_dropped = 0;
+    for (uint32_t i = 0; i < num_events; i++) s->header->events[i] = events[i];
+
+    // Initialize state
+    s->num_groups = (num_events + SNRT_NUM_PERF_CNTS - 1) / SNRT_NUM_PERF_CNTS;
+    if (s->num_groups == 0) s->num_groups = 1;
+    s->active_region = SNRT_PROF_MAX_REGIONS;
+    for (uint32_t i = 0; i < SNRT_PROF_MAX_REGIONS; i++) s->invocations[i] = 0;
+}
+
+/**
+ * @brief Mark the start of a profiled region.
+ * @details Programs the counters with the next event group for this region,
+ *          then resets and starts them.
+ * @param region The region ID. Regions with an ID not smaller than
+ *               @ref SNRT_PROF_MAX_REGIONS are not profiled.
+ */
+inline void snrt_prof_region_start(uint32_t region) {
+    snrt_prof_state_t *s = &snrt_prof_state;
+    const snrt_prof_header_t *h = s->header;
+    if (region >= SNRT_PROF_MAX_REGIONS) return;
+
+    // Select next group of events for this region
+    uint32_t group = s->invocations[region] % s->num_groups;
+    uint32_t first = group * SNRT_NUM_PERF_CNTS;
+
+    // Configure counters
+    for (uint32_t i = 0; i < SNRT_NUM_PERF_CNTS; i++) {
+        snrt_stop_perf_counter(i);
+        snrt_reset_perf_counter(i);
+        if (first + i < h->num_events) {
+            snrt_cfg_perf_counter(i, h->events[first + i].metric,
+                                  h->events[first + i].hart);
+        }
+    }
+
+    s->active_region = region;
+    s->active_group = group;
+
+    // Start counters last to exclude the configuration overhead
+    for (uint32_t i = 0; first + i < h->num_events && i < SNRT_NUM_PERF_CNTS;
+         i++)
+        snrt_start_perf_counter(i);
+    s->tstart = snrt_mcycle();
+}
+
+/**
+ * @brief Mark the end of the currently active region.
+ * @details Stops the counters and appends a record to the profiling buffer.
+ *          Does nothing if no region is active.
+ */
+inline void snrt_prof_region_end() {
+    uint32_t tend = snrt_mcycle();
+    snrt_prof_state_t *s = &snrt_prof_state;
+    snrt_prof_header_t *h = s->header;
+    if (s->active_region >= SNRT_PROF_MAX_REGIONS) return;
+
+    // Stop counters
+    for (uint32_t i = 0; i < SNRT_NUM_PERF_CNTS; i++) snrt_stop_perf_counter(i);
+
+    // Append record to buffer
+    if (h->num_records < h->capacity) {
+        snrt_prof_record_t *r = &s->records[h->num_records];
+        uint32_t first = s->active_group * SNRT_NUM_PERF_CNTS;
+        r->region = s->active_region;
+        r->group = s->active_group;
+        r->tstart = s->tstart;
+        r->tend = tend;
+        for (uint32_t i = 0; i < SNRT_NUM_PERF_CNTS; i++) {
+            r->values[i] =
+                (first + i < h->num_events) ? snrt_get_perf_counter(i) : 0;
+        }
+        h->num_records++;
+    } else {
+        h->num_dropped++;
+    }
+
+    s->invocations[s->active_region]++;
+    s->active_region = SNRT_PROF_MAX_REGIONS;
+}
@@ -75,6 +75,7 @@ typedef enum {
     SNRT_SSR_REG_IDX_CFG = 10,    /**< SSSR index configuration register */
     SNRT_SSR_REG_IDX_BASE = 11,   /**< SSSR base address register */
     SNRT_SSR_REG_RPTR_INDIR = 16, /**< SSSR indir. indices read ptr register */
+    SNRT_SSR_REG_WPTR_INDIR = 20, /**< SSSR indir. indices write ptr register */
     SNRT_SSR_REG_RPTR = 24,       /**< SSR read pointer register */
     SNRT_SSR_REG_WPTR = 28        /**< SSR write pointer register */
 } snrt_ssr_reg_t;
@@ -331,4 +332,21 @@ static inline void snrt_issr_read(const snrt_ssr_dm_t dm, volatile void *base,
     snrt_issr_set_idx_cfg(dm, idxsize);
     snrt_issr_set_bound(dm, bound);
     snrt_issr_set_ptrs(dm, base, idcs);
+}
+
+/**
+ * @brief Start a streaming indirect write.
+ * @param dm The SSSR index.
+ * @param base The base pointer to the data.
+ * @param idcs The pointer to the indirection indices.
+ * @param bound The bound of the first (and only) loop.
+ * @param idxsize The size of the indices.
+ */
+static inline void snrt_issr_write(const snrt_ssr_dm_t dm, volatile void *base,
+                                   volatile void *idcs, size_t bound,
+                                   snrt_ssr_idxsize_t idxsize) {
+    snrt_issr_set_idx_cfg(dm, idxsize);
+    snrt_issr_set_bound(dm, bound);
+    write_ssr_cfg(SNRT_SSR_REG_IDX_BASE, dm, (uintptr_t)base);
+    write_ssr_cfg(SNRT_SSR_REG_WPTR_INDIR, dm, (uintptr_t)idcs);
 }
\ No newline at end of file
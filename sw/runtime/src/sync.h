@@ -366,7 +366,8 @@ inline uint32_t snrt_global_all_to_all_reduction(uint32_t value) {
  *          The receiver then reduces each element in its destination buffer
  *          with the respective element in its source buffer. The result is
  *          stored in the source buffer. It then proceeds to the next level in
- *          the binary tree.
+ *          the binary tree. The number of clusters need not be a power of
+ *          two: receivers without a sender in a level skip its reduction.
  * @param dst_buffer The pointer to the calling cluster's destination buffer.
  * @param src_buffer The pointer to the calling cluster's source buffer.
  * @param len The amount of data in each buffer. Only integer multiples of the
@@ -398,6 +399,10 @@ inline void snrt_global_reduction_dma(T *dst_buffer, T *src_buffer, size_t len,
             // active ones is a sender.
             uint32_t is_active = (snrt_cluster_idx() % (1 << level)) == 0;
             uint32_t is_sender = (snrt_cluster_idx() % (1 << (level + 1))) != 0;
+            // With a number of clusters which is not a power of two, some
+            // receivers have no sender in some levels
+            uint32_t has_sender =
+                (snrt_cluster_idx() + (1 << level)) < comm->size;
 
             // If the cluster is a sender, it sends the data in its source
             // buffer to the respective receiver's destination buffer
@@ -415,7 +420,7 @@ inline void snrt_global_reduction_dma(T *dst_buffer, T *src_buffer, size_t len,
             snrt_global_barrier(comm);
 
             // Every cluster which is not a sender performs the reduction
-            if (is_active && !is_sender) {
+            if (is_active && !is_sender && has_sender) {
                 // Computation is parallelized over the compute cores
                 if (snrt_is_compute_core()) {
                     uint32_t items_per_core =
@@ -429,9 +434,14 @@ inline void snrt_global_reduction_dma(T *dst_buffer, T *src_buffer, size_t len,
                 }
             }
 
-            // Synchronize compute and DM cores for next tree level
+            // Synchronize compute and DM cores for next tree level. Senders
+            // of the next level must also wait for the receivers of this
+            // level to be done with their destination buffers.
             snrt_fpu_fence();
-            snrt_cluster_hw_barrier();
+            if (level + 1 < num_levels)
+                snrt_global_barrier(comm);
+            else
+                snrt_cluster_hw_barrier();
         }
     }
 }
@@ -0,0 +1,68 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#include "dispatch.h"
+#include "primitives/primitives.h"
+
+#define NVARIANTS 3
+
+// Variants differ in runtime only, variant 1 being the fastest
+static const uint32_t work[NVARIANTS] = {400, 20, 200};
+
+typedef struct {
+    uint32_t runs[NVARIANTS];
+} ctx_t;
+
+static void run(void *ctx, uint32_t variant) {
+    ((ctx_t *)ctx)->runs[variant]++;
+    for (volatile uint32_t i = 0; i < work[variant]; i++)
+        ;
+}
+
+__thread dispatch_table_t table = {NVARIANTS};
+
+int main() {
+    uint32_t errors = 0;
+    ctx_t ctx = {{0}};
+
+    if (snrt_is_compute_core()) {
+        // The fastest variant is selected on the first invocation, after
+        // timing every eligible variant twice
+        uint32_t key[DISPATCH_KEY_LEN] = {1, 0, 0, 0};
+        errors += dispatch(&table, key, 0x7, run, &ctx, 0) != 1;
+        errors += ctx.runs[0] != 2 || ctx.runs[1] != 3 || ctx.runs[2] != 2;
+
+        // Later invocations only look up the table
+        errors += dispatch(&table, key, 0x7, run, &ctx, 0) != 1;
+        errors += ctx.runs[0] != 2 || ctx.runs[1] != 4 || ctx.runs[2] != 2;
+
+        // Only eligible variants are considered
+        key[0] = 2;
+        errors += dispatch(&table, key, 0x5, run, &ctx, 0) != 2;
+        errors += ctx.runs[1] != 4;
+
+        // Once the table is full, the oldest entries are replaced first
+        for (uint32_t i = 0; i < DISPATCH_MAX_ENTRIES - 1; i++) {
+            key[0] = 3 + i;
+            dispatch_record(&table, key, 0, 0);
+        }
+        errors += table.nentries != DISPATCH_MAX_ENTRIES;
+        key[0] = 1;
+        errors += dispatch_lookup(&table, key) != NULL;
+        key[0] = 2;
+        errors += dispatch_lookup(&table, key) == NULL;
+    }
+
+    // In collective mode all cores run the variants, and record the
+    // selection of core 0
+    uint32_t key[DISPATCH_KEY_LEN] = {1, 2, 3, 4};
+    ctx = (ctx_t){{0}};
+    errors += dispatch(&table, key, 0x7, run, &ctx, 1) != 1;
+    errors += ctx.runs[0] != 2 || ctx.runs[1] != 3 || ctx.runs[2] != 2;
+
+    errors = prim_allreduce(errors);
+    return snrt_cluster_core_idx() == 0 ? errors : 0;
+}
@@ -0,0 +1,42 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#define REPETITIONS 3
+
+// Exercises the DMA-based global reduction on any number of clusters. With a
+// number of clusters which is not a power of two, some receivers have no
+// sender in some levels of the reduction tree. With more than two clusters,
+// the senders of a level must not overwrite the destination buffers of the
+// receivers of the previous level while these are still being reduced.
+int main() {
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t nclusters = snrt_cluster_num();
+    uint32_t len = 4 * snrt_cluster_compute_core_num();
+    uint32_t errors = 0;
+
+    // Buffers lie at the same offset in every cluster's TCDM
+    double *src = (double *)snrt_l1_alloc_cluster_local(len * sizeof(double),
+                                                        sizeof(double));
+    double *dst = (double *)snrt_l1_alloc_cluster_local(len * sizeof(double),
+                                                        sizeof(double));
+
+    for (uint32_t r = 0; r < REPETITIONS; r++) {
+        // Every element is the sum of r + i + c over all clusters c
+        if (snrt_cluster_core_idx() == 0)
+            for (uint32_t i = 0; i < len; i++) src[i] = r + i + cluster_idx;
+        snrt_cluster_hw_barrier();
+
+        snrt_global_reduction_dma(dst, src, len);
+
+        if (cluster_idx == 0 && snrt_cluster_core_idx() == 0)
+            for (uint32_t i = 0; i < len; i++)
+                errors += src[i] != nclusters * (r + i) +
+                                        0.5 * nclusters * (nclusters - 1);
+        snrt_global_barrier();
+    }
+
+    return snrt_global_core_idx() == 0 ? errors : 0;
+}
@@ -0,0 +1,65 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#define NUM_INVOCATIONS 4
+#define CAPACITY 8
+
+// Profiling buffer in L3
+uint8_t prof_buffer[sizeof(snrt_prof_header_t) +
+                    CAPACITY * sizeof(snrt_prof_record_t)];
+
+int main() {
+    uint32_t errors = 0;
+
+    if (snrt_cluster_idx() == 0 && snrt_cluster_core_idx() == 0) {
+        // Request more events than available counters, to exercise
+        // multiplexing
+        const snrt_prof_event_t events[] = SNRT_PROF_DEFAULT_EVENTS(0);
+        uint32_t num_events = sizeof(events) / sizeof(events[0]);
+        uint32_t num_groups =
+            (num_events + SNRT_NUM_PERF_CNTS - 1) / SNRT_NUM_PERF_CNTS;
+        snrt_prof_init(prof_buffer, CAPACITY, events, num_events);
+
+        // Profile two regions, the second one more often than fits in the
+        // buffer
+        for (int i = 0; i < NUM_INVOCATIONS; i++) {
+            snrt_prof_region_start(0);
+            for (int j = 0; j < 100; j++) asm volatile("nop");
+            snrt_prof_region_end();
+        }
+        for (int i = 0; i < CAPACITY; i++) {
+            snrt_prof_region_start(1);
+            asm volatile("nop");
+            snrt_prof_region_end();
+        }
+
+        // Regions with an out-of-range ID are not profiled
+        snrt_prof_region_start(SNRT_PROF_MAX_REGIONS);
+        snrt_prof_region_end();
+
+        // Check header
+        snrt_prof_header_t *header = (snrt_prof_header_t *)prof_buffer;
+        snrt_prof_record_t *records = (snrt_prof_record_t *)(header + 1);
+        errors += header->magic != SNRT_PROF_MAGIC;
+        errors += header->num_events != num_events;
+        errors += header->capacity != CAPACITY;
+        errors += header->num_records != CAPACITY;
+        errors += header->num_dropped != NUM_INVOCATIONS;
+
+        // Check that groups are cycled through and the counters count
+        for (int i = 0; i < NUM_INVOCATIONS; i++) {
+            errors += records[i].region != 0;
+            errors += records[i].group != (i % num_groups);
+            errors += (records[i].tend - records[i].tstart) < 100;
+        }
+        // The third event of the first group is `issue_fpu`
+        errors += records[0].values[2] != 0;
+        // The fifth event of the first group is `retired_instr`
+        errors += records[0].values[4] < 100;
+    }
+
+    return errors;
+}
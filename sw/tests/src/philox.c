@@ -0,0 +1,100 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#include "prng/fill.h"
+
+#define N 19
+
+// Covers two COPIFT batches and a scalar tail
+#define N_COPIFT (2 * PRNG_BATCH + 5)
+
+// Odd, to cover the extra pair, and large enough for a mean within 0.25 and
+// a variance within 0.35 of a standard normal at five standard errors
+#define N_NORMAL 513
+
+static inline uint32_t moments_ok(double mean, double sq_mean) {
+    double var = sq_mean - mean * mean;
+    return fabs(mean) < 0.25 && fabs(var - 1) < 0.35;
+}
+
+int main() {
+    uint32_t errors = 0;
+
+    if (snrt_cluster_core_idx() != 0) return 0;
+
+    // Known-answer tests of the Random123 reference implementation
+    const uint32_t ctr[3][4] = {{0, 0, 0, 0},
+                                {0xffffffff, 0xffffffff, 0xffffffff,
+                                 0xffffffff},
+                                {0x243f6a88, 0x85a308d3, 0x13198a2e,
+                                 0x03707344}};
+    const uint32_t key[3][2] = {
+        {0, 0}, {0xffffffff, 0xffffffff}, {0xa4093822, 0x299f31d0}};
+    const uint32_t golden[3][4] = {
+        {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8},
+        {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd},
+        {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}};
+    for (int t = 0; t < 3; t++) {
+        uint32_t out[4];
+        philox4x32_block(ctr[t], key[t], out);
+        for (int i = 0; i < 4; i++) errors += out[i] != golden[t][i];
+    }
+
+    // Fills resume where the previous one stopped, and seeking replays them
+    uint32_t a[N], b[N];
+    philox4x32_t philox = philox4x32_init(42, snrt_cluster_idx());
+    prng_fill_u32(&philox, a, 8);
+    prng_fill_u32(&philox, a + 8, N - 8);
+    philox4x32_seek(&philox, 0);
+    prng_fill_u32(&philox, b, N);
+    for (int i = 0; i < N; i++) errors += a[i] != b[i];
+
+    // Uniform variates lie in (0, 1)
+    double u[N];
+    float uf[N];
+    prng_fill_uniform_f64(&philox, u, N);
+    prng_fill_uniform_f32(&philox, uf, N);
+    for (int i = 0; i < N; i++) {
+        errors += !(u[i] > 0 && u[i] < 1);
+        errors += !(uf[i] > 0 && uf[i] < 1);
+    }
+
+    // The COPIFT fill produces the same variates, and leaves the generator
+    // in the same state
+    double *c = (double *)snrt_l1_alloc_cluster_local(
+        N_COPIFT * sizeof(double), sizeof(double));
+    double *d = (double *)snrt_l1_alloc_cluster_local(
+        N_COPIFT * sizeof(double), sizeof(double));
+    uint64_t *staging = (uint64_t *)snrt_l1_alloc_cluster_local(
+        2 * PRNG_BATCH * sizeof(uint64_t), sizeof(uint64_t));
+    philox4x32_t ref = philox;
+    prng_fill_uniform_f64_copift(&philox, c, N_COPIFT, staging);
+    prng_fill_uniform_f64(&ref, d, N_COPIFT);
+    for (int i = 0; i < N_COPIFT; i++)
+        errors += *(uint64_t *)&c[i] != *(uint64_t *)&d[i];
+    prng_fill_u32(&philox, a, 1);
+    prng_fill_u32(&ref, b, 1);
+    errors += a[0] != b[0];
+
+    // Normal variates have zero mean and unit variance
+    double *x = (double *)snrt_l1_alloc_cluster_local(
+        N_NORMAL * sizeof(double), sizeof(double));
+    float *xf = (float *)snrt_l1_alloc_cluster_local(N_NORMAL * sizeof(float),
+                                                     sizeof(float));
+    prng_fill_normal_f64(&philox, x, N_NORMAL, staging);
+    prng_fill_normal_f32(&philox, xf, N_NORMAL);
+    double sum = 0, sq_sum = 0, sumf = 0, sq_sumf = 0;
+    for (int i = 0; i < N_NORMAL; i++) {
+        sum += x[i];
+        sq_sum += x[i] * x[i];
+        sumf += xf[i];
+        sq_sumf += (double)xf[i] * xf[i];
+    }
+    errors += !moments_ok(sum / N_NORMAL, sq_sum / N_NORMAL);
+    errors += !moments_ok(sumf / N_NORMAL, sq_sumf / N_NORMAL);
+
+    return errors;
+}
@@ -0,0 +1,85 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#include "primitives/primitives.h"
+
+#define N 100
+#define NSEG 9
+
+static uint32_t is_odd(uint32_t x) { return x % 2; }
+
+static uint32_t mod7(uint32_t x) { return x % 7; }
+
+int main() {
+    uint32_t cluster_idx = snrt_cluster_idx();
+    uint32_t nclusters = snrt_cluster_num();
+    uint32_t errors = 0;
+
+    uint32_t *x = (uint32_t *)snrt_l1_alloc_cluster_local(
+        N * sizeof(uint32_t), sizeof(uint32_t));
+    uint32_t *y = (uint32_t *)snrt_l1_alloc_cluster_local(
+        N * sizeof(uint32_t), sizeof(uint32_t));
+    double *xd = (double *)snrt_l1_alloc_cluster_local(N * sizeof(double),
+                                                       sizeof(double));
+    double *yd = (double *)snrt_l1_alloc_cluster_local(N * sizeof(double),
+                                                       sizeof(double));
+    uint32_t *offsets = (uint32_t *)snrt_l1_alloc_cluster_local(
+        (NSEG + 1) * sizeof(uint32_t), sizeof(uint32_t));
+    if (snrt_cluster_core_idx() == 0) {
+        for (uint32_t i = 0; i < N; i++) {
+            x[i] = i + cluster_idx;
+            xd[i] = 0.5 * (i + cluster_idx);
+        }
+        // Empty, short, and long segments
+        uint32_t seg_offsets[NSEG + 1] = {0, 0, 1, 3, 3, 60, 61, 61, 99, N};
+        for (uint32_t s = 0; s <= NSEG; s++) offsets[s] = seg_offsets[s];
+    }
+    snrt_cluster_hw_barrier();
+
+    // Sum of i + c over i < N and c < clusters
+    uint32_t sum = N * (N - 1) / 2 + N * cluster_idx;
+    uint32_t global_sum = nclusters * N * (N - 1) / 2 +
+                          N * nclusters * (nclusters - 1) / 2;
+    errors += prim_reduce(x, N) != sum;
+    errors += prim_reduce(x, N, 1) != global_sum;
+    errors += prim_reduce(xd, N) != 0.5 * sum;
+    errors += prim_reduce(xd, N, 1) != 0.5 * global_sum;
+
+    // Preceding elements of all clusters, sum of i + c' over c' < c
+    uint32_t offset = cluster_idx * N * (N - 1) / 2 +
+                      N * cluster_idx * (cluster_idx - 1) / 2;
+    errors += prim_scan(x, y, N, 1) != sum;
+    for (uint32_t i = 0, acc = 0; i < N; i++) {
+        acc += x[i];
+        errors += y[i] != acc;
+    }
+    errors += prim_scan(xd, yd, N, 0, 1) != 0.5 * global_sum;
+    for (uint32_t i = 0, acc = offset; i < N; i++) {
+        errors += yd[i] != 0.5 * acc;
+        acc += x[i];
+    }
+
+    prim_segmented_reduce(x, offsets, NSEG, y);
+    for (uint32_t s = 0; s < NSEG; s++)
+        errors += y[s] != prim_sum_seq(x + offsets[s],
+                                       offsets[s + 1] - offsets[s]);
+
+    prim_histogram(x, N, 7, y, mod7, 1);
+    for (uint32_t d = 0; d < 7; d++) {
+        uint32_t count = 0;
+        for (uint32_t c = 0; c < nclusters; c++)
+            for (uint32_t i = 0; i < N; i++) count += (i + c) % 7 == d;
+        errors += y[d] != count;
+    }
+
+    uint32_t count = prim_compact(x, N, y, is_odd);
+    errors += count != N / 2;
+    for (uint32_t i = 0; i < count; i++)
+        errors += y[i] != cluster_idx + 1 - cluster_idx % 2 + 2 * i;
+
+    errors = prim_allreduce(errors, 1);
+    return snrt_global_core_idx() == 0 ? errors : 0;
+}
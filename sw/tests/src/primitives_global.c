@@ -0,0 +1,37 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "snrt.h"
+
+#include "primitives/primitives.h"
+
+// Exercises the cross-cluster combination of the global reductions and
+// scans on doubles, which all cores, including the DMA core, take part in.
+// On a single cluster, the global variants reduce to the cluster-local ones.
+int main() {
+    uint32_t ncores = snrt_cluster_compute_core_num();
+    uint32_t nclusters = snrt_cluster_num();
+    uint32_t is_compute = snrt_is_compute_core();
+    uint32_t errors = 0;
+
+    // Compute core g, counting across clusters, contributes g + 1
+    uint32_t g = snrt_cluster_idx() * ncores + snrt_cluster_core_idx();
+    uint32_t ng = nclusters * ncores;
+    double value = is_compute ? g + 1 : 0;
+    double global_sum = 0.5 * ng * (ng + 1);
+
+    errors += prim_allreduce(value, 1) != global_sum;
+
+    double total;
+    double offset = prim_exscan(value, &total, 1);
+    errors += total != global_sum;
+    if (is_compute) errors += offset != 0.5 * g * (g + 1);
+
+    // Repeated calls must not interfere through the gather buffers
+    for (uint32_t i = 0; i < 3; i++)
+        errors += prim_allreduce(value * i, 1) != global_sum * i;
+
+    errors = prim_allreduce(errors, 1);
+    return snrt_global_core_idx() == 0 ? errors : 0;
+}
@@ -0,0 +1,65 @@
+// Copyright 2025 ETH Zurich and University of Bologna.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <math.h>
+
+#include "snrt.h"
+
+#include "vmath/vmath.h"
+
+// Covers two chunks of the vectorized paths and a remainder
+#define N (2 * VMATH_CHUNK + 3)
+
+int main() {
+    uint32_t errors = 0;
+
+    if (snrt_cluster_core_idx() != 0) return 0;
+
+    double *x = snrt_l1_alloc_cluster_local<double>(N);
+    double *y = snrt_l1_alloc_cluster_local<double>(N);
+
+    // The vectorized paths agree with the element functions, to one
+    // rounding, as the latter may not be contracted to FMAs
+    for (int i = 0; i < N; i++) x[i] = (i - N / 2) * 0.37;
+    vmath_vexp(x, y, N);
+    for (int i = 0; i < N; i++)
+        errors += fabs(y[i] - vmath_exp(x[i])) > 0x1p-52 * y[i];
+    double sum = vmath_vexp_sum(x, y, N), ref = 0;
+    for (int i = 0; i < N; i++) ref += y[i];
+    errors += fabs(sum - ref) > 0x1p-48 * ref;
+    for (int i = 0; i < N; i++) x[i] = (i + 1) * 0.37;
+    vmath_vrsqrt(x, y, N);
+    for (int i = 0; i < N; i++)
+        errors += fabs(y[i] - vmath_rsqrt(x[i])) > 0x1p-52 * y[i];
+
+    // Relative errors against libm, in double and single precision
+    for (int i = 0; i < N; i++) {
+        double t = (i - N / 2) * 0.05;
+        double u = (i + 1) * 0.05;
+        errors += fabs(vmath_exp(t) - exp(t)) > 0x1p-51 * exp(t);
+        errors += fabs(vmath_log(u) - log(u)) > 0x1p-51 * fabs(log(u));
+        errors += fabs(vmath_sin(t) - sin(t)) > 0x1p-50 * fabs(sin(t));
+        errors += fabs(vmath_cos(t) - cos(t)) > 0x1p-50 * fabs(cos(t));
+        errors += fabs(vmath_tanh(t) - tanh(t)) > 0x1p-50 * fabs(tanh(t));
+        errors += fabs(vmath_rsqrt(u) - 1 / sqrt(u)) > 0x1p-51 / sqrt(u);
+        float tf = t, uf = u;
+        t = tf;
+        u = uf;
+        errors += fabs(vmath_expf(tf) - exp(t)) > 0x1p-23 * exp(t);
+        errors += fabs(vmath_logf(uf) - log(u)) > 0x1p-23 * fabs(log(u));
+        errors += fabs(vmath_sinf(tf) - sin(t)) > 0x1p-23 * fabs(sin(t));
+        errors += fabs(vmath_tanhf(tf) - tanh(t)) > 0x1p-23 * fabs(tanh(t));
+    }
+
+    // Special values
+    errors += vmath_log(0) != -INFINITY;
+    errors += !isnan(vmath_log(-1));
+    errors += vmath_logf(INFINITY) != INFINITY;
+    errors += vmath_expf(-INFINITY) != 0;
+    errors += vmath_expf(100) != INFINITY;
+    errors += vmath_tanh(INFINITY) != 1 || vmath_tanhf(-INFINITY) != -1;
+    errors += vmath_sigmoid(-INFINITY) > 1e-300 || vmath_sigmoid(40) != 1;
+
+    return errors;
+}
@@ -16,6 +16,7 @@ SN_TESTS_BUILDDIR ?= $(SN_ROOT)/sw/tests/build
 ###################
 
 SN_TESTS_INCDIRS += $(SN_RUNTIME_INCDIRS)
+SN_TESTS_INCDIRS += $(SN_ROOT)/sw/kernels/misc
 
 SN_TESTS_RISCV_CFLAGS += $(SN_RISCV_CFLAGS)
 SN_TESTS_RISCV_CFLAGS += $(addprefix -I,$(SN_TESTS_INCDIRS))
@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+"""Converts profiling buffers dumped by the Snitch runtime to JSON.
+
+This script takes one or more profiling buffers, as filled by the
+`snrt_prof_*` functions in `sw/runtime/src/perf_prof.h`, and converts
+them to the JSON format output by [`join.py`][join]. Every record in
+a buffer becomes a region of the hart which recorded it, with the
+performance counter values sampled during that region invocation as
+attributes. The output can thus be fed to [`roi.py`][roi] and
+[`visualize.py`][visualize] like any other performance dump.
+
+Buffers can be passed either as raw binary files, or extracted from a
+memory dump of the simulation, given the ELF binary and the symbol
+holding the buffers. Multiple buffers, e.g. one per cluster, can be
+stored back to back in a file or symbol.
+
+Since every region invocation samples only one group of events, the
+script can optionally summarize all invocations of every region,
+extrapolating per-invocation averages for every event, and deriving
+some commonly used metrics (e.g. TCDM congestion, FPU occupancy).
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = 0x46504e53
+VERSION = 2
+MAX_EVENTS = 64
+
+HEADER_FMT = '<IHHHHHHIII'
+HEADER_SIZE = struct.calcsize(HEADER_FMT) + MAX_EVENTS * 4
+RECORD_HEADER_FMT = '<HHII'
+
+# Must match the `perf_metric` enum in `snitch_cluster_peripheral_reg.rdl`
+METRICS = [
+    'cycle', 'tcdm_accessed', 'tcdm_congested', 'issue_fpu', 'issue_fpu_seq',
+    'issue_core_to_fpu', 'retired_instr', 'retired_load', 'retired_i', 'retired_acc',
+    'dma_aw_stall', 'dma_ar_stall', 'dma_r_stall', 'dma_w_stall', 'dma_buf_w_stall',
+    'dma_buf_r_stall', 'dma_aw_done', 'dma_aw_bw', 'dma_ar_done', 'dma_ar_bw',
+    'dma_r_done', 'dma_r_bw', 'dma_w_done', 'dma_w_bw', 'dma_b_done', 'dma_busy',
+    'icache_miss', 'icache_hit', 'icache_prefetch', 'icache_double_hit', 'icache_stall'
+]
+
+HART_LOCAL_METRICS = [
+    'issue_fpu', 'issue_fpu_seq', 'issue_core_to_fpu', 'retired_instr', 'retired_load',
+    'retired_i', 'retired_acc', 'icache_miss', 'icache_hit', 'icache_prefetch',
+    'icache_double_hit', 'icache_stall'
+]
+
+
+def event_name(metric, hart):
+    """Returns the attribute name of a (metric, hart) event."""
+    name = METRICS[metric] if metric < len(METRICS) else f'metric{metric}'
+    if name in HART_LOCAL_METRICS:
+        name = f'{name}_hart{hart}'
+    return name
+
+
+def parse_buffer(data, offset=0):
+    """Parses a single profiling buffer.
+
+    Args:
+        data: A bytes-like object containing the buffer.
+        offset: The offset of the buffer within `data`.
+
+    Returns:
+        A tuple `(buffer, size)`, where `buffer` is a dictionary with the
+        header fields, the event names and the list of records, and `size`
+        is the size of the buffer in bytes.
+    """
+    fields = struct.unpack_from(HEADER_FMT, data, offset)
+    (magic, version, cluster_idx, hartid, num_cnts, num_events, _, capacity, num_records,
+     num_dropped) = fields
+    if magic != MAGIC:
+        raise ValueError(f'Invalid magic number {hex(magic)} at offset {offset}')
+    if version != VERSION:
+        raise ValueError(f'Unsupported profiling buffer version {version}')
+
+    # Parse events
+    events_offset = offset + struct.calcsize(HEADER_FMT)
+    events = []
+    for i in range(num_events):
+        metric, hart = struct.unpack_from('<HH', data, events_offset + 4 * i)
+        events.append(event_name(metric, hart))
+
+    # Parse records
+    record_fmt = RECORD_HEADER_FMT + f'{num_cnts}I'
+    record_size = struct.calcsize(record_fmt)
+    records = []
+    for i in range(min(num_records, capacity)):
+        region, group, tstart, tend, *values = struct.unpack_from(
+            record_fmt, data, offset + HEADER_SIZE + i * record_size)
+        first = group * num_cnts
+        counters = {events[first + j]: values[j]
+                    for j in range(num_cnts) if first + j < num_events}
+        records.append({
+            'region': region,
+            'group': group,
+            'tstart': tstart,
+            'tend': tend,
+            'counters': counters
+        })
+
+    buffer = {
+        'cluster_idx': cluster_idx,
+        'hartid': hartid,
+        'num_dropped': num_dropped,
+        'events': events,
+        'records': records
+    }
+    return buffer, HEADER_SIZE + capacity * record_size
+
+
+def parse_buffers(data):
+    """Parses all profiling buffers stored back to back in `data`."""
+    buffers = []
+    offset = 0
+    while offset + HEADER_SIZE <= len(data):
+        if struct.unpack_from('<I', data, offset)[0] != MAGIC:
+            break
+        buffer, size = parse_buffer(data, offset)
+        buffers.append(buffer)
+        offset += size
+    return buffers
+
+
+def to_perf_json(buffers):
+    """Converts parsed buffers to the `join.py` output format."""
+    data = {}
+    for buffer in buffers:
+        regions = data.setdefault(f"hart_{buffer['hartid']}", [])
+        for record in buffer['records']:
+            regions.append({
+                'tstart': record['tstart'],
+                'tend': record['tend'],
+                'region': record['region'],
+                **record['counters']
+            })
+    return data
+
+
+def summarize(buffers):
+    """Summarizes all invocations of every region.
+
+    Event values are averaged over the invocations in which the event
+    was sampled, and reported per invocation. Cycles are averaged over
+    all invocations.
+    """
+    samples = {}
+    for buffer in buffers:
+        for record in buffer['records']:
+            region = samples.setdefault(record['region'], {'cycles': [], 'counters': {}})
+            region['cycles'].append(record['tend'] - record['tstart'])
+            for name, value in record['counters'].items():
+                region['counters'].setdefault(name, []).append(value)
+
+    summary = {}
+    for region_id, region in sorted(samples.items()):
+        cycles = sum(region['cycles']) / len(region['cycles'])
+        metrics = {name: sum(values) / len(values) for name, values in region['counters'].items()}
+        entry = {'invocations': len(region['cycles']), 'cycles': cycles, **metrics}
+        # Derived metrics
+        if metrics.get('tcdm_accessed'):
+            entry['tcdm_congestion'] = metrics.get('tcdm_congested', 0) / metrics['tcdm_accessed']
+        if 'dma_busy' in metrics and cycles:
+            entry['dma_utilization'] = metrics['dma_busy'] / cycles
+        if 'dma_ar_bw' in metrics and cycles:
+            entry['dma_read_bw'] = metrics['dma_ar_bw'] / cycles
+        if 'dma_aw_bw' in metrics and cycles:
+            entry['dma_write_bw'] = metrics['dma_aw_bw'] / cycles
+        for name in metrics:
+            if name.startswith('issue_fpu_hart') and cycles:
+                hart = name[len('issue_fpu_hart'):]
+                entry[f'fpu_occupancy_hart{hart}'] = metrics[name] / cycles
+                entry[f'fpu_stall_hart{hart}'] = 1 - metrics[name] / cycles
+            if name.startswith('icache_miss_hart'):
+                hart = name[len('icache_miss_hart'):]
+                accesses = metrics[name] + metrics.get(f'icache_hit_hart{hart}', 0)
+                if accesses:
+                    entry[f'icache_miss_rate_hart{hart}'] = metrics[name] / accesses
+        summary[f'region_{region_id}'] = entry
+    return summary
+
+
+def read_inputs(args):
+    """Reads the raw bytes of all profiling buffers specified on the command line."""
+    data = b''
+    for path in args.inputs:
+        with open(path, 'rb') as f:
+            data += f.read()
+    if args.memdump:
+        from snitch.util.sim.Elf import Elf
+        from snitch.util.sim.verif_utils import MemoryDumpReader
+        elf = Elf(args.elf)
+        reader = MemoryDumpReader(args.memdump, args.memaddr)
+        data += reader.read(elf.get_symbol_address(args.symbol),
+                            elf.get_symbol_size(args.symbol))
+    return data
+
+
+def main():
+    # Argument parsing
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        'inputs',
+        nargs='*',
+        help='Raw profiling buffers')
+    parser.add_argument(
+        '--elf',
+        help='ELF binary defining the symbol which holds the profiling buffers')
+    parser.add_argument(
+        '--symbol',
+        default='prof_buffer',
+        help='Symbol holding the profiling buffers')
+    parser.add_argument(
+        '--memdump',
+        help='Memory dump containing the profiling buffers')
+    parser.add_argument(
+        '--memaddr',
+        type=lambda x: int(x, 0),
+        help='The start address of the memory dump')
+    parser.add_argument(
+        '-o',
+        '--output',
+        nargs='?',
+        default='perf.json',
+        help='Output JSON file')
+    parser.add_argument(
+        '--summary',
+        help='Optional output JSON file summarizing every region')
+    args = parser.parse_args()
+
+    buffers = parse_buffers(read_inputs(args))
+    for buffer in buffers:
+        if buffer['num_dropped']:
+            print(f"Warning: cluster {buffer['cluster_idx']} dropped {buffer['num_dropped']}"
+                  " records", file=sys.stderr)
+
+    with open(args.output, 'w') as f:
+        json.dump(to_perf_json(buffers), f, indent=4)
+    if args.summary:
+        with open(args.summary, 'w') as f:
+            json.dump(summarize(buffers), f, indent=4)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+# Copyright 2025 ETH Zurich and University of Bologna.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+import struct
+import pytest
+from bench.prof import HEADER_FMT, MAGIC, MAX_EVENTS, VERSION, parse_buffers, \
+    to_perf_json, summarize
+
+NUM_CNTS = 2
+CAPACITY = 4
+# tcdm_accessed, tcdm_congested, issue_fpu (hart 3)
+EVENTS = [(1, 0), (2, 0), (3, 3)]
+# region, group, tstart, tend, values
+RECORDS = [
+    (0, 0, 100, 200, [50, 10]),
+    (0, 1, 300, 400, [80, 0]),
+    (1, 0, 500, 540, [20, 0]),
+]
+
+
+def make_buffer(cluster_idx, hartid):
+    data = struct.pack(HEADER_FMT, MAGIC, VERSION, cluster_idx, hartid, NUM_CNTS, len(EVENTS),
+                       0, CAPACITY, len(RECORDS), 0)
+    for i in range(MAX_EVENTS):
+        data += struct.pack('<HH', *(EVENTS[i] if i < len(EVENTS) else (0, 0)))
+    for i in range(CAPACITY):
+        region, group, tstart, tend, values = RECORDS[i] if i < len(RECORDS) else \
+            (0, 0, 0, 0, [0] * NUM_CNTS)
+        data += struct.pack(f'<HHII{NUM_CNTS}I', region, group, tstart, tend, *values)
+    return data
+
+
+def test_parse_buffers():
+    buffers = parse_buffers(make_buffer(0, 8) + make_buffer(1, 17))
+    assert len(buffers) == 2
+    assert buffers[1]['hartid'] == 17
+    assert buffers[0]['events'] == ['tcdm_accessed', 'tcdm_congested', 'issue_fpu_hart3']
+    assert buffers[0]['records'][1]['counters'] == {'issue_fpu_hart3': 80}
+
+
+def test_to_perf_json():
+    data = to_perf_json(parse_buffers(make_buffer(0, 8)))
+    assert data['hart_8'][0] == {
+        'tstart': 100,
+        'tend': 200,
+        'region': 0,
+        'tcdm_accessed': 50,
+        'tcdm_congested': 10
+    }
+
+
+def test_summarize():
+    summary = summarize(parse_buffers(make_buffer(0, 8)))
+    assert summary['region_0']['invocations'] == 2
+    assert summary['region_0']['cycles'] == 100
+    assert summary['region_0']['tcdm_congestion'] == pytest.approx(0.2)
+    assert summary['region_0']['fpu_occupancy_hart3'] == pytest.approx(0.8)
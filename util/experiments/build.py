@@ -55,6 +55,9 @@ def parser():
     parser.add_argument(
         '--testlist-cmd',
         help='A custom command to use in the testlist')
+    parser.add_argument(
+        '--hw-cfg',
+        help='Hardware configuration to build the software for')
 
     return parser
 
@@ -131,7 +134,8 @@ def main():
     processes = []
     for cfg in cfgs:
         build_dir = Path(f'build/{cfg.stem}').resolve()
-        processes.append(build(args.target, build_dir, data_cfg=cfg, sync=False))
+        processes.append(build(args.target, build_dir, data_cfg=cfg, hw_cfg=args.hw_cfg,
+                               sync=False))
         print(colored('Build app', 'black', attrs=['bold']),
               colored(args.target + '-' + cfg.stem, 'cyan', attrs=['bold']),
               colored('in', 'black', attrs=['bold']),
@@ -9,6 +9,7 @@
 
 from concurrent.futures import ThreadPoolExecutor, as_completed
 from copy import deepcopy
+import itertools
 import json5
 import mako
 import pandas as pd
@@ -438,3 +439,89 @@ def derive_data_cfg_from_template(experiment, template_path=Path("cfg.json.tpl")
 
     # Return the path to the rendered configuration file
     return cfg_path
+
+
+class KernelExperimentManager(ExperimentManager):
+    """Manager for the experiments of a kernel with a templated data configuration.
+
+    The data configuration of every experiment is rendered from the
+    `cfg.json.tpl` template in the experiment directory.
+    """
+
+    def __init__(self, experiments, axes, **kwargs):
+        """Initializes the class, designating the given keys as the experiment axes."""
+        self.axes = axes
+        super().__init__(experiments, **kwargs)
+
+    def derive_axes(self, experiment):
+        return derive_axes_from_keys(experiment, self.axes)
+
+    def derive_data_cfg(self, experiment):
+        return derive_data_cfg_from_template(experiment)
+
+
+def sweep(**params):
+    """Generate the Cartesian product of some parameters.
+
+    Args:
+        params: Parameter values, either a list of values to sweep or a
+            single value, common to all experiments.
+
+    Returns:
+        A list of experiment dictionaries, in row-major order of the
+        swept parameters.
+    """
+    values = [val if isinstance(val, list) else [val] for val in params.values()]
+    return [dict(zip(params.keys(), point)) for point in itertools.product(*values)]
+
+
+def timespan(start_region, end_region=None):
+    """Return a function measuring the runtime of an experiment between two regions."""
+    return lambda row: row['results'].get_timespan(start_region, end_region)
+
+
+def add_speedup(df, baseline, keys):
+    """Add the speedup of every experiment over a baseline.
+
+    Args:
+        df: DataFrame of experiment results, with a `cycles` column.
+        baseline: Boolean mask selecting the baseline experiments.
+        keys: Columns identifying the baseline of every experiment.
+    """
+    base = df[baseline]
+    cycles = base['cycles'].set_axis(pd.MultiIndex.from_frame(base[keys]))
+    base_cycles = cycles.reindex(pd.MultiIndex.from_frame(df[keys])).to_numpy()
+    df['speedup'] = base_cycles / df['cycles'].to_numpy()
+
+
+def run_kernel_experiments(experiments, axes, verify_py, get_runtime, metrics=None,
+                           path='results.csv'):
+    """Run the experiments of a kernel and export a table of their results.
+
+    Args:
+        experiments: List of experiment dictionaries.
+        axes: Keys designated as the experiment axes.
+        verify_py: Verification script of the kernel, invoked to run
+            every experiment.
+        get_runtime: Function returning the runtime of an experiment, in
+            cycles, from its row in the results DataFrame.
+        metrics: Optional function deriving further columns from the
+            `cycles` column of the results DataFrame, in place.
+        path: Path of the CSV file the results are exported to.
+    """
+    for experiment in experiments:
+        experiment['cmd'] = [str(Path(verify_py).absolute()), '${sim_bin}', '${elf}']
+    manager = KernelExperimentManager(experiments, axes)
+    manager.run()
+
+    df = manager.get_results()
+    if manager.perf_results_available:
+        df['cycles'] = df.apply(get_runtime, axis=1)
+        if metrics is not None:
+            metrics(df)
+        df.drop(labels=['results'], inplace=True, axis=1)
+
+    # Export results to file
+    print(df)
+    df.to_csv(path, index=False)
+    return df
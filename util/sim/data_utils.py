@@ -286,6 +286,9 @@ def from_buffer(byte_array, ctype='uint32_t'):
     NP_DTYPE_FROM_CTYPE = {
         'uint32_t': np.uint32,
         'int32_t': np.int32,
+        'uint16_t': np.uint16,
+        'int16_t': np.int16,
+        'int8_t': np.int8,
         'double': np.float64,
         'float': np.float32,
         '__fp16': np.float16
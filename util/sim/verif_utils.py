@@ -223,7 +223,8 @@ class Verifier:
             expected: The expected results.
             actual: The actual results.
             atol: Absolute tolerance. The maximum absolute difference
-                between the expected and actual results. Mutually
+                between the expected and actual results, either for all
+                elements or for every element. Mutually
                 exclusive with `rtol`.
             rtol: Relative tolerance. The maximum relative difference
                 between the expected and actual results. Mutually
@@ -241,7 +242,7 @@ class Verifier:
         if atol is not None and rtol is not None:
             raise ValueError('atol and rtol are mutually exclusive.')
         if atol is not None:
-            max_err = [atol] * len(flatten(expected))
+            max_err = np.broadcast_to(atol, err.shape)
             # Handle FlexFloat arrays differently
             if expected.dtype == np.dtype(object):
                 success = np.all(err <= max_err)